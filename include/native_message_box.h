@@ -7,7 +7,9 @@
  *
  * Strings are UTF-8 encoded. Callers are expected to pin the memory for the duration
  * of the API call. Any output strings returned by the runtime must be released with
- * the provided deallocation callback (see NmbAllocator).
+ * the provided deallocation callback (see NmbAllocator). Callers that already hold
+ * text as slices of larger buffers can pass pointer+length views instead of
+ * NUL-terminated copies (see NmbMessageBoxStrings).
  */
 
 #include <stdint.h>
@@ -108,7 +110,9 @@ typedef enum NmbInputMode_t
     NMB_INPUT_CHECKBOX = 1,
     NMB_INPUT_TEXT = 2,
     NMB_INPUT_PASSWORD = 3,
-    NMB_INPUT_COMBO = 4
+    NMB_INPUT_COMBO = 4,
+    NMB_INPUT_MULTILINE = 5, /**< Multi-line text; see NmbInputOption.input_chunk_callback for large answers. */
+    NMB_INPUT_MULTISELECT = 6 /**< Checklist over the combo items; answered in NmbInputOption.selection_bits. */
 } NmbInputMode;
 
 typedef enum NmbButtonId_t
@@ -128,6 +132,50 @@ typedef enum NmbButtonId_t
     NMB_BUTTON_ID_CUSTOM_BASE = 1000
 } NmbButtonId;
 
+/** Implementation that answered a request; reported in NmbMessageBoxResult.backend. */
+typedef enum NmbBackend_t
+{
+    NMB_BACKEND_UNKNOWN = 0,
+    NMB_BACKEND_HEADLESS = 1,  /**< Scripted by the test harness; nothing was shown. */
+    NMB_BACKEND_RUNTIME = 2,   /**< Answered by the runtime itself, e.g. from a suppressed message template. */
+    NMB_BACKEND_GTK = 3,
+    NMB_BACKEND_ZENITY = 4,    /**< Linux fallback when GTK cannot open a display. */
+    NMB_BACKEND_WIN32 = 5,
+    NMB_BACKEND_APPKIT = 6,
+    NMB_BACKEND_UIKIT = 7,
+    NMB_BACKEND_ANDROID = 8,
+    NMB_BACKEND_WEB = 9
+} NmbBackend;
+
+typedef enum NmbMessageBoxFlags_t
+{
+    NMB_MESSAGE_BOX_FLAG_NONE = 0,
+    NMB_MESSAGE_BOX_FLAG_STRING_VIEWS = 1u << 0, /**< Read text from NmbMessageBoxOptions.strings. */
+    NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS = 1u << 1, /**< Read text from NmbMessageBoxOptions.strings_utf16. */
+    NMB_MESSAGE_BOX_FLAG_STRICT_UTF8 = 1u << 2,   /**< Fail the call on ill-formed UTF-8 instead of showing U+FFFD. */
+    NMB_MESSAGE_BOX_FLAG_SHOW_COUNTDOWN = 1u << 3 /**< Show the seconds left on the timeout button. */
+} NmbMessageBoxFlags;
+
+/**
+ * Non-owning UTF-8 slice. The bytes do not need to be NUL-terminated, so a view can point
+ * into a larger buffer (log file, config blob) without copying it first.
+ */
+typedef struct NmbStringView_t
+{
+    const char* data; /**< First byte of the slice; NULL means "not provided". */
+    size_t length;    /**< Length of the slice in bytes. */
+} NmbStringView;
+
+/**
+ * Non-owning UTF-16 slice in native byte order, as held by .NET, Java, JavaScript and Win32 hosts.
+ * Unpaired surrogates are replaced with U+FFFD when the runtime needs UTF-8.
+ */
+typedef struct NmbStringView16_t
+{
+    const uint16_t* data; /**< First code unit of the slice; NULL means "not provided". */
+    size_t length;        /**< Length of the slice in UTF-16 code units. */
+} NmbStringView16;
+
 typedef struct NmbButtonOption_t
 {
     uint32_t struct_size;       /**< Must be set to sizeof(NmbButtonOption). */
@@ -139,6 +187,29 @@ typedef struct NmbButtonOption_t
     nmb_bool is_cancel;         /**< Marks cancel button. */
 } NmbButtonOption;
 
+/**
+ * Items packed back to back into one UTF-8 buffer, for lists too large to pass as one string each.
+ * Item i spans data[offsets[i]] up to (not including) data[offsets[i + 1]], so offsets holds
+ * item_count + 1 non-decreasing entries. Items are not NUL-terminated.
+ */
+typedef struct NmbItemBuffer_t
+{
+    uint32_t struct_size;    /**< Must be set to sizeof(NmbItemBuffer). */
+    const char* data;        /**< Concatenated item text. */
+    const uint32_t* offsets; /**< item_count + 1 byte offsets into data. */
+    size_t item_count;       /**< Number of items. */
+} NmbItemBuffer;
+
+/**
+ * Receives the answer to an NMB_INPUT_MULTILINE prompt in order, one piece at a time. Pieces never split a
+ * UTF-8 sequence and are not NUL-terminated. Returning anything but NMB_OK stops delivery, and that code
+ * becomes the result of nmb_show_message_box.
+ */
+typedef NmbResultCode (*NmbInputChunkCallback)(void* user_data, const char* chunk_utf8, size_t length);
+
+/** Prefix index over a candidate corpus; see nmb_completion_index_create. */
+typedef struct NmbCompletionIndex_t NmbCompletionIndex;
+
 typedef struct NmbInputOption_t
 {
     uint32_t struct_size;         /**< Must be set to sizeof(NmbInputOption). */
@@ -147,8 +218,62 @@ typedef struct NmbInputOption_t
     const char* placeholder_utf8; /**< Placeholder text for text input. */
     const char* default_value_utf8; /**< Initial value (for text/combo). */
     const char* const* combo_items_utf8; /**< Array of strings (NULL-terminated) when mode == NMB_INPUT_COMBO. */
+    const NmbItemBuffer* combo_item_buffer; /**< Optional; replaces combo_items_utf8 when non-NULL. */
+    const NmbCompletionIndex* completion_index; /**< Optional autocomplete candidates for NMB_INPUT_TEXT. */
+    uint32_t completion_max_results; /**< Suggestions shown at once; 0 selects the runtime default. */
+    NmbInputChunkCallback input_chunk_callback; /**< Optional; streams a multiline answer, bypassing input_value_utf8. */
+    void* input_chunk_user_data; /**< Passed to input_chunk_callback. */
+    /**
+     * NMB_INPUT_MULTISELECT answer buffers, owned and sized by the caller so the runtime allocates nothing for
+     * them; at least one must be supplied. Item i is bit (i % 8) of byte i / 8 in selection_bits, which must
+     * hold (item_count + 7) / 8 bytes. Bits set on entry pre-check their items; unless the dialog is cancelled,
+     * the bitset holds the final selection on return. selection_indices receives the checked items in ascending
+     * order, up to selection_index_capacity of them; NmbMessageBoxResult.selection_count reports how many.
+     */
+    uint8_t* selection_bits;
+    size_t selection_bits_size;      /**< Size of selection_bits in bytes. */
+    uint32_t* selection_indices;
+    size_t selection_index_capacity; /**< Entries available in selection_indices. */
 } NmbInputOption;
 
+/**
+ * One answer of a form dialog (see NmbMessageBoxOptions.form_fields), in field order. value_utf8 is always
+ * non-NULL and NUL-terminated; checkbox fields report their state in checked and an empty value.
+ */
+typedef struct NmbFieldValue_t
+{
+    const char* value_utf8; /**< Text answer; points into the block owned by NmbMessageBoxResult.field_values. */
+    size_t length;          /**< Byte length of value_utf8. */
+    nmb_bool checked;       /**< Checkbox state for NMB_INPUT_CHECKBOX fields. */
+} NmbFieldValue;
+
+typedef enum NmbContentSourceKind_t
+{
+    NMB_CONTENT_SOURCE_NONE = 0,
+    NMB_CONTENT_SOURCE_PATH = 1, /**< Open path_utf8 read-only. */
+    NMB_CONTENT_SOURCE_FD = 2    /**< Map the caller's descriptor (POSIX fd, or a HANDLE on Windows). */
+} NmbContentSourceKind;
+
+/**
+ * Text held in a file rather than in memory. The runtime maps the requested range read-only for the
+ * lifetime of the dialog and never closes a caller-supplied descriptor.
+ */
+typedef struct NmbContentSource_t
+{
+    uint32_t struct_size;      /**< Must be set to sizeof(NmbContentSource). */
+    NmbContentSourceKind kind; /**< Selects path_utf8 or fd. */
+    const char* path_utf8;     /**< File to open when kind == NMB_CONTENT_SOURCE_PATH. */
+    intptr_t fd;               /**< Descriptor or HANDLE when kind == NMB_CONTENT_SOURCE_FD; borrowed. */
+    uint64_t offset;           /**< First byte of the range to show. */
+    uint64_t length;           /**< Number of bytes to show; 0 means "to the end of the file". */
+    /**
+     * Keep showing bytes appended to path_utf8 while the dialog is open, like tail -f; length is ignored.
+     * Requires NMB_CONTENT_SOURCE_PATH. Backends that cannot follow a file show a snapshot instead.
+     */
+    nmb_bool follow;
+    uint32_t follow_max_lines; /**< Newest lines kept while following; 0 selects the runtime default. */
+} NmbContentSource;
+
 typedef struct NmbSecondaryContentOption_t
 {
     uint32_t struct_size;
@@ -156,8 +281,150 @@ typedef struct NmbSecondaryContentOption_t
     const char* expanded_text_utf8;    /**< Text shown when expanded section opened. */
     const char* footer_text_utf8;      /**< Footer message / help link. */
     const char* help_link_utf8;        /**< Optional URL to open when user requests help. */
+    const NmbContentSource* expanded_text_source; /**< Optional; replaces expanded_text_utf8 with file content. */
 } NmbSecondaryContentOption;
 
+/**
+ * Read-only table shown under the message, for row data too large to flatten into expanded_text_utf8. The
+ * layout is columnar: columns[c] holds one cell per row as an NmbItemBuffer, so a column of any length is a
+ * single text block plus one offsets array. Cells are borrowed, must be UTF-8, and every column must hold
+ * exactly row_count items.
+ */
+typedef struct NmbTableOption_t
+{
+    uint32_t struct_size;                   /**< Must be set to sizeof(NmbTableOption). */
+    const char* const* column_headers_utf8; /**< column_count header labels. */
+    const NmbItemBuffer* columns;           /**< column_count columns of row_count cells each. */
+    size_t column_count;                    /**< Number of columns; at least one. */
+    size_t row_count;                       /**< Number of rows in every column. */
+} NmbTableOption;
+
+/**
+ * Merges a burst of related messages, such as one error per failed file, into a single dialog. Requests with
+ * the same category_utf8 that arrive within window_milliseconds of the first one are shown together: the first
+ * request's dialog lists every message with its detail, and each caller blocks until that dialog closes and
+ * receives the same button, checkbox and timeout result. Aggregated requests cannot carry input, form fields or a
+ * table of their own. All text is UTF-8 and must stay valid until the call returns.
+ */
+typedef struct NmbAggregationOption_t
+{
+    uint32_t struct_size;         /**< Must be set to sizeof(NmbAggregationOption). */
+    const char* category_utf8;    /**< Required; only requests with an equal category are merged. */
+    uint32_t window_milliseconds; /**< How long the first request of a burst waits for others to join. */
+    const char* detail_utf8;      /**< Optional detail listed next to this request's message. */
+    const char* summary_utf8;     /**< Optional message for a merged dialog; the first request's message if NULL. */
+} NmbAggregationOption;
+
+/** Receives the action clicked on a toast, or NMB_BUTTON_ID_NONE when it expired or made room for newer ones. */
+typedef void(NMB_CALL* NmbToastCallback)(void* user_data, NmbButtonId button);
+
+/**
+ * Shows the request as a small non-modal toast instead of a dialog: nmb_show_message_box returns at once with
+ * NMB_BUTTON_ID_NONE, the toast expires on its own, and its buttons become actions reported to callback. The
+ * title, message and button labels are copied. Toasts cannot carry input, form fields, a table or aggregation.
+ */
+typedef struct NmbToastOption_t
+{
+    uint32_t struct_size;           /**< Must be set to sizeof(NmbToastOption). */
+    uint32_t duration_milliseconds; /**< Time on screen; 0 selects the runtime default. */
+    NmbToastCallback callback;      /**< Optional; called exactly once, on the thread that runs the UI loop. */
+    void* user_data;                /**< Passed to callback. */
+} NmbToastOption;
+
+/** A message pattern parsed once by nmb_message_template_create; see NmbTemplatedMessage. */
+typedef struct NmbMessageTemplate_t NmbMessageTemplate;
+
+/**
+ * Builds the message from a registered template instead of message_utf8, which must then be NULL. The runtime
+ * writes the literal segments and arguments into one exactly sized buffer in a single pass. Requests made with
+ * the same template share its statistics, its suppression and, with coalesce set, one dialog.
+ */
+typedef struct NmbTemplatedMessage_t
+{
+    uint32_t struct_size;                 /**< Must be set to sizeof(NmbTemplatedMessage). */
+    NmbMessageTemplate* message_template; /**< Required; must outlive the request. */
+    const NmbStringView* arguments;       /**< UTF-8 text per placeholder, in order of first appearance. */
+    size_t argument_count;                /**< At least nmb_message_template_argument_count entries. */
+    nmb_bool coalesce; /**< Answer with a dialog of this template that is already open instead of opening another. */
+} NmbTemplatedMessage;
+
+/** Counters of one template, read by nmb_message_template_get_stats. */
+typedef struct NmbMessageTemplateStats_t
+{
+    uint32_t struct_size; /**< Must be set to sizeof(NmbMessageTemplateStats). */
+    uint64_t requests;    /**< Requests made with the template. */
+    uint64_t shown;       /**< Dialogs opened for them. */
+    uint64_t suppressed;  /**< Answered by suppression without a dialog. */
+    uint64_t coalesced;   /**< Answered by a dialog of the template that was already open. */
+} NmbMessageTemplateStats;
+
+/** Caller-owned link to a dialog that lets other threads change it while it is showing; see nmb_update_dialog. */
+typedef struct NmbDialogHandle_t NmbDialogHandle;
+
+typedef enum NmbDialogUpdateFlags_t
+{
+    NMB_DIALOG_UPDATE_MESSAGE = 1u << 0,          /**< Replace the message with message_utf8. */
+    NMB_DIALOG_UPDATE_INFORMATIVE_TEXT = 1u << 1, /**< Replace the informative text with informative_text_utf8. */
+    NMB_DIALOG_UPDATE_BUTTON_ENABLED = 1u << 2    /**< Enable or disable the button button_id. */
+} NmbDialogUpdateFlags;
+
+/** Changes for nmb_update_dialog; only the members selected by flags are read. Text is UTF-8 and copied. */
+typedef struct NmbDialogUpdate_t
+{
+    uint32_t struct_size;              /**< Must be set to sizeof(NmbDialogUpdate). */
+    uint32_t flags;                    /**< NmbDialogUpdateFlags bits. */
+    const char* message_utf8;          /**< New message; required with NMB_DIALOG_UPDATE_MESSAGE. */
+    const char* informative_text_utf8; /**< New informative text; NULL clears it. */
+    NmbButtonId button_id;             /**< Button affected by NMB_DIALOG_UPDATE_BUTTON_ENABLED. */
+    nmb_bool button_enabled;           /**< Whether button_id can be pressed. */
+} NmbDialogUpdate;
+
+/**
+ * Pointer+length variant of every string carried by NmbMessageBoxOptions and the structs it
+ * references. A view with non-NULL data takes precedence over the matching *_utf8 field; a view
+ * with NULL data leaves that field in effect.
+ */
+typedef struct NmbMessageBoxStrings_t
+{
+    uint32_t struct_size;                     /**< Must be set to sizeof(NmbMessageBoxStrings). */
+    NmbStringView title;
+    NmbStringView message;
+    NmbStringView verification_text;
+    NmbStringView locale;
+    const NmbStringView* button_labels;       /**< Optional; button_count entries parallel to buttons. */
+    const NmbStringView* button_descriptions; /**< Optional; button_count entries parallel to buttons. */
+    NmbStringView input_prompt;
+    NmbStringView input_placeholder;
+    NmbStringView input_default_value;
+    const NmbStringView* combo_items;         /**< Replaces combo_items_utf8 when non-NULL. */
+    size_t combo_item_count;                  /**< Number of entries in combo_items. */
+    NmbStringView informative_text;
+    NmbStringView expanded_text;
+    NmbStringView footer_text;
+    NmbStringView help_link;
+} NmbMessageBoxStrings;
+
+/** UTF-16 counterpart of NmbMessageBoxStrings with the same field order and precedence rules. */
+typedef struct NmbMessageBoxStrings16_t
+{
+    uint32_t struct_size;                       /**< Must be set to sizeof(NmbMessageBoxStrings16). */
+    NmbStringView16 title;
+    NmbStringView16 message;
+    NmbStringView16 verification_text;
+    NmbStringView16 locale;
+    const NmbStringView16* button_labels;       /**< Optional; button_count entries parallel to buttons. */
+    const NmbStringView16* button_descriptions; /**< Optional; button_count entries parallel to buttons. */
+    NmbStringView16 input_prompt;
+    NmbStringView16 input_placeholder;
+    NmbStringView16 input_default_value;
+    const NmbStringView16* combo_items;         /**< Replaces combo_items_utf8 when non-NULL. */
+    size_t combo_item_count;                    /**< Number of entries in combo_items. */
+    NmbStringView16 informative_text;
+    NmbStringView16 expanded_text;
+    NmbStringView16 footer_text;
+    NmbStringView16 help_link;
+} NmbMessageBoxStrings16;
+
 typedef struct NmbMessageBoxOptions_t
 {
     uint32_t struct_size;               /**< Must be set to sizeof(NmbMessageBoxOptions). */
@@ -181,6 +448,21 @@ typedef struct NmbMessageBoxOptions_t
     const char* locale_utf8;            /**< Preferred locale (e.g., "en-US"); optional. */
     const NmbAllocator* allocator;      /**< Custom allocator for any runtime allocations; optional. */
     void* user_context;                 /**< User data forwarded to callbacks (future use). */
+    uint32_t flags;                     /**< NmbMessageBoxFlags bits. */
+    const NmbMessageBoxStrings* strings; /**< String views; read when NMB_MESSAGE_BOX_FLAG_STRING_VIEWS is set. */
+    const NmbMessageBoxStrings16* strings_utf16; /**< UTF-16 views; read when NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS is set. */
+    /**
+     * Optional form: form_field_count inputs laid out together and answered in one round trip, replacing input
+     * (which must then be NULL). Fields are UTF-8 only; mode, prompt, placeholder, default value and
+     * combo_items_utf8 are read.
+     */
+    const NmbInputOption* form_fields;
+    size_t form_field_count;            /**< Number of entries in form_fields. */
+    const NmbTableOption* table;        /**< Optional table shown under the message; UTF-8 only. */
+    const NmbAggregationOption* aggregation; /**< Optional; merges this request into a burst of its category. */
+    NmbDialogHandle* dialog_handle;     /**< Optional; applies nmb_update_dialog changes while the dialog shows. */
+    const NmbToastOption* toast;        /**< Optional; shows the request as a non-modal, self-expiring toast. */
+    const NmbTemplatedMessage* templated_message; /**< Optional; builds message_utf8 from a message template. */
 } NmbMessageBoxOptions;
 
 typedef struct NmbMessageBoxResult_t
@@ -191,6 +473,23 @@ typedef struct NmbMessageBoxResult_t
     const char* input_value_utf8;   /**< Allocated string capturing user input (caller must free via allocator). */
     nmb_bool was_timeout;           /**< Indicates timeout path taken. */
     NmbResultCode result_code;      /**< Overall operation status. */
+    /**
+     * form_field_count answers when the dialog was a form. The array and all of its text share one allocation;
+     * release it with a single call to the allocator (NULL when nothing was answered).
+     */
+    const NmbFieldValue* field_values;
+    size_t field_value_count;       /**< Number of entries in field_values. */
+    size_t selection_count;         /**< Items checked in an NMB_INPUT_MULTISELECT prompt. */
+    /**
+     * Monotonic timestamps in microseconds for the stages of the call, on the same clock as every runtime
+     * timeout; only differences between them are meaningful. A stage the backend cannot observe stays 0.
+     */
+    uint64_t received_microseconds;  /**< The call entered the runtime. */
+    uint64_t validated_microseconds; /**< Options were checked and prepared. */
+    uint64_t built_microseconds;     /**< Dialog widgets were created. */
+    uint64_t mapped_microseconds;    /**< Dialog first appeared on screen. */
+    uint64_t responded_microseconds; /**< The answer was known. */
+    NmbBackend backend;              /**< Implementation that answered the request. */
 } NmbMessageBoxResult;
 
 typedef struct NmbInitializeOptions_t
@@ -215,6 +514,63 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
  */
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result);
 
+/** Receives the finished result of nmb_show_message_box_async; result is the out_result passed to that call. */
+typedef void(NMB_CALL* NmbMessageBoxCallback)(void* user_data, NmbMessageBoxResult* result);
+
+/**
+ * Shows a dialog without waiting for it: the call returns once the dialog is on screen, and callback runs
+ * exactly once, on the UI thread, after out_result has been filled in (result_code carries any failure).
+ * Any number of such dialogs can be open at once and each completes on its own. options, everything it
+ * points to, and out_result must stay valid until callback runs. Call it from the thread that runs the UI
+ * main loop. Backends without non-modal dialogs show the dialog modally and run callback before returning.
+ * An error returned by this call means callback will not run; later failures arrive in result_code.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data);
+
+/**
+ * Like nmb_show_message_box_async, but callback is dispatched from main_context, a caller-owned GMainContext
+ * (NULL = the default context), so completion joins the caller's own GMainLoop. It may be called from any
+ * thread: GTK builds the dialog on its own thread without a nested loop, and failures after the call returned
+ * arrive through callback. Aggregated and templated requests, which may wait for other requests, wait on a
+ * runtime helper thread instead, as does the zenity fallback. On other backends main_context is ignored and
+ * the call behaves like nmb_show_message_box_async. include/native_message_box_glib.h wraps it in a GTask.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void* main_context,
+                                                               NmbMessageBoxCallback callback, void* user_data);
+
+/** An asynchronous request started by nmb_submit_message_box; see nmb_poll_result. */
+typedef struct NmbRequest_t NmbRequest;
+
+/**
+ * Starts a dialog for hosts that drive the runtime from their own epoll or frame loop instead of a UI thread.
+ * Like nmb_show_message_box_async, but completion is observed through nmb_poll_result and the event fd. Call
+ * it, nmb_pump and nmb_poll_result from the same thread.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request);
+
+/**
+ * A file descriptor that becomes readable when a request completes or the runtime needs nmb_pump: an epoll
+ * set over the runtime's eventfd and the UI toolkit's own fds and timers on GTK, a plain eventfd or pipe on
+ * other POSIX systems, -1 on Windows. Add it to your poll set and never read from it; nmb_pump drains it.
+ */
+NMB_API int NMB_CALL nmb_get_event_fd(void);
+
+/**
+ * Dispatches pending UI work for at most max_time_milliseconds without blocking, then re-arms the event fd.
+ * Work left over when the time runs out keeps the fd readable.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t max_time_milliseconds);
+
+/**
+ * Reports whether request has finished. While it runs, returns NMB_OK with *out_done false. Once finished,
+ * sets *out_done, returns the request's result_code (out_result is filled in) and releases request.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_poll_result(NmbRequest* request, nmb_bool* out_done);
+
 /**
  * Releases any resources held by the runtime.
  */
@@ -230,6 +586,104 @@ NMB_API uint32_t NMB_CALL nmb_get_abi_version(void);
  */
 NMB_API void NMB_CALL nmb_set_log_callback(void (*log_callback)(void*, const char*), void* user_data);
 
+/**
+ * Builds a prefix index over candidates (paths, host names, ticket ids, ...) for NmbInputOption.completion_index.
+ * The text is copied, so candidates may be released afterwards. Building sorts the corpus once; keep the index
+ * for the life of the process and share it between dialogs. The index is immutable and safe to read from any
+ * thread, but must outlive every nmb_show_message_box call that references it.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_completion_index_create(const NmbItemBuffer* candidates,
+                                                           NmbCompletionIndex** out_index);
+
+/**
+ * Writes up to max_results candidate positions whose text starts with prefix_utf8 (ASCII case-insensitive)
+ * to out_items, in sorted order, and returns how many were written. Exact duplicates are reported once.
+ */
+NMB_API size_t NMB_CALL nmb_completion_index_query(const NmbCompletionIndex* index, const char* prefix_utf8,
+                                                   uint32_t* out_items, size_t max_results);
+
+/**
+ * Releases an index created by nmb_completion_index_create.
+ */
+NMB_API void NMB_CALL nmb_completion_index_destroy(NmbCompletionIndex* index);
+
+/**
+ * Creates a handle for NmbMessageBoxOptions.dialog_handle. One handle serves one showing dialog at a time and
+ * may be reused for later dialogs; changes made while no dialog is showing are applied when the next one opens.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_dialog_handle_create(NmbDialogHandle** out_handle);
+
+/**
+ * Changes the message, informative text or button sensitivity of the dialog attached to handle, from any
+ * thread. Changes are merged with any not yet applied, so a burst of updates (a countdown, a growing count)
+ * costs the UI thread one pass over the existing widgets; the dialog is never rebuilt. Backends without live
+ * updates accept and keep the changes but do not show them.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_update_dialog(NmbDialogHandle* handle, const NmbDialogUpdate* fields);
+
+/** Releases handle. No dialog may be showing with it and no nmb_update_dialog call may be running. */
+NMB_API void NMB_CALL nmb_dialog_handle_destroy(NmbDialogHandle* handle);
+
+/**
+ * Parses pattern_utf8 once into literal and placeholder segments. "{name}" is a placeholder; "{{" and "}}" stand
+ * for literal braces. Placeholders are numbered in order of first appearance, and a repeated name reuses its
+ * number. The template is thread-safe and must outlive every request that references it.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_message_template_create(const char* pattern_utf8,
+                                                           NmbMessageTemplate** out_template);
+
+/**
+ * Stable id of the template: a 64-bit FNV-1a hash of its pattern, equal across processes and runs, for
+ * statistics, logs and suppression lists kept by the application.
+ */
+NMB_API uint64_t NMB_CALL nmb_message_template_id(const NmbMessageTemplate* message_template);
+
+/** Number of distinct placeholders, i.e. the arguments a request must supply. */
+NMB_API size_t NMB_CALL nmb_message_template_argument_count(const NmbMessageTemplate* message_template);
+
+/** Argument position of the placeholder called name_utf8, or SIZE_MAX when the pattern has none. */
+NMB_API size_t NMB_CALL nmb_message_template_argument_index(const NmbMessageTemplate* message_template,
+                                                            const char* name_utf8);
+
+/**
+ * Answers later requests of the template with button, without showing a dialog; NMB_BUTTON_ID_NONE shows them
+ * again. A request that shows the verification checkbox and is answered with it checked suppresses its template
+ * with the chosen button.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_message_template_suppress(NmbMessageTemplate* message_template,
+                                                             NmbButtonId button);
+
+/** Copies the template's counters into out_stats, as far as out_stats->struct_size allows. */
+NMB_API NmbResultCode NMB_CALL nmb_message_template_get_stats(const NmbMessageTemplate* message_template,
+                                                              NmbMessageTemplateStats* out_stats);
+
+/** Releases a template created by nmb_message_template_create. No request may be using it. */
+NMB_API void NMB_CALL nmb_message_template_destroy(NmbMessageTemplate* message_template);
+
+/** Opaque handle of a progress dialog opened by nmb_progress_begin. */
+typedef struct NmbProgressHandle_t NmbProgressHandle;
+
+/**
+ * Opens a non-blocking progress dialog and returns at once. title_utf8, message_utf8, icon, severity and
+ * parent_window are read; the label of the first is_cancel button, if any, names the Cancel button. Call from
+ * the thread that runs the UI main loop, which must keep running for the dialog to draw.
+ */
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options,
+                                                  NmbProgressHandle** out_handle);
+
+/**
+ * Reports progress from any thread at any rate. fraction is clamped to [0, 1]; a negative value shows activity
+ * without a known amount. text_utf8 replaces the status line and is copied; NULL keeps the current one. Updates
+ * are coalesced without locks and the latest one reaches the screen at most once per frame.
+ */
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle* handle, double fraction, const char* text_utf8);
+
+/** NMB_TRUE once the user pressed Cancel or closed the dialog; a single atomic load, cheap to poll. */
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle* handle);
+
+/** Closes the dialog and releases handle. Every nmb_progress_update call must have returned. */
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle* handle);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
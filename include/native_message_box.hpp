@@ -0,0 +1,494 @@
+#ifndef NATIVE_MESSAGE_BOX_HPP
+#define NATIVE_MESSAGE_BOX_HPP
+
+/*
+ * C++20 wrappers over the C ABI. Header-only: the runtime is still consumed through native_message_box.h, and
+ * nothing here allocates. A dialog is awaited with co_await nmb::show(options); the coroutine resumes from the
+ * completion callback instead of parking a thread on the dialog, and the nmb::Result it receives owns the
+ * answer's buffers and returns them to the allocator they came from. Dialogs known at build time can be
+ * declared as constexpr templates (nmb::dialog, nmb::button_set) whose mistakes fail to compile.
+ */
+
+#if !defined(__cplusplus) || (__cplusplus < 202002L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+#error "native_message_box.hpp requires C++20"
+#endif
+
+#include "native_message_box.h"
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace nmb
+{
+
+/* Used by Options unless another allocator is set, so results always have an owner to return their buffers to. */
+inline const NmbAllocator* default_allocator() noexcept
+{
+    static const NmbAllocator allocator = {
+        [](void*, size_t size, size_t) -> void* { return std::malloc(size); },
+        [](void*, void* ptr) { std::free(ptr); },
+        nullptr,
+    };
+    return &allocator;
+}
+
+/*
+ * Compile-time checks. Each rule a constant dialog breaks calls one of these non-constexpr functions from a
+ * consteval context, so the build fails with the rule's name in the diagnostic.
+ */
+namespace rule
+{
+inline void button_set_is_empty() {}
+inline void button_label_is_null() {}
+inline void button_id_is_none() {}
+inline void button_id_is_duplicated() {}
+inline void more_than_one_default_button() {}
+inline void more_than_one_cancel_button() {}
+inline void message_is_null() {}
+inline void timeout_button_is_not_in_the_set() {}
+inline void combo_items_need_combo_or_multiselect_input() {}
+inline void combo_items_are_not_null_terminated() {}
+} // namespace rule
+
+constexpr NmbButtonOption button(NmbButtonId id, const char* label,
+                                 NmbButtonKind kind = NMB_BUTTON_KIND_DEFAULT) noexcept
+{
+    return NmbButtonOption{ sizeof(NmbButtonOption), id, label, nullptr, kind, NMB_FALSE, NMB_FALSE };
+}
+
+/* The button activated by Enter. */
+constexpr NmbButtonOption default_button(NmbButtonId id, const char* label,
+                                         NmbButtonKind kind = NMB_BUTTON_KIND_PRIMARY) noexcept
+{
+    NmbButtonOption option = button(id, label, kind);
+    option.is_default = NMB_TRUE;
+    return option;
+}
+
+/* The button reported when the dialog is dismissed with Escape or closed. */
+constexpr NmbButtonOption cancel_button(NmbButtonId id, const char* label) noexcept
+{
+    NmbButtonOption option = button(id, label);
+    option.is_cancel = NMB_TRUE;
+    return option;
+}
+
+/* N validated buttons, laid out as the NmbButtonOption array the C ABI reads. */
+template <size_t N>
+struct ButtonSet
+{
+    std::array<NmbButtonOption, N> options;
+
+    constexpr bool contains(NmbButtonId id) const noexcept
+    {
+        for (const NmbButtonOption& option : options)
+        {
+            if (option.id == id)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr const NmbButtonOption* data() const noexcept { return options.data(); }
+    constexpr size_t size() const noexcept { return N; }
+};
+
+/* Rejects at compile time an empty set, unlabelled buttons, repeated ids, and two defaults or cancels. */
+template <size_t N>
+consteval ButtonSet<N> button_set(const NmbButtonOption (&buttons)[N])
+{
+    if (N == 0)
+    {
+        rule::button_set_is_empty();
+    }
+
+    ButtonSet<N> set{};
+    size_t defaults = 0;
+    size_t cancels = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        const NmbButtonOption& option = buttons[i];
+        if (!option.label_utf8)
+        {
+            rule::button_label_is_null();
+        }
+        if (option.id == NMB_BUTTON_ID_NONE)
+        {
+            rule::button_id_is_none();
+        }
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (buttons[j].id == option.id)
+            {
+                rule::button_id_is_duplicated();
+            }
+        }
+        defaults += option.is_default ? 1 : 0;
+        cancels += option.is_cancel ? 1 : 0;
+        set.options[i] = option;
+    }
+
+    if (defaults > 1)
+    {
+        rule::more_than_one_default_button();
+    }
+    if (cancels > 1)
+    {
+        rule::more_than_one_cancel_button();
+    }
+    return set;
+}
+
+inline constexpr ButtonSet<1> kOk = button_set({ default_button(NMB_BUTTON_ID_OK, "OK") });
+
+inline constexpr ButtonSet<2> kOkCancel =
+    button_set({ default_button(NMB_BUTTON_ID_OK, "OK"), cancel_button(NMB_BUTTON_ID_CANCEL, "Cancel") });
+
+inline constexpr ButtonSet<2> kYesNo =
+    button_set({ default_button(NMB_BUTTON_ID_YES, "Yes"), cancel_button(NMB_BUTTON_ID_NO, "No") });
+
+inline constexpr ButtonSet<3> kAbortRetryIgnore = button_set({ cancel_button(NMB_BUTTON_ID_ABORT, "Abort"),
+                                                               default_button(NMB_BUTTON_ID_RETRY, "Retry"),
+                                                               button(NMB_BUTTON_ID_IGNORE, "Ignore") });
+
+/*
+ * A dialog fixed at build time. Every step is consteval and checks the rules it touches, so a constexpr
+ * template is validated and laid out by the compiler; nmb::Options(template) only copies pointers into it.
+ * Keep templates in static storage: Options points at their buttons and input.
+ */
+template <size_t N>
+class DialogTemplate
+{
+public:
+    consteval DialogTemplate(const char* message, const ButtonSet<N>& buttons) : buttons_(buttons)
+    {
+        if (!message)
+        {
+            rule::message_is_null();
+        }
+        message_ = message;
+        input_.struct_size = sizeof(input_);
+    }
+
+    consteval DialogTemplate title(const char* text) const
+    {
+        DialogTemplate copy = *this;
+        copy.title_ = text;
+        return copy;
+    }
+
+    consteval DialogTemplate icon(NmbIcon icon) const
+    {
+        DialogTemplate copy = *this;
+        copy.icon_ = icon;
+        return copy;
+    }
+
+    consteval DialogTemplate severity(NmbSeverity severity) const
+    {
+        DialogTemplate copy = *this;
+        copy.severity_ = severity;
+        return copy;
+    }
+
+    consteval DialogTemplate timeout(uint32_t milliseconds, NmbButtonId button) const
+    {
+        if (!buttons_.contains(button))
+        {
+            rule::timeout_button_is_not_in_the_set();
+        }
+        DialogTemplate copy = *this;
+        copy.timeoutMilliseconds_ = milliseconds;
+        copy.timeoutButton_ = button;
+        return copy;
+    }
+
+    consteval DialogTemplate input(NmbInputMode mode, const char* prompt = nullptr) const
+    {
+        if (input_.combo_items_utf8 && mode != NMB_INPUT_COMBO && mode != NMB_INPUT_MULTISELECT)
+        {
+            rule::combo_items_need_combo_or_multiselect_input();
+        }
+        DialogTemplate copy = *this;
+        copy.input_.mode = mode;
+        copy.input_.prompt_utf8 = prompt;
+        copy.hasInput_ = true;
+        return copy;
+    }
+
+    /* items must end with nullptr, as NmbInputOption.combo_items_utf8 requires; call input() first. */
+    template <size_t M>
+    consteval DialogTemplate combo_items(const char* const (&items)[M]) const
+    {
+        if (input_.mode != NMB_INPUT_COMBO && input_.mode != NMB_INPUT_MULTISELECT)
+        {
+            rule::combo_items_need_combo_or_multiselect_input();
+        }
+        if (items[M - 1] != nullptr)
+        {
+            rule::combo_items_are_not_null_terminated();
+        }
+        DialogTemplate copy = *this;
+        copy.input_.combo_items_utf8 = items;
+        return copy;
+    }
+
+    /* Fills the template's fields into options; everything else is left as it was. */
+    constexpr void apply(NmbMessageBoxOptions& options) const noexcept
+    {
+        options.title_utf8 = title_;
+        options.message_utf8 = message_;
+        options.buttons = buttons_.data();
+        options.button_count = N;
+        options.icon = icon_;
+        options.severity = severity_;
+        options.input = hasInput_ ? &input_ : nullptr;
+        options.timeout_milliseconds = timeoutMilliseconds_;
+        options.timeout_button_id = timeoutButton_;
+    }
+
+private:
+    const char* title_ = nullptr;
+    const char* message_ = nullptr;
+    ButtonSet<N> buttons_;
+    NmbIcon icon_ = NmbIcon{};
+    NmbSeverity severity_ = NmbSeverity{};
+    NmbInputOption input_{};
+    bool hasInput_ = false;
+    uint32_t timeoutMilliseconds_ = 0;
+    NmbButtonId timeoutButton_ = NMB_BUTTON_ID_NONE;
+};
+
+template <size_t N>
+consteval DialogTemplate<N> dialog(const char* message, const ButtonSet<N>& buttons)
+{
+    return DialogTemplate<N>(message, buttons);
+}
+
+/*
+ * NmbMessageBoxOptions with struct_size, abi_version and an allocator filled in. Setters return *this so a
+ * request reads as one expression; raw() reaches every other field. Strings and arrays are borrowed and must
+ * outlive the request.
+ */
+class Options
+{
+public:
+    Options() noexcept
+    {
+        raw_.struct_size = sizeof(raw_);
+        raw_.abi_version = NMB_ABI_VERSION;
+        raw_.allocator = default_allocator();
+        raw_.timeout_button_id = NMB_BUTTON_ID_NONE;
+    }
+
+    /* Starts from a constant template; the setters below still apply on top of it. */
+    template <size_t N>
+    explicit Options(const DialogTemplate<N>& dialog) noexcept : Options()
+    {
+        dialog.apply(raw_);
+    }
+    template <size_t N>
+    explicit Options(const DialogTemplate<N>&&) = delete;
+
+    Options& title(const char* text) noexcept { raw_.title_utf8 = text; return *this; }
+    Options& message(const char* text) noexcept { raw_.message_utf8 = text; return *this; }
+    Options& buttons(std::span<const NmbButtonOption> buttons) noexcept
+    {
+        raw_.buttons = buttons.data();
+        raw_.button_count = buttons.size();
+        return *this;
+    }
+    template <size_t N>
+    Options& buttons(const ButtonSet<N>& buttons) noexcept
+    {
+        raw_.buttons = buttons.data();
+        raw_.button_count = N;
+        return *this;
+    }
+    Options& icon(NmbIcon icon) noexcept { raw_.icon = icon; return *this; }
+    Options& severity(NmbSeverity severity) noexcept { raw_.severity = severity; return *this; }
+    Options& input(const NmbInputOption* input) noexcept { raw_.input = input; return *this; }
+    Options& timeout(uint32_t milliseconds, NmbButtonId button) noexcept
+    {
+        raw_.timeout_milliseconds = milliseconds;
+        raw_.timeout_button_id = button;
+        return *this;
+    }
+    /* A null allocator restores default_allocator(). */
+    Options& allocator(const NmbAllocator* allocator) noexcept
+    {
+        raw_.allocator = allocator ? allocator : default_allocator();
+        return *this;
+    }
+    Options& user_context(void* context) noexcept { raw_.user_context = context; return *this; }
+    Options& flags(uint32_t flags) noexcept { raw_.flags = flags; return *this; }
+
+    NmbMessageBoxOptions& raw() noexcept { return raw_; }
+    const NmbMessageBoxOptions& raw() const noexcept { return raw_; }
+
+private:
+    NmbMessageBoxOptions raw_{};
+};
+
+/*
+ * The answer to one request. Owns input_value_utf8 and field_values and releases each with one call to the
+ * allocator the request was made with; moves transfer that ownership.
+ */
+class Result
+{
+public:
+    Result() noexcept { raw_.struct_size = sizeof(raw_); }
+
+    /* Adopts the buffers of raw, which the runtime filled in for a request that used allocator. */
+    Result(const NmbMessageBoxResult& raw, const NmbAllocator* allocator) noexcept : raw_(raw)
+    {
+        if (allocator)
+        {
+            allocator_ = *allocator;
+        }
+    }
+
+    Result(Result&& other) noexcept : raw_(other.raw_), allocator_(other.allocator_) { other.forget(); }
+
+    Result& operator=(Result&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            raw_ = other.raw_;
+            allocator_ = other.allocator_;
+            other.forget();
+        }
+        return *this;
+    }
+
+    Result(const Result&) = delete;
+    Result& operator=(const Result&) = delete;
+
+    ~Result() { reset(); }
+
+    NmbResultCode code() const noexcept { return raw_.result_code; }
+    bool ok() const noexcept { return raw_.result_code == NMB_OK; }
+    NmbButtonId button() const noexcept { return raw_.button; }
+    bool checkbox_checked() const noexcept { return raw_.checkbox_checked != NMB_FALSE; }
+    bool was_timeout() const noexcept { return raw_.was_timeout != NMB_FALSE; }
+    size_t selection_count() const noexcept { return raw_.selection_count; }
+    NmbBackend backend() const noexcept { return raw_.backend; }
+
+    /* Empty when the dialog had no input or the text went to a chunk callback. */
+    std::string_view input_value() const noexcept
+    {
+        return raw_.input_value_utf8 ? std::string_view(raw_.input_value_utf8) : std::string_view();
+    }
+
+    std::span<const NmbFieldValue> field_values() const noexcept
+    {
+        return { raw_.field_values, raw_.field_values ? raw_.field_value_count : 0 };
+    }
+
+    const NmbMessageBoxResult& raw() const noexcept { return raw_; }
+
+    /* Returns the buffers to the allocator now; the answer's scalar fields stay readable. */
+    void reset() noexcept
+    {
+        release(raw_.input_value_utf8);
+        release(raw_.field_values);
+        forget();
+    }
+
+private:
+    void release(const void* ptr) noexcept
+    {
+        if (ptr && allocator_.deallocate)
+        {
+            allocator_.deallocate(allocator_.user_data, const_cast<void*>(ptr));
+        }
+    }
+
+    void forget() noexcept
+    {
+        raw_.input_value_utf8 = nullptr;
+        raw_.field_values = nullptr;
+        raw_.field_value_count = 0;
+    }
+
+    NmbMessageBoxResult raw_{};
+    NmbAllocator allocator_{};
+};
+
+/*
+ * Awaiter returned by nmb::show. It lives in the awaiting coroutine's frame and hands its own address to the C
+ * API as user_data, so waiting needs no allocation. Backends that complete before nmb_show_message_box_async
+ * returns race the call itself; whichever of the two finishes second resumes the coroutine.
+ */
+class ShowAwaiter
+{
+public:
+    ShowAwaiter(const Options& options, void* main_context, bool use_context) noexcept
+        : options_(&options.raw()), mainContext_(main_context), useContext_(use_context)
+    {
+    }
+
+    ShowAwaiter(const ShowAwaiter&) = delete;
+    ShowAwaiter& operator=(const ShowAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        awaiting_ = awaiting;
+        raw_.struct_size = sizeof(raw_);
+        const NmbResultCode rc = useContext_
+            ? nmb_show_message_box_in_context(options_, &raw_, mainContext_, &ShowAwaiter::Complete, this)
+            : nmb_show_message_box_async(options_, &raw_, &ShowAwaiter::Complete, this);
+        if (rc != NMB_OK)
+        {
+            raw_.result_code = rc;
+            return false;
+        }
+        return !finished_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    Result await_resume() noexcept { return Result(raw_, options_->allocator); }
+
+private:
+    static void NMB_CALL Complete(void* user_data, NmbMessageBoxResult*)
+    {
+        ShowAwaiter* self = static_cast<ShowAwaiter*>(user_data);
+        if (self->finished_.exchange(true, std::memory_order_acq_rel))
+        {
+            self->awaiting_.resume();
+        }
+    }
+
+    const NmbMessageBoxOptions* options_;
+    void* mainContext_;
+    bool useContext_;
+    std::coroutine_handle<> awaiting_;
+    std::atomic<bool> finished_{ false };
+    NmbMessageBoxResult raw_{};
+};
+
+/*
+ * co_await nmb::show(options) shows the dialog through nmb_show_message_box_async and resumes the coroutine
+ * on the UI thread once it was answered. options must outlive the co_await, which a temporary does.
+ */
+inline ShowAwaiter show(const Options& options) noexcept { return ShowAwaiter(options, nullptr, false); }
+
+/* Same, but resumes from main_context (a GMainContext*, NULL = default) via nmb_show_message_box_in_context. */
+inline ShowAwaiter show(const Options& options, void* main_context) noexcept
+{
+    return ShowAwaiter(options, main_context, true);
+}
+
+} // namespace nmb
+
+#endif /* NATIVE_MESSAGE_BOX_HPP */
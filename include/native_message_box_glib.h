@@ -0,0 +1,63 @@
+#ifndef NATIVE_MESSAGE_BOX_GLIB_H
+#define NATIVE_MESSAGE_BOX_GLIB_H
+
+/*
+ * GIO integration for applications that run their own GMainLoop. Header-only, for code that already links
+ * GIO; the runtime itself does not depend on it.
+ */
+
+#include <gio/gio.h>
+
+#include "native_message_box.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NMB_GLIB_ERROR (g_quark_from_static_string("nmb-error-quark"))
+
+static inline void NMB_CALL nmb_glib_return_result(void* user_data, NmbMessageBoxResult* result)
+{
+    GTask* task = (GTask*)user_data;
+    if (result->result_code != NMB_OK)
+    {
+        g_task_return_new_error(task, NMB_GLIB_ERROR, (gint)result->result_code, "Message box failed (%u)",
+                                (unsigned)result->result_code);
+    }
+    else
+    {
+        g_task_return_pointer(task, result, NULL);
+    }
+    g_object_unref(task);
+}
+
+/*
+ * Shows the dialog without blocking and completes a GTask on the thread-default main context of the caller.
+ * callback runs from that context once the dialog was answered; call nmb_show_message_box_finish there.
+ * options, everything it points to, and out_result must stay valid until then.
+ */
+static inline void nmb_show_message_box_task(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                             GAsyncReadyCallback callback, gpointer user_data)
+{
+    GTask* task = g_task_new(NULL, NULL, callback, user_data);
+    g_task_set_source_tag(task, (gpointer)nmb_show_message_box_task);
+    NmbResultCode rc = nmb_show_message_box_in_context(options, out_result, g_task_get_context(task),
+                                                       nmb_glib_return_result, task);
+    if (rc != NMB_OK)
+    {
+        g_task_return_new_error(task, NMB_GLIB_ERROR, (gint)rc, "Message box was not shown (%u)", (unsigned)rc);
+        g_object_unref(task);
+    }
+}
+
+/* The out_result passed to nmb_show_message_box_task, or NULL with error set when the request failed. */
+static inline NmbMessageBoxResult* nmb_show_message_box_finish(GAsyncResult* result, GError** error)
+{
+    return (NmbMessageBoxResult*)g_task_propagate_pointer(G_TASK(result), error);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NATIVE_MESSAGE_BOX_GLIB_H */
@@ -14,6 +14,28 @@ typedef struct NmbTestHarness_t
     nmb_bool simulate_timeout;
     NmbResultCode result_code;
     const char* input_value_utf8;
+    const NmbFieldValue* field_values; /* scripted form answers; missing entries answer empty */
+    size_t field_value_count;
+    const uint8_t* selection_bits; /* scripted multiselect answer; covers every item */
+    /* the scripted answer arrives this long after the dialog opens; a shorter timeout answers first */
+    uint32_t answer_after_milliseconds;
 } NmbTestHarness;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Moves the runtime clock forward. The first call swaps the system clock for a virtual one that stands still
+ * between calls, so timeouts, countdowns and scripted answer delays play out without real waiting.
+ */
+NMB_API void NMB_CALL nmb_test_advance_clock(uint64_t milliseconds);
+
+/* Returns the runtime to the system clock. */
+NMB_API void NMB_CALL nmb_test_use_system_clock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* NATIVE_MESSAGE_BOX_TEST_H */
@@ -21,6 +21,102 @@ public class InteropTests
         Assert.NotEqual((nuint)0, native.ButtonCount);
     }
 
+    [Fact]
+    public void CreateNativeOptionsPassesStringsAsUtf16Views()
+    {
+        var options = new MessageBoxOptions("Disk full", title: "Backup");
+        using var scope = new NativeMemoryScope();
+        var native = NativeMessageBoxMarshaller.CreateNativeOptions(options, scope);
+
+        Assert.True(native.Flags.HasFlag(NmbMessageBoxFlags.Utf16Strings));
+        Assert.NotEqual(IntPtr.Zero, native.StringsUtf16);
+        Assert.Equal(IntPtr.Zero, native.MessageUtf8);
+
+        var strings = Marshal.PtrToStructure<NmbMessageBoxStrings16>(native.StringsUtf16);
+        Assert.Equal((uint)Unsafe.SizeOf<NmbMessageBoxStrings16>(), strings.StructSize);
+        Assert.Equal("Disk full", Marshal.PtrToStringUni(strings.Message.Data, (int)strings.Message.Length));
+        Assert.Equal("Backup", Marshal.PtrToStringUni(strings.Title.Data, (int)strings.Title.Length));
+    }
+
+    [Fact]
+    public void CreateNativeOptionsPacksComboItemsIntoOneBuffer()
+    {
+        var options = new MessageBoxOptions(
+            "Pick a region",
+            inputOptions: new MessageBoxInputOptions(MessageBoxInputMode.Combo, comboItems: new[] { "eu-west", "", "ap-süd" }));
+        using var scope = new NativeMemoryScope();
+        var native = NativeMessageBoxMarshaller.CreateNativeOptions(options, scope);
+
+        var input = Marshal.PtrToStructure<NmbInputOption>(native.Input);
+        var strings = Marshal.PtrToStructure<NmbMessageBoxStrings16>(native.StringsUtf16);
+        Assert.Equal(IntPtr.Zero, strings.ComboItems);
+        Assert.NotEqual(IntPtr.Zero, input.ComboItemBuffer);
+
+        var buffer = Marshal.PtrToStructure<NmbItemBuffer>(input.ComboItemBuffer);
+        Assert.Equal((nuint)3, buffer.ItemCount);
+        var offsets = new int[4];
+        Marshal.Copy(buffer.Offsets, offsets, 0, offsets.Length);
+        Assert.Equal(new[] { 0, 7, 7, 14 }, offsets);
+        Assert.Equal("ap-süd", Marshal.PtrToStringUTF8(buffer.Data + offsets[2], offsets[3] - offsets[2]));
+    }
+
+    [Fact]
+    public void MultiSelectRoundTripsThroughTheSelectionBitset()
+    {
+        var services = new string[20];
+        for (var i = 0; i < services.Length; i++)
+        {
+            services[i] = $"service-{i}";
+        }
+
+        var options = new MessageBoxOptions(
+            "Restart services",
+            inputOptions: new MessageBoxInputOptions(MessageBoxInputMode.MultiSelect, comboItems: services, selectedItems: new[] { 1, 9 }));
+        using var scope = new NativeMemoryScope();
+        var native = NativeMessageBoxMarshaller.CreateNativeOptions(options, scope);
+
+        var input = Marshal.PtrToStructure<NmbInputOption>(native.Input);
+        Assert.Equal(NmbInputMode.MultiSelect, input.Mode);
+        Assert.Equal((nuint)3, input.SelectionBitsSize);
+        Assert.Equal(0x02, Marshal.ReadByte(input.SelectionBits, 0));
+        Assert.Equal(0x02, Marshal.ReadByte(input.SelectionBits, 1));
+
+        // Stand in for the runtime writing the confirmed selection back.
+        Marshal.WriteByte(input.SelectionBits, 0, 0x01);
+        Marshal.WriteByte(input.SelectionBits, 1, 0x00);
+        Marshal.WriteByte(input.SelectionBits, 2, 0x08);
+        var result = NativeMessageBoxMarshaller.CreateNativeResult();
+        result.SelectionCount = 2;
+        var managed = NativeMessageBoxMarshaller.ToManagedResult(ref result, options, native.Input);
+        Assert.Equal(new[] { 0, 19 }, managed.SelectedItems);
+    }
+
+    [Fact]
+    public void CreateNativeOptionsPassesFormFieldsAsUtf8()
+    {
+        var options = new MessageBoxOptions(
+            "Request access",
+            formFields: new[]
+            {
+                new MessageBoxInputOptions(MessageBoxInputMode.Text, prompt: "User"),
+                new MessageBoxInputOptions(MessageBoxInputMode.Combo, prompt: "Reason", comboItems: new[] { "Audit", "On-call" }),
+                new MessageBoxInputOptions(MessageBoxInputMode.Checkbox, prompt: "Notify team")
+            });
+        using var scope = new NativeMemoryScope();
+        var native = NativeMessageBoxMarshaller.CreateNativeOptions(options, scope);
+
+        Assert.Equal(IntPtr.Zero, native.Input);
+        Assert.Equal((nuint)3, native.FormFieldCount);
+        var size = Unsafe.SizeOf<NmbInputOption>();
+        var combo = Marshal.PtrToStructure<NmbInputOption>(native.FormFields + size);
+        Assert.Equal(NmbInputMode.Combo, combo.Mode);
+        Assert.Equal("Reason", Marshal.PtrToStringUTF8(combo.PromptUtf8));
+        Assert.Equal("On-call", Marshal.PtrToStringUTF8(Marshal.ReadIntPtr(combo.ComboItemsUtf8, IntPtr.Size)));
+        Assert.Equal(IntPtr.Zero, Marshal.ReadIntPtr(combo.ComboItemsUtf8, 2 * IntPtr.Size));
+        var checkbox = Marshal.PtrToStructure<NmbInputOption>(native.FormFields + 2 * size);
+        Assert.Equal(NmbInputMode.Checkbox, checkbox.Mode);
+    }
+
     [Theory]
     [InlineData((uint)NmbResultCode.Ok, MessageBoxOutcome.Success)]
     [InlineData((uint)NmbResultCode.Cancelled, MessageBoxOutcome.Cancelled)]
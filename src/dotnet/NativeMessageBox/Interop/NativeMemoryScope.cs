@@ -2,12 +2,14 @@ using System;
 using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
+using System.Text;
 
 namespace NativeMessageBox.Interop;
 
 internal sealed class NativeMemoryScope : IDisposable
 {
     private readonly List<IntPtr> _allocations = new();
+    private readonly List<GCHandle> _pins = new();
 
     public IntPtr AllocUtf8(string? value)
     {
@@ -21,6 +23,27 @@ internal sealed class NativeMemoryScope : IDisposable
         return ptr;
     }
 
+    /// <summary>
+    /// Pins each string in place and describes it with a UTF-16 pointer+length view, so no text is
+    /// copied or transcoded on the managed side. Null or empty strings produce an empty view.
+    /// </summary>
+    public void PinUtf16Views(ReadOnlySpan<string?> values, Span<NmbStringView16> views)
+    {
+        views.Clear();
+        for (var i = 0; i < values.Length; i++)
+        {
+            var value = values[i];
+            if (string.IsNullOrEmpty(value))
+            {
+                continue;
+            }
+
+            var handle = GCHandle.Alloc(value, GCHandleType.Pinned);
+            _pins.Add(handle);
+            views[i] = new NmbStringView16(handle.AddrOfPinnedObject(), (nuint)value.Length);
+        }
+    }
+
     public IntPtr AllocStructArray<T>(ReadOnlySpan<T> data) where T : unmanaged
     {
         if (data.IsEmpty)
@@ -57,6 +80,43 @@ internal sealed class NativeMemoryScope : IDisposable
         return ptr;
     }
 
+    /// <summary>
+    /// Encodes the items back to back into one UTF-8 block with an offsets table and returns a pointer to
+    /// the <see cref="NmbItemBuffer"/> describing them, so a long list costs three allocations in total.
+    /// </summary>
+    public IntPtr AllocItemBuffer(IReadOnlyList<string> items)
+    {
+        var offsets = new uint[items.Count + 1];
+        var total = 0;
+        for (var i = 0; i < items.Count; i++)
+        {
+            offsets[i] = (uint)total;
+            total = checked(total + Encoding.UTF8.GetByteCount(items[i] ?? string.Empty));
+        }
+
+        offsets[items.Count] = (uint)total;
+
+        var data = Marshal.AllocCoTaskMem(Math.Max(total, 1));
+        _allocations.Add(data);
+        unsafe
+        {
+            var bytes = new Span<byte>((void*)data, total);
+            for (var i = 0; i < items.Count; i++)
+            {
+                Encoding.UTF8.GetBytes(items[i] ?? string.Empty, bytes.Slice((int)offsets[i]));
+            }
+        }
+
+        var buffer = new NmbItemBuffer
+        {
+            StructSize = (uint)Unsafe.SizeOf<NmbItemBuffer>(),
+            Data = data,
+            Offsets = AllocStructArray<uint>(offsets),
+            ItemCount = (nuint)items.Count
+        };
+        return AllocStructArray<NmbItemBuffer>(stackalloc NmbItemBuffer[] { buffer });
+    }
+
     public void Dispose()
     {
         foreach (var ptr in _allocations)
@@ -65,6 +125,13 @@ internal sealed class NativeMemoryScope : IDisposable
         }
 
         _allocations.Clear();
+
+        foreach (var handle in _pins)
+        {
+            handle.Free();
+        }
+
+        _pins.Clear();
     }
 }
 
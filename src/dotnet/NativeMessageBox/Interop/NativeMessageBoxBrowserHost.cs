@@ -203,12 +203,17 @@ internal sealed class NativeMessageBoxBrowserHost : INativeMessageBoxHost, INati
             wasTimeout: response.WasTimeout,
             outcome: outcome,
             tag: options.Tag,
-            nativeResultCode: response.ResultCode);
+            nativeResultCode: response.ResultCode,
+            fieldValues: response.FieldValues?.Select(value => new MessageBoxFieldValue(value.Value ?? string.Empty, value.Checked)).ToList());
     }
 
     private async Task<MessageBoxResult> ExecuteShowAsync(MessageBoxOptions options, CancellationToken cancellationToken)
     {
         cancellationToken.ThrowIfCancellationRequested();
+        if (options.InputOptions is { Mode: MessageBoxInputMode.MultiSelect })
+        {
+            throw new NativeMessageBoxException("The browser host does not support multi-select inputs.", NmbResultCode.NotSupported);
+        }
 
         var requestJson = SerializeRequest(options);
         var responseJson = await NativeMessageBoxBrowserInterop.ShowMessageBox(requestJson).ConfigureAwait(false);
@@ -232,6 +237,7 @@ internal sealed class NativeMessageBoxBrowserHost : INativeMessageBoxHost, INati
         public string? Locale { get; set; }
         public BrowserMessageBoxInput? Input { get; set; }
         public BrowserMessageBoxSecondary? Secondary { get; set; }
+        public List<BrowserMessageBoxInput>? Fields { get; set; }
 
         public static BrowserMessageBoxRequest FromOptions(MessageBoxOptions options)
         {
@@ -277,6 +283,11 @@ internal sealed class NativeMessageBoxBrowserHost : INativeMessageBoxHost, INati
                 request.Secondary = BrowserMessageBoxSecondary.FromOptions(secondary);
             }
 
+            if (options.FormFields.Count > 0)
+            {
+                request.Fields = options.FormFields.Select(BrowserMessageBoxInput.FromOptions).ToList();
+            }
+
             return request;
         }
     }
@@ -364,5 +375,12 @@ internal sealed class NativeMessageBoxBrowserHost : INativeMessageBoxHost, INati
         public bool CheckboxChecked { get; set; }
         public bool WasTimeout { get; set; }
         public string? InputValue { get; set; }
+        public List<BrowserMessageBoxFieldValue>? FieldValues { get; set; }
+    }
+
+    private sealed class BrowserMessageBoxFieldValue
+    {
+        public string? Value { get; set; }
+        public bool Checked { get; set; }
     }
 }
@@ -9,26 +9,36 @@ namespace NativeMessageBox.Interop;
 
 internal static class NativeMessageBoxMarshaller
 {
+    private const int TitleSlot = 0;
+    private const int MessageSlot = 1;
+    private const int VerificationTextSlot = 2;
+    private const int LocaleSlot = 3;
+    private const int PromptSlot = 4;
+    private const int PlaceholderSlot = 5;
+    private const int DefaultValueSlot = 6;
+    private const int InformativeTextSlot = 7;
+    private const int ExpandedTextSlot = 8;
+    private const int FooterTextSlot = 9;
+    private const int HelpLinkSlot = 10;
+    private const int FixedSlotCount = 11;
+
     internal static NmbMessageBoxOptions CreateNativeOptions(MessageBoxOptions options, NativeMemoryScope scope, IntPtr parentOverride = default)
     {
         var native = new NmbMessageBoxOptions
         {
             StructSize = (uint)Unsafe.SizeOf<NmbMessageBoxOptions>(),
             AbiVersion = NativeConstants.AbiVersion,
-            TitleUtf8 = scope.AllocUtf8(options.Title),
-            MessageUtf8 = scope.AllocUtf8(options.Message),
             Icon = (NmbIcon)options.Icon,
             Severity = (NmbSeverity)options.Severity,
             ParentWindow = parentOverride != IntPtr.Zero ? parentOverride : options.ParentWindow,
-            VerificationTextUtf8 = scope.AllocUtf8(options.VerificationText),
             AllowCancelViaEscape = options.AllowCancelViaEscape,
             ShowSuppressCheckbox = options.ShowSuppressCheckbox,
             RequiresExplicitAck = options.RequiresExplicitAcknowledgement,
             TimeoutMilliseconds = options.Timeout.HasValue ? (uint)Math.Clamp(options.Timeout.Value.TotalMilliseconds, 0, uint.MaxValue) : 0,
             TimeoutButtonId = options.TimeoutButtonId.HasValue ? (NmbButtonId)options.TimeoutButtonId.Value : 0,
-            LocaleUtf8 = scope.AllocUtf8(options.Locale),
             Allocator = IntPtr.Zero,
-            UserContext = IntPtr.Zero
+            UserContext = IntPtr.Zero,
+            Flags = NmbMessageBoxFlags.Utf16Strings
         };
 
         var allocator = NativeAllocator.Create();
@@ -36,15 +46,61 @@ internal static class NativeMessageBoxMarshaller
 
         native.Modality = MapModality(options.Modality);
 
-        var nativeButtons = new List<NmbButtonOption>(options.Buttons.Count);
+        var inputOptions = options.InputOptions is { Mode: not MessageBoxInputMode.None } configuredInput ? configuredInput : null;
+        var comboItems = inputOptions is { Mode: MessageBoxInputMode.Combo or MessageBoxInputMode.MultiSelect }
+            ? inputOptions.ComboItems
+            : Array.Empty<string>();
+        var buttonCount = options.Buttons.Count;
+        var secondary = options.SecondaryContent;
+
+        // Strings are passed as pinned UTF-16 views in slot order: fixed fields first, then button labels and
+        // button descriptions. The native runtime transcodes them only where a backend needs UTF-8. Combo items
+        // travel separately as one contiguous UTF-8 item buffer.
+        var texts = new string?[FixedSlotCount + buttonCount * 2];
+        texts[TitleSlot] = options.Title;
+        texts[MessageSlot] = options.Message;
+        texts[VerificationTextSlot] = options.VerificationText;
+        texts[LocaleSlot] = options.Locale;
+        texts[PromptSlot] = inputOptions?.Prompt;
+        texts[PlaceholderSlot] = inputOptions?.Placeholder;
+        texts[DefaultValueSlot] = inputOptions?.DefaultValue;
+        texts[InformativeTextSlot] = secondary?.InformativeText;
+        texts[ExpandedTextSlot] = secondary?.ExpandedText;
+        texts[FooterTextSlot] = secondary?.FooterText;
+        texts[HelpLinkSlot] = secondary?.HelpLink;
+
+        for (var i = 0; i < buttonCount; i++)
+        {
+            texts[FixedSlotCount + i] = options.Buttons[i].Label;
+            texts[FixedSlotCount + buttonCount + i] = options.Buttons[i].Description;
+        }
+
+        var views = new NmbStringView16[texts.Length];
+        scope.PinUtf16Views(texts, views);
+
+        var strings = new NmbMessageBoxStrings16
+        {
+            StructSize = (uint)Unsafe.SizeOf<NmbMessageBoxStrings16>(),
+            Title = views[TitleSlot],
+            Message = views[MessageSlot],
+            VerificationText = views[VerificationTextSlot],
+            Locale = views[LocaleSlot],
+            InputPrompt = views[PromptSlot],
+            InputPlaceholder = views[PlaceholderSlot],
+            InputDefaultValue = views[DefaultValueSlot],
+            InformativeText = views[InformativeTextSlot],
+            ExpandedText = views[ExpandedTextSlot],
+            FooterText = views[FooterTextSlot],
+            HelpLink = views[HelpLinkSlot]
+        };
+
+        var nativeButtons = new List<NmbButtonOption>(buttonCount);
         foreach (var managedButton in options.Buttons)
         {
             var button = new NmbButtonOption
             {
                 StructSize = (uint)Unsafe.SizeOf<NmbButtonOption>(),
                 Id = (NmbButtonId)managedButton.Id,
-                LabelUtf8 = scope.AllocUtf8(managedButton.Label),
-                DescriptionUtf8 = scope.AllocUtf8(managedButton.Description),
                 Kind = (NmbButtonKind)managedButton.Kind,
                 IsDefault = managedButton.IsDefault,
                 IsCancel = managedButton.IsCancel
@@ -54,52 +110,91 @@ internal static class NativeMessageBoxMarshaller
 
         native.Buttons = scope.AllocStructArray<NmbButtonOption>(CollectionsMarshal.AsSpan(nativeButtons));
         native.ButtonCount = (nuint)nativeButtons.Count;
+        strings.ButtonLabels = scope.AllocStructArray<NmbStringView16>(views.AsSpan(FixedSlotCount, buttonCount));
+        strings.ButtonDescriptions = scope.AllocStructArray<NmbStringView16>(views.AsSpan(FixedSlotCount + buttonCount, buttonCount));
 
-        if (options.InputOptions is { } inputOptions && inputOptions.Mode != MessageBoxInputMode.None)
+        if (inputOptions is not null)
         {
             var input = new NmbInputOption
             {
                 StructSize = (uint)Unsafe.SizeOf<NmbInputOption>(),
-                Mode = (NmbInputMode)inputOptions.Mode,
-                PromptUtf8 = scope.AllocUtf8(inputOptions.Prompt),
-                PlaceholderUtf8 = scope.AllocUtf8(inputOptions.Placeholder),
-                DefaultValueUtf8 = scope.AllocUtf8(inputOptions.DefaultValue)
+                Mode = (NmbInputMode)inputOptions.Mode
             };
 
-            if (inputOptions.Mode == MessageBoxInputMode.Combo)
+            if (inputOptions.Mode is MessageBoxInputMode.Combo or MessageBoxInputMode.MultiSelect)
+            {
+                input.ComboItemBuffer = scope.AllocItemBuffer(comboItems);
+            }
+
+            if (inputOptions.Mode == MessageBoxInputMode.MultiSelect)
             {
-                var pointers = new List<IntPtr>(inputOptions.ComboItems.Count + 1);
-                foreach (var item in inputOptions.ComboItems)
+                // The runtime answers in this bitset, so the selection comes back without a native allocation.
+                var bits = new byte[(comboItems.Count + 7) / 8];
+                foreach (var item in inputOptions.SelectedItems)
                 {
-                    pointers.Add(scope.AllocUtf8(item));
+                    bits[item / 8] |= (byte)(1 << (item % 8));
                 }
 
-                pointers.Add(IntPtr.Zero);
-                input.ComboItemsUtf8 = scope.AllocPointerArray(CollectionsMarshal.AsSpan(pointers));
+                input.SelectionBits = scope.AllocStructArray<byte>(bits);
+                input.SelectionBitsSize = (nuint)bits.Length;
             }
 
             var array = new[] { input };
             native.Input = scope.AllocStructArray<NmbInputOption>(array);
         }
 
-        if (options.SecondaryContent is { } secondary)
+        if (secondary is not null)
         {
             var secondaryNative = new NmbSecondaryContentOption
             {
-                StructSize = (uint)Unsafe.SizeOf<NmbSecondaryContentOption>(),
-                InformativeTextUtf8 = scope.AllocUtf8(secondary.InformativeText),
-                ExpandedTextUtf8 = scope.AllocUtf8(secondary.ExpandedText),
-                FooterTextUtf8 = scope.AllocUtf8(secondary.FooterText),
-                HelpLinkUtf8 = scope.AllocUtf8(secondary.HelpLink)
+                StructSize = (uint)Unsafe.SizeOf<NmbSecondaryContentOption>()
             };
 
             var array = new[] { secondaryNative };
             native.Secondary = scope.AllocStructArray<NmbSecondaryContentOption>(array);
         }
 
+        if (options.FormFields.Count > 0)
+        {
+            native.FormFields = CreateFormFields(options.FormFields, scope);
+            native.FormFieldCount = (nuint)options.FormFields.Count;
+        }
+
+        native.StringsUtf16 = scope.AllocStructArray<NmbMessageBoxStrings16>(stackalloc NmbMessageBoxStrings16[] { strings });
         return native;
     }
 
+    // Form fields are read as UTF-8 by the runtime, so their text is encoded here rather than passed as views.
+    private static IntPtr CreateFormFields(IReadOnlyList<MessageBoxInputOptions> fields, NativeMemoryScope scope)
+    {
+        var nativeFields = new NmbInputOption[fields.Count];
+        for (var i = 0; i < fields.Count; i++)
+        {
+            var field = fields[i];
+            nativeFields[i] = new NmbInputOption
+            {
+                StructSize = (uint)Unsafe.SizeOf<NmbInputOption>(),
+                Mode = (NmbInputMode)field.Mode,
+                PromptUtf8 = scope.AllocUtf8(field.Prompt),
+                PlaceholderUtf8 = scope.AllocUtf8(field.Placeholder),
+                DefaultValueUtf8 = scope.AllocUtf8(field.DefaultValue)
+            };
+
+            if (field.Mode == MessageBoxInputMode.Combo)
+            {
+                var items = new IntPtr[field.ComboItems.Count + 1];
+                for (var j = 0; j < field.ComboItems.Count; j++)
+                {
+                    items[j] = scope.AllocUtf8(field.ComboItems[j] ?? string.Empty);
+                }
+
+                nativeFields[i].ComboItemsUtf8 = scope.AllocPointerArray(items);
+            }
+        }
+
+        return scope.AllocStructArray<NmbInputOption>(nativeFields);
+    }
+
     internal static NmbMessageBoxResult CreateNativeResult()
     {
         return new NmbMessageBoxResult
@@ -109,7 +204,7 @@ internal static class NativeMessageBoxMarshaller
         };
     }
 
-    internal static MessageBoxResult ToManagedResult(ref NmbMessageBoxResult nativeResult, MessageBoxOptions options)
+    internal static MessageBoxResult ToManagedResult(ref NmbMessageBoxResult nativeResult, MessageBoxOptions options, IntPtr nativeInput = default)
     {
         string? input = null;
         if (nativeResult.InputValueUtf8 != IntPtr.Zero)
@@ -118,6 +213,39 @@ internal static class NativeMessageBoxMarshaller
             NativeAllocator.Release(nativeResult.InputValueUtf8);
         }
 
+        MessageBoxFieldValue[]? fieldValues = null;
+        if (nativeResult.FieldValues != IntPtr.Zero)
+        {
+            fieldValues = new MessageBoxFieldValue[(int)nativeResult.FieldValueCount];
+            for (var i = 0; i < fieldValues.Length; i++)
+            {
+                var value = Marshal.PtrToStructure<NmbFieldValue>(nativeResult.FieldValues + i * Unsafe.SizeOf<NmbFieldValue>());
+                var text = Marshal.PtrToStringUTF8(value.ValueUtf8, (int)value.Length) ?? string.Empty;
+                fieldValues[i] = new MessageBoxFieldValue(text, value.Checked);
+            }
+
+            // The array and its text are a single runtime allocation.
+            NativeAllocator.Release(nativeResult.FieldValues);
+        }
+
+        List<int>? selectedItems = null;
+        if (nativeInput != IntPtr.Zero && options.InputOptions is { Mode: MessageBoxInputMode.MultiSelect } && nativeResult.ResultCode == NmbResultCode.Ok)
+        {
+            var input = Marshal.PtrToStructure<NmbInputOption>(nativeInput);
+            selectedItems = new List<int>((int)nativeResult.SelectionCount);
+            for (var i = 0; i < (int)input.SelectionBitsSize; i++)
+            {
+                var bits = Marshal.ReadByte(input.SelectionBits, i);
+                for (var bit = 0; bits != 0; bit++, bits >>= 1)
+                {
+                    if ((bits & 1) != 0)
+                    {
+                        selectedItems.Add(i * 8 + bit);
+                    }
+                }
+            }
+        }
+
         return new MessageBoxResult(
             buttonId: (uint)nativeResult.Button,
             checkboxChecked: nativeResult.CheckboxChecked,
@@ -125,7 +253,9 @@ internal static class NativeMessageBoxMarshaller
             wasTimeout: nativeResult.WasTimeout,
             outcome: ResultMapper.ToOutcome(nativeResult.ResultCode),
             tag: options.Tag,
-            nativeResultCode: (uint)nativeResult.ResultCode);
+            nativeResultCode: (uint)nativeResult.ResultCode,
+            fieldValues: fieldValues,
+            selectedItems: selectedItems);
     }
 
     private static NmbDialogModality MapModality(MessageBoxDialogModality modality)
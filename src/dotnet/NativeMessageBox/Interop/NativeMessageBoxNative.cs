@@ -86,6 +86,87 @@ internal struct NmbMessageBoxOptions
     internal IntPtr LocaleUtf8;
     internal IntPtr Allocator;
     internal IntPtr UserContext;
+    internal NmbMessageBoxFlags Flags;
+    internal IntPtr Strings;
+    internal IntPtr StringsUtf16;
+    internal IntPtr FormFields;
+    internal nuint FormFieldCount;
+}
+
+[Flags]
+internal enum NmbMessageBoxFlags : uint
+{
+    None = 0,
+    StringViews = 1u << 0,
+    Utf16Strings = 1u << 1
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbStringView
+{
+    internal IntPtr Data;
+    internal nuint Length;
+
+    internal NmbStringView(IntPtr data, nuint length)
+    {
+        Data = data;
+        Length = length;
+    }
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbMessageBoxStrings
+{
+    internal uint StructSize;
+    internal NmbStringView Title;
+    internal NmbStringView Message;
+    internal NmbStringView VerificationText;
+    internal NmbStringView Locale;
+    internal IntPtr ButtonLabels;
+    internal IntPtr ButtonDescriptions;
+    internal NmbStringView InputPrompt;
+    internal NmbStringView InputPlaceholder;
+    internal NmbStringView InputDefaultValue;
+    internal IntPtr ComboItems;
+    internal nuint ComboItemCount;
+    internal NmbStringView InformativeText;
+    internal NmbStringView ExpandedText;
+    internal NmbStringView FooterText;
+    internal NmbStringView HelpLink;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbStringView16
+{
+    internal IntPtr Data;
+    internal nuint Length;
+
+    internal NmbStringView16(IntPtr data, nuint length)
+    {
+        Data = data;
+        Length = length;
+    }
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbMessageBoxStrings16
+{
+    internal uint StructSize;
+    internal NmbStringView16 Title;
+    internal NmbStringView16 Message;
+    internal NmbStringView16 VerificationText;
+    internal NmbStringView16 Locale;
+    internal IntPtr ButtonLabels;
+    internal IntPtr ButtonDescriptions;
+    internal NmbStringView16 InputPrompt;
+    internal NmbStringView16 InputPlaceholder;
+    internal NmbStringView16 InputDefaultValue;
+    internal IntPtr ComboItems;
+    internal nuint ComboItemCount;
+    internal NmbStringView16 InformativeText;
+    internal NmbStringView16 ExpandedText;
+    internal NmbStringView16 FooterText;
+    internal NmbStringView16 HelpLink;
 }
 
 [StructLayout(LayoutKind.Sequential)]
@@ -99,6 +180,18 @@ internal struct NmbMessageBoxResult
     [MarshalAs(UnmanagedType.U1)]
     internal bool WasTimeout;
     internal NmbResultCode ResultCode;
+    internal IntPtr FieldValues;
+    internal nuint FieldValueCount;
+    internal nuint SelectionCount;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbFieldValue
+{
+    internal IntPtr ValueUtf8;
+    internal nuint Length;
+    [MarshalAs(UnmanagedType.U1)]
+    internal bool Checked;
 }
 
 [StructLayout(LayoutKind.Sequential)]
@@ -124,6 +217,24 @@ internal struct NmbInputOption
     internal IntPtr PlaceholderUtf8;
     internal IntPtr DefaultValueUtf8;
     internal IntPtr ComboItemsUtf8;
+    internal IntPtr ComboItemBuffer;
+    internal IntPtr CompletionIndex;
+    internal uint CompletionMaxResults;
+    internal IntPtr InputChunkCallback;
+    internal IntPtr InputChunkUserData;
+    internal IntPtr SelectionBits;
+    internal nuint SelectionBitsSize;
+    internal IntPtr SelectionIndices;
+    internal nuint SelectionIndexCapacity;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+internal struct NmbItemBuffer
+{
+    internal uint StructSize;
+    internal IntPtr Data;
+    internal IntPtr Offsets;
+    internal nuint ItemCount;
 }
 
 [StructLayout(LayoutKind.Sequential)]
@@ -193,5 +304,7 @@ internal enum NmbInputMode : uint
     Checkbox = 1,
     Text = 2,
     Password = 3,
-    Combo = 4
+    Combo = 4,
+    Multiline = 5,
+    MultiSelect = 6
 }
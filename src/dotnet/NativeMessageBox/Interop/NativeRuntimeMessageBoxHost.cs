@@ -150,7 +150,7 @@ internal sealed class NativeRuntimeMessageBoxHost : INativeMessageBoxHost, INati
                 nativeResult.ResultCode = status;
             }
 
-            return NativeMessageBoxMarshaller.ToManagedResult(ref nativeResult, options);
+            return NativeMessageBoxMarshaller.ToManagedResult(ref nativeResult, options, nativeOptions.Input);
         }
         finally
         {
@@ -235,10 +235,17 @@ internal sealed class NativeRuntimeMessageBoxHost : INativeMessageBoxHost, INati
         if (OperatingSystem.IsWindows())
         {
             if (options.InputOptions is { Mode: MessageBoxInputMode mode } &&
-                mode is MessageBoxInputMode.Text or MessageBoxInputMode.Password or MessageBoxInputMode.Combo)
+                mode is MessageBoxInputMode.Text or MessageBoxInputMode.Password or MessageBoxInputMode.Combo or MessageBoxInputMode.Multiline)
             {
                 throw new NativeMessageBoxException(
-                    "The Windows native message box only supports checkbox input. Use a custom dialog implementation for text, password, or combo inputs.",
+                    "The Windows native message box only supports checkbox input. Use a custom dialog implementation for text, password, combo, or multi-line inputs.",
+                    NmbResultCode.NotSupported);
+            }
+
+            if (options.FormFields.Count > 0)
+            {
+                throw new NativeMessageBoxException(
+                    "The Windows native message box does not support form dialogs.",
                     NmbResultCode.NotSupported);
             }
 
@@ -257,7 +264,7 @@ internal sealed class NativeRuntimeMessageBoxHost : INativeMessageBoxHost, INati
 
     private static bool RequiresAdvancedWindowsFeatures(MessageBoxOptions options)
     {
-        if (options.InputOptions is { Mode: not MessageBoxInputMode.None })
+        if (options.InputOptions is { Mode: not MessageBoxInputMode.None } || options.FormFields.Count > 0)
         {
             return true;
         }
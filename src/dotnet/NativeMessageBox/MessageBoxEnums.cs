@@ -40,6 +40,8 @@ public enum MessageBoxInputMode
     Checkbox,
     Text,
     Password,
-    Combo
+    Combo,
+    Multiline,
+    MultiSelect
 }
 
@@ -0,0 +1,14 @@
+namespace NativeMessageBox;
+
+public sealed class MessageBoxFieldValue
+{
+    public MessageBoxFieldValue(string value, bool isChecked)
+    {
+        Value = value;
+        IsChecked = isChecked;
+    }
+
+    public string Value { get; }
+
+    public bool IsChecked { get; }
+}
@@ -12,18 +12,31 @@ public sealed class MessageBoxInputOptions
         string? prompt = null,
         string? placeholder = null,
         string? defaultValue = null,
-        IReadOnlyList<string>? comboItems = null)
+        IReadOnlyList<string>? comboItems = null,
+        IEnumerable<int>? selectedItems = null)
     {
         if (mode == MessageBoxInputMode.Combo && (comboItems == null || comboItems.Count == 0))
         {
             throw new ArgumentException("Combo box mode requires at least one item.", nameof(comboItems));
         }
 
+        if (mode == MessageBoxInputMode.MultiSelect && (comboItems == null || comboItems.Count == 0))
+        {
+            throw new ArgumentException("Multi-select mode requires at least one item.", nameof(comboItems));
+        }
+
+        var selection = selectedItems?.ToArray() ?? Array.Empty<int>();
+        if (selection.Any(item => item < 0 || item >= (comboItems?.Count ?? 0)))
+        {
+            throw new ArgumentOutOfRangeException(nameof(selectedItems), "Selected items must index comboItems.");
+        }
+
         Mode = mode;
         Prompt = prompt;
         Placeholder = placeholder;
         DefaultValue = defaultValue;
         ComboItems = comboItems != null ? new ReadOnlyCollection<string>(comboItems.ToArray()) : Array.Empty<string>();
+        SelectedItems = new ReadOnlyCollection<int>(selection);
     }
 
     public MessageBoxInputMode Mode { get; }
@@ -35,4 +48,7 @@ public sealed class MessageBoxInputOptions
     public string? DefaultValue { get; }
 
     public IReadOnlyList<string> ComboItems { get; }
+
+    /// <summary>Indices into <see cref="ComboItems"/> checked when a multi-select list opens.</summary>
+    public IReadOnlyList<int> SelectedItems { get; }
 }
@@ -24,7 +24,8 @@ public sealed class MessageBoxOptions
         TimeSpan? timeout = null,
         uint? timeoutButtonId = null,
         string? locale = null,
-        object? tag = null)
+        object? tag = null,
+        IEnumerable<MessageBoxInputOptions>? formFields = null)
     {
         if (string.IsNullOrWhiteSpace(message))
         {
@@ -41,6 +42,17 @@ public sealed class MessageBoxOptions
             throw new ArgumentException("At least one button must be specified.", nameof(buttons));
         }
 
+        var fieldList = formFields?.ToList() ?? new List<MessageBoxInputOptions>();
+        if (fieldList.Count > 0 && inputOptions is { Mode: not MessageBoxInputMode.None })
+        {
+            throw new ArgumentException("A dialog takes either inputOptions or formFields, not both.", nameof(formFields));
+        }
+
+        if (fieldList.Any(field => field is null || field.Mode is MessageBoxInputMode.None or MessageBoxInputMode.MultiSelect))
+        {
+            throw new ArgumentException("Every form field needs an input mode other than multi-select.", nameof(formFields));
+        }
+
         Message = message;
         Buttons = new ReadOnlyCollection<MessageBoxButton>(buttonList);
         Title = title;
@@ -49,6 +61,7 @@ public sealed class MessageBoxOptions
         Modality = modality;
         ParentWindow = parentWindow;
         InputOptions = inputOptions;
+        FormFields = new ReadOnlyCollection<MessageBoxInputOptions>(fieldList);
         SecondaryContent = secondaryContent;
         VerificationText = verificationText;
         AllowCancelViaEscape = allowCancelViaEscape;
@@ -78,6 +91,9 @@ public sealed class MessageBoxOptions
 
     public MessageBoxInputOptions? InputOptions { get; }
 
+    /// <summary>Inputs shown together as one form; answers arrive in <see cref="MessageBoxResult.FieldValues"/>.</summary>
+    public IReadOnlyList<MessageBoxInputOptions> FormFields { get; }
+
     public MessageBoxSecondaryContent? SecondaryContent { get; }
 
     public string? VerificationText { get; }
@@ -104,11 +120,13 @@ public sealed class MessageBoxOptions
         {
             RequiresStaOnWindows = options.RequiresExplicitAcknowledgement ||
                                    options.InputOptions is { Mode: not MessageBoxInputMode.None } ||
+                                   options.FormFields.Count > 0 ||
                                    options.SecondaryContent != null ||
                                    (options.Timeout.HasValue && options.Timeout.Value > TimeSpan.Zero);
 
-            SupportsWindowsInput = options.InputOptions is null ||
-                                   options.InputOptions.Mode is MessageBoxInputMode.None or MessageBoxInputMode.Checkbox;
+            SupportsWindowsInput = options.FormFields.Count == 0 &&
+                                   (options.InputOptions is null ||
+                                    options.InputOptions.Mode is MessageBoxInputMode.None or MessageBoxInputMode.Checkbox);
 
             LocaleSupported = false;
         }
@@ -1,10 +1,11 @@
 using System;
+using System.Collections.Generic;
 
 namespace NativeMessageBox;
 
 public sealed class MessageBoxResult
 {
-    public MessageBoxResult(uint buttonId, bool checkboxChecked, string? inputValue, bool wasTimeout, MessageBoxOutcome outcome, object? tag, uint nativeResultCode = 0)
+    public MessageBoxResult(uint buttonId, bool checkboxChecked, string? inputValue, bool wasTimeout, MessageBoxOutcome outcome, object? tag, uint nativeResultCode = 0, IReadOnlyList<MessageBoxFieldValue>? fieldValues = null, IReadOnlyList<int>? selectedItems = null)
     {
         ButtonId = buttonId;
         CheckboxChecked = checkboxChecked;
@@ -13,6 +14,8 @@ public sealed class MessageBoxResult
         Outcome = outcome;
         Tag = tag;
         NativeResultCode = nativeResultCode;
+        FieldValues = fieldValues ?? Array.Empty<MessageBoxFieldValue>();
+        SelectedItems = selectedItems ?? Array.Empty<int>();
     }
 
     public uint ButtonId { get; }
@@ -28,6 +31,12 @@ public sealed class MessageBoxResult
     public object? Tag { get; }
 
     public uint NativeResultCode { get; }
+
+    /// <summary>One answer per entry of <see cref="MessageBoxOptions.FormFields"/>, in the same order.</summary>
+    public IReadOnlyList<MessageBoxFieldValue> FieldValues { get; }
+
+    /// <summary>Checked item indices of a multi-select input, in ascending order.</summary>
+    public IReadOnlyList<int> SelectedItems { get; }
 }
 
 public enum MessageBoxOutcome
@@ -4,14 +4,24 @@
 
 #include <android/log.h>
 #include <jni.h>
+#include <unistd.h>
 
 #include <cstddef>
+#include <cstring>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
 
+#include "../../shared/nmb_aggregate.h"
 #include "../../shared/nmb_alloc.h"
+#include "../../shared/nmb_async.h"
+#include "../../shared/nmb_clock.h"
+#include "../../shared/nmb_message_template.h"
+#include "../../shared/nmb_options.h"
+#include "../../shared/nmb_request.h"
 #include "../../shared/nmb_runtime.h"
+#include "../../shared/nmb_timing.h"
+#include "../../shared/nmb_toast.h"
 #if defined(NMB_TESTING)
 #include "native_message_box_test.h"
 #endif
@@ -153,12 +163,6 @@ static NmbResultCode ValidateMessageBoxOptions(const NmbMessageBoxOptions* optio
         return NMB_E_INVALID_ARGUMENT;
     }
 
-    if (!options->message_utf8)
-    {
-        AndroidLog("Android: message_utf8 is required.");
-        return NMB_E_INVALID_ARGUMENT;
-    }
-
     return NMB_OK;
 }
 
@@ -203,6 +207,11 @@ static void LogUnsupportedFeatures(const NmbMessageBoxOptions* options)
         AndroidLog("Android: Input controls are not supported.");
     }
 
+    if (nmb_dialog_handle(options))
+    {
+        AndroidLog("Android: Live dialog updates are not supported; the handle is ignored.");
+    }
+
     if (options->icon != NMB_ICON_NONE)
     {
         AndroidLog("Android: Icon hints are not currently supported.");
@@ -279,9 +288,27 @@ static bool ApplyTestHarness(const NmbMessageBoxOptions* options, NmbMessageBoxR
     out_result->checkbox_checked = harness->checkbox_checked;
     out_result->was_timeout = harness->simulate_timeout;
     out_result->result_code = harness->result_code;
+
+    const uint32_t timeout = options->timeout_button_id != NMB_BUTTON_ID_NONE ? options->timeout_milliseconds : 0;
+    if (nmb_clock_play_scripted_answer(timeout, harness->answer_after_milliseconds))
+    {
+        out_result->button = options->timeout_button_id;
+        out_result->was_timeout = NMB_TRUE;
+    }
+    nmb_timing_finish(out_result, NMB_BACKEND_HEADLESS);
+
     out_result->input_value_utf8 = nullptr;
 
-    if (harness->input_value_utf8)
+    if (harness->input_value_utf8 && harness->result_code == NMB_OK && nmb_input_chunk_callback(options->input))
+    {
+        NmbResultCode rc = nmb_deliver_input_text(options, harness->input_value_utf8,
+                                                  std::strlen(harness->input_value_utf8), out_result);
+        if (rc != NMB_OK)
+        {
+            out_result->result_code = rc;
+        }
+    }
+    else if (harness->input_value_utf8)
     {
         if (harness->result_code == NMB_OK)
         {
@@ -300,6 +327,15 @@ static bool ApplyTestHarness(const NmbMessageBoxOptions* options, NmbMessageBoxR
         }
     }
 
+    NmbResultCode fields_rc =
+        nmb_store_field_values(options, harness->field_values, harness->field_value_count, out_result);
+    if (fields_rc != NMB_OK)
+    {
+        out_result->result_code = fields_rc;
+    }
+
+    nmb_store_selection(options, harness->selection_bits, out_result);
+
     return true;
 }
 #endif
@@ -318,6 +354,21 @@ static NmbResultCode ShowDialogInternal(const NmbMessageBoxOptions* options, Nmb
     }
 #endif
 
+    size_t fieldCount = 0;
+    if (nmb_form_fields(options, &fieldCount))
+    {
+        AndroidLog("Android: Form dialogs are not supported.");
+        out_result->result_code = NMB_E_NOT_SUPPORTED;
+        return NMB_E_NOT_SUPPORTED;
+    }
+
+    if (options->input && options->input->mode == NMB_INPUT_MULTISELECT)
+    {
+        AndroidLog("Android: Multi-select inputs are not supported.");
+        out_result->result_code = NMB_E_NOT_SUPPORTED;
+        return NMB_E_NOT_SUPPORTED;
+    }
+
     if (!options->parent_window)
     {
         AndroidLog("Android: parent_window must provide an Activity jobject handle.");
@@ -438,6 +489,8 @@ static NmbResultCode ShowDialogInternal(const NmbMessageBoxOptions* options, Nmb
         std::unique_lock<std::mutex> lock(state.mutex);
         state.cv.wait(lock, [&state] { return state.completed; });
     }
+    // The dialog is built and shown by the Java bridge, so only the answer is timed here.
+    nmb_timing_finish(out_result, NMB_BACKEND_ANDROID);
 
     ReleaseEnv(didAttach);
 
@@ -548,6 +601,7 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
 
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
 {
+    const uint64_t received = nmb_clock_now_microseconds();
     if (!options || !out_result)
     {
         return NMB_E_INVALID_ARGUMENT;
@@ -565,12 +619,61 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return validation;
     }
 
-    out_result->struct_size = sizeof(*out_result);
-    out_result->button = NMB_BUTTON_ID_NONE;
-    out_result->checkbox_checked = NMB_FALSE;
-    out_result->input_value_utf8 = nullptr;
-    out_result->was_timeout = NMB_FALSE;
-    out_result->result_code = NMB_OK;
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_expanded_source(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_table(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_expand_combo_buffer(&prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    options = prepared.value.options;
+    if (!options->message_utf8)
+    {
+        AndroidLog("Android: message_utf8 is required.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    validation = nmb_reset_result(options, out_result);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    nmb_timing_begin(out_result, received);
+
+    // Dialogs are shown from the main looper, whose thread id is the process id; it must never wait on one.
+    if (nmb_templated_message(options))
+    {
+        const nmb_bool may_wait = gettid() == getpid() ? NMB_FALSE : NMB_TRUE;
+        return nmb_message_template_show(options, out_result, nmb_show_message_box, may_wait);
+    }
+
+    if (nmb_aggregation(options))
+    {
+        return nmb_aggregate_show(options, out_result, nmb_show_message_box);
+    }
+
+    if (nmb_toast(options))
+    {
+        return nmb_toast_show_modal(options, out_result, nmb_show_message_box);
+    }
 
     LogUnsupportedFeatures(options);
 
@@ -578,6 +681,62 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     return result;
 }
 
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void*,
+                                                               NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request)
+{
+    return nmb_request_submit(options, out_result, out_request, nmb_show_message_box_async);
+}
+
+NMB_API int NMB_CALL nmb_get_event_fd(void)
+{
+    return nmb_event_fd();
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t)
+{
+    nmb_event_fd_drain();
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options, NmbProgressHandle** out_handle)
+{
+    if (!options || !out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    *out_handle = nullptr;
+    nmb_runtime_log("Android: Progress dialogs are not supported.");
+    return NMB_E_NOT_SUPPORTED;
+}
+
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle*, double, const char*)
+{
+}
+
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle*)
+{
+    return NMB_FALSE;
+}
+
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle*)
+{
+}
+
 NMB_API void NMB_CALL nmb_shutdown(void)
 {
     nmb_runtime_reset_log();
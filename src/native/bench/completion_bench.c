@@ -0,0 +1,105 @@
+/*
+ * Builds a completion index over a synthetic corpus of host-name-like entries and measures the build
+ * once, then the cost of typing a prefix one character at a time: every keystroke narrows the previous
+ * range, as the GTK popup does, and the first results up to the popup cap are read back.
+ *
+ * Usage: nmb_completion_bench [entries] [result_cap]
+ */
+
+#include "native_message_box.h"
+#include "nmb_completion.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static const char* const kRegions[] = { "eu-west", "eu-central", "us-east", "us-west", "ap-south", "ap-northeast" };
+
+static int build_corpus(size_t entries, NmbItemBuffer* items, char** data, uint32_t** offsets)
+{
+    *data = (char*)malloc(entries * 48 + 1);
+    *offsets = (uint32_t*)malloc((entries + 1) * sizeof(uint32_t));
+    if (!*data || !*offsets)
+    {
+        return 0;
+    }
+
+    /* Multiplicative hashing scatters the entries so the index does not receive them presorted. */
+    uint32_t used = 0;
+    for (size_t i = 0; i < entries; ++i)
+    {
+        const uint32_t scrambled = (uint32_t)(i * 2654435761u);
+        (*offsets)[i] = used;
+        used += (uint32_t)sprintf(*data + used, "node-%08x.%s.example.net", scrambled,
+                                  kRegions[scrambled % (sizeof(kRegions) / sizeof(kRegions[0]))]);
+    }
+    (*offsets)[entries] = used;
+
+    memset(items, 0, sizeof(*items));
+    items->struct_size = sizeof(*items);
+    items->data = *data;
+    items->offsets = *offsets;
+    items->item_count = entries;
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t entries = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000u;
+    const size_t cap = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 50u;
+
+    NmbItemBuffer items;
+    char* data = NULL;
+    uint32_t* offsets = NULL;
+    if (!build_corpus(entries, &items, &data, &offsets))
+    {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    double started = now_seconds();
+    NmbCompletionIndex* index = NULL;
+    if (nmb_completion_index_create(&items, &index) != NMB_OK)
+    {
+        fprintf(stderr, "index build failed\n");
+        return 1;
+    }
+    printf("build      %zu entries   %9.2f ms\n", entries, (now_seconds() - started) * 1000.0);
+
+    /* Type the name of an entry that exists, one keystroke at a time. */
+    const char* typed = data + offsets[entries / 2];
+    const size_t typed_length = (size_t)(offsets[entries / 2 + 1] - offsets[entries / 2]);
+    const int rounds = 1000;
+    size_t shown = 0;
+    started = now_seconds();
+    for (int round = 0; round < rounds; ++round)
+    {
+        NmbCompletionRange range = nmb_completion_index_all(index);
+        for (size_t length = 1; length <= typed_length; ++length)
+        {
+            range = nmb_completion_index_narrow(index, range, typed, length);
+            for (size_t rank = range.first; rank < range.last && rank < range.first + cap; ++rank)
+            {
+                size_t text_length = 0;
+                shown += nmb_completion_index_text(index, rank, &text_length)[0] != '\0' ? 1u : 0u;
+            }
+        }
+    }
+    const double elapsed = now_seconds() - started;
+    printf("keystroke  cap %-6zu       %9.3f us  (%zu suggestions read)\n", cap,
+           elapsed * 1e6 / ((double)rounds * (double)typed_length), shown);
+
+    nmb_completion_index_destroy(index);
+    free(data);
+    free(offsets);
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Measures time-to-visible on the GTK backend: the time from nmb_show_message_box until the dialog
+ * first draws, for message bodies from 1 KiB to 8 MiB of stack-trace-like lines. A plain
+ * GtkMessageDialog with the whole body in its label is timed alongside, up to 1 MiB, as the baseline.
+ * Needs a display; prints a note and exits successfully without one.
+ *
+ * Usage: nmb_message_body_bench [iterations]
+ */
+
+#include "native_message_box.h"
+
+#include <gtk/gtk.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double s_started;
+static double s_visible;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static gboolean close_dialog(gpointer dialog)
+{
+    gtk_dialog_response(GTK_DIALOG(dialog), GTK_RESPONSE_CANCEL);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_draw(GSignalInvocationHint* hint, guint count, const GValue* params, gpointer data)
+{
+    (void)hint;
+    (void)count;
+    (void)data;
+    gpointer instance = g_value_get_object(&params[0]);
+    if (s_visible == 0.0 && GTK_IS_DIALOG(instance))
+    {
+        s_visible = now_seconds();
+        g_idle_add(close_dialog, instance);
+    }
+    return TRUE;
+}
+
+static char* build_message(size_t bytes)
+{
+    char* text = (char*)malloc(bytes + 1);
+    if (!text)
+    {
+        return NULL;
+    }
+
+    size_t used = 0;
+    for (int frame = 0; used < bytes; ++frame)
+    {
+        char line[96];
+        int length = snprintf(line, sizeof(line), "  #%d 0x%08x in worker::process_batch (src/worker.cpp:%d)\n",
+                              frame, 0x401000 + frame * 16, 100 + frame % 900);
+        size_t take = (size_t)length < bytes - used ? (size_t)length : bytes - used;
+        memcpy(text + used, line, take);
+        used += take;
+    }
+    text[bytes] = '\0';
+    return text;
+}
+
+static double time_runtime(const char* message)
+{
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.title_utf8 = "Crash report";
+    options.message_utf8 = message;
+    options.icon = NMB_ICON_ERROR;
+    options.allow_cancel_via_escape = NMB_TRUE;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    s_visible = 0.0;
+    s_started = now_seconds();
+    nmb_show_message_box(&options, &result);
+    return s_visible > 0.0 ? s_visible - s_started : -1.0;
+}
+
+static double time_label(const char* message)
+{
+    s_visible = 0.0;
+    s_started = now_seconds();
+    GtkWidget* dialog =
+        gtk_message_dialog_new(NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_ERROR, GTK_BUTTONS_NONE, "%s", message);
+    gtk_dialog_add_button(GTK_DIALOG(dialog), "OK", GTK_RESPONSE_OK);
+    gtk_widget_show_all(dialog);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+    return s_visible > 0.0 ? s_visible - s_started : -1.0;
+}
+
+static void report(const char* name, double total, int iterations)
+{
+    if (total < 0.0)
+    {
+        printf("  %-10s     (never drew)", name);
+        return;
+    }
+    printf("  %-10s %9.2f ms", name, total * 1000.0 / iterations);
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 5;
+    if (!gtk_init_check(NULL, NULL))
+    {
+        printf("GTK display unavailable; skipping message body benchmark.\n");
+        return 0;
+    }
+
+    g_signal_add_emission_hook(g_signal_lookup("draw", GTK_TYPE_WIDGET), 0, on_draw, NULL, NULL);
+
+    static const size_t kSizes[] = { 1u << 10, 16u << 10, 256u << 10, 1u << 20, 8u << 20 };
+    static const size_t kLabelLimit = 1u << 20;
+    printf("time-to-visible, mean of %d runs\n", iterations);
+    for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s)
+    {
+        char* message = build_message(kSizes[s]);
+        if (!message)
+        {
+            fprintf(stderr, "allocation failed\n");
+            return 1;
+        }
+
+        double runtime = 0.0;
+        double label = 0.0;
+        for (int i = 0; i < iterations && runtime >= 0.0; ++i)
+        {
+            double elapsed = time_runtime(message);
+            runtime = elapsed < 0.0 ? elapsed : runtime + elapsed;
+        }
+        for (int i = 0; kSizes[s] <= kLabelLimit && i < iterations && label >= 0.0; ++i)
+        {
+            double elapsed = time_label(message);
+            label = elapsed < 0.0 ? elapsed : label + elapsed;
+        }
+
+        printf("%8zu KiB", kSizes[s] >> 10);
+        report("runtime", runtime, iterations);
+        if (kSizes[s] <= kLabelLimit)
+        {
+            report("label", label, iterations);
+        }
+        printf("\n");
+        free(message);
+    }
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Measures the UTF-16 entry point on long expanded-text payloads: the raw transcoder (scalar versus
+ * SIMD) and nmb_prepare_options fed UTF-16 views versus UTF-8 views that a host transcoded itself.
+ *
+ * Usage: nmb_utf16_bench [payload_megabytes] [iterations]
+ */
+
+#include "native_message_box.h"
+#include "nmb_options.h"
+#include "nmb_utf16.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Synthetic diagnostic log: mostly ASCII with the occasional accented character, arrow and emoji. */
+static uint16_t* build_payload(size_t units)
+{
+    static const char* const kLine = "2024-05-01T12:00:00Z worker-07 request=GET /api/v1/items status=500 elapsed=";
+    uint16_t* text = (uint16_t*)malloc(units * sizeof(uint16_t));
+    if (!text)
+    {
+        return NULL;
+    }
+
+    size_t i = 0;
+    size_t line = 0;
+    while (i < units)
+    {
+        for (const char* p = kLine; *p && i < units; ++p)
+        {
+            text[i++] = (uint16_t)(unsigned char)*p;
+        }
+
+        if (line % 16 == 0 && i + 4 <= units)
+        {
+            text[i++] = 0x00E9; /* é */
+            text[i++] = 0x2192; /* → */
+            text[i++] = 0xD83D; /* U+1F525 */
+            text[i++] = 0xDD25;
+        }
+
+        if (i < units)
+        {
+            text[i++] = '\n';
+        }
+        ++line;
+    }
+    return text;
+}
+
+static void report(const char* name, size_t bytes, int iterations, double seconds)
+{
+    double mb = (double)bytes * iterations / (1024.0 * 1024.0);
+    printf("%-36s %9.2f ms/iter %10.1f MB/s\n", name, seconds * 1000.0 / iterations, mb / seconds);
+}
+
+static NmbMessageBoxOptions make_options(void)
+{
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Expanded diagnostics";
+    return options;
+}
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 8;
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+    if (megabytes == 0 || iterations <= 0)
+    {
+        fprintf(stderr, "usage: %s [payload_megabytes] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t units = megabytes * 1024 * 1024 / sizeof(uint16_t);
+    uint16_t* payload = build_payload(units);
+    char* utf8 = (char*)malloc(NMB_UTF16_TO_UTF8_MAX(units) + 1);
+    if (!payload || !utf8)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    const size_t bytes = units * sizeof(uint16_t);
+    printf("payload: %zu UTF-16 code units (%zu bytes), %d iterations\n", units, bytes, iterations);
+
+    size_t produced = 0;
+    double start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        produced = nmb_utf16_to_utf8_scalar(payload, units, utf8);
+    }
+    report("transcode scalar", bytes, iterations, now_seconds() - start);
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        produced = nmb_utf16_to_utf8(payload, units, utf8);
+    }
+    report("transcode simd", bytes, iterations, now_seconds() - start);
+
+    /* Host-side transcoding followed by UTF-8 views: the path .NET used before UTF-16 views. */
+    NmbMessageBoxOptions options = make_options();
+    NmbMessageBoxStrings strings;
+    memset(&strings, 0, sizeof(strings));
+    strings.struct_size = sizeof(strings);
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRING_VIEWS;
+    options.strings = &strings;
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        char* host = (char*)malloc(NMB_UTF16_TO_UTF8_MAX(units) + 1);
+        strings.expanded_text.data = host;
+        strings.expanded_text.length = nmb_utf16_to_utf8_scalar(payload, units, host);
+
+        NmbPreparedOptions prepared;
+        if (nmb_prepare_options(&options, &prepared) != NMB_OK)
+        {
+            fprintf(stderr, "prepare failed\n");
+            return 1;
+        }
+        nmb_release_prepared_options(&prepared);
+        free(host);
+    }
+    report("host transcode + utf8 views", bytes, iterations, now_seconds() - start);
+
+    NmbMessageBoxStrings16 strings16;
+    memset(&strings16, 0, sizeof(strings16));
+    strings16.struct_size = sizeof(strings16);
+    strings16.expanded_text.data = payload;
+    strings16.expanded_text.length = units;
+    options.flags = NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS;
+    options.strings = NULL;
+    options.strings_utf16 = &strings16;
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        NmbPreparedOptions prepared;
+        if (nmb_prepare_options(&options, &prepared) != NMB_OK)
+        {
+            fprintf(stderr, "prepare failed\n");
+            return 1;
+        }
+        nmb_release_prepared_options(&prepared);
+    }
+    report("utf16 views", bytes, iterations, now_seconds() - start);
+
+    printf("utf8 output: %zu bytes\n", produced);
+    free(utf8);
+    free(payload);
+    return 0;
+}
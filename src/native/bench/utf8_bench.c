@@ -0,0 +1,134 @@
+/*
+ * Compares UTF-8 validation against memcpy on multi-megabyte diagnostics, for a mostly-ASCII log and
+ * for CJK-heavy text, and measures nmb_prepare_options with the payload as expanded text.
+ *
+ * Usage: nmb_utf8_bench [payload_megabytes] [iterations]
+ */
+
+#include "native_message_box.h"
+#include "nmb_options.h"
+#include "nmb_utf8.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static char* build_payload(size_t bytes, const char* line)
+{
+    char* text = (char*)malloc(bytes + 1);
+    if (!text)
+    {
+        return NULL;
+    }
+
+    const size_t line_length = strlen(line);
+    size_t i = 0;
+    while (i + line_length <= bytes)
+    {
+        memcpy(text + i, line, line_length);
+        i += line_length;
+    }
+    memset(text + i, ' ', bytes - i);
+    text[bytes] = '\0';
+    return text;
+}
+
+static void report(const char* name, size_t bytes, int iterations, double seconds)
+{
+    double mb = (double)bytes * iterations / (1024.0 * 1024.0);
+    printf("  %-24s %9.3f ms/iter %10.1f MB/s\n", name, seconds * 1000.0 / iterations, mb / seconds);
+}
+
+static int run_payload(const char* label, const char* line, size_t bytes, int iterations)
+{
+    char* payload = build_payload(bytes, line);
+    char* copy = (char*)malloc(bytes);
+    if (!payload || !copy)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+
+    printf("%s (%zu bytes, %d iterations)\n", label, bytes, iterations);
+
+    double start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        memcpy(copy, payload, bytes);
+    }
+    report("memcpy", bytes, iterations, now_seconds() - start);
+
+    int valid = 1;
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        valid &= nmb_utf8_is_valid_scalar(payload, bytes);
+    }
+    report("validate scalar", bytes, iterations, now_seconds() - start);
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        valid &= nmb_utf8_is_valid(payload, bytes);
+    }
+    report("validate simd", bytes, iterations, now_seconds() - start);
+
+    NmbSecondaryContentOption secondary;
+    memset(&secondary, 0, sizeof(secondary));
+    secondary.struct_size = sizeof(secondary);
+    secondary.expanded_text_utf8 = payload;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Diagnostics";
+    options.secondary = &secondary;
+
+    start = now_seconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        NmbPreparedOptions prepared;
+        valid &= nmb_prepare_options(&options, &prepared) == NMB_OK;
+        nmb_release_prepared_options(&prepared);
+    }
+    report("prepare (strlen+validate)", bytes, iterations, now_seconds() - start);
+
+    free(copy);
+    free(payload);
+    if (!valid)
+    {
+        fprintf(stderr, "payload unexpectedly rejected\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 16;
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+    if (megabytes == 0 || iterations <= 0)
+    {
+        fprintf(stderr, "usage: %s [payload_megabytes] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const size_t bytes = megabytes * 1024 * 1024;
+    int failures = run_payload("ascii log",
+                               "2024-05-01T12:00:00Z worker-07 GET /api/v1/items status=500 elapsed=12ms caf\xC3\xA9\n",
+                               bytes, iterations);
+    failures += run_payload("cjk text", "\xE8\xA8\xBA\xE6\x96\xAD\xE3\x83\xAD\xE3\x82\xB0: \xE3\x83\x87\xE3\x82\xA3"
+                                        "\xE3\x82\xB9\xE3\x82\xAF\xE5\xAE\xB9\xE9\x87\x8F\xE4\xB8\x8D\xE8\xB6\xB3 "
+                                        "\xF0\x9F\x92\xBE\n",
+                            bytes, iterations);
+    return failures == 0 ? 0 : 1;
+}
@@ -4,18 +4,45 @@
 
 #include <gtk/gtk.h>
 #include <glib.h>
+#include <glib-unix.h>
 #include <gdk/gdkkeysyms.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <string>
 #include <vector>
 #include <utility>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <sys/wait.h>
 #include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include "../../shared/nmb_aggregate.h"
 #include "../../shared/nmb_alloc.h"
+#include "../../shared/nmb_async.h"
+#include "../../shared/nmb_clock.h"
+#include "../../shared/nmb_completion.h"
+#include "../../shared/nmb_dialog_handle.h"
+#include "../../shared/nmb_items.h"
+#include "../../shared/nmb_mapped_file.h"
+#include "../../shared/nmb_message_template.h"
+#include "../../shared/nmb_options.h"
+#include "../../shared/nmb_request.h"
 #include "../../shared/nmb_runtime.h"
+#include "../../shared/nmb_timer_wheel.h"
+#include "../../shared/nmb_timing.h"
+#include "../../shared/nmb_utf8.h"
 #if defined(NMB_TESTING)
 #include "native_message_box_test.h"
 #endif
@@ -28,6 +55,31 @@ namespace
         offsetof(NmbMessageBoxOptions, user_context) + sizeof(void*);
     constexpr size_t kMessageBoxResultMinSize =
         offsetof(NmbMessageBoxResult, result_code) + sizeof(NmbResultCode);
+    constexpr size_t kExpandedChunkBytes = 256 * 1024;
+    constexpr gint kExpandedViewHeight = 240;
+    // A followed log opens on its last kFollowInitialBytes and then reads one batch per idle iteration.
+    constexpr size_t kFollowBatchBytes = 64 * 1024;
+    constexpr off_t kFollowInitialBytes = 1024 * 1024;
+    constexpr uint32_t kDefaultFollowLines = 10000;
+    // Bodies above either limit go into a scrolled text view instead of the dialog's wrapped label.
+    constexpr size_t kLongMessageBytes = 4 * 1024;
+    constexpr size_t kLongMessageLines = 40;
+    // Enough text to fill the capped view before the dialog maps; the rest streams in when idle.
+    constexpr size_t kMessageFirstChunkBytes = 16 * 1024;
+    constexpr gint kMessageViewMaxHeight = 320;
+    constexpr gint kMessageViewWidth = 480;
+    // Dialog deadlines round up to ticks on this boundary of the monotonic clock, so every timeout and countdown
+    // due within one tick, across all open dialogs, shares a single wakeup.
+    constexpr uint32_t kDialogTickMilliseconds = 250;
+    constexpr gint kComboListHeight = 200;
+    constexpr gint kChecklistToggleWidth = 32;
+    constexpr gint kTableHeight = 240;
+    constexpr gint kTableColumnWidth = 160;
+    constexpr size_t kDefaultCompletionResults = 50;
+    constexpr gint kMultilineInputChars = 16 * 1024;
+    constexpr gint kMultilineInputHeight = 160;
+    constexpr guint kFormRowSpacing = 6;
+    constexpr guint kFormColumnSpacing = 12;
 
     NmbResultCode LogInvalid(const char* message)
     {
@@ -36,26 +88,46 @@ namespace
     }
 
 #if defined(NMB_TESTING)
+    bool IsTestHarness(const NmbMessageBoxOptions* options)
+    {
+        const auto* harness = static_cast<const NmbTestHarness*>(options ? options->user_context : nullptr);
+        return harness && harness->magic == NMB_TEST_HARNESS_MAGIC && harness->struct_size == sizeof(NmbTestHarness);
+    }
+
     bool ApplyTestHarness(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
     {
-        if (!options || !options->user_context || !out_result)
+        if (!out_result || !IsTestHarness(options))
         {
             return false;
         }
 
         const NmbTestHarness* harness = static_cast<const NmbTestHarness*>(options->user_context);
-        if (!harness || harness->magic != NMB_TEST_HARNESS_MAGIC || harness->struct_size != sizeof(NmbTestHarness))
-        {
-            return false;
-        }
 
         out_result->button = harness->scripted_button;
         out_result->checkbox_checked = harness->checkbox_checked;
         out_result->was_timeout = harness->simulate_timeout;
         out_result->result_code = harness->result_code;
+
+        const uint32_t timeout = options->timeout_button_id != NMB_BUTTON_ID_NONE ? options->timeout_milliseconds : 0;
+        if (nmb_clock_play_scripted_answer(timeout, harness->answer_after_milliseconds))
+        {
+            out_result->button = options->timeout_button_id;
+            out_result->was_timeout = NMB_TRUE;
+        }
+        nmb_timing_finish(out_result, NMB_BACKEND_HEADLESS);
+
         out_result->input_value_utf8 = nullptr;
 
-        if (harness->input_value_utf8)
+        if (harness->input_value_utf8 && nmb_input_chunk_callback(options->input))
+        {
+            NmbResultCode rc = nmb_deliver_input_text(options, harness->input_value_utf8,
+                                                      std::strlen(harness->input_value_utf8), out_result);
+            if (rc != NMB_OK)
+            {
+                out_result->result_code = rc;
+            }
+        }
+        else if (harness->input_value_utf8)
         {
             if (options->allocator)
             {
@@ -71,6 +143,15 @@ namespace
             }
         }
 
+        NmbResultCode fields_rc =
+            nmb_store_field_values(options, harness->field_values, harness->field_value_count, out_result);
+        if (fields_rc != NMB_OK)
+        {
+            out_result->result_code = fields_rc;
+        }
+
+        nmb_store_selection(options, harness->selection_bits, out_result);
+
         return true;
     }
 #endif
@@ -130,6 +211,343 @@ namespace
         return NMB_OK;
     }
 
+    // Text fed into a GtkTextView one chunk per idle iteration so the dialog keeps painting and handling
+    // input. data points either into the caller's options or into file, when the text is a mapped source.
+    struct LazyTextView
+    {
+        NmbMappedFile file = {};
+        const char* data = nullptr;
+        size_t length = 0;
+        GtkTextBuffer* buffer = nullptr;
+        GtkWidget* textView = nullptr;
+        size_t loaded = 0;
+        guint idleSource = 0;
+        size_t matchOffset = 0;
+        std::vector<std::pair<size_t, gint>> chunkStarts; // text byte offset -> buffer char offset
+        std::vector<char> repaired;
+
+        LazyTextView() = default;
+        LazyTextView(const LazyTextView&) = delete;
+        LazyTextView& operator=(const LazyTextView&) = delete;
+
+        ~LazyTextView()
+        {
+            if (idleSource != 0)
+            {
+                g_source_remove(idleSource);
+            }
+            nmb_mapped_file_close(&file);
+        }
+    };
+
+    // A log followed like tail -f. inotify wakes the GLib loop when the file changes; the appended bytes are
+    // then read and inserted at most kFollowBatchBytes per idle iteration, and the oldest lines are dropped
+    // once the buffer holds more than maxLines, so a chatty log costs bounded memory and frame time.
+    struct FollowView
+    {
+        int fd = -1;
+        int notify = -1;
+        guint notifySource = 0;
+        guint readSource = 0;
+        off_t position = 0;
+        off_t origin = 0;
+        uint32_t maxLines = kDefaultFollowLines;
+        bool skipPartialLine = false;
+        std::vector<char> pending; // read but not shown yet: the start of a UTF-8 sequence cut by the read
+        std::vector<char> repaired;
+        GtkTextBuffer* buffer = nullptr;
+        GtkWidget* textView = nullptr;
+        GtkWidget* scrolled = nullptr;
+        GtkTextMark* end = nullptr;
+
+        FollowView() = default;
+        FollowView(const FollowView&) = delete;
+        FollowView& operator=(const FollowView&) = delete;
+
+        ~FollowView()
+        {
+            if (readSource != 0)
+            {
+                g_source_remove(readSource);
+            }
+            if (notifySource != 0)
+            {
+                g_source_remove(notifySource);
+            }
+            if (notify >= 0)
+            {
+                close(notify);
+            }
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+    };
+
+    // Combo items supplied as an NmbItemBuffer, and the items of a multiselect checklist. The list store
+    // holds item indices only and the renderer reads text straight from the caller's buffer, so no per-item
+    // strings exist; fixed-height mode lets GTK measure one row instead of every row. A checklist keeps its
+    // state as one bit per item, so toggling and filtering never touch per-row objects.
+    struct ComboListView
+    {
+        const NmbItemBuffer* items = nullptr;
+        NmbItemIndex index = {};
+        std::vector<uint32_t> matches;
+        size_t matchCount = 0;
+        std::string cellText;
+        GtkListStore* store = nullptr;
+        GtkWidget* treeView = nullptr;
+        std::vector<uint8_t> checked;
+        // Checklist items passed as combo_items_utf8, packed so both item sources render the same way.
+        NmbItemBuffer packed = {};
+        std::string packedData;
+        std::vector<uint32_t> packedOffsets;
+
+        ComboListView() = default;
+        ComboListView(const ComboListView&) = delete;
+        ComboListView& operator=(const ComboListView&) = delete;
+
+        ~ComboListView()
+        {
+            nmb_item_index_release(&index);
+            if (store)
+            {
+                g_object_unref(store);
+            }
+        }
+    };
+
+    struct TableView;
+
+    // Identifies a column to the renderer and header callbacks shared by every column.
+    struct TableColumn
+    {
+        TableView* view = nullptr;
+        size_t index = 0;
+        GtkTreeViewColumn* column = nullptr;
+    };
+
+    // An NmbTableOption shown as a list. Like ComboListView, the store holds row indices only and every cell is
+    // read from the caller's column buffers when GTK draws it, so only visible rows are ever turned into text.
+    // Sorting reorders the store in place rather than rebuilding it.
+    struct TableView
+    {
+        const NmbTableOption* table = nullptr;
+        std::vector<TableColumn> columns;
+        std::vector<uint32_t> order; // row shown at each position
+        std::vector<uint32_t> scratch;
+        std::string cellText;
+        size_t sortColumn = SIZE_MAX;
+        bool descending = false;
+        GtkListStore* store = nullptr;
+        GtkWidget* treeView = nullptr;
+
+        TableView() = default;
+        TableView(const TableView&) = delete;
+        TableView& operator=(const TableView&) = delete;
+
+        ~TableView()
+        {
+            if (store)
+            {
+                g_object_unref(store);
+            }
+        }
+    };
+
+    // Autocomplete for a text entry over a shared NmbCompletionIndex. While the text only grows, each
+    // keystroke narrows the previous match range instead of searching the whole corpus, and at most
+    // maxResults suggestions are copied into the popup model.
+    struct CompletionPopup
+    {
+        const NmbCompletionIndex* index = nullptr;
+        NmbCompletionRange range = {};
+        std::string prefix;
+        size_t maxResults = kDefaultCompletionResults;
+        GtkListStore* store = nullptr;
+        GtkEntryCompletion* completion = nullptr;
+
+        CompletionPopup() = default;
+        CompletionPopup(const CompletionPopup&) = delete;
+        CompletionPopup& operator=(const CompletionPopup&) = delete;
+
+        ~CompletionPopup()
+        {
+            if (completion)
+            {
+                g_object_unref(completion);
+            }
+            if (store)
+            {
+                g_object_unref(store);
+            }
+        }
+    };
+
+    // The control holding the answer to one field of a form dialog.
+    struct FormField
+    {
+        NmbInputMode mode = NMB_INPUT_NONE;
+        GtkWidget* widget = nullptr;
+    };
+
+    struct GtkDialogInfo;
+
+    // Every dialog deadline lives in one timer wheel, driven by one GSource on the default main context whose
+    // ready time is the wheel's next tick with something due. UI thread only.
+    struct DialogTimers
+    {
+        NmbTimerWheel wheel = {};
+        GSource* source = nullptr;
+    };
+
+    // Times are read from the runtime clock, which tests may swap for a virtual one.
+    uint64_t NowMilliseconds()
+    {
+        return nmb_clock_now_milliseconds();
+    }
+
+    void WakeMainContext()
+    {
+        g_main_context_wakeup(nullptr);
+    }
+
+    // GSource ready time for a deadline on the runtime clock. A virtual clock only moves when a test advances
+    // it, so its deadlines are left to the sources' prepare functions, which the clock's wake gets re-run.
+    gint64 ReadyTime(uint64_t deadline)
+    {
+        const uint64_t now = NowMilliseconds();
+        if (deadline <= now)
+        {
+            return 0;
+        }
+        if (nmb_clock_is_virtual())
+        {
+            return -1;
+        }
+        return g_get_monotonic_time() + static_cast<gint64>(deadline - now) * 1000;
+    }
+
+    DialogTimers& Timers()
+    {
+        static DialogTimers timers = [] {
+            DialogTimers created;
+            nmb_timer_wheel_init(&created.wheel, kDialogTickMilliseconds, NowMilliseconds());
+            return created;
+        }();
+        return timers;
+    }
+
+    void ArmDialogTimers();
+
+    gboolean PrepareDialogTimers(GSource*, gint* timeout)
+    {
+        *timeout = -1;
+        uint64_t next = 0;
+        return nmb_clock_is_virtual() && nmb_timer_wheel_next_deadline(&Timers().wheel, &next) &&
+               next <= NowMilliseconds();
+    }
+
+    gboolean DispatchDialogTimers(GSource*, GSourceFunc, gpointer)
+    {
+        nmb_timer_wheel_advance(&Timers().wheel, NowMilliseconds());
+        ArmDialogTimers();
+        return G_SOURCE_CONTINUE;
+    }
+
+    GSourceFuncs kDialogTimerSourceFuncs = { PrepareDialogTimers, nullptr, DispatchDialogTimers, nullptr, nullptr,
+                                             nullptr };
+
+    // Sleeps the source until the earliest pending tick, or indefinitely when the wheel is empty.
+    void ArmDialogTimers()
+    {
+        DialogTimers& timers = Timers();
+        uint64_t next = 0;
+        const bool pending = nmb_timer_wheel_next_deadline(&timers.wheel, &next) == NMB_TRUE;
+        if (!timers.source)
+        {
+            if (!pending)
+            {
+                return;
+            }
+            timers.source = g_source_new(&kDialogTimerSourceFuncs, sizeof(GSource));
+            g_source_attach(timers.source, nullptr);
+            nmb_clock_set_wake(WakeMainContext);
+        }
+        g_source_set_ready_time(timers.source, pending ? ReadyTime(next) : -1);
+    }
+
+    void ScheduleDialogTimer(NmbTimer* timer, uint64_t deadline)
+    {
+        nmb_timer_wheel_schedule(&Timers().wheel, timer, deadline);
+        ArmDialogTimers();
+    }
+
+    // The timeout of one dialog and, with NMB_MESSAGE_BOX_FLAG_SHOW_COUNTDOWN, the countdown on its timeout
+    // button. The countdown only wakes when the whole seconds left change.
+    struct DialogDeadline
+    {
+        NmbTimer timeout = {};
+        NmbTimer countdown = {};
+        uint64_t deadline = 0;
+        GtkWidget* button = nullptr;
+        std::string label;
+
+        DialogDeadline() = default;
+        DialogDeadline(const DialogDeadline&) = delete;
+        DialogDeadline& operator=(const DialogDeadline&) = delete;
+
+        ~DialogDeadline()
+        {
+            Cancel();
+        }
+
+        void Cancel()
+        {
+            nmb_timer_wheel_cancel(&Timers().wheel, &timeout);
+            nmb_timer_wheel_cancel(&Timers().wheel, &countdown);
+        }
+    };
+
+    void UpdateCountdown(void* data)
+    {
+        auto* deadline = static_cast<DialogDeadline*>(data);
+        const uint64_t now = NowMilliseconds();
+        const uint64_t left = deadline->deadline > now ? deadline->deadline - now : 0;
+        const uint64_t seconds = (left + 999) / 1000;
+
+        gchar* text = g_strdup_printf("%s (Closing in %us)", deadline->label.c_str(), static_cast<unsigned>(seconds));
+        gtk_button_set_label(GTK_BUTTON(deadline->button), text);
+        g_free(text);
+        if (seconds > 1)
+        {
+            ScheduleDialogTimer(&deadline->countdown, deadline->deadline - (seconds - 1) * 1000);
+        }
+    }
+
+    // Connects a showing dialog to the caller's NmbDialogHandle. Updates wake the UI thread through at most
+    // one idle source at a time, which is found again by its data on teardown so no source id crosses threads.
+    struct LiveDialog
+    {
+        NmbDialogHandle* handle = nullptr;
+        GtkDialogInfo* info = nullptr;
+        std::string message; // backs the message body once a long message has been replaced
+
+        LiveDialog() = default;
+        LiveDialog(const LiveDialog&) = delete;
+        LiveDialog& operator=(const LiveDialog&) = delete;
+
+        ~LiveDialog()
+        {
+            if (handle)
+            {
+                nmb_dialog_handle_detach(handle);
+            }
+            g_source_remove_by_user_data(this);
+        }
+    };
+
     struct GtkDialogInfo
     {
         GtkWidget* dialog = nullptr;
@@ -139,22 +557,66 @@ namespace
         NmbInputMode inputMode = NMB_INPUT_NONE;
         std::vector<std::pair<int, NmbButtonId>> buttonMap;
         int timeoutResponse = 0;
+        std::unique_ptr<DialogDeadline> deadline;
         bool timedOut = false;
         bool allowClose = true;
         bool requiresExplicitAck = false;
+        std::unique_ptr<LazyTextView> messageBody;
+        std::unique_ptr<LazyTextView> expandedSource;
+        std::unique_ptr<FollowView> follow;
+        std::unique_ptr<ComboListView> comboList;
+        std::unique_ptr<CompletionPopup> completion;
+        std::vector<FormField> formFields;
+        std::unique_ptr<TableView> table;
+        std::unique_ptr<LiveDialog> live;
     };
 
-    gboolean TimeoutCallback(gpointer data)
+    void TimeoutCallback(void* data)
     {
         auto* info = static_cast<GtkDialogInfo*>(data);
         if (!info || !info->dialog)
         {
-            return G_SOURCE_REMOVE;
+            return;
         }
 
+        info->deadline->Cancel();
         info->timedOut = true;
         gtk_dialog_response(GTK_DIALOG(info->dialog), info->timeoutResponse);
-        return G_SOURCE_REMOVE;
+    }
+
+    // Arms the dialog's timeout on the shared wheel and, when asked for, the countdown on its timeout button.
+    void StartDialogDeadline(const NmbMessageBoxOptions* options, GtkDialogInfo* info)
+    {
+        info->deadline.reset(new DialogDeadline());
+        DialogDeadline& deadline = *info->deadline;
+        deadline.deadline = NowMilliseconds() + options->timeout_milliseconds;
+        nmb_timer_init(&deadline.timeout, TimeoutCallback, info);
+        ScheduleDialogTimer(&deadline.timeout, deadline.deadline);
+
+        const uint32_t flags = NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, flags) ? options->flags : 0;
+        if ((flags & NMB_MESSAGE_BOX_FLAG_SHOW_COUNTDOWN) == 0)
+        {
+            return;
+        }
+
+        GtkWidget* button = gtk_dialog_get_widget_for_response(GTK_DIALOG(info->dialog), info->timeoutResponse);
+        if (!button || !GTK_IS_BUTTON(button))
+        {
+            return;
+        }
+
+        const gchar* label = gtk_button_get_label(GTK_BUTTON(button));
+        deadline.button = button;
+        deadline.label = label ? label : "";
+        nmb_timer_init(&deadline.countdown, UpdateCountdown, &deadline);
+        UpdateCountdown(&deadline);
+    }
+
+    // Toplevel windows select structure events, so the first map-event is the dialog reaching the screen.
+    gboolean OnDialogMapped(GtkWidget*, GdkEvent*, gpointer data)
+    {
+        nmb_timing_mark(static_cast<NmbMessageBoxResult*>(data), NMB_TIMING_MAPPED);
+        return FALSE;
     }
 
     gboolean OnDeleteEvent(GtkWidget*, GdkEvent*, gpointer data)
@@ -187,152 +649,1325 @@ namespace
         return FALSE;
     }
 
-    GtkMessageType MapMessageType(NmbIcon icon, NmbSeverity severity)
+    void AppendTextChunk(LazyTextView* view, size_t limit)
     {
-        switch (icon)
+        const char* start = view->data + view->loaded;
+        const size_t length = nmb_text_chunk_end(start, view->length - view->loaded, limit);
+        view->chunkStarts.emplace_back(view->loaded, gtk_text_buffer_get_char_count(view->buffer));
+
+        GtkTextIter end;
+        gtk_text_buffer_get_end_iter(view->buffer, &end);
+        if (nmb_utf8_is_valid(start, length))
         {
-        case NMB_ICON_WARNING:
-            return GTK_MESSAGE_WARNING;
-        case NMB_ICON_ERROR:
-            return GTK_MESSAGE_ERROR;
-        case NMB_ICON_QUESTION:
-            return GTK_MESSAGE_QUESTION;
-        case NMB_ICON_SHIELD:
-            return GTK_MESSAGE_OTHER;
-        default:
-            break;
+            gtk_text_buffer_insert(view->buffer, &end, start, static_cast<gint>(length));
         }
-
-        if (severity == NMB_SEVERITY_CRITICAL)
+        else
         {
-            return GTK_MESSAGE_ERROR;
+            view->repaired.resize(NMB_UTF8_REPAIR_MAX(length));
+            const size_t written = nmb_utf8_repair(start, length, view->repaired.data());
+            gtk_text_buffer_insert(view->buffer, &end, view->repaired.data(), static_cast<gint>(written));
         }
 
-        return GTK_MESSAGE_INFO;
+        view->loaded += length;
     }
 
-    bool EnsureGtkInitialized()
+    gboolean LoadTextChunk(gpointer data)
     {
-        static bool initialized = false;
-        static bool available = false;
-        if (!initialized)
+        auto* view = static_cast<LazyTextView*>(data);
+        AppendTextChunk(view, kExpandedChunkBytes);
+        if (view->loaded < view->length)
         {
-            initialized = true;
-            available = gtk_init_check(nullptr, nullptr);
+            return G_SOURCE_CONTINUE;
         }
 
-        return available;
+        view->idleSource = 0;
+        return G_SOURCE_REMOVE;
     }
 
-    NmbResultCode CopyInputValue(const NmbMessageBoxOptions* options, GtkDialogInfo* info, NmbMessageBoxResult* out_result)
+    void StartTextLoading(LazyTextView* view)
     {
-        if (!info || !info->inputWidget)
+        if (view->idleSource == 0 && view->loaded < view->length)
         {
-            out_result->input_value_utf8 = nullptr;
-            return NMB_OK;
+            view->idleSource = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, LoadTextChunk, view, nullptr);
         }
+    }
 
-        switch (info->inputMode)
-        {
-        case NMB_INPUT_TEXT:
-        case NMB_INPUT_PASSWORD:
+    void OnExpanderToggled(GObject* expander, GParamSpec*, gpointer data)
+    {
+        if (gtk_expander_get_expanded(GTK_EXPANDER(expander)))
         {
-            const char* text = gtk_entry_get_text(GTK_ENTRY(info->inputWidget));
-            return nmb_copy_string_to_allocator(options->allocator, text, &out_result->input_value_utf8);
+            StartTextLoading(static_cast<LazyTextView*>(data));
         }
-        case NMB_INPUT_COMBO:
-        {
-            gchar* active = gtk_combo_box_text_get_active_text(GTK_COMBO_BOX_TEXT(info->inputWidget));
-            if (!active)
-            {
-                out_result->input_value_utf8 = nullptr;
-                return NMB_OK;
-            }
+    }
 
-            NmbResultCode rc = nmb_copy_string_to_allocator(options->allocator, active, &out_result->input_value_utf8);
-            g_free(active);
-            return rc;
-        }
-        case NMB_INPUT_CHECKBOX:
-        {
-            if (info->inputCheckbox)
-            {
-                gboolean active = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(info->inputCheckbox));
-                out_result->checkbox_checked = active ? NMB_TRUE : NMB_FALSE;
-            }
-            out_result->input_value_utf8 = nullptr;
-            return NMB_OK;
-        }
-        default:
-            out_result->input_value_utf8 = nullptr;
-            return NMB_OK;
-        }
+    GtkWidget* CreateLazyTextView(LazyTextView* view)
+    {
+        GtkWidget* scrolled = gtk_scrolled_window_new(nullptr, nullptr);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+
+        view->textView = gtk_text_view_new();
+        view->buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->textView));
+        gtk_text_view_set_editable(GTK_TEXT_VIEW(view->textView), FALSE);
+        gtk_container_add(GTK_CONTAINER(scrolled), view->textView);
+        return scrolled;
     }
 
-    bool MapButtonId(const GtkDialogInfo& info, int response, NmbButtonId* outId)
+    // Maps a byte offset in the text to a character offset in the buffer. Chunks that needed repair
+    // can drift by a few characters, which only moves the highlight, never past the buffer end.
+    gint TextCharOffset(const LazyTextView& view, size_t byteOffset)
     {
-        for (const auto& pair : info.buttonMap)
+        auto chunk = std::upper_bound(view.chunkStarts.begin(), view.chunkStarts.end(), byteOffset,
+                                      [](size_t offset, const std::pair<size_t, gint>& start)
+                                      { return offset < start.first; });
+        if (chunk == view.chunkStarts.begin())
         {
-            if (pair.first == response)
-            {
-                if (outId)
-                {
-                    *outId = pair.second;
-                }
-                return true;
-            }
+            return 0;
         }
 
-        return false;
+        --chunk;
+        const char* start = view.data + chunk->first;
+        return chunk->second + static_cast<gint>(g_utf8_strlen(start, static_cast<gssize>(byteOffset - chunk->first)));
     }
 
-    bool RunZenityFallback(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    void SelectExpandedMatch(LazyTextView* view, size_t offset, size_t length)
     {
-        if (!options || options->input != nullptr || (options->buttons && options->button_count > 1))
-        {
-            return false;
-        }
-
-        gchar* zenity = g_find_program_in_path("zenity");
-        if (!zenity)
+        // The match may lie beyond what the idle loader has reached; pull in the chunks up to it now.
+        while (view->loaded < offset + length)
         {
-            return false;
+            AppendTextChunk(view, kExpandedChunkBytes);
         }
 
-        std::vector<char*> args;
-        args.push_back(zenity);
+        GtkTextIter start;
+        GtkTextIter end;
+        gtk_text_buffer_get_iter_at_offset(view->buffer, &start, TextCharOffset(*view, offset));
+        gtk_text_buffer_get_iter_at_offset(view->buffer, &end, TextCharOffset(*view, offset + length));
+        gtk_text_buffer_select_range(view->buffer, &start, &end);
+        gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(view->textView), &start, 0.0, TRUE, 0.0, 0.5);
+    }
 
-        switch (options->icon)
+    // Searches the mapped bytes rather than the text buffer, so matches are found even in parts of the
+    // file that have not been loaded yet.
+    void FindExpandedText(LazyTextView* view, GtkWidget* entry, size_t from)
+    {
+        const char* needle = gtk_entry_get_text(GTK_ENTRY(entry));
+        const size_t needleLength = needle ? std::strlen(needle) : 0;
+        if (needleLength == 0)
         {
-        case NMB_ICON_WARNING:
-            args.push_back(g_strdup("--warning"));
-            break;
-        case NMB_ICON_ERROR:
-            args.push_back(g_strdup("--error"));
-            break;
-        case NMB_ICON_QUESTION:
-            args.push_back(g_strdup("--question"));
-            break;
-        default:
-            args.push_back(g_strdup("--info"));
-            break;
+            view->matchOffset = 0;
+            return;
         }
 
-        args.push_back(g_strdup("--no-wrap"));
-
-        if (options->title_utf8)
+        size_t hit = nmb_text_find(view->data, view->length, needle, needleLength, from);
+        if (hit == NMB_TEXT_NOT_FOUND && from > 0)
         {
-            args.push_back(g_strdup_printf("--title=%s", options->title_utf8));
+            hit = nmb_text_find(view->data, view->length, needle, needleLength, 0);
         }
 
-        if (options->message_utf8)
+        if (hit == NMB_TEXT_NOT_FOUND)
         {
-            args.push_back(g_strdup_printf("--text=%s", options->message_utf8));
+            gtk_widget_error_bell(entry);
+            return;
         }
 
-        args.push_back(nullptr);
+        view->matchOffset = hit;
+        SelectExpandedMatch(view, hit, needleLength);
+    }
 
-        GError* error = nullptr;
+    void OnExpandedSearchChanged(GtkWidget* entry, gpointer data)
+    {
+        auto* view = static_cast<LazyTextView*>(data);
+        FindExpandedText(view, entry, view->matchOffset);
+    }
+
+    void OnExpandedSearchNext(GtkWidget* entry, gpointer data)
+    {
+        auto* view = static_cast<LazyTextView*>(data);
+        FindExpandedText(view, entry, view->matchOffset + 1);
+    }
+
+    NmbResultCode AddExpandedSource(const NmbContentSource* source, GtkBox* content, GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<LazyTextView>();
+        NmbResultCode rc = nmb_mapped_file_open(source, &view->file);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+        view->data = view->file.data;
+        view->length = view->file.length;
+
+        GtkWidget* expander = gtk_expander_new("More details");
+        GtkWidget* box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+        GtkWidget* search = gtk_search_entry_new();
+        GtkWidget* scrolled = CreateLazyTextView(view.get());
+        gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(scrolled), kExpandedViewHeight);
+        gtk_text_view_set_monospace(GTK_TEXT_VIEW(view->textView), TRUE);
+
+        gtk_box_pack_start(GTK_BOX(box), search, FALSE, FALSE, 0);
+        gtk_box_pack_start(GTK_BOX(box), scrolled, TRUE, TRUE, 0);
+        gtk_container_add(GTK_CONTAINER(expander), box);
+        gtk_box_pack_start(content, expander, FALSE, FALSE, 0);
+
+        g_signal_connect(expander, "notify::expanded", G_CALLBACK(OnExpanderToggled), view.get());
+        g_signal_connect(search, "search-changed", G_CALLBACK(OnExpandedSearchChanged), view.get());
+        g_signal_connect(search, "activate", G_CALLBACK(OnExpandedSearchNext), view.get());
+        g_signal_connect(search, "next-match", G_CALLBACK(OnExpandedSearchNext), view.get());
+
+        info->expandedSource = std::move(view);
+        return NMB_OK;
+    }
+
+    // Bytes of data that end on a whole UTF-8 sequence; a sequence cut by the last read waits for the next one.
+    size_t CompleteSequenceLength(const char* data, size_t length)
+    {
+        size_t lead = length;
+        while (lead > 0 && length - lead < 3 && (static_cast<unsigned char>(data[lead - 1]) & 0xC0u) == 0x80u)
+        {
+            --lead;
+        }
+        if (lead == 0)
+        {
+            return length;
+        }
+
+        const unsigned char byte = static_cast<unsigned char>(data[lead - 1]);
+        const size_t needed = byte >= 0xF0u ? 4 : byte >= 0xE0u ? 3 : byte >= 0xC0u ? 2 : 1;
+        return length - (lead - 1) < needed ? lead - 1 : length;
+    }
+
+    void TrimFollowedLines(FollowView* view)
+    {
+        const gint excess = gtk_text_buffer_get_line_count(view->buffer) - static_cast<gint>(view->maxLines);
+        if (excess > 0)
+        {
+            GtkTextIter start;
+            GtkTextIter cut;
+            gtk_text_buffer_get_start_iter(view->buffer, &start);
+            gtk_text_buffer_get_iter_at_line(view->buffer, &cut, excess);
+            gtk_text_buffer_delete(view->buffer, &start, &cut);
+        }
+    }
+
+    void AppendFollowedText(FollowView* view, const char* data, size_t length)
+    {
+        GtkAdjustment* scroll = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(view->scrolled));
+        const bool atBottom = gtk_adjustment_get_value(scroll) + gtk_adjustment_get_page_size(scroll) >=
+                              gtk_adjustment_get_upper(scroll) - 1.0;
+
+        GtkTextIter end;
+        gtk_text_buffer_get_end_iter(view->buffer, &end);
+        if (nmb_utf8_is_valid(data, length))
+        {
+            gtk_text_buffer_insert(view->buffer, &end, data, static_cast<gint>(length));
+        }
+        else
+        {
+            view->repaired.resize(NMB_UTF8_REPAIR_MAX(length));
+            const size_t written = nmb_utf8_repair(data, length, view->repaired.data());
+            gtk_text_buffer_insert(view->buffer, &end, view->repaired.data(), static_cast<gint>(written));
+        }
+
+        TrimFollowedLines(view);
+        if (atBottom)
+        {
+            gtk_text_view_scroll_to_mark(GTK_TEXT_VIEW(view->textView), view->end, 0.0, FALSE, 0.0, 0.0);
+        }
+    }
+
+    // Starts over when the file shrank below what was already shown, as a log truncated in place does.
+    void RestartIfTruncated(FollowView* view)
+    {
+        struct stat info = {};
+        if (fstat(view->fd, &info) == 0 && info.st_size < view->position)
+        {
+            view->position = std::min(view->origin, static_cast<off_t>(info.st_size));
+            view->pending.clear();
+            view->skipPartialLine = false;
+            lseek(view->fd, view->position, SEEK_SET);
+            gtk_text_buffer_set_text(view->buffer, "", 0);
+        }
+    }
+
+    gboolean ReadFollowedBatch(gpointer data)
+    {
+        auto* view = static_cast<FollowView*>(data);
+        const size_t kept = view->pending.size();
+        view->pending.resize(kept + kFollowBatchBytes);
+        const ssize_t count = read(view->fd, view->pending.data() + kept, kFollowBatchBytes);
+        view->pending.resize(kept + (count > 0 ? static_cast<size_t>(count) : 0));
+        if (count <= 0)
+        {
+            RestartIfTruncated(view);
+            view->readSource = 0;
+            return G_SOURCE_REMOVE;
+        }
+
+        view->position += count;
+        size_t start = 0;
+        if (view->skipPartialLine)
+        {
+            const char* lineEnd = static_cast<const char*>(memchr(view->pending.data(), '\n', view->pending.size()));
+            start = lineEnd ? static_cast<size_t>(lineEnd - view->pending.data()) + 1 : view->pending.size();
+            view->skipPartialLine = lineEnd == nullptr;
+        }
+
+        const size_t ready = start + CompleteSequenceLength(view->pending.data() + start, view->pending.size() - start);
+        if (ready > start)
+        {
+            AppendFollowedText(view, view->pending.data() + start, ready - start);
+        }
+        view->pending.erase(view->pending.begin(), view->pending.begin() + static_cast<std::ptrdiff_t>(ready));
+        return G_SOURCE_CONTINUE;
+    }
+
+    void StartFollowedRead(FollowView* view)
+    {
+        if (view->readSource == 0)
+        {
+            view->readSource = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, ReadFollowedBatch, view, nullptr);
+        }
+    }
+
+    // Every event only means "the file changed"; the events themselves are drained and reading catches up.
+    gboolean OnFollowedFileChanged(gint fd, GIOCondition, gpointer data)
+    {
+        alignas(struct inotify_event) char events[4096];
+        while (read(fd, events, sizeof(events)) > 0)
+        {
+        }
+
+        StartFollowedRead(static_cast<FollowView*>(data));
+        return G_SOURCE_CONTINUE;
+    }
+
+    // Shows the tail of a growing log in the expander: the last kFollowInitialBytes already written (from the
+    // first whole line), then everything appended while the dialog is open.
+    NmbResultCode AddFollowedSource(const NmbContentSource* source, GtkBox* content, GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<FollowView>();
+        view->fd = open(source->path_utf8, O_RDONLY | O_CLOEXEC);
+        struct stat status = {};
+        if (view->fd < 0 || fstat(view->fd, &status) != 0)
+        {
+            nmb_runtime_log("Linux: could not open the followed NmbContentSource.path_utf8.");
+            return NMB_E_INVALID_ARGUMENT;
+        }
+
+        view->notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (view->notify < 0 || inotify_add_watch(view->notify, source->path_utf8, IN_MODIFY) < 0)
+        {
+            nmb_runtime_log("Linux: could not watch the followed NmbContentSource.path_utf8.");
+            return NMB_E_PLATFORM_FAILURE;
+        }
+
+        view->origin = static_cast<off_t>(std::min<uint64_t>(source->offset, static_cast<uint64_t>(status.st_size)));
+        view->position = view->origin;
+        if (status.st_size - view->origin > kFollowInitialBytes)
+        {
+            view->position = status.st_size - kFollowInitialBytes;
+            view->skipPartialLine = true;
+        }
+        lseek(view->fd, view->position, SEEK_SET);
+        if (source->follow_max_lines > 0)
+        {
+            view->maxLines = source->follow_max_lines;
+        }
+
+        GtkWidget* expander = gtk_expander_new("More details");
+        view->scrolled = gtk_scrolled_window_new(nullptr, nullptr);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(view->scrolled), GTK_POLICY_AUTOMATIC,
+                                       GTK_POLICY_AUTOMATIC);
+        gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(view->scrolled), kExpandedViewHeight);
+        view->textView = gtk_text_view_new();
+        view->buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->textView));
+        gtk_text_view_set_editable(GTK_TEXT_VIEW(view->textView), FALSE);
+        gtk_text_view_set_monospace(GTK_TEXT_VIEW(view->textView), TRUE);
+
+        GtkTextIter end;
+        gtk_text_buffer_get_end_iter(view->buffer, &end);
+        view->end = gtk_text_buffer_create_mark(view->buffer, nullptr, &end, FALSE);
+
+        gtk_container_add(GTK_CONTAINER(view->scrolled), view->textView);
+        gtk_container_add(GTK_CONTAINER(expander), view->scrolled);
+        gtk_box_pack_start(content, expander, FALSE, FALSE, 0);
+
+        view->notifySource = g_unix_fd_add(view->notify, G_IO_IN, OnFollowedFileChanged, view.get());
+        StartFollowedRead(view.get());
+        info->follow = std::move(view);
+        return NMB_OK;
+    }
+
+    // Places a long body under the (empty) primary label, ahead of the secondary text. The view's height
+    // follows its content up to kMessageViewMaxHeight, and only the first screenful is laid out before the
+    // dialog maps.
+    void AddMessageBody(const char* message, size_t length, GtkWidget* dialog, GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<LazyTextView>();
+        view->data = message;
+        view->length = length;
+
+        GtkWidget* scrolled = CreateLazyTextView(view.get());
+        gtk_scrolled_window_set_max_content_height(GTK_SCROLLED_WINDOW(scrolled), kMessageViewMaxHeight);
+        gtk_scrolled_window_set_propagate_natural_height(GTK_SCROLLED_WINDOW(scrolled), TRUE);
+        gtk_widget_set_size_request(scrolled, kMessageViewWidth, -1);
+        gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(view->textView), GTK_WRAP_WORD_CHAR);
+        gtk_text_view_set_cursor_visible(GTK_TEXT_VIEW(view->textView), FALSE);
+
+        GtkWidget* area = gtk_message_dialog_get_message_area(GTK_MESSAGE_DIALOG(dialog));
+        gtk_box_pack_start(GTK_BOX(area), scrolled, TRUE, TRUE, 0);
+        gtk_box_reorder_child(GTK_BOX(area), scrolled, 1);
+
+        AppendTextChunk(view.get(), kMessageFirstChunkBytes);
+        StartTextLoading(view.get());
+        info->messageBody = std::move(view);
+    }
+
+    void SetLiveMessage(LiveDialog* live, const char* message)
+    {
+        LazyTextView* body = live->info->messageBody.get();
+        if (!body)
+        {
+            g_object_set(live->info->dialog, "text", message, nullptr);
+            return;
+        }
+
+        // A long message keeps its text view; the new text streams into the same buffer.
+        if (body->idleSource != 0)
+        {
+            g_source_remove(body->idleSource);
+            body->idleSource = 0;
+        }
+        live->message = message;
+        body->data = live->message.data();
+        body->length = live->message.size();
+        body->loaded = 0;
+        body->chunkStarts.clear();
+        gtk_text_buffer_set_text(body->buffer, "", 0);
+        AppendTextChunk(body, kMessageFirstChunkBytes);
+        StartTextLoading(body);
+    }
+
+    // Applies every change waiting on the handle to the existing widgets; nothing is rebuilt.
+    void ApplyDialogChanges(LiveDialog* live)
+    {
+        NmbDialogChanges changes;
+        nmb_dialog_handle_take(live->handle, &changes);
+        GtkDialogInfo* info = live->info;
+        if (changes.flags & NMB_DIALOG_UPDATE_MESSAGE)
+        {
+            SetLiveMessage(live, changes.message);
+        }
+        if (changes.flags & NMB_DIALOG_UPDATE_INFORMATIVE_TEXT)
+        {
+            g_object_set(info->dialog, "secondary-text", changes.informative_text, nullptr);
+        }
+        for (size_t i = 0; i < changes.button_count; ++i)
+        {
+            for (const auto& pair : info->buttonMap)
+            {
+                if (pair.second == changes.buttons[i].id)
+                {
+                    gtk_dialog_set_response_sensitive(GTK_DIALOG(info->dialog), pair.first,
+                                                      changes.buttons[i].enabled ? TRUE : FALSE);
+                }
+            }
+        }
+        nmb_dialog_changes_release(&changes);
+    }
+
+    gboolean ApplyLiveUpdates(gpointer data)
+    {
+        ApplyDialogChanges(static_cast<LiveDialog*>(data));
+        return G_SOURCE_REMOVE;
+    }
+
+    void WakeLiveDialog(void* context)
+    {
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, ApplyLiveUpdates, context, nullptr);
+    }
+
+    // Changes made before the dialog opened are applied here, before it is first shown.
+    NmbResultCode AttachDialogHandle(NmbDialogHandle* handle, GtkDialogInfo* info)
+    {
+        auto live = std::make_unique<LiveDialog>();
+        live->info = info;
+        if (!nmb_dialog_handle_attach(handle, WakeLiveDialog, live.get()))
+        {
+            nmb_runtime_log("Linux: NmbMessageBoxOptions.dialog_handle is already attached to a showing dialog.");
+            return NMB_E_INVALID_ARGUMENT;
+        }
+
+        live->handle = handle;
+        ApplyDialogChanges(live.get());
+        info->live = std::move(live);
+        return NMB_OK;
+    }
+
+    void RenderComboItem(GtkTreeViewColumn*, GtkCellRenderer* cell, GtkTreeModel* model, GtkTreeIter* iter,
+                         gpointer data)
+    {
+        auto* view = static_cast<ComboListView*>(data);
+        guint item = 0;
+        gtk_tree_model_get(model, iter, 0, &item, -1);
+        view->cellText.assign(nmb_item_data(view->items, item), nmb_item_length(view->items, item));
+        g_object_set(cell, "text", view->cellText.c_str(), nullptr);
+    }
+
+    void FillComboList(ComboListView* view)
+    {
+        // Detached while refilling so the view does not relayout after every inserted row.
+        gtk_tree_view_set_model(GTK_TREE_VIEW(view->treeView), nullptr);
+        gtk_list_store_clear(view->store);
+        for (size_t i = 0; i < view->matchCount; ++i)
+        {
+            gtk_list_store_insert_with_values(view->store, nullptr, -1, 0, static_cast<guint>(view->matches[i]), -1);
+        }
+        gtk_tree_view_set_model(GTK_TREE_VIEW(view->treeView), GTK_TREE_MODEL(view->store));
+    }
+
+    void SelectComboRow(ComboListView* view, size_t row)
+    {
+        GtkTreeModel* model = GTK_TREE_MODEL(view->store);
+        GtkTreeIter iter;
+        if (!gtk_tree_model_iter_nth_child(model, &iter, nullptr, static_cast<gint>(row)))
+        {
+            return;
+        }
+
+        gtk_tree_selection_select_iter(gtk_tree_view_get_selection(GTK_TREE_VIEW(view->treeView)), &iter);
+        GtkTreePath* path = gtk_tree_model_get_path(model, &iter);
+        gtk_tree_view_scroll_to_cell(GTK_TREE_VIEW(view->treeView), path, nullptr, TRUE, 0.5f, 0.0f);
+        gtk_tree_path_free(path);
+    }
+
+    // Rows list matching items in ascending item order, so an item's row is found by binary search.
+    bool SelectComboItem(ComboListView* view, size_t item)
+    {
+        auto end = view->matches.begin() + static_cast<std::ptrdiff_t>(view->matchCount);
+        auto row = std::lower_bound(view->matches.begin(), end, static_cast<uint32_t>(item));
+        if (row == end || *row != item)
+        {
+            return false;
+        }
+
+        SelectComboRow(view, static_cast<size_t>(row - view->matches.begin()));
+        return true;
+    }
+
+    size_t GetSelectedComboItem(const ComboListView& view)
+    {
+        GtkTreeModel* model = nullptr;
+        GtkTreeIter iter;
+        if (!gtk_tree_selection_get_selected(gtk_tree_view_get_selection(GTK_TREE_VIEW(view.treeView)), &model, &iter))
+        {
+            return NMB_ITEM_NOT_FOUND;
+        }
+
+        guint item = 0;
+        gtk_tree_model_get(model, &iter, 0, &item, -1);
+        return item;
+    }
+
+    void OnComboFilterChanged(GtkWidget* entry, gpointer data)
+    {
+        auto* view = static_cast<ComboListView*>(data);
+        const size_t selected = GetSelectedComboItem(*view);
+        const char* text = gtk_entry_get_text(GTK_ENTRY(entry));
+        view->matchCount = nmb_items_filter(view->items, text ? text : "", text ? std::strlen(text) : 0,
+                                            view->matches.data());
+        FillComboList(view);
+
+        // Keep the previous choice while it still matches; otherwise move to the first match.
+        if (selected == NMB_ITEM_NOT_FOUND || !SelectComboItem(view, selected))
+        {
+            SelectComboRow(view, 0);
+        }
+    }
+
+    void OnComboFilterActivate(GtkWidget* entry, gpointer data)
+    {
+        // Enter on an exact item name picks that item even when other items also contain the text.
+        auto* view = static_cast<ComboListView*>(data);
+        const char* text = gtk_entry_get_text(GTK_ENTRY(entry));
+        const size_t item = nmb_item_index_find(&view->index, text, text ? std::strlen(text) : 0);
+        if (item != NMB_ITEM_NOT_FOUND)
+        {
+            SelectComboItem(view, item);
+        }
+    }
+
+    // The filter box and fixed-height tree view shared by long combo lists and checklists.
+    NmbResultCode BuildItemList(ComboListView* view, const NmbItemBuffer* items, GtkBox* content)
+    {
+        view->items = items;
+        NmbResultCode rc = nmb_item_index_build(&view->index, items);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        view->matches.resize(items->item_count);
+        view->matchCount = nmb_items_filter(items, "", 0, view->matches.data());
+        view->store = gtk_list_store_new(1, G_TYPE_UINT);
+
+        view->treeView = gtk_tree_view_new();
+        gtk_tree_view_set_headers_visible(GTK_TREE_VIEW(view->treeView), FALSE);
+        gtk_tree_view_set_enable_search(GTK_TREE_VIEW(view->treeView), FALSE);
+        GtkTreeViewColumn* column = gtk_tree_view_column_new();
+        GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
+        gtk_tree_view_column_pack_start(column, renderer, TRUE);
+        gtk_tree_view_column_set_cell_data_func(column, renderer, RenderComboItem, view, nullptr);
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(view->treeView), column);
+        gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(view->treeView), TRUE);
+        gtk_tree_selection_set_mode(gtk_tree_view_get_selection(GTK_TREE_VIEW(view->treeView)), GTK_SELECTION_BROWSE);
+        FillComboList(view);
+
+        GtkWidget* filter = gtk_search_entry_new();
+        GtkWidget* scrolled = gtk_scrolled_window_new(nullptr, nullptr);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+        gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(scrolled), kComboListHeight);
+        gtk_container_add(GTK_CONTAINER(scrolled), view->treeView);
+        gtk_box_pack_start(content, filter, FALSE, FALSE, 0);
+        gtk_box_pack_start(content, scrolled, TRUE, TRUE, 0);
+
+        g_signal_connect(filter, "search-changed", G_CALLBACK(OnComboFilterChanged), view);
+        g_signal_connect(filter, "activate", G_CALLBACK(OnComboFilterActivate), view);
+        return NMB_OK;
+    }
+
+    NmbResultCode AddComboList(const NmbItemBuffer* items, const char* defaultValue, GtkBox* content,
+                               GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<ComboListView>();
+        NmbResultCode rc = BuildItemList(view.get(), items, content);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        // A default that names no item leaves the first item selected.
+        const size_t defaultItem = defaultValue
+                                       ? nmb_item_index_find(&view->index, defaultValue, std::strlen(defaultValue))
+                                       : NMB_ITEM_NOT_FOUND;
+        SelectComboRow(view.get(), defaultItem != NMB_ITEM_NOT_FOUND ? defaultItem : 0);
+
+        info->inputWidget = view->treeView;
+        info->comboList = std::move(view);
+        return NMB_OK;
+    }
+
+    bool IsItemChecked(const ComboListView& view, size_t item)
+    {
+        return (view.checked[item / 8] >> (item % 8)) & 1u;
+    }
+
+    void RenderCheckItem(GtkTreeViewColumn*, GtkCellRenderer* cell, GtkTreeModel* model, GtkTreeIter* iter,
+                         gpointer data)
+    {
+        auto* view = static_cast<ComboListView*>(data);
+        guint item = 0;
+        gtk_tree_model_get(model, iter, 0, &item, -1);
+        g_object_set(cell, "active", IsItemChecked(*view, item) ? TRUE : FALSE, nullptr);
+    }
+
+    void ToggleCheckRow(ComboListView* view, GtkTreePath* path)
+    {
+        const gint row = gtk_tree_path_get_indices(path)[0];
+        if (row < 0 || static_cast<size_t>(row) >= view->matchCount)
+        {
+            return;
+        }
+
+        const uint32_t item = view->matches[static_cast<size_t>(row)];
+        view->checked[item / 8] ^= static_cast<uint8_t>(1u << (item % 8));
+        gtk_widget_queue_draw(view->treeView);
+    }
+
+    void OnCheckItemToggled(GtkCellRendererToggle*, gchar* pathText, gpointer data)
+    {
+        GtkTreePath* path = gtk_tree_path_new_from_string(pathText);
+        ToggleCheckRow(static_cast<ComboListView*>(data), path);
+        gtk_tree_path_free(path);
+    }
+
+    void OnCheckRowActivated(GtkTreeView*, GtkTreePath* path, GtkTreeViewColumn*, gpointer data)
+    {
+        ToggleCheckRow(static_cast<ComboListView*>(data), path);
+    }
+
+    void RenderTableCell(GtkTreeViewColumn*, GtkCellRenderer* cell, GtkTreeModel* model, GtkTreeIter* iter,
+                         gpointer data)
+    {
+        auto* column = static_cast<TableColumn*>(data);
+        TableView* view = column->view;
+        guint row = 0;
+        gtk_tree_model_get(model, iter, 0, &row, -1);
+        const NmbItemBuffer& cells = view->table->columns[column->index];
+        view->cellText.assign(nmb_item_data(&cells, row), nmb_item_length(&cells, row));
+        g_object_set(cell, "text", view->cellText.c_str(), nullptr);
+    }
+
+    bool IsDigits(const char* text, size_t length)
+    {
+        if (length == 0)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (text[i] < '0' || text[i] > '9')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Counts such as retry numbers order by value; other cells order by bytes with ASCII case folded.
+    int CompareCells(const NmbItemBuffer& cells, uint32_t a, uint32_t b)
+    {
+        const char* aText = nmb_item_data(&cells, a);
+        const char* bText = nmb_item_data(&cells, b);
+        size_t aLength = nmb_item_length(&cells, a);
+        size_t bLength = nmb_item_length(&cells, b);
+        if (IsDigits(aText, aLength) && IsDigits(bText, bLength))
+        {
+            for (; aLength > 1 && *aText == '0'; ++aText, --aLength)
+            {
+            }
+            for (; bLength > 1 && *bText == '0'; ++bText, --bLength)
+            {
+            }
+            if (aLength != bLength)
+            {
+                return aLength < bLength ? -1 : 1;
+            }
+            return std::memcmp(aText, bText, aLength);
+        }
+
+        const size_t common = std::min(aLength, bLength);
+        for (size_t i = 0; i < common; ++i)
+        {
+            const int x = g_ascii_tolower(aText[i]);
+            const int y = g_ascii_tolower(bText[i]);
+            if (x != y)
+            {
+                return x < y ? -1 : 1;
+            }
+        }
+        return aLength == bLength ? 0 : (aLength < bLength ? -1 : 1);
+    }
+
+    void OnTableHeaderClicked(GtkTreeViewColumn*, gpointer data)
+    {
+        auto* column = static_cast<TableColumn*>(data);
+        TableView* view = column->view;
+        view->descending = view->sortColumn == column->index ? !view->descending : false;
+        view->sortColumn = column->index;
+        for (TableColumn& other : view->columns)
+        {
+            gtk_tree_view_column_set_sort_indicator(other.column, other.index == column->index);
+        }
+        gtk_tree_view_column_set_sort_order(column->column,
+                                            view->descending ? GTK_SORT_DESCENDING : GTK_SORT_ASCENDING);
+
+        // Stable, so equal cells keep the order of the previous sort.
+        const NmbItemBuffer& cells = view->table->columns[column->index];
+        view->scratch = view->order;
+        const bool descending = view->descending;
+        std::stable_sort(view->scratch.begin(), view->scratch.end(), [&](uint32_t a, uint32_t b) {
+            const int order = CompareCells(cells, a, b);
+            return descending ? order > 0 : order < 0;
+        });
+
+        // gtk_list_store_reorder takes, for each new position, the position the row held before.
+        std::vector<gint> positions(view->order.size());
+        std::vector<gint> newOrder(view->order.size());
+        for (size_t i = 0; i < view->order.size(); ++i)
+        {
+            positions[view->order[i]] = static_cast<gint>(i);
+        }
+        for (size_t i = 0; i < view->scratch.size(); ++i)
+        {
+            newOrder[i] = positions[view->scratch[i]];
+        }
+        view->order.swap(view->scratch);
+        if (!newOrder.empty())
+        {
+            gtk_list_store_reorder(view->store, newOrder.data());
+        }
+    }
+
+    void AddTable(const NmbTableOption* table, GtkBox* content, GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<TableView>();
+        view->table = table;
+        view->store = gtk_list_store_new(1, G_TYPE_UINT);
+        view->order.resize(table->row_count);
+        for (size_t row = 0; row < table->row_count; ++row)
+        {
+            view->order[row] = static_cast<uint32_t>(row);
+            gtk_list_store_insert_with_values(view->store, nullptr, -1, 0, static_cast<guint>(row), -1);
+        }
+
+        view->treeView = gtk_tree_view_new_with_model(GTK_TREE_MODEL(view->store));
+        gtk_tree_view_set_enable_search(GTK_TREE_VIEW(view->treeView), FALSE);
+        view->columns.resize(table->column_count);
+        for (size_t c = 0; c < table->column_count; ++c)
+        {
+            TableColumn& column = view->columns[c];
+            column.view = view.get();
+            column.index = c;
+            column.column = gtk_tree_view_column_new();
+            const char* header = table->column_headers_utf8[c];
+            gtk_tree_view_column_set_title(column.column, header ? header : "");
+            GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
+            gtk_tree_view_column_pack_start(column.column, renderer, TRUE);
+            gtk_tree_view_column_set_cell_data_func(column.column, renderer, RenderTableCell, &column, nullptr);
+            gtk_tree_view_column_set_sizing(column.column, GTK_TREE_VIEW_COLUMN_FIXED);
+            gtk_tree_view_column_set_fixed_width(column.column, kTableColumnWidth);
+            gtk_tree_view_column_set_resizable(column.column, TRUE);
+            gtk_tree_view_column_set_clickable(column.column, TRUE);
+            g_signal_connect(column.column, "clicked", G_CALLBACK(OnTableHeaderClicked), &column);
+            gtk_tree_view_append_column(GTK_TREE_VIEW(view->treeView), column.column);
+        }
+        gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(view->treeView), TRUE);
+
+        GtkWidget* scrolled = gtk_scrolled_window_new(nullptr, nullptr);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+        gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(scrolled), kTableHeight);
+        gtk_container_add(GTK_CONTAINER(scrolled), view->treeView);
+        gtk_box_pack_start(content, scrolled, TRUE, TRUE, 0);
+        info->table = std::move(view);
+    }
+
+    // Checklist for NMB_INPUT_MULTISELECT. The caller's bitset seeds the state; the answer is written back
+    // through nmb_store_selection when the dialog is confirmed.
+    NmbResultCode AddChecklist(const NmbInputOption& input, GtkBox* content, GtkDialogInfo* info)
+    {
+        auto view = std::make_unique<ComboListView>();
+        const NmbItemBuffer* items =
+            NMB_STRUCT_HAS_FIELD(&input, NmbInputOption, combo_item_buffer) ? input.combo_item_buffer : nullptr;
+        if (!items)
+        {
+            view->packedOffsets.push_back(0);
+            for (const char* const* item = input.combo_items_utf8; item && *item; ++item)
+            {
+                view->packedData.append(*item);
+                view->packedOffsets.push_back(static_cast<uint32_t>(view->packedData.size()));
+            }
+            view->packed.struct_size = sizeof(view->packed);
+            view->packed.data = view->packedData.data();
+            view->packed.offsets = view->packedOffsets.data();
+            view->packed.item_count = view->packedOffsets.size() - 1;
+            items = &view->packed;
+        }
+
+        view->checked.assign((items->item_count + 7) / 8, 0);
+        if (input.selection_bits && !view->checked.empty())
+        {
+            std::memcpy(view->checked.data(), input.selection_bits, view->checked.size());
+        }
+
+        NmbResultCode rc = BuildItemList(view.get(), items, content);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        GtkCellRenderer* toggle = gtk_cell_renderer_toggle_new();
+        GtkTreeViewColumn* column = gtk_tree_view_column_new();
+        gtk_tree_view_column_pack_start(column, toggle, FALSE);
+        gtk_tree_view_column_set_cell_data_func(column, toggle, RenderCheckItem, view.get(), nullptr);
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(column, kChecklistToggleWidth);
+        gtk_tree_view_insert_column(GTK_TREE_VIEW(view->treeView), column, 0);
+        g_signal_connect(toggle, "toggled", G_CALLBACK(OnCheckItemToggled), view.get());
+        g_signal_connect(view->treeView, "row-activated", G_CALLBACK(OnCheckRowActivated), view.get());
+        SelectComboRow(view.get(), 0);
+
+        info->inputWidget = view->treeView;
+        info->comboList = std::move(view);
+        return NMB_OK;
+    }
+
+    gboolean MatchAllCompletions(GtkEntryCompletion*, const gchar*, GtkTreeIter*, gpointer)
+    {
+        // The store only ever holds matches of the current text.
+        return TRUE;
+    }
+
+    void OnCompletionEntryChanged(GtkEditable* editable, gpointer data)
+    {
+        auto* popup = static_cast<CompletionPopup*>(data);
+        const char* text = gtk_entry_get_text(GTK_ENTRY(editable));
+        const size_t length = text ? std::strlen(text) : 0;
+
+        const bool extended = length >= popup->prefix.size() &&
+                              std::memcmp(text, popup->prefix.data(), popup->prefix.size()) == 0;
+        const NmbCompletionRange within = extended ? popup->range : nmb_completion_index_all(popup->index);
+        popup->range = nmb_completion_index_narrow(popup->index, within, text ? text : "", length);
+        popup->prefix.assign(text ? text : "", length);
+
+        gtk_list_store_clear(popup->store);
+        if (length == 0)
+        {
+            return;
+        }
+
+        const size_t last = std::min(popup->range.last, popup->range.first + popup->maxResults);
+        std::string suggestion;
+        for (size_t rank = popup->range.first; rank < last; ++rank)
+        {
+            size_t suggestionLength = 0;
+            const char* candidate = nmb_completion_index_text(popup->index, rank, &suggestionLength);
+            suggestion.assign(candidate, suggestionLength);
+            gtk_list_store_insert_with_values(popup->store, nullptr, -1, 0, suggestion.c_str(), -1);
+        }
+    }
+
+    void AttachCompletion(const NmbInputOption* input, GtkWidget* entry, GtkDialogInfo* info)
+    {
+        auto popup = std::make_unique<CompletionPopup>();
+        popup->index = input->completion_index;
+        popup->range = nmb_completion_index_all(popup->index);
+        if (NMB_STRUCT_HAS_FIELD(input, NmbInputOption, completion_max_results) && input->completion_max_results > 0)
+        {
+            popup->maxResults = input->completion_max_results;
+        }
+
+        popup->store = gtk_list_store_new(1, G_TYPE_STRING);
+        popup->completion = gtk_entry_completion_new();
+        gtk_entry_completion_set_model(popup->completion, GTK_TREE_MODEL(popup->store));
+        gtk_entry_completion_set_text_column(popup->completion, 0);
+        gtk_entry_completion_set_minimum_key_length(popup->completion, 1);
+        gtk_entry_completion_set_match_func(popup->completion, MatchAllCompletions, nullptr, nullptr);
+
+        // Connected before the completion attaches so the store is refilled before GTK refilters it.
+        g_signal_connect(entry, "changed", G_CALLBACK(OnCompletionEntryChanged), popup.get());
+        gtk_entry_set_completion(GTK_ENTRY(entry), popup->completion);
+        info->completion = std::move(popup);
+    }
+
+    GtkWidget* CreateEntry(const NmbInputOption& input)
+    {
+        GtkWidget* entry = gtk_entry_new();
+        if (input.mode == NMB_INPUT_PASSWORD)
+        {
+            gtk_entry_set_visibility(GTK_ENTRY(entry), FALSE);
+        }
+
+        if (input.default_value_utf8)
+        {
+            gtk_entry_set_text(GTK_ENTRY(entry), input.default_value_utf8);
+        }
+
+        return entry;
+    }
+
+    // Returns the scrolled window to pack; *textView receives the view that holds the answer.
+    GtkWidget* CreateMultilineInput(const NmbInputOption& input, GtkWidget** textView)
+    {
+        *textView = gtk_text_view_new();
+        gtk_text_view_set_wrap_mode(GTK_TEXT_VIEW(*textView), GTK_WRAP_WORD_CHAR);
+        if (input.default_value_utf8)
+        {
+            gtk_text_buffer_set_text(gtk_text_view_get_buffer(GTK_TEXT_VIEW(*textView)), input.default_value_utf8, -1);
+        }
+
+        GtkWidget* scrolled = gtk_scrolled_window_new(nullptr, nullptr);
+        gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+        gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(scrolled), GTK_SHADOW_IN);
+        gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(scrolled), kMultilineInputHeight);
+        gtk_container_add(GTK_CONTAINER(scrolled), *textView);
+        return scrolled;
+    }
+
+    GtkWidget* CreateComboBoxText(const NmbInputOption& input)
+    {
+        GtkWidget* combo = gtk_combo_box_text_new();
+        if (!input.combo_items_utf8)
+        {
+            return combo;
+        }
+
+        const char* const* items = input.combo_items_utf8;
+        int index = 0;
+        int defaultIndex = -1;
+        while (items && *items)
+        {
+            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), *items);
+            if (input.default_value_utf8 && strcmp(input.default_value_utf8, *items) == 0)
+            {
+                defaultIndex = index;
+            }
+            ++index;
+            ++items;
+        }
+
+        if (defaultIndex >= 0)
+        {
+            gtk_combo_box_set_active(GTK_COMBO_BOX(combo), defaultIndex);
+        }
+        else if (index > 0)
+        {
+            gtk_combo_box_set_active(GTK_COMBO_BOX(combo), 0);
+        }
+
+        if (input.default_value_utf8 && defaultIndex == -1)
+        {
+            gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), input.default_value_utf8);
+            gtk_combo_box_set_active(GTK_COMBO_BOX(combo), index);
+        }
+
+        return combo;
+    }
+
+    GtkWidget* CreateCheckbox(const NmbInputOption& input)
+    {
+        GtkWidget* checkbox = gtk_check_button_new_with_label(input.prompt_utf8 ? input.prompt_utf8 : "");
+        if (input.default_value_utf8 && strcmp(input.default_value_utf8, "true") == 0)
+        {
+            gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(checkbox), TRUE);
+        }
+
+        return checkbox;
+    }
+
+    // Lays the fields out as label/control rows of one grid. Checkboxes carry their prompt on the control
+    // and sit in the control column, so every control lines up regardless of its label width.
+    void AddFormGrid(const NmbInputOption* fields, size_t count, GtkBox* content, GtkDialogInfo* info)
+    {
+        GtkWidget* grid = gtk_grid_new();
+        gtk_grid_set_row_spacing(GTK_GRID(grid), kFormRowSpacing);
+        gtk_grid_set_column_spacing(GTK_GRID(grid), kFormColumnSpacing);
+        info->formFields.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const NmbInputOption& field = fields[i];
+            const gint row = static_cast<gint>(i);
+            FormField formField;
+            formField.mode = field.mode;
+
+            GtkWidget* cell = nullptr;
+            switch (field.mode)
+            {
+            case NMB_INPUT_CHECKBOX:
+                formField.widget = CreateCheckbox(field);
+                cell = formField.widget;
+                break;
+            case NMB_INPUT_COMBO:
+                formField.widget = CreateComboBoxText(field);
+                cell = formField.widget;
+                break;
+            case NMB_INPUT_MULTILINE:
+                cell = CreateMultilineInput(field, &formField.widget);
+                gtk_widget_set_vexpand(cell, TRUE);
+                break;
+            default:
+                formField.widget = CreateEntry(field);
+                if (field.placeholder_utf8)
+                {
+                    gtk_entry_set_placeholder_text(GTK_ENTRY(formField.widget), field.placeholder_utf8);
+                }
+                cell = formField.widget;
+                break;
+            }
+
+            if (field.mode != NMB_INPUT_CHECKBOX)
+            {
+                GtkWidget* label = gtk_label_new(field.prompt_utf8 ? field.prompt_utf8 : "");
+                gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+                gtk_widget_set_valign(label, field.mode == NMB_INPUT_MULTILINE ? GTK_ALIGN_START : GTK_ALIGN_CENTER);
+                gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+            }
+
+            gtk_widget_set_hexpand(cell, TRUE);
+            gtk_grid_attach(GTK_GRID(grid), cell, 1, row, 1, 1);
+            info->formFields.push_back(formField);
+        }
+
+        gtk_box_pack_start(content, grid, TRUE, TRUE, 0);
+    }
+
+    GtkMessageType MapMessageType(NmbIcon icon, NmbSeverity severity)
+    {
+        switch (icon)
+        {
+        case NMB_ICON_WARNING:
+            return GTK_MESSAGE_WARNING;
+        case NMB_ICON_ERROR:
+            return GTK_MESSAGE_ERROR;
+        case NMB_ICON_QUESTION:
+            return GTK_MESSAGE_QUESTION;
+        case NMB_ICON_SHIELD:
+            return GTK_MESSAGE_OTHER;
+        default:
+            break;
+        }
+
+        if (severity == NMB_SEVERITY_CRITICAL)
+        {
+            return GTK_MESSAGE_ERROR;
+        }
+
+        return GTK_MESSAGE_INFO;
+    }
+
+    bool EnsureGtkInitialized()
+    {
+        static bool initialized = false;
+        static bool available = false;
+        if (!initialized)
+        {
+            initialized = true;
+            available = gtk_init_check(nullptr, nullptr);
+        }
+
+        return available;
+    }
+
+    // Reads the text view in slices of kMultilineInputChars characters, so a pasted megabyte answer never
+    // exists twice in full: each slice goes to the chunk callback, or into one allocator block sized from
+    // the per-line byte counts GTK already tracks.
+    NmbResultCode CopyMultilineValue(const NmbMessageBoxOptions* options, GtkTextBuffer* buffer,
+                                     NmbMessageBoxResult* out_result)
+    {
+        NmbInputChunkCallback callback = nmb_input_chunk_callback(options->input);
+        char* copy = nullptr;
+        size_t capacity = 0;
+        if (!callback)
+        {
+            GtkTextIter line;
+            gtk_text_buffer_get_start_iter(buffer, &line);
+            do
+            {
+                capacity += static_cast<size_t>(gtk_text_iter_get_bytes_in_line(&line));
+            } while (gtk_text_iter_forward_line(&line));
+
+            copy = static_cast<char*>(nmb_allocate(options->allocator, capacity + 1, 1));
+            if (!copy)
+            {
+                return NMB_E_OUT_OF_MEMORY;
+            }
+        }
+
+        size_t written = 0;
+        GtkTextIter start;
+        gtk_text_buffer_get_start_iter(buffer, &start);
+        while (!gtk_text_iter_is_end(&start))
+        {
+            GtkTextIter end = start;
+            gtk_text_iter_forward_chars(&end, kMultilineInputChars);
+            gchar* slice = gtk_text_buffer_get_slice(buffer, &start, &end, TRUE);
+            const size_t length = std::strlen(slice);
+            NmbResultCode rc = NMB_OK;
+            if (callback)
+            {
+                rc = callback(options->input->input_chunk_user_data, slice, length);
+            }
+            else
+            {
+                const size_t take = std::min(length, capacity - written);
+                std::memcpy(copy + written, slice, take);
+                written += take;
+            }
+            g_free(slice);
+            if (rc != NMB_OK)
+            {
+                return rc;
+            }
+            start = end;
+        }
+
+        if (copy)
+        {
+            copy[written] = '\0';
+        }
+        out_result->input_value_utf8 = copy;
+        return NMB_OK;
+    }
+
+    NmbResultCode CopyInputValue(const NmbMessageBoxOptions* options, GtkDialogInfo* info, NmbMessageBoxResult* out_result)
+    {
+        if (!info || !info->inputWidget)
+        {
+            out_result->input_value_utf8 = nullptr;
+            return NMB_OK;
+        }
+
+        switch (info->inputMode)
+        {
+        case NMB_INPUT_TEXT:
+        case NMB_INPUT_PASSWORD:
+        {
+            const char* text = gtk_entry_get_text(GTK_ENTRY(info->inputWidget));
+            return nmb_copy_string_to_allocator(options->allocator, text, &out_result->input_value_utf8);
+        }
+        case NMB_INPUT_MULTILINE:
+            return CopyMultilineValue(options, gtk_text_view_get_buffer(GTK_TEXT_VIEW(info->inputWidget)), out_result);
+        case NMB_INPUT_COMBO:
+        {
+            if (info->comboList)
+            {
+                const size_t item = GetSelectedComboItem(*info->comboList);
+                if (item == NMB_ITEM_NOT_FOUND)
+                {
+                    out_result->input_value_utf8 = nullptr;
+                    return NMB_OK;
+                }
+
+                const NmbItemBuffer* items = info->comboList->items;
+                const std::string value(nmb_item_data(items, item), nmb_item_length(items, item));
+                return nmb_copy_string_to_allocator(options->allocator, value.c_str(), &out_result->input_value_utf8);
+            }
+
+            gchar* active = gtk_combo_box_text_get_active_text(GTK_COMBO_BOX_TEXT(info->inputWidget));
+            if (!active)
+            {
+                out_result->input_value_utf8 = nullptr;
+                return NMB_OK;
+            }
+
+            NmbResultCode rc = nmb_copy_string_to_allocator(options->allocator, active, &out_result->input_value_utf8);
+            g_free(active);
+            return rc;
+        }
+        case NMB_INPUT_MULTISELECT:
+            nmb_store_selection(options, info->comboList->checked.data(), out_result);
+            out_result->input_value_utf8 = nullptr;
+            return NMB_OK;
+        case NMB_INPUT_CHECKBOX:
+        {
+            if (info->inputCheckbox)
+            {
+                gboolean active = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(info->inputCheckbox));
+                out_result->checkbox_checked = active ? NMB_TRUE : NMB_FALSE;
+            }
+            out_result->input_value_utf8 = nullptr;
+            return NMB_OK;
+        }
+        default:
+            out_result->input_value_utf8 = nullptr;
+            return NMB_OK;
+        }
+    }
+
+    // Gathers every field's answer and hands them to the runtime, which packs them into one allocation.
+    NmbResultCode CopyFormValues(const NmbMessageBoxOptions* options, const GtkDialogInfo& info,
+                                 NmbMessageBoxResult* out_result)
+    {
+        std::vector<NmbFieldValue> answers(info.formFields.size());
+        std::vector<gchar*> owned;
+        for (size_t i = 0; i < info.formFields.size(); ++i)
+        {
+            const FormField& field = info.formFields[i];
+            const char* text = nullptr;
+            switch (field.mode)
+            {
+            case NMB_INPUT_CHECKBOX:
+                answers[i].checked =
+                    gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(field.widget)) ? NMB_TRUE : NMB_FALSE;
+                break;
+            case NMB_INPUT_COMBO:
+                owned.push_back(gtk_combo_box_text_get_active_text(GTK_COMBO_BOX_TEXT(field.widget)));
+                text = owned.back();
+                break;
+            case NMB_INPUT_MULTILINE:
+            {
+                GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(field.widget));
+                GtkTextIter start;
+                GtkTextIter end;
+                gtk_text_buffer_get_bounds(buffer, &start, &end);
+                owned.push_back(gtk_text_buffer_get_text(buffer, &start, &end, TRUE));
+                text = owned.back();
+                break;
+            }
+            default:
+                text = gtk_entry_get_text(GTK_ENTRY(field.widget));
+                break;
+            }
+
+            answers[i].value_utf8 = text;
+            answers[i].length = text ? std::strlen(text) : 0;
+        }
+
+        NmbResultCode rc = nmb_store_field_values(options, answers.data(), answers.size(), out_result);
+        for (gchar* text : owned)
+        {
+            g_free(text);
+        }
+        return rc;
+    }
+
+    bool MapButtonId(const GtkDialogInfo& info, int response, NmbButtonId* outId)
+    {
+        for (const auto& pair : info.buttonMap)
+        {
+            if (pair.first == response)
+            {
+                if (outId)
+                {
+                    *outId = pair.second;
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool RunZenityFallback(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    {
+        size_t fieldCount = 0;
+        if (!options || options->input != nullptr || nmb_form_fields(options, &fieldCount) ||
+            (options->buttons && options->button_count > 1))
+        {
+            return false;
+        }
+
+        gchar* zenity = g_find_program_in_path("zenity");
+        if (!zenity)
+        {
+            return false;
+        }
+
+        std::vector<char*> args;
+        args.push_back(zenity);
+
+        switch (options->icon)
+        {
+        case NMB_ICON_WARNING:
+            args.push_back(g_strdup("--warning"));
+            break;
+        case NMB_ICON_ERROR:
+            args.push_back(g_strdup("--error"));
+            break;
+        case NMB_ICON_QUESTION:
+            args.push_back(g_strdup("--question"));
+            break;
+        default:
+            args.push_back(g_strdup("--info"));
+            break;
+        }
+
+        args.push_back(g_strdup("--no-wrap"));
+
+        if (options->title_utf8)
+        {
+            args.push_back(g_strdup_printf("--title=%s", options->title_utf8));
+        }
+
+        if (options->message_utf8)
+        {
+            args.push_back(g_strdup_printf("--text=%s", options->message_utf8));
+        }
+
+        args.push_back(nullptr);
+
+        GError* error = nullptr;
         gint exitStatus = 0;
         gboolean spawnOk = g_spawn_sync(
             nullptr,
@@ -346,272 +1981,1197 @@ namespace
             &exitStatus,
             &error);
 
-        for (size_t i = 0; i + 1 < args.size(); ++i)
+        for (size_t i = 0; i + 1 < args.size(); ++i)
+        {
+            g_free(args[i]);
+        }
+
+        if (!spawnOk)
+        {
+            if (error)
+            {
+                nmb_runtime_log(error->message);
+                g_error_free(error);
+            }
+            return false;
+        }
+
+        if (!WIFEXITED(exitStatus))
+        {
+            nmb_runtime_log("Linux: zenity terminated without exit status.");
+            return false;
+        }
+
+        int exitCode = WEXITSTATUS(exitStatus);
+        out_result->button = (exitCode == 0) ? NMB_BUTTON_ID_OK : NMB_BUTTON_ID_CANCEL;
+        out_result->checkbox_checked = NMB_FALSE;
+        out_result->input_value_utf8 = nullptr;
+        out_result->was_timeout = NMB_FALSE;
+        out_result->result_code = NMB_OK;
+        return true;
+    }
+
+    // Creates the dialog and every control of options in info, ready to show. A modal dialog is run with
+    // gtk_dialog_run; a non-modal one reports through its "response" signal. On failure nothing is left behind.
+    NmbResultCode BuildGtkDialog(const NmbMessageBoxOptions* options, GtkDialogInfo* info, bool modal)
+    {
+        GtkMessageType messageType = MapMessageType(options->icon, options->severity);
+        const char* message = options->message_utf8 ? options->message_utf8 : "";
+        const bool longMessage = nmb_text_exceeds(message, kLongMessageBytes, kLongMessageLines) == NMB_TRUE;
+
+        GtkWidget* dialog = gtk_message_dialog_new(
+            options->parent_window ? GTK_WINDOW(const_cast<void*>(options->parent_window)) : nullptr,
+            modal ? GTK_DIALOG_MODAL : static_cast<GtkDialogFlags>(0),
+            messageType,
+            GTK_BUTTONS_NONE,
+            "%s",
+            longMessage ? "" : message);
+
+        info->dialog = dialog;
+        if (longMessage)
+        {
+            AddMessageBody(message, std::strlen(message), dialog, info);
+        }
+
+        if (options->title_utf8)
+        {
+            gtk_window_set_title(GTK_WINDOW(dialog), options->title_utf8);
+        }
+
+        if (options->secondary && options->secondary->informative_text_utf8)
+        {
+            gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog), "%s", options->secondary->informative_text_utf8);
+        }
+
+        GtkBox* content = GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog)));
+        if (const NmbTableOption* table = nmb_table(options))
+        {
+            AddTable(table, content, info);
+        }
+
+        const NmbSecondaryContentOption* secondary = options->secondary;
+        const NmbContentSource* expandedSource =
+            (secondary && NMB_STRUCT_HAS_FIELD(secondary, NmbSecondaryContentOption, expanded_text_source))
+                ? secondary->expanded_text_source
+                : nullptr;
+        if (expandedSource)
+        {
+            NmbResultCode rc = nmb_content_source_follows(expandedSource)
+                                   ? AddFollowedSource(expandedSource, content, info)
+                                   : AddExpandedSource(expandedSource, content, info);
+            if (rc != NMB_OK)
+            {
+                gtk_widget_destroy(dialog);
+                return rc;
+            }
+        }
+        else if (options->secondary && options->secondary->expanded_text_utf8)
+        {
+            GtkWidget* expander = gtk_expander_new("More details");
+            GtkWidget* expanded_label = gtk_label_new(options->secondary->expanded_text_utf8);
+            gtk_label_set_xalign(GTK_LABEL(expanded_label), 0.0f);
+            gtk_label_set_line_wrap(GTK_LABEL(expanded_label), TRUE);
+            gtk_label_set_selectable(GTK_LABEL(expanded_label), FALSE);
+            gtk_container_add(GTK_CONTAINER(expander), expanded_label);
+            gtk_box_pack_start(content, expander, FALSE, FALSE, 0);
+        }
+
+        if (options->secondary && options->secondary->help_link_utf8)
+        {
+            GtkWidget* link = gtk_link_button_new_with_label(options->secondary->help_link_utf8, "Open Help");
+            gtk_box_pack_start(content, link, FALSE, FALSE, 0);
+        }
+
+        if (options->show_suppress_checkbox == NMB_TRUE && options->verification_text_utf8)
+        {
+            info->verification = gtk_check_button_new_with_label(options->verification_text_utf8);
+            gtk_box_pack_start(content, info->verification, FALSE, FALSE, 0);
+        }
+
+        if (options->input)
+        {
+            info->inputMode = options->input->mode;
+            switch (options->input->mode)
+            {
+            case NMB_INPUT_TEXT:
+            case NMB_INPUT_PASSWORD:
+            {
+                GtkWidget* label = nullptr;
+                if (options->input->prompt_utf8)
+                {
+                    label = gtk_label_new(options->input->prompt_utf8);
+                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
+                }
+
+                GtkWidget* entry = CreateEntry(*options->input);
+                if (options->input->mode == NMB_INPUT_TEXT &&
+                    NMB_STRUCT_HAS_FIELD(options->input, NmbInputOption, completion_index) &&
+                    options->input->completion_index)
+                {
+                    AttachCompletion(options->input, entry, info);
+                }
+
+                info->inputWidget = entry;
+                gtk_box_pack_start(content, entry, FALSE, FALSE, 0);
+                break;
+            }
+            case NMB_INPUT_MULTILINE:
+            {
+                if (options->input->prompt_utf8)
+                {
+                    GtkWidget* label = gtk_label_new(options->input->prompt_utf8);
+                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
+                }
+
+                GtkWidget* textView = nullptr;
+                GtkWidget* scrolled = CreateMultilineInput(*options->input, &textView);
+                gtk_box_pack_start(content, scrolled, TRUE, TRUE, 0);
+                info->inputWidget = textView;
+                break;
+            }
+            case NMB_INPUT_COMBO:
+            {
+                GtkWidget* label = nullptr;
+                if (options->input->prompt_utf8)
+                {
+                    label = gtk_label_new(options->input->prompt_utf8);
+                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
+                }
+
+                const NmbItemBuffer* itemBuffer =
+                    NMB_STRUCT_HAS_FIELD(options->input, NmbInputOption, combo_item_buffer)
+                        ? options->input->combo_item_buffer
+                        : nullptr;
+                if (itemBuffer)
+                {
+                    NmbResultCode rc = AddComboList(itemBuffer, options->input->default_value_utf8, content, info);
+                    if (rc != NMB_OK)
+                    {
+                        gtk_widget_destroy(dialog);
+                        return rc;
+                    }
+                    break;
+                }
+
+                GtkWidget* combo = CreateComboBoxText(*options->input);
+                info->inputWidget = combo;
+                gtk_box_pack_start(content, combo, FALSE, FALSE, 0);
+                break;
+            }
+            case NMB_INPUT_MULTISELECT:
+            {
+                if (options->input->prompt_utf8)
+                {
+                    GtkWidget* label = gtk_label_new(options->input->prompt_utf8);
+                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
+                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
+                }
+
+                NmbResultCode rc = AddChecklist(*options->input, content, info);
+                if (rc != NMB_OK)
+                {
+                    gtk_widget_destroy(dialog);
+                    return rc;
+                }
+                break;
+            }
+            case NMB_INPUT_CHECKBOX:
+            {
+                GtkWidget* checkbox = CreateCheckbox(*options->input);
+                info->inputCheckbox = checkbox;
+                gtk_box_pack_start(content, checkbox, FALSE, FALSE, 0);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        else
+        {
+            size_t fieldCount = 0;
+            const NmbInputOption* fields = nmb_form_fields(options, &fieldCount);
+            if (fields)
+            {
+                AddFormGrid(fields, fieldCount, content, info);
+            }
+        }
+
+        if (options->buttons && options->button_count > 0)
+        {
+            for (size_t i = 0; i < options->button_count; ++i)
+            {
+                const NmbButtonOption& button = options->buttons[i];
+                int responseId = GTK_RESPONSE_NONE - static_cast<int>(i) - 1;
+                gtk_dialog_add_button(GTK_DIALOG(dialog), button.label_utf8 ? button.label_utf8 : "", responseId);
+                info->buttonMap.emplace_back(responseId, button.id);
+                if (button.is_default)
+                {
+                    gtk_dialog_set_default_response(GTK_DIALOG(dialog), responseId);
+                }
+            }
+        }
+        else
+        {
+            gtk_dialog_add_button(GTK_DIALOG(dialog), "OK", GTK_RESPONSE_OK);
+            info->buttonMap.emplace_back(GTK_RESPONSE_OK, NMB_BUTTON_ID_OK);
+        }
+
+        if (NmbDialogHandle* handle = nmb_dialog_handle(options))
+        {
+            NmbResultCode rc = AttachDialogHandle(handle, info);
+            if (rc != NMB_OK)
+            {
+                gtk_widget_destroy(dialog);
+                return rc;
+            }
+        }
+
+        info->requiresExplicitAck = options->requires_explicit_ack == NMB_TRUE;
+        info->allowClose = (options->allow_cancel_via_escape == NMB_TRUE) && !info->requiresExplicitAck;
+        g_signal_connect(dialog, "delete-event", G_CALLBACK(OnDeleteEvent), info);
+        g_signal_connect(dialog, "key-press-event", G_CALLBACK(OnKeyPress), info);
+
+        if (options->timeout_milliseconds > 0 && options->timeout_button_id != NMB_BUTTON_ID_NONE)
+        {
+            int mappedResponse = 0;
+            for (const auto& pair : info->buttonMap)
+            {
+                if (pair.second == options->timeout_button_id)
+                {
+                    mappedResponse = pair.first;
+                    break;
+                }
+            }
+
+            if (mappedResponse != 0)
+            {
+                info->timeoutResponse = mappedResponse;
+                StartDialogDeadline(options, info);
+            }
+        }
+        return NMB_OK;
+    }
+
+    // Reads the answer of a dialog that produced response into out_result. The dialog itself is left alone.
+    NmbResultCode CompleteGtkDialog(const NmbMessageBoxOptions* options, GtkDialogInfo& info, int response,
+                                    NmbMessageBoxResult* out_result)
+    {
+        nmb_timing_finish(out_result, NMB_BACKEND_GTK);
+        if (info.deadline)
+        {
+            info.deadline->Cancel();
+        }
+
+        NmbButtonId button = NMB_BUTTON_ID_NONE;
+        bool mapped = MapButtonId(info, response, &button);
+
+        if (info.verification)
+        {
+            gboolean value = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(info.verification));
+            out_result->checkbox_checked = value ? NMB_TRUE : NMB_FALSE;
+        }
+
+        out_result->was_timeout = info.timedOut ? NMB_TRUE : NMB_FALSE;
+
+        if (!mapped)
+        {
+            switch (response)
+            {
+            case GTK_RESPONSE_DELETE_EVENT:
+            case GTK_RESPONSE_CANCEL:
+            case GTK_RESPONSE_CLOSE:
+            case GTK_RESPONSE_REJECT:
+            case GTK_RESPONSE_NONE:
+                out_result->button = NMB_BUTTON_ID_CANCEL;
+                out_result->input_value_utf8 = nullptr;
+                out_result->result_code = NMB_E_CANCELLED;
+                return NMB_E_CANCELLED;
+            default:
+                break;
+            }
+        }
+
+        out_result->button = button;
+
+        NmbResultCode rc = CopyInputValue(options, &info, out_result);
+        if (rc == NMB_OK && !info.formFields.empty())
+        {
+            rc = CopyFormValues(options, info, out_result);
+        }
+
+        out_result->result_code = rc;
+        return rc;
+    }
+
+    NmbResultCode ShowGtkDialog(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    {
+        GtkDialogInfo info = {};
+        NmbResultCode rc = BuildGtkDialog(options, &info, true);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        nmb_timing_mark(out_result, NMB_TIMING_BUILT);
+        g_signal_connect(info.dialog, "map-event", G_CALLBACK(OnDialogMapped), out_result);
+        gtk_widget_show_all(info.dialog);
+        const int response = gtk_dialog_run(GTK_DIALOG(info.dialog));
+        rc = CompleteGtkDialog(options, info, response, out_result);
+        gtk_widget_destroy(info.dialog);
+        return rc;
+    }
+
+    // Where and how a finished asynchronous request is reported. context is held with a reference; without one
+    // the callback runs on the GTK thread as soon as the dialog is answered.
+    struct AsyncCompletion
+    {
+        NmbMessageBoxResult* result = nullptr;
+        NmbMessageBoxCallback callback = nullptr;
+        void* userData = nullptr;
+        GMainContext* context = nullptr;
+    };
+
+    gboolean RunAsyncCompletion(gpointer data)
+    {
+        auto* completion = static_cast<AsyncCompletion*>(data);
+        completion->callback(completion->userData, completion->result);
+        return G_SOURCE_REMOVE;
+    }
+
+    void FreeAsyncCompletion(gpointer data)
+    {
+        auto* completion = static_cast<AsyncCompletion*>(data);
+        if (completion->context)
+        {
+            g_main_context_unref(completion->context);
+        }
+        delete completion;
+    }
+
+    // Reports a finished request, dispatched from the caller's main context when it supplied one. That context
+    // runs the callback on its next iteration, or right away when the current thread already owns it.
+    void DeliverAsyncResult(const AsyncCompletion& completion, NmbResultCode rc)
+    {
+        if (NMB_STRUCT_HAS_FIELD(completion.result, NmbMessageBoxResult, result_code))
+        {
+            completion.result->result_code = rc;
+        }
+        if (!completion.context)
+        {
+            completion.callback(completion.userData, completion.result);
+            return;
+        }
+
+        auto* pending = new AsyncCompletion(completion);
+        GMainContext* context = g_main_context_ref(completion.context);
+        pending->context = g_main_context_ref(context);
+        g_main_context_invoke_full(context, G_PRIORITY_DEFAULT, RunAsyncCompletion, pending, FreeAsyncCompletion);
+        g_main_context_unref(context);
+    }
+
+    // A non-modal request owns everything a modal one keeps on the stack of ShowGtkDialog, until it answers.
+    struct AsyncDialog
+    {
+        NmbPreparedOptionsScope prepared;
+        GtkDialogInfo info = {};
+        AsyncCompletion completion;
+
+        AsyncDialog() = default;
+        AsyncDialog(const AsyncDialog&) = delete;
+        AsyncDialog& operator=(const AsyncDialog&) = delete;
+
+        ~AsyncDialog()
+        {
+            if (completion.context)
+            {
+                g_main_context_unref(completion.context);
+            }
+        }
+    };
+
+    void OnAsyncResponse(GtkDialog* dialog, gint response, gpointer data)
+    {
+        auto* request = static_cast<AsyncDialog*>(data);
+        AsyncCompletion completion = request->completion;
+        const NmbResultCode rc =
+            CompleteGtkDialog(request->prepared.value.options, request->info, response, completion.result);
+        if (completion.context)
         {
-            g_free(args[i]);
+            g_main_context_ref(completion.context);
         }
 
-        if (!spawnOk)
+        gtk_widget_destroy(GTK_WIDGET(dialog));
+        delete request;
+        DeliverAsyncResult(completion, rc);
+        if (completion.context)
         {
-            if (error)
+            g_main_context_unref(completion.context);
+        }
+    }
+
+    // Shows a prepared request without gtk_dialog_run: the call returns once the dialog is mapped, and its
+    // "response" signal completes it later, so any number of dialogs can be open and answered in any order.
+    NmbResultCode ShowGtkDialogAsync(std::unique_ptr<AsyncDialog> request)
+    {
+        NmbResultCode rc = BuildGtkDialog(request->prepared.value.options, &request->info, false);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        GtkWidget* dialog = request->info.dialog;
+        nmb_timing_mark(request->completion.result, NMB_TIMING_BUILT);
+        g_signal_connect(dialog, "map-event", G_CALLBACK(OnDialogMapped), request->completion.result);
+        g_signal_connect(dialog, "response", G_CALLBACK(OnAsyncResponse), request.release());
+        gtk_widget_show_all(dialog);
+        return NMB_OK;
+    }
+
+    // Builds a request handed over from another thread; failures can only be reported through its completion.
+    gboolean ShowHandedOverDialog(gpointer data)
+    {
+        std::unique_ptr<AsyncDialog> request(static_cast<AsyncDialog*>(data));
+        AsyncCompletion completion = request->completion;
+        if (completion.context)
+        {
+            g_main_context_ref(completion.context);
+        }
+
+        NmbResultCode rc = ShowGtkDialogAsync(std::move(request));
+        if (rc != NMB_OK)
+        {
+            DeliverAsyncResult(completion, rc);
+        }
+        if (completion.context)
+        {
+            g_main_context_unref(completion.context);
+        }
+        return G_SOURCE_REMOVE;
+    }
+
+    // Set on the helper threads below. Their dialogs are built by the GTK thread, which stays free to run them.
+    thread_local bool t_handsOverDialogs = false;
+
+    struct HandedOverAnswer
+    {
+        std::mutex lock;
+        std::condition_variable answered;
+        bool done = false;
+    };
+
+    void NMB_CALL OnHandedOverAnswer(void* user_data, NmbMessageBoxResult*)
+    {
+        auto* answer = static_cast<HandedOverAnswer*>(user_data);
+        std::lock_guard<std::mutex> guard(answer->lock);
+        answer->done = true;
+        answer->answered.notify_one();
+    }
+
+    // Shows a dialog for a helper thread: the GTK thread builds it non-modally, and the helper sleeps until the
+    // "response" signal has filled in out_result.
+    NmbResultCode ShowGtkDialogForHelper(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    {
+        std::unique_ptr<AsyncDialog> request(new (std::nothrow) AsyncDialog());
+        if (!request)
+        {
+            return NMB_E_OUT_OF_MEMORY;
+        }
+
+        NmbResultCode rc = nmb_prepare_options(options, &request->prepared.value);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+
+        HandedOverAnswer answer;
+        request->completion.result = out_result;
+        request->completion.callback = OnHandedOverAnswer;
+        request->completion.userData = &answer;
+        g_main_context_invoke(nullptr, ShowHandedOverDialog, request.release());
+
+        std::unique_lock<std::mutex> guard(answer.lock);
+        answer.answered.wait(guard, [&answer] { return answer.done; });
+        return out_result->result_code;
+    }
+
+    // An asynchronous request that may block: an aggregated or templated one waits for other requests, and the
+    // zenity fallback for its child process. It runs on a helper thread instead of the caller's.
+    struct BlockingRequest
+    {
+        const NmbMessageBoxOptions* options = nullptr;
+        AsyncCompletion completion;
+
+        BlockingRequest() = default;
+        BlockingRequest(const BlockingRequest&) = delete;
+        BlockingRequest& operator=(const BlockingRequest&) = delete;
+
+        ~BlockingRequest()
+        {
+            if (completion.context)
             {
-                nmb_runtime_log(error->message);
-                g_error_free(error);
+                g_main_context_unref(completion.context);
             }
-            return false;
         }
+    };
 
-        if (!WIFEXITED(exitStatus))
+    gpointer RunBlockingRequest(gpointer data)
+    {
+        std::unique_ptr<BlockingRequest> request(static_cast<BlockingRequest*>(data));
+        t_handsOverDialogs = true;
+        DeliverAsyncResult(request->completion, nmb_show_message_box(request->options, request->completion.result));
+        return nullptr;
+    }
+
+    // Without a caller context the answer is dispatched from the default one, which the caller's thread runs.
+    NmbResultCode StartBlockingRequest(const NmbMessageBoxOptions* options, const AsyncCompletion& completion)
+    {
+        auto* request = new (std::nothrow) BlockingRequest();
+        if (!request)
         {
-            nmb_runtime_log("Linux: zenity terminated without exit status.");
-            return false;
+            return NMB_E_OUT_OF_MEMORY;
         }
 
-        int exitCode = WEXITSTATUS(exitStatus);
-        out_result->button = (exitCode == 0) ? NMB_BUTTON_ID_OK : NMB_BUTTON_ID_CANCEL;
-        out_result->checkbox_checked = NMB_FALSE;
-        out_result->input_value_utf8 = nullptr;
-        out_result->was_timeout = NMB_FALSE;
-        out_result->result_code = NMB_OK;
-        return true;
+        request->options = options;
+        request->completion = completion;
+        request->completion.context =
+            g_main_context_ref(completion.context ? completion.context : g_main_context_default());
+        g_thread_unref(g_thread_new("nmb-request", RunBlockingRequest, request));
+        return NMB_OK;
     }
 
-    NmbResultCode ShowGtkDialog(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    // Shared by both asynchronous entry points. With a context, the dialog is built on the GTK thread whichever
+    // thread asked for it, and the result is reported on context; without one, the caller is the GTK thread.
+    NmbResultCode ShowMessageBoxAsync(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                      GMainContext* context, NmbMessageBoxCallback callback, void* user_data)
     {
-        GtkDialogInfo info = {};
-        GtkMessageType messageType = MapMessageType(options->icon, options->severity);
+        if (!options || !out_result || !callback)
+        {
+            return NMB_E_INVALID_ARGUMENT;
+        }
 
-        GtkWidget* dialog = gtk_message_dialog_new(
-            options->parent_window ? GTK_WINDOW(const_cast<void*>(options->parent_window)) : nullptr,
-            GTK_DIALOG_MODAL,
-            messageType,
-            GTK_BUTTONS_NONE,
-            "%s",
-            options->message_utf8 ? options->message_utf8 : "");
+        const uint64_t received = nmb_clock_now_microseconds();
+#if defined(NMB_TESTING)
+        if (IsTestHarness(options))
+        {
+            return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+        }
+#endif
 
-        info.dialog = dialog;
+        NmbResultCode validation = ValidateMessageBoxOptions(options);
+        if (validation != NMB_OK)
+        {
+            return validation;
+        }
 
-        if (options->title_utf8)
+        validation = ValidateMessageBoxResult(out_result);
+        if (validation != NMB_OK)
         {
-            gtk_window_set_title(GTK_WINDOW(dialog), options->title_utf8);
+            return validation;
         }
 
-        if (options->secondary && options->secondary->informative_text_utf8)
+        AsyncCompletion completion;
+        completion.result = out_result;
+        completion.callback = callback;
+        completion.userData = user_data;
+        completion.context = context;
+
+        // Without a display or a caller context there is no main loop to answer on, so the zenity fallback
+        // runs within the call. Other requests that may block leave the caller's thread free.
+        const bool gtk = EnsureGtkInitialized();
+        if (!gtk && !context)
         {
-            gtk_message_dialog_format_secondary_text(GTK_MESSAGE_DIALOG(dialog), "%s", options->secondary->informative_text_utf8);
+            DeliverAsyncResult(completion, nmb_show_message_box(options, out_result));
+            return NMB_OK;
+        }
+        if (!gtk || nmb_aggregation(options) || nmb_templated_message(options))
+        {
+            return StartBlockingRequest(options, completion);
         }
 
-        GtkBox* content = GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog)));
+        // Toasts never block: they are queued from any thread and answered through their own callback.
+        if (nmb_toast(options))
+        {
+            DeliverAsyncResult(completion, nmb_show_message_box(options, out_result));
+            return NMB_OK;
+        }
 
-        if (options->secondary && options->secondary->expanded_text_utf8)
+        std::unique_ptr<AsyncDialog> request(new (std::nothrow) AsyncDialog());
+        if (!request)
         {
-            GtkWidget* expander = gtk_expander_new("More details");
-            GtkWidget* expanded_label = gtk_label_new(options->secondary->expanded_text_utf8);
-            gtk_label_set_xalign(GTK_LABEL(expanded_label), 0.0f);
-            gtk_label_set_line_wrap(GTK_LABEL(expanded_label), TRUE);
-            gtk_label_set_selectable(GTK_LABEL(expanded_label), FALSE);
-            gtk_container_add(GTK_CONTAINER(expander), expanded_label);
-            gtk_box_pack_start(content, expander, FALSE, FALSE, 0);
+            return NMB_E_OUT_OF_MEMORY;
         }
 
-        if (options->secondary && options->secondary->help_link_utf8)
+        validation = nmb_prepare_options(options, &request->prepared.value);
+        if (validation != NMB_OK)
         {
-            GtkWidget* link = gtk_link_button_new_with_label(options->secondary->help_link_utf8, "Open Help");
-            gtk_box_pack_start(content, link, FALSE, FALSE, 0);
+            return validation;
         }
 
-        if (options->show_suppress_checkbox == NMB_TRUE && options->verification_text_utf8)
+        options = request->prepared.value.options;
+        if (!options->message_utf8)
         {
-            info.verification = gtk_check_button_new_with_label(options->verification_text_utf8);
-            gtk_box_pack_start(content, info.verification, FALSE, FALSE, 0);
+            return NMB_E_INVALID_ARGUMENT;
         }
 
-        if (options->input)
+        validation = nmb_reset_result(options, out_result);
+        if (validation != NMB_OK)
         {
-            info.inputMode = options->input->mode;
-            switch (options->input->mode)
+            return validation;
+        }
+        nmb_timing_begin(out_result, received);
+
+        request->completion = completion;
+        if (context)
+        {
+            g_main_context_ref(context);
+            if (!g_main_context_is_owner(g_main_context_default()))
             {
-            case NMB_INPUT_TEXT:
-            case NMB_INPUT_PASSWORD:
+                g_main_context_invoke(nullptr, ShowHandedOverDialog, request.release());
+                return NMB_OK;
+            }
+        }
+        return ShowGtkDialogAsync(std::move(request));
+    }
+}
+
+// Shared by worker threads and the GTK thread. Workers only touch the atomics: every update overwrites the
+// latest fraction and text, and only the first update after the dialog caught up arms a source, so any number
+// of updates between two frames costs one GTK pass. The widgets belong to the GTK thread.
+struct NmbProgressHandle_t
+{
+    std::atomic<uint64_t> fractionBits{0};
+    std::atomic<char*> pendingText{nullptr};
+    std::atomic<bool> armed{false};
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> references{1}; // the caller's, plus one per armed source
+    bool headless = false;          // scripted by the test harness; never armed
+    GtkWidget* dialog = nullptr;
+    GtkWidget* bar = nullptr;
+    GtkWidget* status = nullptr;
+};
+
+namespace
+{
+    constexpr guint kProgressFrameMilliseconds = 16;
+
+    void ReleaseProgress(NmbProgressHandle* handle)
+    {
+        if (handle->references.fetch_sub(1) == 1)
+        {
+            g_free(handle->pendingText.exchange(nullptr));
+            delete handle;
+        }
+    }
+
+    // Clears armed before reading, so an update that lands after the read arms the next frame's pass.
+    gboolean ApplyProgress(gpointer data)
+    {
+        auto* handle = static_cast<NmbProgressHandle*>(data);
+        handle->armed.store(false);
+        if (handle->dialog)
+        {
+            const uint64_t bits = handle->fractionBits.load();
+            double fraction = 0.0;
+            std::memcpy(&fraction, &bits, sizeof(fraction));
+            if (fraction < 0.0)
             {
-                GtkWidget* label = nullptr;
-                if (options->input->prompt_utf8)
-                {
-                    label = gtk_label_new(options->input->prompt_utf8);
-                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
-                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
-                }
+                gtk_progress_bar_pulse(GTK_PROGRESS_BAR(handle->bar));
+            }
+            else
+            {
+                gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(handle->bar), fraction);
+            }
 
-                GtkWidget* entry = gtk_entry_new();
-                if (options->input->mode == NMB_INPUT_PASSWORD)
-                {
-                    gtk_entry_set_visibility(GTK_ENTRY(entry), FALSE);
-                }
+            if (char* text = handle->pendingText.exchange(nullptr))
+            {
+                gtk_label_set_text(GTK_LABEL(handle->status), text);
+                g_free(text);
+            }
+        }
+        ReleaseProgress(handle);
+        return G_SOURCE_REMOVE;
+    }
 
-                if (options->input->default_value_utf8)
-                {
-                    gtk_entry_set_text(GTK_ENTRY(entry), options->input->default_value_utf8);
-                }
+    // Cancel, Escape and the close button only raise the flag; the dialog stays up until nmb_progress_end.
+    void OnProgressResponse(GtkDialog* dialog, gint, gpointer data)
+    {
+        static_cast<NmbProgressHandle*>(data)->cancelled.store(true);
+        gtk_dialog_set_response_sensitive(dialog, GTK_RESPONSE_CANCEL, FALSE);
+    }
 
-                info.inputWidget = entry;
-                gtk_box_pack_start(content, entry, FALSE, FALSE, 0);
-                break;
+    gboolean OnProgressDelete(GtkWidget*, GdkEvent*, gpointer)
+    {
+        return TRUE;
+    }
+
+    gboolean FinishProgress(gpointer data)
+    {
+        auto* handle = static_cast<NmbProgressHandle*>(data);
+        if (handle->dialog)
+        {
+            gtk_widget_destroy(handle->dialog);
+            handle->dialog = nullptr;
+        }
+        ReleaseProgress(handle);
+        return G_SOURCE_REMOVE;
+    }
+
+    const char* CancelLabel(const NmbMessageBoxOptions* options)
+    {
+        for (size_t i = 0; options->buttons && i < options->button_count; ++i)
+        {
+            if (options->buttons[i].is_cancel && options->buttons[i].label_utf8)
+            {
+                return options->buttons[i].label_utf8;
             }
-            case NMB_INPUT_COMBO:
+        }
+        return "Cancel";
+    }
+
+    void ShowProgressDialog(const NmbMessageBoxOptions* options, NmbProgressHandle* handle)
+    {
+        GtkWidget* dialog = gtk_message_dialog_new(
+            options->parent_window ? GTK_WINDOW(const_cast<void*>(options->parent_window)) : nullptr,
+            GTK_DIALOG_DESTROY_WITH_PARENT,
+            MapMessageType(options->icon, options->severity),
+            GTK_BUTTONS_NONE,
+            "%s",
+            options->message_utf8 ? options->message_utf8 : "");
+        if (options->title_utf8)
+        {
+            gtk_window_set_title(GTK_WINDOW(dialog), options->title_utf8);
+        }
+
+        GtkBox* content = GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog)));
+        handle->bar = gtk_progress_bar_new();
+        gtk_box_pack_start(content, handle->bar, FALSE, FALSE, 0);
+        handle->status = gtk_label_new("");
+        gtk_label_set_xalign(GTK_LABEL(handle->status), 0.0f);
+        gtk_box_pack_start(content, handle->status, FALSE, FALSE, 0);
+
+        gtk_dialog_add_button(GTK_DIALOG(dialog), CancelLabel(options), GTK_RESPONSE_CANCEL);
+        g_signal_connect(dialog, "response", G_CALLBACK(OnProgressResponse), handle);
+        g_signal_connect(dialog, "delete-event", G_CALLBACK(OnProgressDelete), nullptr);
+        gtk_widget_show_all(dialog);
+        handle->dialog = dialog;
+    }
+}
+
+namespace
+{
+    constexpr guint kToastMilliseconds = 4000;
+    constexpr size_t kMaxVisibleToasts = 5;
+    constexpr gint kToastMargin = 16;
+    constexpr gint kToastSpacing = 8;
+    constexpr gint kToastWidthChars = 40;
+
+    // Plain data copied from the caller, so a toast can be requested from any thread and outlive the call.
+    struct ToastRequest
+    {
+        std::string title;
+        std::string message;
+        std::vector<std::pair<std::string, NmbButtonId>> actions;
+        guint milliseconds = kToastMilliseconds;
+        NmbToastCallback callback = nullptr;
+        void* userData = nullptr;
+    };
+
+    struct Toast;
+
+    struct ToastAction
+    {
+        Toast* toast;
+        NmbButtonId id;
+    };
+
+    struct Toast
+    {
+        GtkWidget* window = nullptr;
+        uint64_t expires = 0; // runtime clock milliseconds
+        NmbToastCallback callback = nullptr;
+        void* userData = nullptr;
+        std::vector<ToastAction> actions;
+        bool answered = false;
+        NmbButtonId answer = NMB_BUTTON_ID_NONE;
+    };
+
+    // Every toast is created, expired and stacked by one GSource whose ready time is the earliest deadline,
+    // so any number of toasts costs one source and one wakeup per expiry. Other threads only append to
+    // incoming and make the source ready now; GTK itself is touched on the UI thread alone.
+    struct ToastStack
+    {
+        std::mutex lock;
+        std::vector<ToastRequest> incoming;
+        GSource* source = nullptr;
+        std::vector<std::unique_ptr<Toast>> shown; // oldest first; UI thread only
+    };
+
+    ToastStack& Toasts()
+    {
+        static ToastStack stack;
+        return stack;
+    }
+
+    void OnToastAction(GtkButton*, gpointer data)
+    {
+        auto* action = static_cast<ToastAction*>(data);
+        action->toast->answered = true;
+        action->toast->answer = action->id;
+        gtk_widget_hide(action->toast->window);
+        g_source_set_ready_time(Toasts().source, 0);
+    }
+
+    std::unique_ptr<Toast> CreateToast(const ToastRequest& request, uint64_t now)
+    {
+        auto toast = std::make_unique<Toast>();
+        toast->expires = now + request.milliseconds;
+        toast->callback = request.callback;
+        toast->userData = request.userData;
+
+        GtkWidget* window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+        gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
+        gtk_window_set_type_hint(GTK_WINDOW(window), GDK_WINDOW_TYPE_HINT_NOTIFICATION);
+        gtk_window_set_skip_taskbar_hint(GTK_WINDOW(window), TRUE);
+        gtk_window_set_skip_pager_hint(GTK_WINDOW(window), TRUE);
+        gtk_window_set_keep_above(GTK_WINDOW(window), TRUE);
+        gtk_window_set_accept_focus(GTK_WINDOW(window), FALSE);
+        gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
+        gtk_container_set_border_width(GTK_CONTAINER(window), 12);
+
+        GtkWidget* box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+        if (!request.title.empty())
+        {
+            char* markup = g_markup_printf_escaped("<b>%s</b>", request.title.c_str());
+            GtkWidget* title = gtk_label_new(nullptr);
+            gtk_label_set_markup(GTK_LABEL(title), markup);
+            gtk_label_set_xalign(GTK_LABEL(title), 0.0f);
+            gtk_box_pack_start(GTK_BOX(box), title, FALSE, FALSE, 0);
+            g_free(markup);
+        }
+
+        GtkWidget* message = gtk_label_new(request.message.c_str());
+        gtk_label_set_xalign(GTK_LABEL(message), 0.0f);
+        gtk_label_set_line_wrap(GTK_LABEL(message), TRUE);
+        gtk_label_set_max_width_chars(GTK_LABEL(message), kToastWidthChars);
+        gtk_box_pack_start(GTK_BOX(box), message, FALSE, FALSE, 0);
+
+        if (!request.actions.empty())
+        {
+            GtkWidget* row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
+            toast->actions.reserve(request.actions.size());
+            for (const auto& action : request.actions)
             {
-                GtkWidget* label = nullptr;
-                if (options->input->prompt_utf8)
-                {
-                    label = gtk_label_new(options->input->prompt_utf8);
-                    gtk_label_set_xalign(GTK_LABEL(label), 0.0f);
-                    gtk_box_pack_start(content, label, FALSE, FALSE, 0);
-                }
+                toast->actions.push_back(ToastAction{ toast.get(), action.second });
+                GtkWidget* button = gtk_button_new_with_label(action.first.c_str());
+                g_signal_connect(button, "clicked", G_CALLBACK(OnToastAction), &toast->actions.back());
+                gtk_box_pack_end(GTK_BOX(row), button, FALSE, FALSE, 0);
+            }
+            gtk_box_pack_start(GTK_BOX(box), row, FALSE, FALSE, 0);
+        }
 
-                GtkWidget* combo = gtk_combo_box_text_new();
-                if (options->input->combo_items_utf8)
-                {
-                    const char* const* items = options->input->combo_items_utf8;
-                    int index = 0;
-                    int defaultIndex = -1;
-                    while (items && *items)
-                    {
-                        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), *items);
-                        if (options->input->default_value_utf8 && strcmp(options->input->default_value_utf8, *items) == 0)
-                        {
-                            defaultIndex = index;
-                        }
-                        ++index;
-                        ++items;
-                    }
+        gtk_container_add(GTK_CONTAINER(window), box);
+        gtk_widget_show_all(window);
+        toast->window = window;
+        return toast;
+    }
+
+    // Newest toast at the top right of the work area, older ones below it.
+    void StackToasts(const std::vector<std::unique_ptr<Toast>>& shown)
+    {
+        GdkDisplay* display = gdk_display_get_default();
+        GdkMonitor* monitor = display ? gdk_display_get_primary_monitor(display) : nullptr;
+        if (!monitor && display)
+        {
+            monitor = gdk_display_get_monitor(display, 0);
+        }
+        if (!monitor)
+        {
+            return;
+        }
+
+        GdkRectangle area = {};
+        gdk_monitor_get_workarea(monitor, &area);
+        gint y = area.y + kToastMargin;
+        for (auto it = shown.rbegin(); it != shown.rend(); ++it)
+        {
+            gint width = 0;
+            gint height = 0;
+            gtk_window_get_size(GTK_WINDOW((*it)->window), &width, &height);
+            gtk_window_move(GTK_WINDOW((*it)->window), area.x + area.width - width - kToastMargin, y);
+            y += height + kToastSpacing;
+        }
+    }
+
+    const Toast* EarliestToast(const std::vector<std::unique_ptr<Toast>>& shown)
+    {
+        const Toast* earliest = nullptr;
+        for (const auto& toast : shown)
+        {
+            earliest = (!earliest || toast->expires < earliest->expires) ? toast.get() : earliest;
+        }
+        return earliest;
+    }
+
+    // Under the virtual clock the ready time stays unset, so expiry is checked whenever the loop wakes.
+    gboolean PrepareToasts(GSource*, gint* timeout)
+    {
+        *timeout = -1;
+        const Toast* earliest = EarliestToast(Toasts().shown);
+        return nmb_clock_is_virtual() && earliest && earliest->expires <= NowMilliseconds();
+    }
 
-                    if (defaultIndex >= 0)
-                    {
-                        gtk_combo_box_set_active(GTK_COMBO_BOX(combo), defaultIndex);
-                    }
-                    else if (index > 0)
-                    {
-                        gtk_combo_box_set_active(GTK_COMBO_BOX(combo), 0);
-                    }
+    gboolean DispatchToasts(GSource* source, GSourceFunc, gpointer)
+    {
+        ToastStack& stack = Toasts();
+        std::vector<ToastRequest> incoming;
+        {
+            std::lock_guard<std::mutex> guard(stack.lock);
+            incoming.swap(stack.incoming);
+        }
 
-                    if (options->input->default_value_utf8 && defaultIndex == -1)
-                    {
-                        gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo), options->input->default_value_utf8);
-                        gtk_combo_box_set_active(GTK_COMBO_BOX(combo), index);
-                    }
-                }
+        const uint64_t now = NowMilliseconds();
+        bool moved = !incoming.empty();
+        for (const ToastRequest& request : incoming)
+        {
+            stack.shown.push_back(CreateToast(request, now));
+        }
 
-                info.inputWidget = combo;
-                gtk_box_pack_start(content, combo, FALSE, FALSE, 0);
-                break;
-            }
-            case NMB_INPUT_CHECKBOX:
+        // Expired, answered and overflowing toasts leave together; callbacks run last, when the stack is
+        // consistent again, because they may well request another toast.
+        std::vector<std::unique_ptr<Toast>> finished;
+        const size_t overflow = stack.shown.size() > kMaxVisibleToasts ? stack.shown.size() - kMaxVisibleToasts : 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < stack.shown.size(); ++i)
+        {
+            std::unique_ptr<Toast>& toast = stack.shown[i];
+            if (i < overflow || toast->answered || toast->expires <= now)
             {
-                GtkWidget* checkbox = gtk_check_button_new_with_label(options->input->prompt_utf8 ? options->input->prompt_utf8 : "");
-                if (options->input->default_value_utf8 && strcmp(options->input->default_value_utf8, "true") == 0)
-                {
-                    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(checkbox), TRUE);
-                }
-
-                info.inputCheckbox = checkbox;
-                gtk_box_pack_start(content, checkbox, FALSE, FALSE, 0);
-                break;
+                finished.push_back(std::move(toast));
             }
-            default:
-                break;
+            else if (kept++ != i)
+            {
+                stack.shown[kept - 1] = std::move(toast);
             }
         }
+        stack.shown.resize(kept);
 
-        if (options->buttons && options->button_count > 0)
+        gint64 next = -1;
+        if (const Toast* earliest = EarliestToast(stack.shown))
         {
-            for (size_t i = 0; i < options->button_count; ++i)
+            next = ReadyTime(earliest->expires);
+        }
+        {
+            // A request queued since the swap above has already asked for an immediate pass; keep it.
+            std::lock_guard<std::mutex> guard(stack.lock);
+            g_source_set_ready_time(source, stack.incoming.empty() ? next : 0);
+        }
+
+        if (moved || !finished.empty())
+        {
+            StackToasts(stack.shown);
+        }
+        for (const auto& toast : finished)
+        {
+            gtk_widget_destroy(toast->window);
+            if (toast->callback)
             {
-                const NmbButtonOption& button = options->buttons[i];
-                int responseId = GTK_RESPONSE_NONE - static_cast<int>(i) - 1;
-                gtk_dialog_add_button(GTK_DIALOG(dialog), button.label_utf8 ? button.label_utf8 : "", responseId);
-                info.buttonMap.emplace_back(responseId, button.id);
-                if (button.is_default)
-                {
-                    gtk_dialog_set_default_response(GTK_DIALOG(dialog), responseId);
-                }
+                toast->callback(toast->userData, toast->answer);
             }
         }
-        else
+        return G_SOURCE_CONTINUE;
+    }
+
+    GSourceFuncs kToastSourceFuncs = { PrepareToasts, nullptr, DispatchToasts, nullptr, nullptr, nullptr };
+
+    void QueueToast(const NmbMessageBoxOptions* options, const NmbToastOption* toast)
+    {
+        ToastRequest request;
+        request.title = options->title_utf8 ? options->title_utf8 : "";
+        request.message = options->message_utf8;
+        for (size_t i = 0; options->buttons && i < options->button_count; ++i)
         {
-            gtk_dialog_add_button(GTK_DIALOG(dialog), "OK", GTK_RESPONSE_OK);
-            info.buttonMap.emplace_back(GTK_RESPONSE_OK, NMB_BUTTON_ID_OK);
+            const NmbButtonOption& button = options->buttons[i];
+            request.actions.emplace_back(button.label_utf8 ? button.label_utf8 : "", button.id);
+        }
+        if (toast->duration_milliseconds > 0)
+        {
+            request.milliseconds = toast->duration_milliseconds;
         }
+        request.callback = toast->callback;
+        request.userData = toast->user_data;
 
-        info.requiresExplicitAck = options->requires_explicit_ack == NMB_TRUE;
-        info.allowClose = (options->allow_cancel_via_escape == NMB_TRUE) && !info.requiresExplicitAck;
-        g_signal_connect(dialog, "delete-event", G_CALLBACK(OnDeleteEvent), &info);
-        g_signal_connect(dialog, "key-press-event", G_CALLBACK(OnKeyPress), &info);
+        ToastStack& stack = Toasts();
+        std::lock_guard<std::mutex> guard(stack.lock);
+        stack.incoming.push_back(std::move(request));
+        if (!stack.source)
+        {
+            stack.source = g_source_new(&kToastSourceFuncs, sizeof(GSource));
+            g_source_attach(stack.source, nullptr);
+            nmb_clock_set_wake(WakeMainContext);
+        }
+        g_source_set_ready_time(stack.source, 0);
+    }
+}
 
-        if (options->timeout_milliseconds > 0 && options->timeout_button_id != NMB_BUTTON_ID_NONE)
+namespace
+{
+    // Lets a host without GLib drive GTK from its own poll loop. The fd it watches is an epoll set over the
+    // runtime's eventfd, a timerfd for GLib's next timeout and the fds GLib itself would poll. nmb_pump runs
+    // GLib's external-loop cycle (prepare, query, check, dispatch) without blocking, then refreshes the set.
+    struct PumpState
+    {
+        std::mutex lock;
+        int epoll = -1;
+        int timer = -1;
+        std::vector<int> watched; // GLib fds currently in the epoll set
+        std::vector<GPollFD> fds;
+        gint polled = 0;          // entries of fds filled in by the latest query
+    };
+
+    PumpState& Pump()
+    {
+        static PumpState state;
+        return state;
+    }
+
+    // Requires state.lock.
+    bool OpenPumpFd(PumpState& state)
+    {
+        if (state.epoll >= 0)
         {
-            int mappedResponse = 0;
-            for (const auto& pair : info.buttonMap)
+            return true;
+        }
+
+        const int events = nmb_event_fd();
+        const int epoll = epoll_create1(EPOLL_CLOEXEC);
+        const int timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        bool ready = events >= 0 && epoll >= 0 && timer >= 0;
+        event.data.fd = events;
+        ready = ready && epoll_ctl(epoll, EPOLL_CTL_ADD, events, &event) == 0;
+        event.data.fd = timer;
+        ready = ready && epoll_ctl(epoll, EPOLL_CTL_ADD, timer, &event) == 0;
+        if (!ready)
+        {
+            nmb_runtime_log("Linux: Unable to create the pump fd.");
+            if (epoll >= 0)
             {
-                if (pair.second == options->timeout_button_id)
-                {
-                    mappedResponse = pair.first;
-                    break;
-                }
+                close(epoll);
             }
-
-            if (mappedResponse != 0)
+            if (timer >= 0)
             {
-                info.timeoutResponse = mappedResponse;
-                g_timeout_add(options->timeout_milliseconds, TimeoutCallback, &info);
+                close(timer);
             }
+            return false;
         }
 
-        gtk_widget_show_all(dialog);
+        state.epoll = epoll;
+        state.timer = timer;
+        return true;
+    }
 
-        int response = gtk_dialog_run(GTK_DIALOG(dialog));
+    // Fires the timer after timeout milliseconds; 0 makes the fd readable now and -1 disarms it.
+    void ArmPumpTimer(const PumpState& state, gint timeout)
+    {
+        itimerspec spec = {};
+        if (timeout == 0)
+        {
+            spec.it_value.tv_nsec = 1;
+        }
+        else if (timeout > 0)
+        {
+            spec.it_value.tv_sec = timeout / 1000;
+            spec.it_value.tv_nsec = static_cast<long>(timeout % 1000) * 1000000L;
+        }
+        timerfd_settime(state.timer, 0, &spec, nullptr);
+    }
 
-        NmbButtonId button = NMB_BUTTON_ID_NONE;
-        bool mapped = MapButtonId(info, response, &button);
+    // Clears the timer's expirations so the pump fd blocks again. EAGAIN only means it has not fired.
+    void DrainPumpTimer(const PumpState& state)
+    {
+        uint64_t expirations = 0;
+        ssize_t count = 0;
+        do
+        {
+            count = read(state.timer, &expirations, sizeof(expirations));
+        } while (count < 0 && errno == EINTR);
 
-        if (info.verification)
+        if (count < 0 && errno != EAGAIN)
         {
-            gboolean value = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(info.verification));
-            out_result->checkbox_checked = value ? NMB_TRUE : NMB_FALSE;
+            nmb_runtime_log("Linux: Unable to clear the pump timer.");
         }
+    }
 
-        out_result->was_timeout = info.timedOut ? NMB_TRUE : NMB_FALSE;
+    // Replaces the GLib fds in the epoll set with those of the latest query. An fd GLib lists twice is merged.
+    void WatchGlibFds(PumpState& state, gint count)
+    {
+        for (int fd : state.watched)
+        {
+            epoll_ctl(state.epoll, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        state.watched.clear();
 
-        if (!mapped)
+        std::vector<std::pair<int, uint32_t>> merged;
+        for (gint i = 0; i < count; ++i)
         {
-            switch (response)
+            const GPollFD& fd = state.fds[i];
+            uint32_t events = 0;
+            events |= (fd.events & G_IO_IN) ? static_cast<uint32_t>(EPOLLIN) : 0u;
+            events |= (fd.events & G_IO_OUT) ? static_cast<uint32_t>(EPOLLOUT) : 0u;
+            events |= (fd.events & G_IO_PRI) ? static_cast<uint32_t>(EPOLLPRI) : 0u;
+            auto existing = std::find_if(merged.begin(), merged.end(),
+                                         [&](const std::pair<int, uint32_t>& entry) { return entry.first == fd.fd; });
+            if (existing != merged.end())
             {
-            case GTK_RESPONSE_DELETE_EVENT:
-            case GTK_RESPONSE_CANCEL:
-            case GTK_RESPONSE_CLOSE:
-            case GTK_RESPONSE_REJECT:
-            case GTK_RESPONSE_NONE:
-                out_result->button = NMB_BUTTON_ID_CANCEL;
-                out_result->input_value_utf8 = nullptr;
-                gtk_widget_destroy(dialog);
-                out_result->result_code = NMB_E_CANCELLED;
-                return NMB_E_CANCELLED;
-            default:
-                break;
+                existing->second |= events;
+            }
+            else
+            {
+                merged.emplace_back(fd.fd, events);
             }
         }
 
-        out_result->button = button;
-
-        NmbResultCode rc = CopyInputValue(options, &info, out_result);
-        gtk_widget_destroy(dialog);
+        for (const auto& entry : merged)
+        {
+            epoll_event event = {};
+            event.events = entry.second;
+            event.data.fd = entry.first;
+            if (epoll_ctl(state.epoll, EPOLL_CTL_ADD, entry.first, &event) == 0)
+            {
+                state.watched.push_back(entry.first);
+            }
+        }
+    }
 
-        if (rc != NMB_OK)
+    // One non-blocking pass of the cycle. Afterwards the first state.polled entries of state.fds and *timeout
+    // say what the context waits for. guard holds state.lock and is released while sources dispatch, so their
+    // callbacks may call nmb_pump or nmb_get_event_fd. Returns whether any source was dispatched.
+    bool IteratePump(PumpState& state, std::unique_lock<std::mutex>& guard, GMainContext* context, gint* timeout)
+    {
+        gint priority = 0;
+        g_main_context_prepare(context, &priority);
+        gint capacity = static_cast<gint>(state.fds.size());
+        gint needed = 0;
+        while ((needed = g_main_context_query(context, priority, timeout, state.fds.data(), capacity)) > capacity)
         {
-            out_result->result_code = rc;
-            return rc;
+            state.fds.resize(static_cast<size_t>(needed));
+            capacity = needed;
         }
 
-        out_result->result_code = NMB_OK;
-        return NMB_OK;
+        g_poll(state.fds.data(), static_cast<guint>(needed), 0);
+        const bool ready = g_main_context_check(context, priority, state.fds.data(), needed) == TRUE;
+        state.polled = needed;
+        if (ready)
+        {
+            guard.unlock();
+            g_main_context_dispatch(context);
+            guard.lock();
+        }
+        return ready;
     }
 }
 
@@ -646,7 +3206,8 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
 
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
 {
-    if (!options || !options->message_utf8 || !out_result)
+    const uint64_t received = nmb_clock_now_microseconds();
+    if (!options || !out_result)
     {
         return NMB_E_INVALID_ARGUMENT;
     }
@@ -663,25 +3224,76 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return validation;
     }
 
-    out_result->struct_size = sizeof(*out_result);
-    out_result->button = NMB_BUTTON_ID_NONE;
-    out_result->checkbox_checked = NMB_FALSE;
-    out_result->input_value_utf8 = nullptr;
-    out_result->was_timeout = NMB_FALSE;
-    out_result->result_code = NMB_OK;
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    options = prepared.value.options;
+    if (!options->message_utf8)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    validation = nmb_reset_result(options, out_result);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    nmb_timing_begin(out_result, received);
+
+    // A thread that runs the GLib loop, nested in a dialog's or its own, would stop answering the dialog it
+    // joined, so only other threads coalesce.
+    if (nmb_templated_message(options))
+    {
+        const nmb_bool may_wait = g_main_context_is_owner(g_main_context_default()) ? NMB_FALSE : NMB_TRUE;
+        return nmb_message_template_show(options, out_result, nmb_show_message_box, may_wait);
+    }
 
+    if (nmb_aggregation(options))
+    {
+        return nmb_aggregate_show(options, out_result, nmb_show_message_box);
+    }
+
+    const NmbToastOption* toast = nmb_toast(options);
 #if defined(NMB_TESTING)
     if (ApplyTestHarness(options, out_result))
     {
+        // The scripted button stands for the action clicked on the toast.
+        if (toast)
+        {
+            if (toast->callback)
+            {
+                toast->callback(toast->user_data, out_result->button);
+            }
+            out_result->button = NMB_BUTTON_ID_NONE;
+        }
         return out_result->result_code;
     }
 #endif
 
+    if (toast)
+    {
+        if (!EnsureGtkInitialized())
+        {
+            nmb_runtime_log("Linux: GTK unavailable; toasts need a display.");
+            return NMB_E_PLATFORM_FAILURE;
+        }
+
+        QueueToast(options, toast);
+        nmb_timing_finish(out_result, NMB_BACKEND_GTK);
+        out_result->result_code = NMB_OK;
+        return NMB_OK;
+    }
+
     if (!EnsureGtkInitialized())
     {
         nmb_runtime_log("Linux: GTK unavailable, attempting zenity fallback.");
         if (RunZenityFallback(options, out_result))
         {
+            nmb_timing_finish(out_result, NMB_BACKEND_ZENITY);
             return NMB_OK;
         }
 
@@ -689,9 +3301,195 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return NMB_E_PLATFORM_FAILURE;
     }
 
+    if (t_handsOverDialogs)
+    {
+        return ShowGtkDialogForHelper(options, out_result);
+    }
     return ShowGtkDialog(options, out_result);
 }
 
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data)
+{
+    return ShowMessageBoxAsync(options, out_result, nullptr, callback, user_data);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void* main_context,
+                                                               NmbMessageBoxCallback callback, void* user_data)
+{
+    GMainContext* context = main_context ? static_cast<GMainContext*>(main_context) : g_main_context_default();
+    return ShowMessageBoxAsync(options, out_result, context, callback, user_data);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request)
+{
+    NmbResultCode rc = nmb_request_submit(options, out_result, out_request, nmb_show_message_box_async);
+    if (rc == NMB_OK)
+    {
+        // The new dialog has GTK work to do before it maps; have the host pump.
+        nmb_event_fd_signal();
+    }
+    return rc;
+}
+
+NMB_API int NMB_CALL nmb_get_event_fd(void)
+{
+    PumpState& state = Pump();
+    std::lock_guard<std::mutex> guard(state.lock);
+    const bool created = state.epoll < 0;
+    if (!OpenPumpFd(state))
+    {
+        return -1;
+    }
+    if (created)
+    {
+        // GLib's fds join the set on the first pump.
+        ArmPumpTimer(state, 0);
+    }
+    return state.epoll;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t max_time_milliseconds)
+{
+    PumpState& state = Pump();
+    std::unique_lock<std::mutex> guard(state.lock);
+    nmb_event_fd_drain();
+    if (state.timer >= 0)
+    {
+        DrainPumpTimer(state);
+    }
+    if (!EnsureGtkInitialized())
+    {
+        return NMB_OK;
+    }
+
+    GMainContext* context = g_main_context_default();
+    if (!g_main_context_acquire(context))
+    {
+        nmb_runtime_log("Linux: Another thread runs the GLib main context; nmb_pump has nothing to do.");
+        return NMB_E_PLATFORM_FAILURE;
+    }
+
+    const uint64_t deadline = nmb_clock_now_milliseconds() + max_time_milliseconds;
+    gint timeout = -1;
+    bool dispatched = false;
+    do
+    {
+        dispatched = IteratePump(state, guard, context, &timeout);
+    } while (dispatched && nmb_clock_now_milliseconds() < deadline);
+
+    if (OpenPumpFd(state))
+    {
+        // A nested nmb_pump may have queried since; state.polled always matches the fds it left behind.
+        WatchGlibFds(state, state.polled);
+        // Out of time with sources still dispatching: come back right away.
+        ArmPumpTimer(state, dispatched ? 0 : timeout);
+    }
+    g_main_context_release(context);
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options, NmbProgressHandle** out_handle)
+{
+    if (!out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    *out_handle = nullptr;
+    if (!options)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    NmbResultCode validation = ValidateMessageBoxOptions(options);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    options = prepared.value.options;
+
+    auto* handle = new (std::nothrow) NmbProgressHandle();
+    if (!handle)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+#if defined(NMB_TESTING)
+    if (IsTestHarness(options))
+    {
+        const auto* harness = static_cast<const NmbTestHarness*>(options->user_context);
+        handle->headless = true;
+        handle->cancelled.store(harness->result_code == NMB_E_CANCELLED);
+        *out_handle = handle;
+        return NMB_OK;
+    }
+#endif
+
+    if (!EnsureGtkInitialized())
+    {
+        nmb_runtime_log("Linux: Progress dialogs require GTK.");
+        delete handle;
+        return NMB_E_PLATFORM_FAILURE;
+    }
+
+    ShowProgressDialog(options, handle);
+    *out_handle = handle;
+    return NMB_OK;
+}
+
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle* handle, double fraction, const char* text_utf8)
+{
+    if (!handle)
+    {
+        return;
+    }
+
+    fraction = fraction >= 0.0 ? std::min(fraction, 1.0) : -1.0;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &fraction, sizeof(bits));
+    handle->fractionBits.store(bits);
+    if (text_utf8)
+    {
+        g_free(handle->pendingText.exchange(g_strdup(text_utf8)));
+    }
+
+    if (!handle->headless && !handle->armed.exchange(true))
+    {
+        handle->references.fetch_add(1);
+        g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, kProgressFrameMilliseconds, ApplyProgress, handle, nullptr);
+    }
+}
+
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle* handle)
+{
+    return handle && handle->cancelled.load(std::memory_order_relaxed) ? NMB_TRUE : NMB_FALSE;
+}
+
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle* handle)
+{
+    if (!handle)
+    {
+        return;
+    }
+
+    if (handle->headless)
+    {
+        ReleaseProgress(handle);
+        return;
+    }
+    g_main_context_invoke(nullptr, FinishProgress, handle);
+}
+
 NMB_API void NMB_CALL nmb_shutdown(void)
 {
     nmb_runtime_reset_log();
@@ -8,9 +8,18 @@
 #include <string.h>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
+#include "../../shared/nmb_aggregate.h"
 #include "../../shared/nmb_alloc.h"
+#include "../../shared/nmb_async.h"
+#include "../../shared/nmb_clock.h"
+#include "../../shared/nmb_message_template.h"
+#include "../../shared/nmb_options.h"
+#include "../../shared/nmb_request.h"
 #include "../../shared/nmb_runtime.h"
+#include "../../shared/nmb_timing.h"
+#include "../../shared/nmb_toast.h"
 #if defined(NMB_TESTING)
 #include "native_message_box_test.h"
 #endif
@@ -433,9 +442,27 @@ static bool ApplyTestHarness(const NmbMessageBoxOptions* options, NmbMessageBoxR
         out_result->checkbox_checked = harness->checkbox_checked;
         out_result->was_timeout = harness->simulate_timeout;
         out_result->result_code = harness->result_code;
+
+        const uint32_t timeout = options->timeout_button_id != NMB_BUTTON_ID_NONE ? options->timeout_milliseconds : 0;
+        if (nmb_clock_play_scripted_answer(timeout, harness->answer_after_milliseconds))
+        {
+            out_result->button = options->timeout_button_id;
+            out_result->was_timeout = NMB_TRUE;
+        }
+        nmb_timing_finish(out_result, NMB_BACKEND_HEADLESS);
+
         out_result->input_value_utf8 = nullptr;
 
-        if (harness->input_value_utf8)
+        if (harness->input_value_utf8 && nmb_input_chunk_callback(options->input))
+        {
+            NmbResultCode rc = nmb_deliver_input_text(options, harness->input_value_utf8,
+                                                      std::strlen(harness->input_value_utf8), out_result);
+            if (rc != NMB_OK)
+            {
+                out_result->result_code = rc;
+            }
+        }
+        else if (harness->input_value_utf8)
         {
             if (options->allocator)
             {
@@ -451,6 +478,15 @@ static bool ApplyTestHarness(const NmbMessageBoxOptions* options, NmbMessageBoxR
             }
         }
 
+        NmbResultCode fields_rc =
+            nmb_store_field_values(options, harness->field_values, harness->field_value_count, out_result);
+        if (fields_rc != NMB_OK)
+        {
+            out_result->result_code = fields_rc;
+        }
+
+        nmb_store_selection(options, harness->selection_bits, out_result);
+
         return true;
 }
 #endif
@@ -470,6 +506,26 @@ static NmbResultCode ShowAlertInternal(const NmbMessageBoxOptions* options, NmbM
         }
 #endif
 
+        size_t fieldCount = 0;
+        if (nmb_form_fields(options, &fieldCount))
+        {
+            nmb_runtime_log("macOS: Form dialogs are not supported.");
+            out_result->result_code = NMB_E_NOT_SUPPORTED;
+            return NMB_E_NOT_SUPPORTED;
+        }
+
+        if (options->input && options->input->mode == NMB_INPUT_MULTISELECT)
+        {
+            nmb_runtime_log("macOS: Multi-select inputs are not supported.");
+            out_result->result_code = NMB_E_NOT_SUPPORTED;
+            return NMB_E_NOT_SUPPORTED;
+        }
+
+        if (nmb_dialog_handle(options))
+        {
+            nmb_runtime_log("macOS: Live dialog updates are not supported; the handle is ignored.");
+        }
+
         @autoreleasepool
         {
             NSAlert* alert = [[NSAlert alloc] init];
@@ -685,6 +741,7 @@ static NmbResultCode ShowAlertInternal(const NmbMessageBoxOptions* options, NmbM
                 }
             }
 
+            nmb_timing_mark(out_result, NMB_TIMING_BUILT);
             if (parent)
             {
                 __block NSModalResponse sheetResponse = NSModalResponseCancel;
@@ -711,6 +768,7 @@ static NmbResultCode ShowAlertInternal(const NmbMessageBoxOptions* options, NmbM
             {
                 response = [alert runModal];
             }
+            nmb_timing_finish(out_result, NMB_BACKEND_APPKIT);
 
             if (helper.timeoutSource)
             {
@@ -832,6 +890,7 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
 
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
 {
+    const uint64_t received = nmb_clock_now_microseconds();
     if (!options || !out_result)
     {
         return NMB_E_INVALID_ARGUMENT;
@@ -849,12 +908,57 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return validation;
     }
 
-    out_result->struct_size = sizeof(*out_result);
-    out_result->button = NMB_BUTTON_ID_NONE;
-    out_result->checkbox_checked = NMB_FALSE;
-    out_result->input_value_utf8 = nullptr;
-    out_result->was_timeout = NMB_FALSE;
-    out_result->result_code = NMB_OK;
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_expanded_source(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_table(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_expand_combo_buffer(&prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    options = prepared.value.options;
+
+    validation = nmb_reset_result(options, out_result);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    nmb_timing_begin(out_result, received);
+
+    // Joining an open dialog would block the main thread that shows it, so main-thread requests never coalesce.
+    if (nmb_templated_message(options))
+    {
+        const nmb_bool may_wait = [NSThread isMainThread] ? NMB_FALSE : NMB_TRUE;
+        return nmb_message_template_show(options, out_result, nmb_show_message_box, may_wait);
+    }
+
+    // A burst blocks its followers until the dialog closes, which would deadlock the main thread that shows it.
+    if (nmb_aggregation(options) && ![NSThread isMainThread])
+    {
+        return nmb_aggregate_show(options, out_result, nmb_show_message_box);
+    }
+
+    if (nmb_toast(options))
+    {
+        return nmb_toast_show_modal(options, out_result, nmb_show_message_box);
+    }
 
     if (![NSThread isMainThread])
     {
@@ -868,6 +972,62 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     return ShowAlertInternal(options, out_result);
 }
 
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void*,
+                                                               NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request)
+{
+    return nmb_request_submit(options, out_result, out_request, nmb_show_message_box_async);
+}
+
+NMB_API int NMB_CALL nmb_get_event_fd(void)
+{
+    return nmb_event_fd();
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t)
+{
+    nmb_event_fd_drain();
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options, NmbProgressHandle** out_handle)
+{
+    if (!options || !out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    *out_handle = nullptr;
+    nmb_runtime_log("macOS: Progress dialogs are not supported.");
+    return NMB_E_NOT_SUPPORTED;
+}
+
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle*, double, const char*)
+{
+}
+
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle*)
+{
+    return NMB_FALSE;
+}
+
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle*)
+{
+}
+
 NMB_API void NMB_CALL nmb_shutdown(void)
 {
     nmb_runtime_reset_log();
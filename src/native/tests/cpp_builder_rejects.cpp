@@ -0,0 +1,42 @@
+#include "native_message_box.hpp"
+
+/*
+ * Each non-zero NMB_BROKEN_RULE declares one constant dialog that breaks a rule; building it must fail.
+ * NMB_BROKEN_RULE=0 is the control and must build.
+ */
+
+#if NMB_BROKEN_RULE == 0
+static constexpr const char* kItems[] = { "One", "Two", nullptr };
+static constexpr auto kBroken = nmb::dialog("Pick one", nmb::kOkCancel).input(NMB_INPUT_COMBO).combo_items(kItems);
+#elif NMB_BROKEN_RULE == 1
+static constexpr auto kBroken =
+    nmb::button_set({ nmb::button(NMB_BUTTON_ID_OK, "OK"), nmb::button(NMB_BUTTON_ID_OK, "Also OK") });
+#elif NMB_BROKEN_RULE == 2
+static constexpr auto kBroken = nmb::button_set(
+    { nmb::default_button(NMB_BUTTON_ID_YES, "Yes"), nmb::default_button(NMB_BUTTON_ID_NO, "No") });
+#elif NMB_BROKEN_RULE == 3
+static constexpr auto kBroken = nmb::dialog("Continue?", nmb::kYesNo).timeout(5000, NMB_BUTTON_ID_CANCEL);
+#elif NMB_BROKEN_RULE == 4
+static constexpr const char* kItems[] = { "One", "Two", nullptr };
+static constexpr auto kBroken = nmb::dialog("Name?", nmb::kOkCancel).input(NMB_INPUT_TEXT).combo_items(kItems);
+#elif NMB_BROKEN_RULE == 5
+static constexpr auto kBroken = nmb::button_set({ nmb::button(NMB_BUTTON_ID_OK, nullptr) });
+#elif NMB_BROKEN_RULE == 6
+static constexpr auto kBroken = nmb::button_set({ nmb::button(NMB_BUTTON_ID_NONE, "Nothing") });
+#elif NMB_BROKEN_RULE == 7
+static constexpr auto kBroken = nmb::button_set(
+    { nmb::cancel_button(NMB_BUTTON_ID_ABORT, "Abort"), nmb::cancel_button(NMB_BUTTON_ID_CANCEL, "Cancel") });
+#elif NMB_BROKEN_RULE == 8
+static constexpr auto kBroken = nmb::dialog(nullptr, nmb::kOk);
+#elif NMB_BROKEN_RULE == 9
+static constexpr const char* kItems[] = { "One", "Two" };
+static constexpr auto kBroken = nmb::dialog("Pick one", nmb::kOkCancel).input(NMB_INPUT_COMBO).combo_items(kItems);
+#else
+#error "Define NMB_BROKEN_RULE"
+#endif
+
+int main()
+{
+    static_cast<void>(kBroken);
+    return 0;
+}
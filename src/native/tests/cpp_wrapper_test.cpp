@@ -0,0 +1,272 @@
+#include "native_message_box.hpp"
+#include "native_message_box_test.h"
+
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <new>
+
+/* Counts every operator new in the process, the runtime's own included, so the wrapper is held to the C API. */
+static size_t s_heap_allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++s_heap_allocations;
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+struct CountingAllocator
+{
+    size_t allocations;
+    size_t deallocations;
+};
+
+static void* counting_allocate(void* user_data, size_t size, size_t)
+{
+    ++static_cast<CountingAllocator*>(user_data)->allocations;
+    return std::malloc(size);
+}
+
+static void counting_deallocate(void* user_data, void* ptr)
+{
+    ++static_cast<CountingAllocator*>(user_data)->deallocations;
+    std::free(ptr);
+}
+
+/* Fire-and-forget coroutine; the frame frees itself when the body returns. */
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+struct Outcome
+{
+    bool finished;
+    size_t heap_allocations;
+    NmbResultCode code;
+    NmbButtonId button;
+    bool input_matches;
+    size_t deallocations_while_held;
+};
+
+static const NmbButtonOption kButtons[2] = {
+    { sizeof(NmbButtonOption), NMB_BUTTON_ID_OK, "OK", nullptr, NMB_BUTTON_KIND_DEFAULT, NMB_TRUE, NMB_FALSE },
+    { sizeof(NmbButtonOption), NMB_BUTTON_ID_CANCEL, "Cancel", nullptr, NMB_BUTTON_KIND_DEFAULT, NMB_FALSE, NMB_TRUE },
+};
+
+static Detached await_dialog(const NmbAllocator* allocator, NmbTestHarness* harness, Outcome* outcome)
+{
+    const size_t heap_before = s_heap_allocations;
+    nmb::Result result = co_await nmb::show(
+        nmb::Options().title("Test").message("Name?").buttons(kButtons).allocator(allocator).user_context(harness));
+    outcome->heap_allocations = s_heap_allocations - heap_before;
+    outcome->code = result.code();
+    outcome->button = result.button();
+    outcome->input_matches = result.input_value() == "Ada";
+    outcome->deallocations_while_held = static_cast<const CountingAllocator*>(allocator->user_data)->deallocations;
+
+    nmb::Result moved = std::move(result);
+    outcome->input_matches = outcome->input_matches && result.input_value().empty() && moved.input_value() == "Ada";
+    outcome->finished = true;
+}
+
+static void init_harness(NmbTestHarness* harness)
+{
+    std::memset(harness, 0, sizeof(*harness));
+    harness->struct_size = sizeof(*harness);
+    harness->magic = NMB_TEST_HARNESS_MAGIC;
+    harness->scripted_button = NMB_BUTTON_ID_OK;
+    harness->result_code = NMB_OK;
+    harness->input_value_utf8 = "Ada";
+}
+
+/* The C API's own heap and allocator traffic for the same request, freed by hand. */
+static int measure_c_api(const NmbAllocator* allocator, size_t* out_heap_allocations)
+{
+    NmbTestHarness harness;
+    init_harness(&harness);
+
+    NmbMessageBoxOptions options;
+    std::memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.title_utf8 = "Test";
+    options.message_utf8 = "Name?";
+    options.buttons = kButtons;
+    options.button_count = 2;
+    options.timeout_button_id = NMB_BUTTON_ID_NONE;
+    options.allocator = allocator;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    std::memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    struct Probe
+    {
+        static void NMB_CALL Done(void* user_data, NmbMessageBoxResult*) { *static_cast<bool*>(user_data) = true; }
+    };
+
+    bool done = false;
+    const size_t heap_before = s_heap_allocations;
+    NmbResultCode rc = nmb_show_message_box_async(&options, &result, &Probe::Done, &done);
+    *out_heap_allocations = s_heap_allocations - heap_before;
+    if (rc != NMB_OK || !done || result.result_code != NMB_OK || !result.input_value_utf8)
+    {
+        std::fprintf(stderr, "C API baseline failed (rc=%u)\n", rc);
+        return 1;
+    }
+    allocator->deallocate(allocator->user_data, const_cast<char*>(result.input_value_utf8));
+    return 0;
+}
+
+static int run_allocation_count_test()
+{
+    CountingAllocator counts = {};
+    const NmbAllocator allocator = { counting_allocate, counting_deallocate, &counts };
+
+    size_t c_heap_allocations = 0;
+    if (measure_c_api(&allocator, &c_heap_allocations) != 0)
+    {
+        return 1;
+    }
+    const size_t c_allocations = counts.allocations;
+    counts = {};
+
+    NmbTestHarness harness;
+    init_harness(&harness);
+    Outcome outcome = {};
+    await_dialog(&allocator, &harness, &outcome);
+
+    if (!outcome.finished || outcome.code != NMB_OK || outcome.button != NMB_BUTTON_ID_OK || !outcome.input_matches)
+    {
+        std::fprintf(stderr, "Awaited dialog did not resume with its answer (code=%u, button=%d)\n", outcome.code,
+                     static_cast<int>(outcome.button));
+        return 1;
+    }
+    if (outcome.heap_allocations != c_heap_allocations || counts.allocations != c_allocations)
+    {
+        std::fprintf(stderr, "Wrapper allocated beyond the C API (heap %zu vs %zu, allocator %zu vs %zu)\n",
+                     outcome.heap_allocations, c_heap_allocations, counts.allocations, c_allocations);
+        return 1;
+    }
+    if (outcome.deallocations_while_held != 0 || counts.deallocations != counts.allocations)
+    {
+        std::fprintf(stderr, "Result did not free its input exactly once (%zu of %zu)\n", counts.deallocations,
+                     counts.allocations);
+        return 1;
+    }
+    return 0;
+}
+
+static Detached await_rejected(NmbResultCode* out_code)
+{
+    nmb::Options options;
+    options.raw().struct_size = 0;
+    nmb::Result result = co_await nmb::show(options);
+    *out_code = result.code();
+}
+
+static constexpr const char* kColors[] = { "Red", "Green", "Blue", nullptr };
+
+static constexpr auto kPickColor = nmb::dialog("Pick a color", nmb::kOkCancel)
+                                       .title("Colors")
+                                       .input(NMB_INPUT_COMBO, "Color")
+                                       .combo_items(kColors)
+                                       .timeout(30000, NMB_BUTTON_ID_CANCEL);
+
+static_assert(nmb::kOkCancel.size() == 2 && nmb::kOkCancel.options[0].is_default &&
+              nmb::kOkCancel.options[1].is_cancel);
+static_assert(nmb::kYesNo.contains(NMB_BUTTON_ID_NO) && !nmb::kYesNo.contains(NMB_BUTTON_ID_OK));
+static_assert(nmb::kAbortRetryIgnore.options[2].id == NMB_BUTTON_ID_IGNORE);
+
+static int run_dialog_template_test()
+{
+    NmbTestHarness harness;
+    init_harness(&harness);
+    harness.scripted_button = NMB_BUTTON_ID_CANCEL;
+    harness.input_value_utf8 = "Green";
+
+    nmb::Options options(kPickColor);
+    options.user_context(&harness);
+    const NmbMessageBoxOptions& raw = options.raw();
+    if (raw.button_count != 2 || raw.buttons[0].id != NMB_BUTTON_ID_OK || !raw.buttons[1].is_cancel)
+    {
+        std::fprintf(stderr, "Template buttons were not applied\n");
+        return 1;
+    }
+    if (!raw.input || raw.input->mode != NMB_INPUT_COMBO || raw.input->combo_items_utf8 != kColors ||
+        raw.timeout_button_id != NMB_BUTTON_ID_CANCEL || std::strcmp(raw.title_utf8, "Colors") != 0)
+    {
+        std::fprintf(stderr, "Template fields were not applied\n");
+        return 1;
+    }
+
+    NmbMessageBoxResult result;
+    std::memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+    NmbResultCode rc = nmb_show_message_box(&raw, &result);
+    nmb::Result owned(result, raw.allocator);
+    if (rc != NMB_OK || owned.button() != NMB_BUTTON_ID_CANCEL || owned.input_value() != "Green" ||
+        owned.backend() != NMB_BACKEND_HEADLESS)
+    {
+        std::fprintf(stderr, "Template dialog was not shown (rc=%u)\n", rc);
+        return 1;
+    }
+    return 0;
+}
+
+static int run_rejected_request_test()
+{
+    NmbResultCode code = NMB_OK;
+    await_rejected(&code);
+    if (code != NMB_E_INVALID_ARGUMENT)
+    {
+        std::fprintf(stderr, "Rejected request did not resume with its error (%u)\n", code);
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    NmbInitializeOptions init_opts;
+    std::memset(&init_opts, 0, sizeof(init_opts));
+    init_opts.struct_size = sizeof(init_opts);
+    init_opts.abi_version = NMB_ABI_VERSION;
+
+    NmbResultCode rc = nmb_initialize(&init_opts);
+    if (rc != NMB_OK && rc != NMB_E_PLATFORM_FAILURE)
+    {
+        std::fprintf(stderr, "nmb_initialize failed: %u\n", rc);
+        return 1;
+    }
+
+    const int failed = run_allocation_count_test() != 0 || run_rejected_request_test() != 0 ||
+                       run_dialog_template_test() != 0;
+    nmb_shutdown();
+    return failed ? 1 : 0;
+}
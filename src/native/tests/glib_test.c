@@ -0,0 +1,70 @@
+#include "native_message_box_glib.h"
+#include "native_message_box_test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct GlibAnswer_t
+{
+    int calls;
+    NmbMessageBoxResult* result;
+    GError* error;
+} GlibAnswer;
+
+static void on_answered(GObject* source, GAsyncResult* result, gpointer user_data)
+{
+    (void)source;
+    GlibAnswer* answer = (GlibAnswer*)user_data;
+    ++answer->calls;
+    answer->result = nmb_show_message_box_finish(result, &answer->error);
+}
+
+int main(void)
+{
+    GMainContext* context = g_main_context_new();
+    g_main_context_push_thread_default(context);
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.title_utf8 = "Test";
+    options.message_utf8 = "Test message";
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    GlibAnswer answer;
+    memset(&answer, 0, sizeof(answer));
+    nmb_show_message_box_task(&options, &result, on_answered, &answer);
+
+    int failures = 0;
+    if (answer.calls != 0)
+    {
+        fprintf(stderr, "GTask callback ran before the caller's context dispatched it\n");
+        ++failures;
+    }
+
+    /* The completion is an idle source on the thread-default context; one iteration dispatches it. */
+    g_main_context_iteration(context, FALSE);
+    if (answer.calls != 1 || answer.result != &result || answer.error || result.button != NMB_BUTTON_ID_OK)
+    {
+        fprintf(stderr, "GTask completion failed (calls=%d, error=%s, button=%u)\n", answer.calls,
+                answer.error ? answer.error->message : "none", (unsigned int)result.button);
+        ++failures;
+    }
+
+    g_clear_error(&answer.error);
+    g_main_context_pop_thread_default(context);
+    g_main_context_unref(context);
+    return failures ? 1 : 0;
+}
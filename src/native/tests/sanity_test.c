@@ -1,9 +1,15 @@
 #include "native_message_box.h"
 #include "native_message_box_test.h"
 
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
+
 #if defined(__APPLE__)
 #include <TargetConditionals.h>
 #include <dispatch/dispatch.h>
@@ -201,6 +207,866 @@ static int run_verification_checkbox_test(void)
     return 0;
 }
 
+typedef struct NmbChunkSink_t
+{
+    const char* expected;
+    size_t received;
+    size_t chunks;
+    size_t largest;
+    NmbResultCode reply;
+} NmbChunkSink;
+
+static NmbResultCode collect_chunk(void* user_data, const char* chunk_utf8, size_t length)
+{
+    NmbChunkSink* sink = (NmbChunkSink*)user_data;
+    if (memcmp(sink->expected + sink->received, chunk_utf8, length) != 0)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    sink->received += length;
+    sink->chunks += 1;
+    sink->largest = length > sink->largest ? length : sink->largest;
+    return sink->reply;
+}
+
+static int run_multiline_chunk_test(void)
+{
+    const size_t length = 300 * 1024;
+    char* answer = (char*)malloc(length + 1);
+    if (!answer)
+    {
+        fprintf(stderr, "Multiline test could not allocate its answer\n");
+        return 1;
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        answer[i] = (i % 61 == 60) ? '\n' : (char)('a' + i % 26);
+    }
+    answer[length] = '\0';
+
+    NmbButtonOption button;
+    init_button_option(&button, NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    NmbChunkSink sink;
+    memset(&sink, 0, sizeof(sink));
+    sink.expected = answer;
+    sink.reply = NMB_OK;
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_MULTILINE;
+    input.prompt_utf8 = "Incident notes";
+    input.input_chunk_callback = collect_chunk;
+    input.input_chunk_user_data = &sink;
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &button, 1);
+    options.input = &input;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    harness.input_value_utf8 = answer;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    int failures = 0;
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.input_value_utf8 != NULL || sink.received != length || sink.chunks < 2 ||
+        sink.largest > 64 * 1024)
+    {
+        fprintf(stderr, "Multiline answer not streamed (rc=%u, received=%zu, chunks=%zu, largest=%zu)\n", rc,
+                sink.received, sink.chunks, sink.largest);
+        failures = 1;
+    }
+
+    memset(&sink, 0, sizeof(sink));
+    sink.expected = answer;
+    sink.reply = NMB_E_CANCELLED;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_CANCELLED || sink.chunks != 1)
+    {
+        fprintf(stderr, "Multiline chunk callback could not stop delivery (rc=%u, chunks=%zu)\n", rc, sink.chunks);
+        failures = 1;
+    }
+
+    free(answer);
+    return failures;
+}
+
+typedef struct NmbCountingAllocator_t
+{
+    size_t allocations;
+    size_t releases;
+} NmbCountingAllocator;
+
+static void* counting_allocate(void* user_data, size_t size, size_t alignment)
+{
+    (void)alignment;
+    ((NmbCountingAllocator*)user_data)->allocations++;
+    return malloc(size);
+}
+
+static void counting_deallocate(void* user_data, void* ptr)
+{
+    ((NmbCountingAllocator*)user_data)->releases++;
+    free(ptr);
+}
+
+static int run_form_fields_test(void)
+{
+    NmbButtonOption button;
+    init_button_option(&button, NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    NmbInputOption fields[3];
+    memset(fields, 0, sizeof(fields));
+    for (size_t i = 0; i < 3; ++i)
+    {
+        fields[i].struct_size = sizeof(fields[i]);
+    }
+    fields[0].mode = NMB_INPUT_TEXT;
+    fields[0].prompt_utf8 = "Host";
+    fields[1].mode = NMB_INPUT_CHECKBOX;
+    fields[1].prompt_utf8 = "Remember";
+    fields[2].mode = NMB_INPUT_MULTILINE;
+    fields[2].prompt_utf8 = "Notes";
+
+    NmbCountingAllocator counter;
+    memset(&counter, 0, sizeof(counter));
+    NmbAllocator allocator;
+    allocator.allocate = counting_allocate;
+    allocator.deallocate = counting_deallocate;
+    allocator.user_data = &counter;
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &button, 1);
+    options.allocator = &allocator;
+    options.form_fields = fields;
+    options.form_field_count = 3;
+
+    /* The multiline answer is left out of the script and must come back empty. */
+    NmbFieldValue answers[2];
+    answers[0].value_utf8 = "build-01";
+    answers[0].length = 8;
+    answers[0].checked = NMB_FALSE;
+    answers[1].value_utf8 = "";
+    answers[1].length = 0;
+    answers[1].checked = NMB_TRUE;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    harness.field_values = answers;
+    harness.field_value_count = 2;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    int failures = 0;
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    const NmbFieldValue* values = result.field_values;
+    if (rc != NMB_OK || !values || result.field_value_count != 3 || counter.allocations != 1 ||
+        strcmp(values[0].value_utf8, "build-01") != 0 || values[0].length != 8 || values[0].checked ||
+        !values[1].checked || values[1].length != 0 || values[2].length != 0 || values[2].value_utf8[0] != '\0')
+    {
+        fprintf(stderr, "Form answers not returned (rc=%u, count=%zu, allocations=%zu)\n", rc,
+                result.field_value_count, counter.allocations);
+        failures = 1;
+    }
+    if (values)
+    {
+        allocator.deallocate(allocator.user_data, (void*)values);
+    }
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_TEXT;
+    options.input = &input;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Form combined with a single input was accepted (rc=%u)\n", rc);
+        failures = 1;
+    }
+    options.input = NULL;
+
+    result.struct_size = (uint32_t)offsetof(NmbMessageBoxResult, field_values);
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT || counter.allocations != counter.releases)
+    {
+        fprintf(stderr, "Form accepted a result too small for its answers (rc=%u)\n", rc);
+        failures = 1;
+    }
+
+    /* A result from before multi-select holds the answers but has no selection_count. */
+    memset(&result, 0, sizeof(result));
+    result.struct_size = (uint32_t)offsetof(NmbMessageBoxResult, selection_count);
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || !result.field_values || result.field_value_count != 3)
+    {
+        fprintf(stderr, "Form rejected a result without selection_count (rc=%u)\n", rc);
+        failures = 1;
+    }
+    if (result.field_values)
+    {
+        allocator.deallocate(allocator.user_data, (void*)result.field_values);
+    }
+
+    return failures;
+}
+
+static int run_multiselect_test(void)
+{
+    static const char* const kServices[] = { "api",    "auth",   "billing", "cache", "cron", "gateway",
+                                             "ingest", "mailer", "search",  "queue", "web",  NULL };
+
+    NmbButtonOption button;
+    init_button_option(&button, NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    uint8_t bits[2] = { 0xFF, 0xFF };
+    uint32_t indices[2] = { 0, 0 };
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_MULTISELECT;
+    input.prompt_utf8 = "Services to restart";
+    input.combo_items_utf8 = kServices;
+    input.selection_bits = bits;
+    input.selection_bits_size = sizeof(bits);
+    input.selection_indices = indices;
+    input.selection_index_capacity = 2;
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &button, 1);
+    options.input = &input;
+
+    /* Items 0, 2 and 10; the high bit of the second byte lies past the 11 items and must be dropped. */
+    static const uint8_t kScripted[2] = { 0x05, 0x84 };
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    harness.selection_bits = kScripted;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    int failures = 0;
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.selection_count != 3 || bits[0] != 0x05 || bits[1] != 0x04 || indices[0] != 0 ||
+        indices[1] != 2 || result.input_value_utf8 != NULL)
+    {
+        fprintf(stderr, "Multiselect answer not delivered (rc=%u, count=%zu, bits=%02x%02x)\n", rc,
+                result.selection_count, bits[0], bits[1]);
+        failures = 1;
+    }
+
+    input.selection_bits_size = 1;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Multiselect accepted a bitset smaller than its items (rc=%u)\n", rc);
+        failures = 1;
+    }
+
+    input.selection_bits = NULL;
+    input.selection_bits_size = 0;
+    input.selection_indices = NULL;
+    input.selection_index_capacity = 0;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Multiselect accepted a call without answer buffers (rc=%u)\n", rc);
+        failures = 1;
+    }
+
+    return failures;
+}
+
+static int run_progress_test(void)
+{
+    NmbMessageBoxOptions options;
+    init_options(&options, NULL, 0);
+    options.message_utf8 = "Copying files";
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbProgressHandle* handle = NULL;
+    NmbResultCode rc = nmb_progress_begin(&options, &handle);
+    if (rc == NMB_E_NOT_SUPPORTED)
+    {
+        return handle == NULL ? 0 : 1;
+    }
+    if (rc != NMB_OK || !handle)
+    {
+        fprintf(stderr, "nmb_progress_begin failed (rc=%u)\n", rc);
+        return 1;
+    }
+
+    char text[32];
+    for (int i = 0; i <= 10000; ++i)
+    {
+        snprintf(text, sizeof(text), "file %d of 10000", i);
+        nmb_progress_update(handle, i / 10000.0, (i % 100) == 0 ? text : NULL);
+    }
+    nmb_progress_update(handle, -1.0, NULL);
+    int failures = 0;
+    if (nmb_progress_is_cancelled(handle))
+    {
+        fprintf(stderr, "Progress reported cancellation nobody requested\n");
+        failures = 1;
+    }
+    nmb_progress_end(handle);
+
+    harness.result_code = NMB_E_CANCELLED;
+    rc = nmb_progress_begin(&options, &handle);
+    if (rc != NMB_OK || !nmb_progress_is_cancelled(handle))
+    {
+        fprintf(stderr, "Cancelled progress not reported (rc=%u)\n", rc);
+        failures = 1;
+    }
+    nmb_progress_end(handle);
+
+    if (nmb_progress_begin(NULL, &handle) != NMB_E_INVALID_ARGUMENT || handle != NULL)
+    {
+        fprintf(stderr, "nmb_progress_begin accepted NULL options\n");
+        failures = 1;
+    }
+    return failures;
+}
+
+typedef struct ToastProbe_t
+{
+    int calls;
+    NmbButtonId button;
+} ToastProbe;
+
+static void NMB_CALL record_toast(void* user_data, NmbButtonId button)
+{
+    ToastProbe* probe = (ToastProbe*)user_data;
+    ++probe->calls;
+    probe->button = button;
+}
+
+static int run_toast_test(void)
+{
+    NmbButtonOption action;
+    init_button_option(&action, NMB_BUTTON_ID_RETRY, "Undo", NMB_FALSE, NMB_FALSE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &action, 1);
+    options.message_utf8 = "Sync complete";
+
+    ToastProbe probe;
+    memset(&probe, 0, sizeof(probe));
+    NmbToastOption toast;
+    memset(&toast, 0, sizeof(toast));
+    toast.struct_size = sizeof(toast);
+    toast.callback = record_toast;
+    toast.user_data = &probe;
+    options.toast = &toast;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_RETRY;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || probe.calls != 1 || probe.button != NMB_BUTTON_ID_RETRY)
+    {
+        fprintf(stderr, "Toast action not reported once (rc=%u, calls=%d)\n", rc, probe.calls);
+        return 1;
+    }
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_TEXT;
+    options.input = &input;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT || probe.calls != 1)
+    {
+        fprintf(stderr, "Toast with input was not rejected (rc=%u)\n", rc);
+        return 1;
+    }
+    return 0;
+}
+
+typedef struct AsyncProbe_t
+{
+    int calls;
+    NmbMessageBoxResult* result;
+    NmbButtonId button;
+} AsyncProbe;
+
+static void NMB_CALL record_async_result(void* user_data, NmbMessageBoxResult* result)
+{
+    AsyncProbe* probe = (AsyncProbe*)user_data;
+    ++probe->calls;
+    probe->result = result;
+    probe->button = result->button;
+}
+
+static int run_async_test(void)
+{
+    NmbButtonOption buttons[2];
+    init_button_option(&buttons[0], NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+    init_button_option(&buttons[1], NMB_BUTTON_ID_CANCEL, "Cancel", NMB_FALSE, NMB_TRUE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, buttons, 2);
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_CANCEL;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    AsyncProbe probe;
+    memset(&probe, 0, sizeof(probe));
+    NmbResultCode rc = nmb_show_message_box_async(&options, &result, record_async_result, &probe);
+    if (rc != NMB_OK || probe.calls != 1 || probe.result != &result || probe.button != NMB_BUTTON_ID_CANCEL)
+    {
+        fprintf(stderr, "Async completion not reported once (rc=%u, calls=%d)\n", rc, probe.calls);
+        return 1;
+    }
+    if (result.result_code != NMB_OK)
+    {
+        fprintf(stderr, "Async result_code not filled (%u)\n", result.result_code);
+        return 1;
+    }
+
+    rc = nmb_show_message_box_async(&options, &result, NULL, NULL);
+    if (rc != NMB_E_INVALID_ARGUMENT || probe.calls != 1)
+    {
+        fprintf(stderr, "Async request without a callback was not rejected (rc=%u)\n", rc);
+        return 1;
+    }
+
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    rc = nmb_show_message_box_in_context(&options, &result, NULL, record_async_result, &probe);
+    if (rc != NMB_OK || probe.calls != 2 || probe.button != NMB_BUTTON_ID_OK)
+    {
+        fprintf(stderr, "Main-context completion not reported once (rc=%u, calls=%d)\n", rc, probe.calls);
+        return 1;
+    }
+    return 0;
+}
+
+static int run_message_template_test(void)
+{
+    NmbButtonOption buttons[2];
+    init_button_option(&buttons[0], NMB_BUTTON_ID_YES, "Retry", NMB_TRUE, NMB_FALSE);
+    init_button_option(&buttons[1], NMB_BUTTON_ID_NO, "Skip", NMB_FALSE, NMB_TRUE);
+
+    NmbMessageTemplate* message_template = NULL;
+    NmbResultCode rc = nmb_message_template_create("{count} files failed on {host}", &message_template);
+    if (rc != NMB_OK)
+    {
+        fprintf(stderr, "Message template not created (%u)\n", rc);
+        return 1;
+    }
+
+    NmbStringView arguments[2];
+    arguments[0].data = "3";
+    arguments[0].length = 1;
+    arguments[1].data = "build-01";
+    arguments[1].length = 8;
+
+    NmbTemplatedMessage templated;
+    memset(&templated, 0, sizeof(templated));
+    templated.struct_size = sizeof(templated);
+    templated.message_template = message_template;
+    templated.arguments = arguments;
+    templated.argument_count = 2;
+
+    NmbMessageBoxOptions options;
+    init_options(&options, buttons, 2);
+    options.message_utf8 = NULL;
+    options.templated_message = &templated;
+    options.verification_text_utf8 = "Do not ask again";
+    options.show_suppress_checkbox = NMB_TRUE;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_NO;
+    harness.checkbox_checked = NMB_TRUE;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    int status = 0;
+    rc = nmb_show_message_box(&options, &result);
+    harness.scripted_button = NMB_BUTTON_ID_YES;
+    NmbResultCode suppressed_rc = nmb_show_message_box(&options, &result);
+    NmbMessageTemplateStats stats;
+    stats.struct_size = sizeof(stats);
+    nmb_message_template_get_stats(message_template, &stats);
+    if (rc != NMB_OK || suppressed_rc != NMB_OK || result.button != NMB_BUTTON_ID_NO || stats.requests != 2 ||
+        stats.shown != 1 || stats.suppressed != 1)
+    {
+        fprintf(stderr, "Templated request not shown then suppressed (rc=%u, button=%d)\n", rc, result.button);
+        status = 1;
+    }
+
+    options.message_utf8 = "3 files failed";
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Template with message_utf8 was not rejected (rc=%u)\n", rc);
+        status = 1;
+    }
+
+    nmb_message_template_destroy(message_template);
+    return status;
+}
+
+static int run_virtual_clock_test(void)
+{
+    NmbButtonOption buttons[2];
+    init_button_option(&buttons[0], NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+    init_button_option(&buttons[1], NMB_BUTTON_ID_CANCEL, "Cancel", NMB_FALSE, NMB_TRUE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, buttons, 2);
+    options.timeout_milliseconds = 60u * 60u * 1000u;
+    options.timeout_button_id = NMB_BUTTON_ID_CANCEL;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    harness.answer_after_milliseconds = 2u * 60u * 60u * 1000u;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    /* The first advance swaps in the virtual clock, so the hour below passes without waiting. */
+    nmb_test_advance_clock(0);
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.button != NMB_BUTTON_ID_CANCEL || result.was_timeout != NMB_TRUE)
+    {
+        fprintf(stderr, "Hour-long timeout did not fire (rc=%u, button=%u)\n", rc, result.button);
+        nmb_test_use_system_clock();
+        return 1;
+    }
+
+    harness.answer_after_milliseconds = 59u * 60u * 1000u;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.button != NMB_BUTTON_ID_OK || result.was_timeout != NMB_FALSE)
+    {
+        fprintf(stderr, "Answer before the timeout was not kept (rc=%u, button=%u)\n", rc, result.button);
+        nmb_test_use_system_clock();
+        return 1;
+    }
+
+    options.timeout_milliseconds = 30u * 1000u;
+    harness.answer_after_milliseconds = options.timeout_milliseconds;
+    for (int i = 0; i < 10000; ++i)
+    {
+        rc = nmb_show_message_box(&options, &result);
+        if (rc != NMB_OK || result.was_timeout != NMB_TRUE)
+        {
+            fprintf(stderr, "Timed dialog %d did not time out (rc=%u)\n", i, rc);
+            nmb_test_use_system_clock();
+            return 1;
+        }
+    }
+
+    nmb_test_use_system_clock();
+    return 0;
+}
+
+static int run_timing_test(void)
+{
+    NmbButtonOption buttons[1];
+    init_button_option(&buttons[0], NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, buttons, 1);
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    harness.answer_after_milliseconds = 1500;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    /* The virtual clock stands still until the scripted answer advances it, so every gap is exact. */
+    nmb_test_advance_clock(0);
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    nmb_test_use_system_clock();
+    if (rc != NMB_OK || result.backend != NMB_BACKEND_HEADLESS || result.received_microseconds == 0)
+    {
+        fprintf(stderr, "Scripted dialog did not report its backend (rc=%u, backend=%u)\n", rc, result.backend);
+        return 1;
+    }
+    if (result.validated_microseconds != result.received_microseconds ||
+        result.responded_microseconds - result.validated_microseconds != 1500u * 1000u ||
+        result.built_microseconds != 0 || result.mapped_microseconds != 0)
+    {
+        fprintf(stderr, "Scripted dialog reported the wrong stages\n");
+        return 1;
+    }
+
+    harness.answer_after_milliseconds = 0;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.validated_microseconds < result.received_microseconds ||
+        result.responded_microseconds < result.validated_microseconds)
+    {
+        fprintf(stderr, "System clock stages went backwards (rc=%u)\n", rc);
+        return 1;
+    }
+
+    /* A result from before the timing fields must not be written past its end. */
+    memset(&result, 0, sizeof(result));
+    result.struct_size = (uint32_t)offsetof(NmbMessageBoxResult, received_microseconds);
+    result.backend = (NmbBackend)99;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.received_microseconds != 0 || result.backend != (NmbBackend)99)
+    {
+        fprintf(stderr, "Timing fields were written into a smaller result (rc=%u)\n", rc);
+        return 1;
+    }
+    return 0;
+}
+
+static int run_pollable_test(void)
+{
+    NmbButtonOption buttons[2];
+    init_button_option(&buttons[0], NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+    init_button_option(&buttons[1], NMB_BUTTON_ID_CANCEL, "Cancel", NMB_FALSE, NMB_TRUE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, buttons, 2);
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_CANCEL;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+#if !defined(_WIN32)
+    const int fd = nmb_get_event_fd();
+    if (fd < 0 || nmb_pump(0) != NMB_OK)
+    {
+        fprintf(stderr, "No pollable event fd (fd=%d)\n", fd);
+        return 1;
+    }
+#endif
+
+    NmbRequest* request = NULL;
+    NmbResultCode rc = nmb_submit_message_box(&options, &result, &request);
+    if (rc != NMB_OK || !request)
+    {
+        fprintf(stderr, "Pollable request not started (rc=%u)\n", rc);
+        return 1;
+    }
+
+#if !defined(_WIN32)
+    struct pollfd readable;
+    readable.fd = fd;
+    readable.events = POLLIN;
+    readable.revents = 0;
+    if (poll(&readable, 1, 0) != 1)
+    {
+        fprintf(stderr, "Event fd not readable after a completion\n");
+        return 1;
+    }
+    nmb_pump(0);
+#endif
+
+    nmb_bool done = NMB_FALSE;
+    rc = nmb_poll_result(request, &done);
+    if (rc != NMB_OK || !done || result.button != NMB_BUTTON_ID_CANCEL)
+    {
+        fprintf(stderr, "Polled result not reported (rc=%u, done=%d)\n", rc, (int)done);
+        return 1;
+    }
+
+    rc = nmb_poll_result(NULL, &done);
+    if (rc != NMB_E_INVALID_ARGUMENT || done)
+    {
+        fprintf(stderr, "Polling without a request was not rejected (rc=%u)\n", rc);
+        return 1;
+    }
+    return 0;
+}
+
+static int run_string_view_test(void)
+{
+    static const char buffer[] = "Title|Message from a larger buffer|trailing";
+
+    NmbButtonOption button;
+    init_button_option(&button, NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &button, 1);
+    options.title_utf8 = NULL;
+    options.message_utf8 = NULL;
+
+    NmbMessageBoxStrings strings;
+    memset(&strings, 0, sizeof(strings));
+    strings.struct_size = sizeof(strings);
+    strings.title.data = buffer;
+    strings.title.length = 5;
+    strings.message.data = buffer + 6;
+    strings.message.length = 28;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Expected invalid argument without a message (rc=%u)\n", rc);
+        return 1;
+    }
+
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRING_VIEWS;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Expected invalid argument for string view flag without table (rc=%u)\n", rc);
+        return 1;
+    }
+
+    options.strings = &strings;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.button != NMB_BUTTON_ID_OK)
+    {
+        fprintf(stderr, "String view round-trip failed (rc=%u, button=%u)\n", rc, (unsigned int)result.button);
+        return 1;
+    }
+
+    static const uint16_t message16[] = {'U', 'T', 'F', '-', '1', '6', ' ', 0x00FC};
+    NmbMessageBoxStrings16 strings16;
+    memset(&strings16, 0, sizeof(strings16));
+    strings16.struct_size = sizeof(strings16);
+    strings16.message.data = message16;
+    strings16.message.length = sizeof(message16) / sizeof(message16[0]);
+
+    options.flags = NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS;
+    options.strings = NULL;
+    options.strings_utf16 = &strings16;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.button != NMB_BUTTON_ID_OK)
+    {
+        fprintf(stderr, "UTF-16 view round-trip failed (rc=%u, button=%u)\n", rc, (unsigned int)result.button);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int run_invalid_utf8_test(void)
+{
+    NmbButtonOption button;
+    init_button_option(&button, NMB_BUTTON_ID_OK, "OK", NMB_TRUE, NMB_FALSE);
+
+    NmbMessageBoxOptions options;
+    init_options(&options, &button, 1);
+    options.message_utf8 = "Truncated \xE2\x82";
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRICT_UTF8;
+
+    NmbTestHarness harness;
+    memset(&harness, 0, sizeof(harness));
+    harness.struct_size = sizeof(harness);
+    harness.magic = NMB_TEST_HARNESS_MAGIC;
+    harness.scripted_button = NMB_BUTTON_ID_OK;
+    harness.result_code = NMB_OK;
+    options.user_context = &harness;
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+
+    NmbResultCode rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_E_INVALID_ARGUMENT)
+    {
+        fprintf(stderr, "Expected invalid argument for ill-formed UTF-8 under the strict flag (rc=%u)\n", rc);
+        return 1;
+    }
+
+    options.flags = NMB_MESSAGE_BOX_FLAG_NONE;
+    rc = nmb_show_message_box(&options, &result);
+    if (rc != NMB_OK || result.button != NMB_BUTTON_ID_OK)
+    {
+        fprintf(stderr, "UTF-8 repair round-trip failed (rc=%u, button=%u)\n", rc, (unsigned int)result.button);
+        return 1;
+    }
+
+    return 0;
+}
+
 #if defined(__ANDROID__)
 static int run_android_requires_activity_test(void)
 {
@@ -323,7 +1189,19 @@ int main(void)
     if (run_null_options_test() != 0 ||
         run_standard_button_tests() != 0 ||
         run_timeout_test() != 0 ||
-        run_verification_checkbox_test() != 0)
+        run_verification_checkbox_test() != 0 ||
+        run_multiline_chunk_test() != 0 ||
+        run_form_fields_test() != 0 ||
+        run_multiselect_test() != 0 ||
+        run_progress_test() != 0 ||
+        run_toast_test() != 0 ||
+        run_async_test() != 0 ||
+        run_message_template_test() != 0 ||
+        run_virtual_clock_test() != 0 ||
+        run_timing_test() != 0 ||
+        run_pollable_test() != 0 ||
+        run_string_view_test() != 0 ||
+        run_invalid_utf8_test() != 0)
     {
         nmb_shutdown();
         return 1;
@@ -0,0 +1,1360 @@
+#include "native_message_box.h"
+#include "nmb_aggregate.h"
+#include "nmb_clock.h"
+#include "nmb_completion.h"
+#include "nmb_dialog_handle.h"
+#include "nmb_items.h"
+#include "nmb_mapped_file.h"
+#include "nmb_message_template.h"
+#include "nmb_options.h"
+#include "nmb_thread.h"
+#include "nmb_timer_wheel.h"
+#include "nmb_timing.h"
+#include "nmb_utf16.h"
+#include "nmb_utf8.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+static int expect(int condition, const char* what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "shared test failed: %s\n", what);
+        return 1;
+    }
+
+    return 0;
+}
+
+static NmbStringView make_view(const char* data, size_t length)
+{
+    NmbStringView view;
+    view.data = data;
+    view.length = length;
+    return view;
+}
+
+typedef struct ConcurrentCall_t
+{
+    void (*fn)(void*);
+    void* item;
+} ConcurrentCall;
+
+#if defined(_WIN32)
+static DWORD WINAPI run_concurrent_call(LPVOID data)
+#else
+static void* run_concurrent_call(void* data)
+#endif
+{
+    ConcurrentCall* call = (ConcurrentCall*)data;
+    call->fn(call->item);
+    return 0;
+}
+
+/* Runs fn on every item of an array, each on its own thread, and returns once all of them finished. */
+static void run_concurrently(void (*fn)(void*), void* items, size_t count, size_t stride)
+{
+    ConcurrentCall* calls = (ConcurrentCall*)malloc(count * sizeof(*calls));
+#if defined(_WIN32)
+    HANDLE* threads = (HANDLE*)malloc(count * sizeof(*threads));
+#else
+    pthread_t* threads = (pthread_t*)malloc(count * sizeof(*threads));
+#endif
+    for (size_t i = 0; i < count; ++i)
+    {
+        calls[i].fn = fn;
+        calls[i].item = (char*)items + i * stride;
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, run_concurrent_call, &calls[i], 0, NULL);
+#else
+        pthread_create(&threads[i], NULL, run_concurrent_call, &calls[i]);
+#endif
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+    free(threads);
+    free(calls);
+}
+
+static int run_passthrough_test(void)
+{
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Plain";
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    int failures = expect(rc == NMB_OK, "passthrough rc");
+    failures += expect(prepared.options == &options, "passthrough keeps caller struct");
+    failures += expect(prepared.arena.head == NULL, "passthrough allocates nothing");
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+static int run_string_view_test(void)
+{
+    /* Slices of one larger buffer; none of them is NUL-terminated at its end. */
+    static const char blob[] = "Backup failed|Disk full on /var|OKCancel|alpha|beta|More text";
+
+    NmbButtonOption buttons[2];
+    memset(buttons, 0, sizeof(buttons));
+    buttons[0].struct_size = sizeof(NmbButtonOption);
+    buttons[0].id = NMB_BUTTON_ID_OK;
+    buttons[0].label_utf8 = "unused";
+    buttons[1].struct_size = sizeof(NmbButtonOption);
+    buttons[1].id = NMB_BUTTON_ID_CANCEL;
+    buttons[1].label_utf8 = "Cancel (original)";
+
+    NmbStringView labels[2];
+    labels[0] = make_view(blob + 32, 2);
+    labels[1] = make_view(NULL, 0);
+
+    NmbStringView combo[2];
+    combo[0] = make_view(blob + 41, 5);
+    combo[1] = make_view(blob + 47, 4);
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_COMBO;
+
+    NmbMessageBoxStrings strings;
+    memset(&strings, 0, sizeof(strings));
+    strings.struct_size = sizeof(strings);
+    strings.title = make_view(blob, 13);
+    strings.message = make_view(blob + 14, 17);
+    strings.button_labels = labels;
+    strings.combo_items = combo;
+    strings.combo_item_count = 2;
+    strings.expanded_text = make_view(blob + 52, 9);
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.buttons = buttons;
+    options.button_count = 2;
+    options.input = &input;
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRING_VIEWS;
+    options.strings = &strings;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    int failures = expect(rc == NMB_OK, "view rc");
+    if (failures)
+    {
+        nmb_release_prepared_options(&prepared);
+        return failures;
+    }
+
+    const NmbMessageBoxOptions* resolved = prepared.options;
+    failures += expect(strcmp(resolved->title_utf8, "Backup failed") == 0, "title view");
+    failures += expect(strcmp(resolved->message_utf8, "Disk full on /var") == 0, "message view");
+    failures += expect(strcmp(resolved->buttons[0].label_utf8, "OK") == 0, "button label view");
+    failures += expect(strcmp(resolved->buttons[1].label_utf8, "Cancel (original)") == 0, "NULL view keeps field");
+    failures += expect(buttons[0].label_utf8 != resolved->buttons[0].label_utf8, "caller buttons untouched");
+    failures += expect(strcmp(resolved->input->combo_items_utf8[0], "alpha") == 0, "combo item 0");
+    failures += expect(strcmp(resolved->input->combo_items_utf8[1], "beta") == 0, "combo item 1");
+    failures += expect(resolved->input->combo_items_utf8[2] == NULL, "combo terminator");
+    failures += expect(resolved->secondary != NULL, "secondary synthesized");
+    failures += expect(strcmp(resolved->secondary->expanded_text_utf8, "More text") == 0, "expanded view");
+    failures += expect((resolved->flags & NMB_MESSAGE_BOX_FLAG_STRING_VIEWS) == 0, "flag cleared");
+    failures += expect(prepared.arena.head != NULL, "arena used");
+
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+static int run_missing_strings_test(void)
+{
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRING_VIEWS;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    nmb_release_prepared_options(&prepared);
+    return expect(rc == NMB_E_INVALID_ARGUMENT, "flag without strings is rejected");
+}
+
+static int run_utf16_transcode_test(void)
+{
+    /* ASCII run longer than one AVX2 block, then a surrogate pair straddling the 8/16-unit block edge. */
+    uint16_t text[40];
+    for (size_t i = 0; i < 40; ++i)
+    {
+        text[i] = (uint16_t)('a' + i % 26);
+    }
+    text[15] = 0xD83D; /* U+1F600 split across units 15 and 16 */
+    text[16] = 0xDE00;
+    text[20] = 0x00E9; /* two-byte */
+    text[21] = 0x20AC; /* three-byte */
+    text[30] = 0xDC00; /* lone low surrogate */
+    text[39] = 0xD800; /* lone high surrogate at the end */
+
+    char simd[NMB_UTF16_TO_UTF8_MAX(40)];
+    char scalar[NMB_UTF16_TO_UTF8_MAX(40)];
+    size_t simd_length = nmb_utf16_to_utf8(text, 40, simd);
+    size_t scalar_length = nmb_utf16_to_utf8_scalar(text, 40, scalar);
+
+    int failures = expect(simd_length == scalar_length, "simd length matches scalar");
+    failures += expect(memcmp(simd, scalar, scalar_length) == 0, "simd output matches scalar");
+    failures += expect(scalar_length == 34 + 4 + 2 + 3 + 3 + 3, "transcoded length");
+    failures += expect(memcmp(scalar, "abcdefghijklmno\xF0\x9F\x98\x80", 19) == 0, "surrogate pair");
+    failures += expect(memcmp(scalar + scalar_length - 3, "\xEF\xBF\xBD", 3) == 0, "lone surrogate replaced");
+    return failures;
+}
+
+static int run_utf16_views_test(void)
+{
+    static const uint16_t title[] = {'C', 'a', 'f', 0x00E9};
+    static const uint16_t message[] = {'S', 'a', 'v', 'e', 'd', '?'};
+    static const uint16_t label[] = {'O', 'K'};
+
+    NmbButtonOption button;
+    memset(&button, 0, sizeof(button));
+    button.struct_size = sizeof(button);
+    button.id = NMB_BUTTON_ID_OK;
+
+    NmbStringView16 labels[1];
+    labels[0].data = label;
+    labels[0].length = 2;
+
+    NmbMessageBoxStrings16 strings;
+    memset(&strings, 0, sizeof(strings));
+    strings.struct_size = sizeof(strings);
+    strings.title.data = title;
+    strings.title.length = 4;
+    strings.message.data = message;
+    strings.message.length = 5; /* slice drops the trailing '?' */
+    strings.button_labels = labels;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.buttons = &button;
+    options.button_count = 1;
+    options.flags = NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS;
+    options.strings_utf16 = &strings;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    int failures = expect(rc == NMB_OK, "utf16 rc");
+    if (failures)
+    {
+        nmb_release_prepared_options(&prepared);
+        return failures;
+    }
+
+    const NmbMessageBoxOptions* resolved = prepared.options;
+    failures += expect(strcmp(resolved->title_utf8, "Caf\xC3\xA9") == 0, "utf16 title");
+    failures += expect(strcmp(resolved->message_utf8, "Saved") == 0, "utf16 message");
+    failures += expect(strcmp(resolved->buttons[0].label_utf8, "OK") == 0, "utf16 button label");
+    failures += expect(prepared.strings_utf16 == &strings, "utf16 table kept for UTF-16 backends");
+    failures += expect((resolved->flags & NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS) == 0, "utf16 flag cleared");
+    nmb_release_prepared_options(&prepared);
+
+    rc = nmb_prepare_options_utf16(&options, &prepared);
+    failures += expect(rc == NMB_OK, "utf16 backend rc");
+    if (rc == NMB_OK)
+    {
+        resolved = prepared.options;
+        failures += expect(!resolved->title_utf8 && !resolved->message_utf8 && prepared.strings_utf16 == &strings,
+                           "utf16 backend reads the views without a UTF-8 copy");
+        failures += expect(strcmp(resolved->buttons[0].label_utf8, "OK") == 0, "utf16 backend still gets labels");
+    }
+    nmb_release_prepared_options(&prepared);
+
+    options.flags |= NMB_MESSAGE_BOX_FLAG_STRING_VIEWS;
+    rc = nmb_prepare_options(&options, &prepared);
+    nmb_release_prepared_options(&prepared);
+    failures += expect(rc == NMB_E_INVALID_ARGUMENT, "both view flags are rejected");
+    return failures;
+}
+
+static int run_utf8_validation_test(void)
+{
+    /* 100 bytes of ASCII first so the defect lands in a later SIMD block, not the scalar tail. */
+    char text[128];
+    memset(text, 'x', sizeof(text));
+
+    int failures = expect(nmb_utf8_is_valid(text, sizeof(text)), "ascii valid");
+    failures += expect(nmb_utf8_is_valid("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80", 14), "mixed valid");
+
+    static const char* const invalid[] = {
+        "\xC0\x80",         /* overlong NUL */
+        "\xE0\x9F\xBF",     /* overlong three-byte */
+        "\xED\xA0\x80",     /* UTF-16 surrogate */
+        "\xF4\x90\x80\x80", /* above U+10FFFF */
+        "\x80",             /* stray continuation */
+        "\xE2\x82",         /* truncated at end of input */
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+    {
+        const size_t length = strlen(invalid[i]);
+        memcpy(text + 100, invalid[i], length);
+        failures += expect(!nmb_utf8_is_valid_scalar(invalid[i], length), "scalar rejects ill-formed sequence");
+        failures += expect(!nmb_utf8_is_valid(text, 100 + length), "simd rejects ill-formed sequence");
+        memset(text + 100, 'x', length);
+    }
+
+    /* Unicode 15, section 3.9 example of maximal subpart replacement. */
+    static const char broken[] = "a\xF1\x80\x80\xE1\x80\xC2" "b\x80" "c\x80\xBF" "d";
+    static const char repaired[] = "a\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD" "b\xEF\xBF\xBD" "c\xEF\xBF\xBD\xEF\xBF\xBD" "d";
+    char out[NMB_UTF8_REPAIR_MAX(sizeof(broken))];
+    size_t written = nmb_utf8_repair(broken, sizeof(broken) - 1, out);
+    failures += expect(written == sizeof(repaired) - 1 && memcmp(out, repaired, written) == 0, "maximal subpart repair");
+    return failures;
+}
+
+static int run_invalid_utf8_options_test(void)
+{
+    static const char* const title = "Valid title";
+
+    NmbSecondaryContentOption secondary;
+    memset(&secondary, 0, sizeof(secondary));
+    secondary.struct_size = sizeof(secondary);
+    secondary.expanded_text_utf8 = "log line \xFF tail";
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.title_utf8 = title;
+    options.message_utf8 = "Crash report";
+    options.secondary = &secondary;
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRICT_UTF8;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    nmb_release_prepared_options(&prepared);
+    int failures = expect(rc == NMB_E_INVALID_ARGUMENT, "ill-formed text rejected with strict flag");
+
+    options.flags = NMB_MESSAGE_BOX_FLAG_NONE;
+    rc = nmb_prepare_options(&options, &prepared);
+    failures += expect(rc == NMB_OK, "repair rc");
+    if (rc == NMB_OK)
+    {
+        failures += expect(strcmp(prepared.options->secondary->expanded_text_utf8, "log line \xEF\xBF\xBD tail") == 0,
+                           "expanded text repaired");
+        failures += expect(prepared.options->title_utf8 == title, "valid strings are not copied");
+        failures += expect(secondary.expanded_text_utf8 != prepared.options->secondary->expanded_text_utf8,
+                           "caller string untouched");
+    }
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+static int run_legacy_invalid_utf8_test(void)
+{
+    NmbButtonOption button;
+    memset(&button, 0, sizeof(button));
+    button.struct_size = sizeof(button);
+    button.id = NMB_BUTTON_ID_OK;
+    button.label_utf8 = "O\xC0K";
+
+    /* A caller built before flags existed, showing a crash report with one bad byte. */
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = (uint32_t)offsetof(NmbMessageBoxOptions, flags);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Crash in module \xFF";
+    options.buttons = &button;
+    options.button_count = 1;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    int failures = expect(rc == NMB_OK, "old-style call with ill-formed text still shows a dialog");
+    if (rc == NMB_OK)
+    {
+        failures += expect(strcmp(prepared.options->message_utf8, "Crash in module \xEF\xBF\xBD") == 0 &&
+                               strcmp(prepared.options->buttons[0].label_utf8, "O\xEF\xBF\xBDK") == 0,
+                           "old-style call shows U+FFFD for the bad bytes");
+    }
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+static int run_mapped_file_test(void)
+{
+    static const char* const path = "nmb_shared_test_mapped.txt";
+    static const char content[] = "first line\nsecond caf\xC3\xA9 line\nthird line\n";
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        return expect(0, "create mapped file fixture");
+    }
+    fwrite(content, 1, sizeof(content) - 1, file);
+    fclose(file);
+
+    NmbContentSource source;
+    memset(&source, 0, sizeof(source));
+    source.struct_size = sizeof(source);
+    source.kind = NMB_CONTENT_SOURCE_PATH;
+    source.path_utf8 = path;
+    source.offset = 6;
+
+    NmbMappedFile mapped;
+    NmbResultCode rc = nmb_mapped_file_open(&source, &mapped);
+    int failures = expect(rc == NMB_OK, "map path source");
+    if (rc == NMB_OK)
+    {
+        failures += expect(mapped.length == sizeof(content) - 1 - 6, "mapped length honours offset");
+        failures += expect(memcmp(mapped.data, "line\nsecond", 11) == 0, "mapped data starts at offset");
+        failures += expect(nmb_text_find(mapped.data, mapped.length, "line", 4, 0) == 0, "find at start");
+        failures += expect(nmb_text_find(mapped.data, mapped.length, "line", 4, 1) == 18, "find from offset");
+        failures += expect(nmb_text_find(mapped.data, mapped.length, "fourth", 6, 0) == NMB_TEXT_NOT_FOUND,
+                           "missing needle");
+    }
+    nmb_mapped_file_close(&mapped);
+
+    source.offset = 0;
+    source.length = 5;
+    rc = nmb_mapped_file_open(&source, &mapped);
+    failures += expect(rc == NMB_OK && mapped.length == 5, "mapped length honours length");
+    nmb_mapped_file_close(&mapped);
+
+    source.offset = sizeof(content) + 10;
+    rc = nmb_mapped_file_open(&source, &mapped);
+    failures += expect(rc == NMB_E_INVALID_ARGUMENT, "offset past end rejected");
+
+    source.offset = 0;
+    source.kind = (NmbContentSourceKind)7;
+    rc = nmb_mapped_file_open(&source, &mapped);
+    failures += expect(rc == NMB_E_INVALID_ARGUMENT, "unknown source kind rejected");
+
+    /* Chunks prefer a line break near the limit and never split a UTF-8 sequence. */
+    failures += expect(nmb_text_chunk_end(content, sizeof(content) - 1, 12) == 11, "chunk ends after line break");
+    failures += expect(nmb_text_chunk_end(content + 11, sizeof(content) - 12, 11) == 10, "chunk keeps sequence whole");
+    failures += expect(nmb_text_chunk_end(content, 5, 64) == 5, "short tail is one chunk");
+
+    source.kind = NMB_CONTENT_SOURCE_PATH;
+    source.length = 0;
+    NmbSecondaryContentOption secondary;
+    memset(&secondary, 0, sizeof(secondary));
+    secondary.struct_size = sizeof(secondary);
+    secondary.expanded_text_source = &source;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Crash report";
+    options.secondary = &secondary;
+
+    NmbPreparedOptions prepared;
+    rc = nmb_prepare_options(&options, &prepared);
+    if (rc == NMB_OK)
+    {
+        rc = nmb_inline_expanded_source(&prepared, 22);
+    }
+    failures += expect(rc == NMB_OK, "inline expanded source");
+    if (rc == NMB_OK)
+    {
+        const NmbSecondaryContentOption* resolved = prepared.options->secondary;
+        failures += expect(strcmp(resolved->expanded_text_utf8, "first line\nsecond caf\n\xE2\x80\xA6") == 0,
+                           "inlined prefix truncated on a character boundary");
+        failures += expect(resolved->expanded_text_source == NULL, "inlined source cleared");
+        failures += expect(secondary.expanded_text_source == &source, "caller secondary untouched");
+    }
+    nmb_release_prepared_options(&prepared);
+
+    /* Following needs a path to watch; a source compiled before the follow fields never follows. */
+    source.follow = NMB_TRUE;
+    failures += expect(nmb_content_source_follows(&source), "follow requested");
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_OK, "followed path accepted");
+    nmb_release_prepared_options(&prepared);
+    source.kind = NMB_CONTENT_SOURCE_FD;
+    source.fd = 0;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "followed descriptor rejected");
+    nmb_release_prepared_options(&prepared);
+    source.struct_size = (uint32_t)offsetof(NmbContentSource, follow);
+    failures += expect(!nmb_content_source_follows(&source), "old struct never follows");
+
+    remove(path);
+    return failures;
+}
+
+static int run_text_threshold_test(void)
+{
+    int failures = expect(!nmb_text_exceeds("short", 8, 2), "short text stays inline");
+    failures += expect(nmb_text_exceeds("exactly nine", 8, 2), "byte limit exceeded");
+    failures += expect(!nmb_text_exceeds("12345678", 8, 2), "byte limit is inclusive");
+    failures += expect(nmb_text_exceeds("a\nb\nc", 8, 2), "line limit exceeded");
+    failures += expect(!nmb_text_exceeds("a\nb", 8, 2), "line limit is inclusive");
+    failures += expect(!nmb_text_exceeds(NULL, 8, 2), "missing text");
+    return failures;
+}
+
+static int run_item_buffer_test(void)
+{
+    static const char kData[] = "alphaBetagammabeta\xC3\xA9\xFF";
+    static const uint32_t kOffsets[] = { 0, 5, 9, 14, 14, 20, 21 };
+    NmbItemBuffer items;
+    memset(&items, 0, sizeof(items));
+    items.struct_size = sizeof(items);
+    items.data = kData;
+    items.offsets = kOffsets;
+    items.item_count = 5;
+
+    nmb_bool valid = NMB_FALSE;
+    int failures = expect(nmb_item_buffer_check(&items, &valid) == NMB_OK && valid, "valid item buffer accepted");
+
+    NmbItemIndex index;
+    failures += expect(nmb_item_index_build(&index, &items) == NMB_OK, "item index built");
+    failures += expect(nmb_item_index_find(&index, "gamma", 5) == 2, "item found by text");
+    failures += expect(nmb_item_index_find(&index, "", 0) == 3, "empty item found");
+    failures += expect(nmb_item_index_find(&index, "beta", 4) == NMB_ITEM_NOT_FOUND, "prefix of an item not found");
+    nmb_item_index_release(&index);
+
+    uint32_t matches[6];
+    size_t count = nmb_items_filter(&items, "BETA", 4, matches);
+    failures += expect(count == 2 && matches[0] == 1 && matches[1] == 4, "filter ignores ASCII case");
+    failures += expect(nmb_items_filter(&items, "", 0, matches) == 5, "empty filter matches everything");
+
+    items.item_count = 6;
+    failures += expect(nmb_item_buffer_check(&items, &valid) == NMB_OK && !valid, "ill-formed item flagged");
+
+    static const uint32_t kDescending[] = { 0, 5, 4 };
+    items.offsets = kDescending;
+    items.item_count = 2;
+    failures += expect(nmb_item_buffer_check(&items, &valid) == NMB_E_INVALID_ARGUMENT, "descending offsets rejected");
+
+    items.offsets = kOffsets;
+    items.item_count = 6;
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_COMBO;
+    input.combo_item_buffer = &items;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Pick one";
+    options.input = &input;
+
+    NmbPreparedOptions prepared;
+    options.flags = NMB_MESSAGE_BOX_FLAG_STRICT_UTF8;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "ill-formed item rejected with strict flag");
+
+    options.flags = NMB_MESSAGE_BOX_FLAG_NONE;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    failures += expect(rc == NMB_OK, "ill-formed item repaired");
+    if (rc == NMB_OK)
+    {
+        const NmbItemBuffer* repaired = prepared.options->input->combo_item_buffer;
+        failures += expect(repaired != &items && repaired->item_count == 6, "repaired copy replaces caller items");
+        failures += expect(nmb_item_length(repaired, 5) == 3 &&
+                               memcmp(nmb_item_data(repaired, 5), "\xEF\xBF\xBD", 3) == 0,
+                           "ill-formed byte replaced");
+
+        rc = nmb_expand_combo_buffer(&prepared);
+        const char* const* expanded = prepared.options->input->combo_items_utf8;
+        failures += expect(rc == NMB_OK && expanded && prepared.options->input->combo_item_buffer == NULL,
+                           "item buffer expanded to strings");
+        if (rc == NMB_OK && expanded)
+        {
+            failures += expect(strcmp(expanded[1], "Beta") == 0 && expanded[3][0] == '\0' && expanded[6] == NULL,
+                               "expanded items are NUL-terminated");
+        }
+        nmb_release_prepared_options(&prepared);
+    }
+    return failures;
+}
+
+static int run_completion_index_test(void)
+{
+    static const char kData[] = "srv-02.example.comsrv-01.example.comSRV-10.example.orgbuild-agentsrv-01.example.com";
+    static const uint32_t kOffsets[] = { 0, 18, 36, 54, 65, 83 };
+    NmbItemBuffer candidates;
+    memset(&candidates, 0, sizeof(candidates));
+    candidates.struct_size = sizeof(candidates);
+    candidates.data = kData;
+    candidates.offsets = kOffsets;
+    candidates.item_count = 5;
+
+    NmbCompletionIndex* index = NULL;
+    int failures =
+        expect(nmb_completion_index_create(&candidates, &index) == NMB_OK && index != NULL, "completion index built");
+    if (!index)
+    {
+        return failures;
+    }
+
+    uint32_t found[8];
+    size_t count = nmb_completion_index_query(index, "srv-", found, 8);
+    failures += expect(count == 3 && found[0] == 1 && found[1] == 0 && found[2] == 2,
+                       "prefix matches sorted, case-insensitive and without duplicates");
+    failures += expect(nmb_completion_index_query(index, "srv-", found, 2) == 2, "result cap honoured");
+    failures += expect(nmb_completion_index_query(index, "srv-03", found, 8) == 0, "missing prefix");
+    failures += expect(nmb_completion_index_query(index, "", found, 8) == 4, "empty prefix lists every entry");
+
+    NmbCompletionRange range = nmb_completion_index_narrow(index, nmb_completion_index_all(index), "s", 1);
+    range = nmb_completion_index_narrow(index, range, "srv-1", 5);
+    size_t length = 0;
+    const char* text = range.last == range.first + 1 ? nmb_completion_index_text(index, range.first, &length) : NULL;
+    failures += expect(text && length == 18 && memcmp(text, "SRV-10", 6) == 0, "narrowing reuses the previous range");
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_TEXT;
+    input.completion_index = index;
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Connect to";
+    options.input = &input;
+
+    NmbPreparedOptions prepared;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_OK, "live completion index accepted");
+    nmb_release_prepared_options(&prepared);
+
+    nmb_completion_index_destroy(index);
+    input.completion_index = (const NmbCompletionIndex*)kOffsets;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "foreign completion index rejected");
+    return failures;
+}
+
+static int run_table_test(void)
+{
+    static const char kFiles[] = "a.cb\tc.cd.c";
+    static const uint32_t kFileOffsets[] = { 0, 3, 8, 11 };
+    static const char kCodes[] = "E1E22E3";
+    static const uint32_t kCodeOffsets[] = { 0, 2, 5, 7 };
+    static const char* const kHeaders[] = { "File", "Code" };
+
+    NmbItemBuffer columns[2];
+    memset(columns, 0, sizeof(columns));
+    columns[0].struct_size = sizeof(columns[0]);
+    columns[0].data = kFiles;
+    columns[0].offsets = kFileOffsets;
+    columns[0].item_count = 3;
+    columns[1].struct_size = sizeof(columns[1]);
+    columns[1].data = kCodes;
+    columns[1].offsets = kCodeOffsets;
+    columns[1].item_count = 3;
+
+    NmbTableOption table;
+    memset(&table, 0, sizeof(table));
+    table.struct_size = sizeof(table);
+    table.column_headers_utf8 = kHeaders;
+    table.columns = columns;
+    table.column_count = 2;
+    table.row_count = 3;
+
+    NmbSecondaryContentOption secondary;
+    memset(&secondary, 0, sizeof(secondary));
+    secondary.struct_size = sizeof(secondary);
+    secondary.expanded_text_utf8 = "See log";
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Sync failed";
+    options.table = &table;
+
+    NmbPreparedOptions prepared;
+    NmbResultCode rc = nmb_prepare_options(&options, &prepared);
+    if (rc == NMB_OK)
+    {
+        rc = nmb_inline_table(&prepared, 1000);
+    }
+    int failures = expect(rc == NMB_OK, "inline table");
+    if (rc == NMB_OK)
+    {
+        failures += expect(strcmp(prepared.options->secondary->expanded_text_utf8,
+                                  "File\tCode\na.c\tE1\nb c.c\tE22\nd.c\tE3") == 0,
+                           "table rendered as tab-separated lines");
+        failures += expect(prepared.options->table == NULL, "inlined table cleared");
+    }
+    nmb_release_prepared_options(&prepared);
+
+    options.secondary = &secondary;
+    rc = nmb_prepare_options(&options, &prepared);
+    if (rc == NMB_OK)
+    {
+        rc = nmb_inline_table(&prepared, 27);
+    }
+    failures += expect(rc == NMB_OK, "inline truncated table");
+    if (rc == NMB_OK)
+    {
+        failures += expect(strcmp(prepared.options->secondary->expanded_text_utf8,
+                                  "See log\n\nFile\tCode\na.c\tE1\nb c.c\tE22\n\xE2\x80\xA6") == 0,
+                           "table appended to expanded text and cut at a row");
+        failures += expect(strcmp(secondary.expanded_text_utf8, "See log") == 0, "caller secondary untouched");
+    }
+    nmb_release_prepared_options(&prepared);
+
+    columns[1].item_count = 2;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "ragged table rejected");
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+#define BURST_SIZE 4
+
+typedef struct BurstProbe_t
+{
+    int shows;
+    size_t rows;
+    size_t columns;
+    const char* message;
+    nmb_bool listed[BURST_SIZE];
+} BurstProbe;
+
+static BurstProbe s_burst_probe;
+
+static NmbResultCode NMB_CALL record_burst(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+{
+    ++s_burst_probe.shows;
+    s_burst_probe.message = options->message_utf8;
+    s_burst_probe.rows = options->table ? options->table->row_count : 0;
+    s_burst_probe.columns = options->table ? options->table->column_count : 0;
+    for (size_t row = 0; row < s_burst_probe.rows; ++row)
+    {
+        const NmbItemBuffer* messages = &options->table->columns[0];
+        const char* cell = nmb_item_data(messages, row);
+        if (nmb_item_length(messages, row) == 6 && memcmp(cell, "file ", 5) == 0 && cell[5] >= '0' &&
+            cell[5] < '0' + BURST_SIZE)
+        {
+            s_burst_probe.listed[cell[5] - '0'] = NMB_TRUE;
+        }
+    }
+    out_result->button = 7;
+    out_result->result_code = NMB_OK;
+    return NMB_OK;
+}
+
+typedef struct BurstRequest_t
+{
+    char message[8];
+    NmbAggregationOption aggregation;
+    NmbMessageBoxOptions options;
+    NmbMessageBoxResult result;
+    NmbResultCode rc;
+} BurstRequest;
+
+static void init_burst_request(BurstRequest* request, int index, uint32_t window_milliseconds)
+{
+    memset(request, 0, sizeof(*request));
+    snprintf(request->message, sizeof(request->message), "file %d", index);
+    request->aggregation.struct_size = sizeof(request->aggregation);
+    request->aggregation.category_utf8 = "sync";
+    request->aggregation.window_milliseconds = window_milliseconds;
+    request->aggregation.detail_utf8 = "EIO";
+    request->aggregation.summary_utf8 = "Some files failed to sync";
+    request->options.struct_size = sizeof(request->options);
+    request->options.abi_version = NMB_ABI_VERSION;
+    request->options.message_utf8 = request->message;
+    request->options.aggregation = &request->aggregation;
+    request->result.struct_size = sizeof(request->result);
+}
+
+static void run_burst_request(void* data)
+{
+    BurstRequest* request = (BurstRequest*)data;
+    request->rc = nmb_aggregate_show(&request->options, &request->result, record_burst);
+}
+
+static int run_aggregation_test(void)
+{
+    BurstRequest requests[BURST_SIZE];
+    memset(&s_burst_probe, 0, sizeof(s_burst_probe));
+    for (int i = 0; i < BURST_SIZE; ++i)
+    {
+        init_burst_request(&requests[i], i, 300);
+    }
+    run_concurrently(run_burst_request, requests, BURST_SIZE, sizeof(requests[0]));
+
+    int failures = expect(s_burst_probe.shows == 1, "one dialog per burst");
+    failures += expect(s_burst_probe.rows == BURST_SIZE && s_burst_probe.columns == 2, "burst listed with details");
+    failures += expect(s_burst_probe.message && strcmp(s_burst_probe.message, "Some files failed to sync") == 0,
+                       "merged dialog shows the summary");
+    for (int i = 0; i < BURST_SIZE; ++i)
+    {
+        failures += expect(s_burst_probe.listed[i], "every message of the burst listed");
+        failures += expect(requests[i].rc == NMB_OK && requests[i].result.button == 7,
+                           "every caller shares the result");
+    }
+
+    BurstRequest alone;
+    memset(&s_burst_probe, 0, sizeof(s_burst_probe));
+    init_burst_request(&alone, 0, 0);
+    alone.aggregation.detail_utf8 = NULL;
+    failures += expect(nmb_aggregate_show(&alone.options, &alone.result, record_burst) == NMB_OK &&
+                           s_burst_probe.shows == 1 && s_burst_probe.columns == 0 &&
+                           strcmp(s_burst_probe.message, "file 0") == 0,
+                       "lone request shown unchanged");
+
+    NmbInputOption input;
+    memset(&input, 0, sizeof(input));
+    input.struct_size = sizeof(input);
+    input.mode = NMB_INPUT_TEXT;
+    alone.options.input = &input;
+    NmbPreparedOptions prepared;
+    failures += expect(nmb_prepare_options(&alone.options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "aggregated input rejected");
+    nmb_release_prepared_options(&prepared);
+    return failures;
+}
+
+#define COALESCE_SIZE 4
+
+static NmbMessageTemplate* s_coalesced_template;
+static int s_template_shows;
+static const char* s_template_message;
+
+/* Answers with Yes, ticking the verification checkbox whenever it is shown. */
+static NmbResultCode NMB_CALL record_template(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+{
+    ++s_template_shows;
+    s_template_message = options->message_utf8;
+    out_result->button = NMB_BUTTON_ID_YES;
+    out_result->checkbox_checked = options->show_suppress_checkbox;
+    out_result->result_code = NMB_OK;
+    return NMB_OK;
+}
+
+/* Keeps the first dialog open until every other request has arrived and joined it. */
+static NmbResultCode NMB_CALL hold_template(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+{
+    NmbMessageTemplateStats stats;
+    stats.struct_size = sizeof(stats);
+    do
+    {
+        nmb_sleep_milliseconds(1);
+        nmb_message_template_get_stats(s_coalesced_template, &stats);
+    } while (stats.requests < COALESCE_SIZE);
+    return record_template(options, out_result);
+}
+
+typedef struct TemplateRequest_t
+{
+    NmbStringView arguments[2];
+    NmbTemplatedMessage templated;
+    NmbMessageBoxOptions options;
+    NmbMessageBoxResult result;
+    NmbResultCode rc;
+} TemplateRequest;
+
+static void init_template_request(TemplateRequest* request, NmbMessageTemplate* message_template)
+{
+    memset(request, 0, sizeof(*request));
+    request->arguments[0] = make_view("3", 1);
+    request->arguments[1] = make_view("build-01", 8);
+    request->templated.struct_size = sizeof(request->templated);
+    request->templated.message_template = message_template;
+    request->templated.arguments = request->arguments;
+    request->templated.argument_count = 2;
+    request->options.struct_size = sizeof(request->options);
+    request->options.abi_version = NMB_ABI_VERSION;
+    request->options.templated_message = &request->templated;
+    request->result.struct_size = sizeof(request->result);
+}
+
+static void run_template_request(void* data)
+{
+    TemplateRequest* request = (TemplateRequest*)data;
+    request->rc = nmb_message_template_show(&request->options, &request->result, hold_template, NMB_TRUE);
+}
+
+static int run_message_template_test(void)
+{
+    static const char* const kBroken[] = { "{", "}", "{}", "{a{b}", "files {count" };
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(kBroken) / sizeof(kBroken[0]); ++i)
+    {
+        NmbMessageTemplate* broken = NULL;
+        failures += expect(nmb_message_template_create(kBroken[i], &broken) == NMB_E_INVALID_ARGUMENT && !broken,
+                           "malformed pattern rejected");
+    }
+
+    NmbMessageTemplate* message_template = NULL;
+    NmbMessageTemplate* same = NULL;
+    NmbMessageTemplate* other = NULL;
+    const char* pattern = "{count} files failed on {host}; {{{count}}} queued";
+    failures += expect(nmb_message_template_create(pattern, &message_template) == NMB_OK &&
+                           nmb_message_template_create(pattern, &same) == NMB_OK &&
+                           nmb_message_template_create("{count} files synced", &other) == NMB_OK,
+                       "templates created");
+    failures += expect(nmb_message_template_id(message_template) == nmb_message_template_id(same) &&
+                           nmb_message_template_id(message_template) != nmb_message_template_id(other) &&
+                           nmb_message_template_id(message_template) != 0,
+                       "template id follows the pattern");
+    failures += expect(nmb_message_template_argument_count(message_template) == 2 &&
+                           nmb_message_template_argument_index(message_template, "host") == 1 &&
+                           nmb_message_template_argument_index(message_template, "count") == 0 &&
+                           nmb_message_template_argument_index(message_template, "user") == SIZE_MAX,
+                       "placeholders numbered by first appearance");
+
+    TemplateRequest request;
+    init_template_request(&request, message_template);
+    NmbPreparedOptions prepared;
+    failures += expect(nmb_prepare_options(&request.options, &prepared) == NMB_OK &&
+                           strcmp(prepared.options->message_utf8, "3 files failed on build-01; {3} queued") == 0,
+                       "arguments substituted into the message");
+    nmb_release_prepared_options(&prepared);
+
+    request.options.message_utf8 = "plain";
+    failures += expect(nmb_prepare_options(&request.options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "template and message_utf8 together rejected");
+    nmb_release_prepared_options(&prepared);
+    request.options.message_utf8 = NULL;
+    request.templated.argument_count = 1;
+    failures += expect(nmb_prepare_options(&request.options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "missing template argument rejected");
+    nmb_release_prepared_options(&prepared);
+    request.templated.argument_count = 2;
+
+    s_template_shows = 0;
+    request.options.message_utf8 = "3 files failed";
+    failures += expect(nmb_message_template_show(&request.options, &request.result, record_template, NMB_TRUE) ==
+                               NMB_OK &&
+                           s_template_shows == 1 && request.result.button == NMB_BUTTON_ID_YES,
+                       "templated request shown");
+    request.options.show_suppress_checkbox = NMB_TRUE;
+    nmb_message_template_show(&request.options, &request.result, record_template, NMB_TRUE);
+    request.result.button = NMB_BUTTON_ID_NONE;
+    failures += expect(nmb_message_template_show(&request.options, &request.result, record_template, NMB_TRUE) ==
+                               NMB_OK &&
+                           s_template_shows == 2 && request.result.button == NMB_BUTTON_ID_YES,
+                       "checked verification box suppresses the template");
+    nmb_message_template_suppress(message_template, NMB_BUTTON_ID_NONE);
+    nmb_message_template_show(&request.options, &request.result, record_template, NMB_FALSE);
+    failures += expect(s_template_shows == 3, "lifted suppression shows the template again");
+
+    NmbMessageTemplateStats stats;
+    stats.struct_size = sizeof(stats);
+    failures += expect(nmb_message_template_get_stats(message_template, &stats) == NMB_OK && stats.requests == 4 &&
+                           stats.shown == 3 && stats.suppressed == 1 && stats.coalesced == 0,
+                       "template statistics counted");
+
+    TemplateRequest requests[COALESCE_SIZE];
+    s_coalesced_template = other;
+    s_template_shows = 0;
+    for (int i = 0; i < COALESCE_SIZE; ++i)
+    {
+        init_template_request(&requests[i], other);
+        requests[i].templated.argument_count = 1;
+        requests[i].templated.coalesce = NMB_TRUE;
+        requests[i].options.message_utf8 = "3 files synced";
+    }
+    run_concurrently(run_template_request, requests, COALESCE_SIZE, sizeof(requests[0]));
+
+    failures += expect(s_template_shows == 1, "coalesced requests share one dialog");
+    for (int i = 0; i < COALESCE_SIZE; ++i)
+    {
+        failures += expect(requests[i].rc == NMB_OK && requests[i].result.button == NMB_BUTTON_ID_YES,
+                           "every coalesced caller shares the answer");
+    }
+    failures += expect(nmb_message_template_get_stats(other, &stats) == NMB_OK &&
+                           stats.coalesced == COALESCE_SIZE - 1 && stats.shown == 1,
+                       "coalesced requests counted");
+
+    nmb_message_template_destroy(message_template);
+    nmb_message_template_destroy(same);
+    nmb_message_template_destroy(other);
+    return failures;
+}
+
+static int s_wake_count;
+
+static void count_wake(void* context)
+{
+    (void)context;
+    ++s_wake_count;
+}
+
+static NmbDialogUpdate make_update(uint32_t flags)
+{
+    NmbDialogUpdate update;
+    memset(&update, 0, sizeof(update));
+    update.struct_size = sizeof(update);
+    update.flags = flags;
+    return update;
+}
+
+static int run_dialog_handle_test(void)
+{
+    int failures = 0;
+    NmbDialogHandle* handle = NULL;
+    failures += expect(nmb_dialog_handle_create(&handle) == NMB_OK && nmb_dialog_handle_is_valid(handle),
+                       "dialog handle created");
+    if (!handle)
+    {
+        return failures;
+    }
+
+    NmbDialogUpdate early = make_update(NMB_DIALOG_UPDATE_INFORMATIVE_TEXT);
+    early.informative_text_utf8 = "Waiting";
+    failures += expect(nmb_update_dialog(handle, &early) == NMB_OK, "update before the dialog opens");
+
+    s_wake_count = 0;
+    failures += expect(nmb_dialog_handle_attach(handle, count_wake, NULL), "dialog attached");
+    failures += expect(s_wake_count == 1, "waiting changes wake the new dialog");
+    failures += expect(!nmb_dialog_handle_attach(handle, count_wake, NULL), "second dialog refused");
+
+    char countdown[32];
+    for (int remaining = 10; remaining > 0; --remaining)
+    {
+        snprintf(countdown, sizeof(countdown), "Closing in %d", remaining);
+        NmbDialogUpdate tick = make_update(NMB_DIALOG_UPDATE_MESSAGE | NMB_DIALOG_UPDATE_BUTTON_ENABLED);
+        tick.message_utf8 = countdown;
+        tick.button_id = NMB_BUTTON_ID_OK;
+        tick.button_enabled = remaining % 2 == 0 ? NMB_TRUE : NMB_FALSE;
+        failures += expect(nmb_update_dialog(handle, &tick) == NMB_OK, "countdown update");
+    }
+    NmbDialogUpdate cancel = make_update(NMB_DIALOG_UPDATE_BUTTON_ENABLED);
+    cancel.button_id = NMB_BUTTON_ID_CANCEL;
+    cancel.button_enabled = NMB_TRUE;
+    failures += expect(nmb_update_dialog(handle, &cancel) == NMB_OK, "second button update");
+    failures += expect(s_wake_count == 1, "burst of updates wakes the UI thread once");
+
+    NmbDialogChanges changes;
+    nmb_dialog_handle_take(handle, &changes);
+    failures += expect(changes.flags == (NMB_DIALOG_UPDATE_MESSAGE | NMB_DIALOG_UPDATE_INFORMATIVE_TEXT |
+                                         NMB_DIALOG_UPDATE_BUTTON_ENABLED),
+                       "changes merged across updates");
+    failures += expect(changes.message && strcmp(changes.message, "Closing in 1") == 0, "latest message kept");
+    failures += expect(changes.informative_text && strcmp(changes.informative_text, "Waiting") == 0,
+                       "earlier informative text kept");
+    failures += expect(changes.button_count == 2 && changes.buttons[0].id == NMB_BUTTON_ID_OK &&
+                           !changes.buttons[0].enabled && changes.buttons[1].id == NMB_BUTTON_ID_CANCEL,
+                       "one latest state per button");
+    nmb_dialog_changes_release(&changes);
+
+    NmbDialogUpdate clear = make_update(NMB_DIALOG_UPDATE_INFORMATIVE_TEXT);
+    failures += expect(nmb_update_dialog(handle, &clear) == NMB_OK && s_wake_count == 2, "taking rearms wake");
+    nmb_dialog_handle_take(handle, &changes);
+    failures += expect(changes.flags == NMB_DIALOG_UPDATE_INFORMATIVE_TEXT && changes.informative_text == NULL,
+                       "NULL informative text clears it");
+    nmb_dialog_changes_release(&changes);
+
+    NmbDialogUpdate invalid = make_update(NMB_DIALOG_UPDATE_MESSAGE);
+    failures += expect(nmb_update_dialog(handle, &invalid) == NMB_E_INVALID_ARGUMENT, "missing message rejected");
+    invalid.message_utf8 = "bad \xC3";
+    failures += expect(nmb_update_dialog(handle, &invalid) == NMB_E_INVALID_ARGUMENT, "ill-formed message rejected");
+
+    nmb_dialog_handle_detach(handle);
+    failures += expect(nmb_update_dialog(handle, &cancel) == NMB_OK && s_wake_count == 2,
+                       "detached handle stays quiet");
+
+    NmbMessageBoxOptions options;
+    memset(&options, 0, sizeof(options));
+    options.struct_size = sizeof(options);
+    options.abi_version = NMB_ABI_VERSION;
+    options.message_utf8 = "Updating";
+    options.dialog_handle = handle;
+    NmbPreparedOptions prepared;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_OK, "live dialog handle accepted");
+    nmb_release_prepared_options(&prepared);
+
+    nmb_dialog_handle_destroy(handle);
+    static const uint32_t kForeign[8] = { 0 };
+    options.dialog_handle = (NmbDialogHandle*)kForeign;
+    failures += expect(nmb_prepare_options(&options, &prepared) == NMB_E_INVALID_ARGUMENT,
+                       "foreign dialog handle rejected");
+    return failures;
+}
+
+typedef struct TimerProbe_t
+{
+    NmbTimerWheel* wheel;
+    uint64_t* clock;
+    uint64_t fired_at;
+    int calls;
+    uint64_t period; /* re-arms itself this far ahead when non-zero */
+} TimerProbe;
+
+static void record_timer(void* user_data)
+{
+    TimerProbe* probe = (TimerProbe*)user_data;
+    ++probe->calls;
+    probe->fired_at = *probe->clock;
+}
+
+static NmbTimer* s_repeating_timer = NULL;
+
+static void repeat_timer(void* user_data)
+{
+    TimerProbe* probe = (TimerProbe*)user_data;
+    record_timer(probe);
+    nmb_timer_wheel_schedule(probe->wheel, s_repeating_timer, *probe->clock + probe->period);
+}
+
+static int run_timer_wheel_test(void)
+{
+    int failures = 0;
+    uint64_t clock = 1000; /* virtual milliseconds */
+    NmbTimerWheel wheel;
+    nmb_timer_wheel_init(&wheel, 250, clock);
+
+    uint64_t next = 0;
+    failures += expect(!nmb_timer_wheel_next_deadline(&wheel, &next), "empty wheel has no deadline");
+
+    TimerProbe probes[5];
+    NmbTimer timers[5];
+    static const uint64_t kDelays[5] = {
+        100,                            /* rounds up to the next tick */
+        1000,                           /* cancelled below */
+        20000,                          /* second level */
+        3600000,                        /* third level */
+        60ull * 24 * 3600 * 1000        /* beyond the wheel's span */
+    };
+    for (int i = 0; i < 5; ++i)
+    {
+        memset(&probes[i], 0, sizeof(probes[i]));
+        probes[i].wheel = &wheel;
+        probes[i].clock = &clock;
+        nmb_timer_init(&timers[i], record_timer, &probes[i]);
+        nmb_timer_wheel_schedule(&wheel, &timers[i], clock + kDelays[i]);
+    }
+
+    failures += expect(nmb_timer_wheel_next_deadline(&wheel, &next) && next == 1250, "deadline aligned to a tick");
+    clock = 1249;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 0, "nothing fires before the tick");
+    clock = 1250;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 1 && probes[0].calls == 1, "first timer fires");
+    failures += expect(!nmb_timer_is_pending(&timers[0]), "fired timer is no longer pending");
+
+    nmb_timer_wheel_cancel(&wheel, &timers[1]);
+    nmb_timer_wheel_cancel(&wheel, &timers[1]);
+    failures += expect(nmb_timer_wheel_next_deadline(&wheel, &next) && next == 21000,
+                       "next deadline found on an upper level");
+    clock = 20999;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 0, "cancelled timer stays quiet");
+    clock = 21000;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 1 && probes[2].fired_at == 21000,
+                       "cascaded timer fires on time");
+
+    failures += expect(nmb_timer_wheel_next_deadline(&wheel, &next) && next == 3601000, "hour-long deadline");
+    clock = 3600999;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 0, "hour-long timer waits");
+    clock = 3601000;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 1 && probes[3].calls == 1, "hour-long timer fires");
+
+    clock = 1000 + kDelays[4] - 1;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 0, "distant timer waits past the span");
+    clock += 1;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 1 && probes[4].fired_at == clock,
+                       "distant timer fires on time");
+    failures += expect(!nmb_timer_wheel_next_deadline(&wheel, &next), "wheel drained");
+
+    /* A countdown re-arms itself from its own callback once a second. */
+    TimerProbe countdown;
+    memset(&countdown, 0, sizeof(countdown));
+    countdown.wheel = &wheel;
+    countdown.clock = &clock;
+    countdown.period = 1000;
+    NmbTimer repeating;
+    nmb_timer_init(&repeating, repeat_timer, &countdown);
+    s_repeating_timer = &repeating;
+    nmb_timer_wheel_schedule(&wheel, &repeating, clock + 1000);
+    for (int step = 0; step < 40; ++step)
+    {
+        clock += 250;
+        nmb_timer_wheel_advance(&wheel, clock);
+    }
+    failures += expect(countdown.calls == 10, "repeating timer fires once per period");
+    clock += 5000;
+    failures += expect(nmb_timer_wheel_advance(&wheel, clock) == 1 && countdown.calls == 11,
+                       "a late advance fires a missed timer once");
+    nmb_timer_wheel_cancel(&wheel, &repeating);
+    failures += expect(wheel.count == 0, "cancelled from outside its callback");
+    return failures;
+}
+
+static int s_clock_wakes = 0;
+
+static void count_clock_wake(void)
+{
+    ++s_clock_wakes;
+}
+
+typedef struct ClockWaiter_t
+{
+    NmbMutex lock;
+    nmb_bool done;
+    nmb_bool released;
+} ClockWaiter;
+
+typedef struct ClockTask_t
+{
+    ClockWaiter* waiter;
+    nmb_bool advances;
+} ClockTask;
+
+static void run_clock_task(void* data)
+{
+    ClockTask* task = (ClockTask*)data;
+    ClockWaiter* waiter = task->waiter;
+    if (!task->advances)
+    {
+        nmb_clock_wait_milliseconds(60000);
+        nmb_mutex_lock(&waiter->lock);
+        waiter->done = NMB_TRUE;
+        nmb_mutex_unlock(&waiter->lock);
+        return;
+    }
+
+    nmb_bool done = NMB_FALSE;
+    for (int step = 0; step < 10000 && !done; ++step)
+    {
+        nmb_clock_advance(10000);
+        nmb_sleep_milliseconds(1);
+        nmb_mutex_lock(&waiter->lock);
+        done = waiter->done;
+        nmb_mutex_unlock(&waiter->lock);
+    }
+    /* Releases a waiter the advances never reached so the test fails instead of hanging. */
+    nmb_clock_use_system();
+    waiter->released = done;
+}
+
+static int run_clock_test(void)
+{
+    int failures = expect(!nmb_clock_is_virtual(), "system clock by default");
+    s_clock_wakes = 0;
+    nmb_clock_set_wake(count_clock_wake);
+
+    nmb_clock_advance(0);
+    const uint64_t start = nmb_clock_now_milliseconds();
+    nmb_sleep_milliseconds(5);
+    failures += expect(nmb_clock_is_virtual() && nmb_clock_now_milliseconds() == start, "virtual clock stands still");
+    nmb_clock_advance(3600000);
+    failures += expect(nmb_clock_now_milliseconds() == start + 3600000 && s_clock_wakes == 2,
+                       "an hour passes at once and wakes the backend");
+    failures += expect(nmb_clock_play_scripted_answer(1000, 5000) && nmb_clock_now_milliseconds() == start + 3601000,
+                       "timeout answers before a slower script");
+    failures += expect(!nmb_clock_play_scripted_answer(0, 2000) && nmb_clock_now_milliseconds() == start + 3603000,
+                       "scripted answer without a timeout");
+
+    /* A wait ends once other threads moved the clock far enough, however long that is in real time. */
+    ClockWaiter waiter;
+    memset(&waiter, 0, sizeof(waiter));
+    nmb_mutex_init(&waiter.lock);
+    ClockTask tasks[2] = { { &waiter, NMB_FALSE }, { &waiter, NMB_TRUE } };
+    run_concurrently(run_clock_task, tasks, 2, sizeof(tasks[0]));
+    nmb_mutex_destroy(&waiter.lock);
+    failures += expect(waiter.released, "virtual wait released by advancing");
+
+    nmb_clock_set_wake(NULL);
+    failures += expect(!nmb_clock_is_virtual(), "system clock restored");
+    return failures;
+}
+
+/* Stands in for a backend: takes its own stamps as a GTK dialog would, a little apart on the virtual clock. */
+static NmbResultCode NMB_CALL timed_show(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+{
+    (void)options;
+    nmb_timing_begin(out_result, nmb_clock_now_microseconds());
+    nmb_clock_advance(10);
+    nmb_timing_mark(out_result, NMB_TIMING_BUILT);
+    nmb_clock_advance(5);
+    nmb_timing_mark(out_result, NMB_TIMING_MAPPED);
+    nmb_clock_advance(5);
+    nmb_timing_mark(out_result, NMB_TIMING_MAPPED);
+    nmb_clock_advance(100);
+    nmb_timing_finish(out_result, NMB_BACKEND_GTK);
+    return NMB_OK;
+}
+
+static int run_timing_test(void)
+{
+    nmb_clock_advance(0);
+    const uint64_t start = nmb_clock_now_microseconds();
+    int failures = expect(start == nmb_clock_now_milliseconds() * 1000u, "virtual clock in microseconds");
+
+    NmbMessageBoxResult result;
+    memset(&result, 0, sizeof(result));
+    result.struct_size = sizeof(result);
+    nmb_clock_advance(2);
+    nmb_timing_begin(&result, start);
+    nmb_clock_advance(3);
+    failures += expect(nmb_timing_reenter(timed_show, NULL, &result) == NMB_OK, "re-entered show");
+    failures += expect(result.received_microseconds == start && result.validated_microseconds == start + 2000,
+                       "re-entering keeps the outer request's stamps");
+    failures += expect(result.built_microseconds == start + 15000 && result.mapped_microseconds == start + 20000,
+                       "built and first mapped");
+    failures += expect(result.responded_microseconds == start + 125000 && result.backend == NMB_BACKEND_GTK,
+                       "responded on GTK");
+
+    NmbDialogTiming timing;
+    nmb_timing_save(&result, &timing);
+    NmbMessageBoxResult joined;
+    memset(&joined, 0, sizeof(joined));
+    joined.struct_size = sizeof(joined);
+    nmb_timing_begin(&joined, start + 1000);
+    nmb_timing_load(&joined, &timing);
+    failures += expect(joined.received_microseconds == start + 1000 && joined.mapped_microseconds == start + 20000 &&
+                           joined.backend == NMB_BACKEND_GTK,
+                       "a joined caller shares the dialog's stages");
+
+    memset(&joined, 0xA5, sizeof(joined));
+    joined.struct_size = (uint32_t)offsetof(NmbMessageBoxResult, received_microseconds);
+    nmb_timing_begin(&joined, start);
+    nmb_timing_finish(&joined, NMB_BACKEND_GTK);
+    nmb_timing_load(&joined, &timing);
+    failures += expect(joined.received_microseconds == 0xA5A5A5A5A5A5A5A5ull &&
+                           joined.responded_microseconds == 0xA5A5A5A5A5A5A5A5ull,
+                       "results without timing fields are left alone");
+
+    nmb_clock_use_system();
+    return failures;
+}
+
+int main(void)
+{
+    int failures = 0;
+    failures += run_passthrough_test();
+    failures += run_string_view_test();
+    failures += run_missing_strings_test();
+    failures += run_utf16_transcode_test();
+    failures += run_utf16_views_test();
+    failures += run_utf8_validation_test();
+    failures += run_invalid_utf8_options_test();
+    failures += run_legacy_invalid_utf8_test();
+    failures += run_mapped_file_test();
+    failures += run_text_threshold_test();
+    failures += run_item_buffer_test();
+    failures += run_completion_index_test();
+    failures += run_table_test();
+    failures += run_aggregation_test();
+    failures += run_message_template_test();
+    failures += run_dialog_handle_test();
+    failures += run_timer_wheel_test();
+    failures += run_clock_test();
+    failures += run_timing_test();
+    return failures == 0 ? 0 : 1;
+}
@@ -18,7 +18,8 @@
     CHECKBOX: 1,
     TEXT: 2,
     PASSWORD: 3,
-    COMBO: 4
+    COMBO: 4,
+    MULTILINE: 5
   };
 
   Module.NmbResultCode = ResultCode;
@@ -136,6 +137,53 @@
   color: inherit;
   font: inherit;
 }
+textarea.nmb-dialog-input {
+  min-height: 8em;
+  resize: vertical;
+}
+.nmb-dialog-form {
+  display: grid;
+  grid-template-columns: max-content 1fr;
+  align-items: center;
+  gap: 8px 12px;
+}
+.nmb-dialog-form > .nmb-dialog-checkbox {
+  grid-column: 2;
+}
+.nmb-dialog-table {
+  display: flex;
+  flex-direction: column;
+  border: 1px solid rgba(255, 255, 255, 0.25);
+  border-radius: 8px;
+  overflow: hidden;
+}
+.nmb-dialog-table-row {
+  display: grid;
+  grid-auto-flow: column;
+  grid-auto-columns: minmax(0, 1fr);
+  height: 24px;
+  line-height: 24px;
+}
+.nmb-dialog-table-row > span {
+  padding: 0 8px;
+  overflow: hidden;
+  white-space: nowrap;
+  text-overflow: ellipsis;
+}
+.nmb-dialog-table-header > span {
+  font-weight: 600;
+  cursor: pointer;
+}
+.nmb-dialog-table-viewport {
+  position: relative;
+  height: 240px;
+  overflow-y: auto;
+}
+.nmb-dialog-table-viewport > .nmb-dialog-table-row {
+  position: absolute;
+  left: 0;
+  right: 0;
+}
 .nmb-dialog-select {
   padding: 8px 10px;
   border-radius: 8px;
@@ -191,13 +239,14 @@
         wasTimeout: false
       };
 
-      if (typeof alert === "function" && buttons.length <= 1) {
+      const hasForm = request.fields && request.fields.length > 0;
+      if (typeof alert === "function" && buttons.length <= 1 && !hasForm) {
         alert(text);
         resolve(res);
         return;
       }
 
-      if (typeof confirm === "function" && buttons.length === 2) {
+      if (typeof confirm === "function" && buttons.length === 2 && !hasForm) {
         const confirmed = confirm(text);
         res.buttonId = confirmed
           ? primary.id
@@ -261,6 +310,192 @@
       return undefined;
     }
 
+    function gatherFieldValues(fields, controls) {
+      if (!fields || fields.length === 0) {
+        return undefined;
+      }
+
+      return fields.map((field, index) => {
+        const control = controls[index];
+        if (field.mode === InputMode.CHECKBOX) {
+          return { value: "", checked: !!(control && control.checked) };
+        }
+        return { value: control ? control.value : "", checked: false };
+      });
+    }
+
+    // Bare control for one input; the caller supplies the label or checkbox wrapper around it.
+    function createInputControl(input) {
+      let control;
+      if (input.mode === InputMode.CHECKBOX) {
+        control = document.createElement("input");
+        control.type = "checkbox";
+        control.className = "nmb-dialog-input";
+        control.checked = input.defaultValue === "true";
+        return control;
+      }
+
+      if (input.mode === InputMode.COMBO) {
+        control = document.createElement("select");
+        control.className = "nmb-dialog-select";
+
+        if (input.comboItems && input.comboItems.length > 0) {
+          // Built off-document so a long list costs one insertion instead of one per item.
+          const fragment = document.createDocumentFragment();
+          const hasDefaultIndex = typeof input.defaultIndex === "number";
+          input.comboItems.forEach((item) => {
+            const option = document.createElement("option");
+            option.value = item;
+            option.textContent = item;
+            if (!hasDefaultIndex && input.defaultValue && input.defaultValue === item) {
+              option.selected = true;
+            }
+            fragment.appendChild(option);
+          });
+          control.appendChild(fragment);
+          if (hasDefaultIndex && input.defaultIndex < input.comboItems.length) {
+            control.selectedIndex = input.defaultIndex;
+          }
+        }
+        return control;
+      }
+
+      if (input.mode === InputMode.MULTILINE) {
+        control = document.createElement("textarea");
+        control.rows = 8;
+      } else {
+        control = document.createElement("input");
+        control.type = input.mode === InputMode.PASSWORD ? "password" : "text";
+      }
+
+      control.className = "nmb-dialog-input";
+      control.placeholder = input.placeholder || "";
+      if (input.defaultValue) {
+        control.value = input.defaultValue;
+      }
+      return control;
+    }
+
+    function createCheckboxRow(control, text) {
+      const checkboxWrapper = document.createElement("label");
+      checkboxWrapper.className = "nmb-dialog-checkbox";
+
+      const span = document.createElement("span");
+      span.textContent = text || "";
+
+      checkboxWrapper.appendChild(control);
+      checkboxWrapper.appendChild(span);
+      return checkboxWrapper;
+    }
+
+    // Prompts in the first grid column and controls in the second; checkboxes carry their own prompt.
+    function createForm(fields, controls) {
+      const form = document.createElement("div");
+      form.className = "nmb-dialog-form";
+
+      fields.forEach((field) => {
+        const control = createInputControl(field);
+        controls.push(control);
+        if (field.mode === InputMode.CHECKBOX) {
+          form.appendChild(createCheckboxRow(control, field.prompt));
+          return;
+        }
+
+        const label = document.createElement("label");
+        label.textContent = field.prompt || "";
+        control.setAttribute("aria-label", field.prompt || "");
+        form.appendChild(label);
+        form.appendChild(control);
+      });
+
+      return form;
+    }
+
+    const TABLE_ROW_HEIGHT = 24;
+
+    // Only the rows inside the viewport exist as elements; scrolling rebinds the same few rows, so
+    // a table of any length costs one spacer plus about a screenful of nodes.
+    function createTable(table) {
+      const rowCount = table.columns.length > 0 ? table.columns[0].length : 0;
+      const order = Array.from({ length: rowCount }, (_, index) => index);
+      const container = document.createElement("div");
+      container.className = "nmb-dialog-table";
+      container.setAttribute("role", "table");
+
+      const header = document.createElement("div");
+      header.className = "nmb-dialog-table-row nmb-dialog-table-header";
+      header.setAttribute("role", "row");
+      container.appendChild(header);
+
+      const viewport = document.createElement("div");
+      viewport.className = "nmb-dialog-table-viewport";
+      viewport.tabIndex = 0;
+      const spacer = document.createElement("div");
+      spacer.style.height = `${rowCount * TABLE_ROW_HEIGHT}px`;
+      viewport.appendChild(spacer);
+      container.appendChild(viewport);
+
+      const pool = [];
+      let pending = 0;
+      function render() {
+        pending = 0;
+        const first = Math.floor(viewport.scrollTop / TABLE_ROW_HEIGHT);
+        const visible = Math.min(rowCount - first, Math.ceil(viewport.clientHeight / TABLE_ROW_HEIGHT) + 1);
+        while (pool.length < visible) {
+          const row = document.createElement("div");
+          row.className = "nmb-dialog-table-row";
+          row.setAttribute("role", "row");
+          table.columns.forEach(() => row.appendChild(document.createElement("span")));
+          viewport.appendChild(row);
+          pool.push(row);
+        }
+
+        pool.forEach((row, slot) => {
+          if (slot >= visible) {
+            row.hidden = true;
+            return;
+          }
+          const position = first + slot;
+          const source = order[position];
+          row.hidden = false;
+          row.style.top = `${position * TABLE_ROW_HEIGHT}px`;
+          table.columns.forEach((column, index) => {
+            row.children[index].textContent = column[source];
+          });
+        });
+      }
+
+      function schedule() {
+        if (!pending) {
+          pending = requestAnimationFrame(render);
+        }
+      }
+
+      const collator = new Intl.Collator(undefined, { numeric: true, sensitivity: "base" });
+      let sortColumn = -1;
+      let descending = false;
+      table.headers.forEach((text, index) => {
+        const cell = document.createElement("span");
+        cell.textContent = text;
+        cell.setAttribute("role", "columnheader");
+        cell.setAttribute("aria-sort", "none");
+        cell.addEventListener("click", () => {
+          descending = sortColumn === index ? !descending : false;
+          sortColumn = index;
+          const column = table.columns[index];
+          order.sort((a, b) => (descending ? -1 : 1) * collator.compare(column[a], column[b]) || a - b);
+          Array.from(header.children).forEach((other) => other.setAttribute("aria-sort", "none"));
+          cell.setAttribute("aria-sort", descending ? "descending" : "ascending");
+          schedule();
+        });
+        header.appendChild(cell);
+      });
+
+      viewport.addEventListener("scroll", schedule);
+      schedule();
+      return container;
+    }
+
     async function showMessageBox(request) {
       if (!supportsDom) {
         return fallbackPrompt(request);
@@ -321,63 +556,28 @@
       body.appendChild(message);
       dialog.appendChild(body);
 
+      if (request.table && request.table.columns.length > 0) {
+        dialog.appendChild(createTable(request.table));
+      }
+
       const controlsContainer = document.createElement("div");
       controlsContainer.className = "nmb-dialog-controls";
       let inputControl = null;
       let verificationControl = null;
+      const fieldControls = [];
 
       if (request.input && request.input.mode !== InputMode.NONE) {
+        inputControl = createInputControl(request.input);
         if (request.input.mode === InputMode.CHECKBOX) {
-          const checkboxWrapper = document.createElement("label");
-          checkboxWrapper.className = "nmb-dialog-checkbox";
-
-          inputControl = document.createElement("input");
-          inputControl.type = "checkbox";
-          inputControl.className = "nmb-dialog-input";
-          inputControl.checked = request.input.defaultValue === "true";
-
-          const span = document.createElement("span");
-          span.textContent = request.input.prompt || "";
-
-          checkboxWrapper.appendChild(inputControl);
-          checkboxWrapper.appendChild(span);
-          controlsContainer.appendChild(checkboxWrapper);
-        } else if (request.input.mode === InputMode.COMBO) {
-          const label = document.createElement("label");
-          label.textContent = request.input.prompt || "";
-
-          inputControl = document.createElement("select");
-          inputControl.className = "nmb-dialog-select";
-
-          if (request.input.comboItems && request.input.comboItems.length > 0) {
-            request.input.comboItems.forEach((item) => {
-              const option = document.createElement("option");
-              option.value = item;
-              option.textContent = item;
-              if (request.input.defaultValue && request.input.defaultValue === item) {
-                option.selected = true;
-              }
-              inputControl.appendChild(option);
-            });
-          }
-
-          label.appendChild(inputControl);
-          controlsContainer.appendChild(label);
+          controlsContainer.appendChild(createCheckboxRow(inputControl, request.input.prompt));
         } else {
           const label = document.createElement("label");
           label.textContent = request.input.prompt || "";
-
-          inputControl = document.createElement("input");
-          inputControl.type = request.input.mode === InputMode.PASSWORD ? "password" : "text";
-          inputControl.className = "nmb-dialog-input";
-          inputControl.placeholder = request.input.placeholder || "";
-          if (request.input.defaultValue) {
-            inputControl.value = request.input.defaultValue;
-          }
-
           label.appendChild(inputControl);
           controlsContainer.appendChild(label);
         }
+      } else if (request.fields && request.fields.length > 0) {
+        controlsContainer.appendChild(createForm(request.fields, fieldControls));
       }
 
       if (request.verificationText) {
@@ -440,7 +640,8 @@
             buttonId: button.id,
             checkboxChecked: verificationControl ? verificationControl.checked : false,
             wasTimeout: false,
-            inputValue: gatherInputValue(request, { input: inputControl })
+            inputValue: gatherInputValue(request, { input: inputControl }),
+            fieldValues: gatherFieldValues(request.fields, fieldControls)
           });
         });
 
@@ -472,7 +673,8 @@
               buttonId: cancelButton.id,
               checkboxChecked: verificationControl ? verificationControl.checked : false,
               wasTimeout: false,
-              inputValue: gatherInputValue(request, { input: inputControl })
+              inputValue: gatherInputValue(request, { input: inputControl }),
+              fieldValues: gatherFieldValues(request.fields, fieldControls)
             });
           } else {
             teardownDialog({
@@ -490,6 +692,11 @@
           if (inputControl && inputControl.tabIndex !== -1) {
             focusables.push(inputControl);
           }
+          fieldControls.forEach((control) => {
+            if (control.tabIndex !== -1) {
+              focusables.push(control);
+            }
+          });
           if (verificationControl && verificationControl.tabIndex !== -1) {
             focusables.push(verificationControl);
           }
@@ -523,7 +730,8 @@
               buttonId: cancelButton.id,
               checkboxChecked: verificationControl ? verificationControl.checked : false,
               wasTimeout: false,
-              inputValue: gatherInputValue(request, { input: inputControl })
+              inputValue: gatherInputValue(request, { input: inputControl }),
+              fieldValues: gatherFieldValues(request.fields, fieldControls)
             });
           } else {
             teardownDialog({
@@ -550,7 +758,8 @@
               buttonId: timeoutButton.id,
               checkboxChecked: verificationControl ? verificationControl.checked : false,
               wasTimeout: true,
-              inputValue: gatherInputValue(request, { input: inputControl })
+              inputValue: gatherInputValue(request, { input: inputControl }),
+              fieldValues: gatherFieldValues(request.fields, fieldControls)
             });
           } else if (cancelButton) {
             teardownDialog({
@@ -558,7 +767,8 @@
               buttonId: cancelButton.id,
               checkboxChecked: verificationControl ? verificationControl.checked : false,
               wasTimeout: true,
-              inputValue: gatherInputValue(request, { input: inputControl })
+              inputValue: gatherInputValue(request, { input: inputControl }),
+              fieldValues: gatherFieldValues(request.fields, fieldControls)
             });
           } else {
             teardownDialog({
@@ -600,6 +810,7 @@
 
   if (!Module.nmbCreateMessageBoxInterop) {
     Module.nmbCreateMessageBoxInterop = function (ModuleInstance) {
+      const HEAPU8 = ModuleInstance.HEAPU8;
       const HEAPU32 = ModuleInstance.HEAPU32;
       const utf8ToString = ModuleInstance.UTF8ToString;
       const stringToUTF8 = ModuleInstance.stringToUTF8;
@@ -607,10 +818,14 @@
       const malloc = ModuleInstance._malloc;
 
       const BUTTON_WORDS = 6;
-      const INPUT_WORDS = 6;
+      const INPUT_WORDS = 9;
+      const NO_DEFAULT_INDEX = 0xffffffff;
       const SECONDARY_WORDS = 4;
-      const REQUEST_WORDS = 16;
-      const RESPONSE_WORDS = 6;
+      const REQUEST_WORDS = 19;
+      const TABLE_WORDS = 4;
+      const COLUMN_WORDS = 2;
+      const RESPONSE_WORDS = 8;
+      const FIELD_VALUE_WORDS = 3;
 
       let host = null;
 
@@ -640,6 +855,24 @@
         return out;
       }
 
+      let itemDecoder = null;
+
+      // Contiguous items: one data block plus comboCount + 1 offsets, decoded without per-item C strings.
+      function readItemBuffer(dataPtr, offsetsPtr, count) {
+        if (!itemDecoder) {
+          itemDecoder = new TextDecoder("utf-8");
+        }
+
+        const items = new Array(count);
+        const offsets = offsetsPtr >> 2;
+        for (let i = 0; i < count; i += 1) {
+          const start = dataPtr + HEAPU32[offsets + i];
+          const end = dataPtr + HEAPU32[offsets + i + 1];
+          items[i] = itemDecoder.decode(HEAPU8.subarray(start, end));
+        }
+        return items;
+      }
+
       function readInput(ptr) {
         if (!ptr) {
           return null;
@@ -649,8 +882,13 @@
         const mode = HEAPU32[base];
         const comboPtr = HEAPU32[base + 4];
         const comboCount = HEAPU32[base + 5];
-        const comboItems = [];
-        if (comboPtr && comboCount > 0) {
+        const comboDataPtr = HEAPU32[base + 6];
+        const comboOffsetsPtr = HEAPU32[base + 7];
+        const defaultIndex = HEAPU32[base + 8];
+        let comboItems = [];
+        if (comboDataPtr && comboOffsetsPtr && comboCount > 0) {
+          comboItems = readItemBuffer(comboDataPtr, comboOffsetsPtr, comboCount);
+        } else if (comboPtr && comboCount > 0) {
           const comboBase = comboPtr >> 2;
           for (let i = 0; i < comboCount; i += 1) {
             const value = readOptionalString(HEAPU32[comboBase + i]);
@@ -663,10 +901,41 @@
           prompt: readOptionalString(HEAPU32[base + 1]),
           placeholder: readOptionalString(HEAPU32[base + 2]),
           defaultValue: readOptionalString(HEAPU32[base + 3]),
+          defaultIndex: defaultIndex !== NO_DEFAULT_INDEX ? defaultIndex : undefined,
           comboItems
         };
       }
 
+      function readFields(ptr, count) {
+        const fields = [];
+        for (let i = 0; i < count; i += 1) {
+          fields.push(readInput(ptr + i * INPUT_WORDS * 4));
+        }
+        return fields;
+      }
+
+      // Each column is its own item buffer, so cells decode without a JSON round trip.
+      function readTable(ptr) {
+        if (!ptr) {
+          return null;
+        }
+
+        const base = ptr >> 2;
+        const headersBase = HEAPU32[base] >> 2;
+        const columnsBase = HEAPU32[base + 1] >> 2;
+        const columnCount = HEAPU32[base + 2];
+        const rowCount = HEAPU32[base + 3];
+        const headers = [];
+        const columns = [];
+        for (let i = 0; i < columnCount; i += 1) {
+          const header = readOptionalString(HEAPU32[headersBase + i]);
+          headers.push(header !== undefined ? header : "");
+          const column = columnsBase + i * COLUMN_WORDS;
+          columns.push(readItemBuffer(HEAPU32[column], HEAPU32[column + 1], rowCount));
+        }
+        return { headers, columns };
+      }
+
       function readSecondary(ptr) {
         if (!ptr) {
           return null;
@@ -703,13 +972,47 @@
           timeoutButtonId: HEAPU32[base + 12],
           locale: readOptionalString(HEAPU32[base + 13]),
           input: readInput(HEAPU32[base + 14]),
-          secondary: readSecondary(HEAPU32[base + 15])
+          secondary: readSecondary(HEAPU32[base + 15]),
+          fields: readFields(HEAPU32[base + 16], HEAPU32[base + 17]),
+          table: readTable(HEAPU32[base + 18])
         };
       }
 
-      function writeResponse(ptr, result) {
+      // All answers go into one block, [valuePtr, length, checked] per field followed by the text, so the
+      // runtime frees a single allocation however many fields the form has.
+      function writeFieldValues(base, fieldValues, fieldCount) {
+        const texts = new Array(fieldCount);
+        let total = fieldCount * FIELD_VALUE_WORDS * 4;
+        for (let i = 0; i < fieldCount; i += 1) {
+          const answer = fieldValues[i];
+          texts[i] = answer && typeof answer.value === "string" ? answer.value : "";
+          total += lengthBytesUTF8(texts[i]) + 1;
+        }
+
+        const mem = malloc(total);
+        if (!mem) {
+          HEAPU32[base + 0] = ResultCode.OUT_OF_MEMORY;
+          return;
+        }
+
+        let text = mem + fieldCount * FIELD_VALUE_WORDS * 4;
+        for (let i = 0; i < fieldCount; i += 1) {
+          const entry = (mem >> 2) + i * FIELD_VALUE_WORDS;
+          const size = lengthBytesUTF8(texts[i]) + 1;
+          stringToUTF8(texts[i], text, size);
+          HEAPU32[entry] = text;
+          HEAPU32[entry + 1] = size - 1;
+          HEAPU32[entry + 2] = fieldValues[i] && fieldValues[i].checked ? 1 : 0;
+          text += size;
+        }
+
+        HEAPU32[base + 6] = mem;
+        HEAPU32[base + 7] = fieldCount;
+      }
+
+      function writeResponse(ptr, result, fieldCount) {
         const base = ptr >> 2;
-        const { resultCode, buttonId, checkboxChecked, wasTimeout, inputValue } = result;
+        const { resultCode, buttonId, checkboxChecked, wasTimeout, inputValue, fieldValues } = result;
 
         HEAPU32[base + 0] = resultCode >>> 0;
         HEAPU32[base + 1] = buttonId >>> 0;
@@ -717,6 +1020,15 @@
         HEAPU32[base + 3] = wasTimeout ? 1 : 0;
         HEAPU32[base + 4] = 0;
         HEAPU32[base + 5] = 0;
+        HEAPU32[base + 6] = 0;
+        HEAPU32[base + 7] = 0;
+
+        if (fieldCount > 0) {
+          if (Array.isArray(fieldValues)) {
+            writeFieldValues(base, fieldValues, fieldCount);
+          }
+          return;
+        }
 
         if (typeof inputValue === "string") {
           const length = lengthBytesUTF8(inputValue) + 1;
@@ -793,7 +1105,7 @@
           result.wasTimeout = false;
         }
 
-        writeResponse(ptrResponse, result);
+        writeResponse(ptrResponse, result, request.fields.length);
       }
 
       function shutdown() {
@@ -910,6 +1222,26 @@
       normalized.input = null;
     }
 
+    normalized.fields = Array.isArray(normalized.fields)
+      ? normalized.fields.filter((field) => field && typeof field === "object").map((field) => ({
+        ...field,
+        mode: Number(field.mode || 0),
+        comboItems: Array.isArray(field.comboItems)
+          ? field.comboItems.map((item) => (typeof item === "string" ? item : ""))
+          : []
+      }))
+      : [];
+
+    const table = normalized.table;
+    normalized.table = table && Array.isArray(table.headers) && Array.isArray(table.columns)
+      ? {
+        headers: table.headers.map((header) => (typeof header === "string" ? header : "")),
+        columns: table.columns.map((column) =>
+          (Array.isArray(column) ? column : []).map((cell) => (typeof cell === "string" ? cell : ""))
+        )
+      }
+      : null;
+
     if (normalized.secondary && typeof normalized.secondary === "object") {
       const secondary = normalized.secondary;
       secondary.informativeText = typeof secondary.informativeText === "string" ? secondary.informativeText : undefined;
@@ -986,7 +1318,13 @@
             buttonId: typeof result.buttonId === "number" ? result.buttonId : 0,
             checkboxChecked: !!result.checkboxChecked,
             wasTimeout: !!result.wasTimeout,
-            inputValue: typeof result.inputValue === "string" ? result.inputValue : null
+            inputValue: typeof result.inputValue === "string" ? result.inputValue : null,
+            fieldValues: Array.isArray(result.fieldValues)
+              ? result.fieldValues.map((answer) => ({
+                value: answer && typeof answer.value === "string" ? answer.value : "",
+                checked: !!(answer && answer.checked)
+              }))
+              : null
           });
         } catch (err) {
           managedLog("NativeMessageBox: managed host dispatch failed.", "error");
@@ -1,15 +1,31 @@
 #include "../../../include/native_message_box.h"
 #include "../../shared/nmb_alloc.h"
+#include "../../shared/nmb_async.h"
+#include "../../shared/nmb_clock.h"
+#include "../../shared/nmb_items.h"
+#include "../../shared/nmb_message_template.h"
+#include "../../shared/nmb_options.h"
+#include "../../shared/nmb_request.h"
 #include "../../shared/nmb_runtime.h"
+#include "../../shared/nmb_timing.h"
+#include "../../shared/nmb_toast.h"
 
 #include <emscripten/emscripten.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 
 namespace
 {
+    constexpr size_t kMessageBoxOptionsMinSize =
+        offsetof(NmbMessageBoxOptions, user_context) + sizeof(void*);
+    constexpr size_t kMessageBoxResultMinSize =
+        offsetof(NmbMessageBoxResult, result_code) + sizeof(NmbResultCode);
+    constexpr uint32_t kNoDefaultIndex = 0xFFFFFFFFu;
+
     struct NmbWasmButton
     {
         uint32_t id;
@@ -28,6 +44,9 @@ namespace
         uint32_t default_value_ptr;
         uint32_t combo_items_ptr;
         uint32_t combo_count;
+        uint32_t combo_data_ptr; // contiguous items; data and offsets replace combo_items_ptr
+        uint32_t combo_offsets_ptr;
+        uint32_t default_index; // kNoDefaultIndex when the default matches no item
     };
 
     struct NmbWasmSecondary
@@ -38,6 +57,20 @@ namespace
         uint32_t help_link_ptr;
     };
 
+    struct NmbWasmColumn
+    {
+        uint32_t data_ptr;
+        uint32_t offsets_ptr; // row_count + 1 offsets into data_ptr
+    };
+
+    struct NmbWasmTable
+    {
+        uint32_t headers_ptr; // column_count header string pointers
+        uint32_t columns_ptr; // column_count NmbWasmColumn entries
+        uint32_t column_count;
+        uint32_t row_count;
+    };
+
     struct NmbWasmRequest
     {
         uint32_t title_ptr;
@@ -56,6 +89,9 @@ namespace
         uint32_t locale_ptr;
         uint32_t input_ptr;
         uint32_t secondary_ptr;
+        uint32_t form_fields_ptr; // form_field_count NmbWasmInput entries
+        uint32_t form_field_count;
+        uint32_t table_ptr;
     };
 
     struct NmbWasmResponse
@@ -66,13 +102,25 @@ namespace
         uint32_t was_timeout;
         uint32_t input_ptr;
         uint32_t input_length;
+        uint32_t fields_ptr; // one malloc block: field_count NmbWasmFieldValue entries, then their text
+        uint32_t field_count;
+    };
+
+    struct NmbWasmFieldValue
+    {
+        uint32_t value_ptr;
+        uint32_t length;
+        uint32_t checked;
     };
 
     static_assert(sizeof(NmbWasmButton) == 24, "Unexpected NmbWasmButton size.");
-    static_assert(sizeof(NmbWasmInput) == 24, "Unexpected NmbWasmInput size.");
+    static_assert(sizeof(NmbWasmInput) == 36, "Unexpected NmbWasmInput size.");
     static_assert(sizeof(NmbWasmSecondary) == 16, "Unexpected NmbWasmSecondary size.");
-    static_assert(sizeof(NmbWasmRequest) == 64, "Unexpected NmbWasmRequest size.");
-    static_assert(sizeof(NmbWasmResponse) == 24, "Unexpected NmbWasmResponse size.");
+    static_assert(sizeof(NmbWasmColumn) == 8, "Unexpected NmbWasmColumn size.");
+    static_assert(sizeof(NmbWasmTable) == 16, "Unexpected NmbWasmTable size.");
+    static_assert(sizeof(NmbWasmRequest) == 76, "Unexpected NmbWasmRequest size.");
+    static_assert(sizeof(NmbWasmResponse) == 32, "Unexpected NmbWasmResponse size.");
+    static_assert(sizeof(NmbWasmFieldValue) == 12, "Unexpected NmbWasmFieldValue size.");
 
     inline uint32_t ToPtr(const void* value)
     {
@@ -86,7 +134,7 @@ namespace
             return NMB_E_INVALID_ARGUMENT;
         }
 
-        if (options->struct_size < sizeof(NmbMessageBoxOptions))
+        if (options->struct_size < kMessageBoxOptionsMinSize)
         {
             return NMB_E_INVALID_ARGUMENT;
         }
@@ -96,11 +144,6 @@ namespace
             return NMB_E_INVALID_ARGUMENT;
         }
 
-        if (!options->message_utf8)
-        {
-            return NMB_E_INVALID_ARGUMENT;
-        }
-
         if (options->button_count > 0 && !options->buttons)
         {
             return NMB_E_INVALID_ARGUMENT;
@@ -116,7 +159,7 @@ namespace
             return NMB_E_INVALID_ARGUMENT;
         }
 
-        if (result->struct_size < sizeof(NmbMessageBoxResult))
+        if (result->struct_size < kMessageBoxResultMinSize)
         {
             return NMB_E_INVALID_ARGUMENT;
         }
@@ -124,6 +167,73 @@ namespace
         return NMB_OK;
     }
 
+    // comboItems keeps the pointer table of combo_items_utf8 alive until the request has been dispatched.
+    NmbResultCode EncodeInput(const NmbInputOption& input, NmbWasmInput* wasmInput, std::vector<uint32_t>* comboItems)
+    {
+        wasmInput->mode = static_cast<uint32_t>(input.mode);
+        wasmInput->prompt_ptr = ToPtr(input.prompt_utf8);
+        wasmInput->placeholder_ptr = ToPtr(input.placeholder_utf8);
+        wasmInput->default_value_ptr = ToPtr(input.default_value_utf8);
+        wasmInput->combo_items_ptr = 0;
+        wasmInput->combo_count = 0;
+        wasmInput->default_index = kNoDefaultIndex;
+
+        const NmbItemBuffer* itemBuffer =
+            NMB_STRUCT_HAS_FIELD(&input, NmbInputOption, combo_item_buffer) ? input.combo_item_buffer : nullptr;
+        if (input.mode == NMB_INPUT_COMBO && itemBuffer)
+        {
+            // The page decodes items straight from linear memory; only the default lookup happens here.
+            wasmInput->combo_count = static_cast<uint32_t>(itemBuffer->item_count);
+            wasmInput->combo_data_ptr = ToPtr(itemBuffer->data);
+            wasmInput->combo_offsets_ptr = ToPtr(itemBuffer->offsets);
+            if (input.default_value_utf8)
+            {
+                NmbItemIndex index{};
+                NmbResultCode rc = nmb_item_index_build(&index, itemBuffer);
+                if (rc != NMB_OK)
+                {
+                    return rc;
+                }
+                const size_t item =
+                    nmb_item_index_find(&index, input.default_value_utf8, std::strlen(input.default_value_utf8));
+                nmb_item_index_release(&index);
+                if (item != NMB_ITEM_NOT_FOUND)
+                {
+                    wasmInput->default_index = static_cast<uint32_t>(item);
+                }
+            }
+        }
+        else if (input.mode == NMB_INPUT_COMBO && input.combo_items_utf8)
+        {
+            for (const char* const* items = input.combo_items_utf8; *items; ++items)
+            {
+                comboItems->push_back(ToPtr(*items));
+            }
+            wasmInput->combo_count = static_cast<uint32_t>(comboItems->size());
+            if (!comboItems->empty())
+            {
+                wasmInput->combo_items_ptr = ToPtr(comboItems->data());
+            }
+        }
+
+        return NMB_OK;
+    }
+
+    NmbResultCode CopyFieldValues(const NmbMessageBoxOptions* options, const NmbWasmResponse& response,
+                                  NmbMessageBoxResult* out_result)
+    {
+        const auto* entries = reinterpret_cast<const NmbWasmFieldValue*>(static_cast<uintptr_t>(response.fields_ptr));
+        std::vector<NmbFieldValue> answers(response.field_count);
+        for (size_t i = 0; i < answers.size(); ++i)
+        {
+            answers[i].value_utf8 = reinterpret_cast<const char*>(static_cast<uintptr_t>(entries[i].value_ptr));
+            answers[i].length = entries[i].length;
+            answers[i].checked = entries[i].checked ? NMB_TRUE : NMB_FALSE;
+        }
+
+        return nmb_store_field_values(options, answers.data(), answers.size(), out_result);
+    }
+
     void ApplyLogCallback(const NmbInitializeOptions* options)
     {
         if (options && options->log_callback)
@@ -198,6 +308,7 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
 
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
 {
+    const uint64_t received = nmb_clock_now_microseconds();
     if (!options || !out_result)
     {
         return NMB_E_INVALID_ARGUMENT;
@@ -215,12 +326,54 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return validation;
     }
 
-    out_result->struct_size = sizeof(*out_result);
-    out_result->button = NMB_BUTTON_ID_NONE;
-    out_result->checkbox_checked = NMB_FALSE;
-    out_result->input_value_utf8 = nullptr;
-    out_result->was_timeout = NMB_FALSE;
-    out_result->result_code = NMB_OK;
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_expanded_source(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    options = prepared.value.options;
+    if (!options->message_utf8)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    validation = nmb_reset_result(options, out_result);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    nmb_timing_begin(out_result, received);
+
+    // The browser runs one thread, so a request can never wait for another dialog to close.
+    if (nmb_templated_message(options))
+    {
+        return nmb_message_template_show(options, out_result, nmb_show_message_box, NMB_FALSE);
+    }
+
+    if (nmb_toast(options))
+    {
+        return nmb_toast_show_modal(options, out_result, nmb_show_message_box);
+    }
+
+    if (options->input && options->input->mode == NMB_INPUT_MULTISELECT)
+    {
+        nmb_runtime_log("Web: Multi-select inputs are not supported.");
+        out_result->result_code = NMB_E_NOT_SUPPORTED;
+        return NMB_E_NOT_SUPPORTED;
+    }
+
+    if (nmb_dialog_handle(options))
+    {
+        nmb_runtime_log("Web: Live dialog updates are not supported; the handle is ignored.");
+    }
 
     std::vector<NmbWasmButton> buttons;
     buttons.reserve(options->button_count);
@@ -245,30 +398,45 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     uint32_t inputPtr = 0;
     if (options->input)
     {
-        const NmbInputOption& input = *options->input;
-        wasmInput.mode = static_cast<uint32_t>(input.mode);
-        wasmInput.prompt_ptr = ToPtr(input.prompt_utf8);
-        wasmInput.placeholder_ptr = ToPtr(input.placeholder_utf8);
-        wasmInput.default_value_ptr = ToPtr(input.default_value_utf8);
-        wasmInput.combo_items_ptr = 0;
-        wasmInput.combo_count = 0;
+        validation = EncodeInput(*options->input, &wasmInput, &comboItems);
+        if (validation != NMB_OK)
+        {
+            return validation;
+        }
+        inputPtr = ToPtr(&wasmInput);
+    }
 
-        if (input.mode == NMB_INPUT_COMBO && input.combo_items_utf8)
+    size_t fieldCount = 0;
+    const NmbInputOption* fields = nmb_form_fields(options, &fieldCount);
+    std::vector<NmbWasmInput> wasmFields(fieldCount);
+    std::vector<std::vector<uint32_t>> fieldComboItems(fieldCount);
+    for (size_t i = 0; i < fieldCount; ++i)
+    {
+        validation = EncodeInput(fields[i], &wasmFields[i], &fieldComboItems[i]);
+        if (validation != NMB_OK)
         {
-            const char* const* items = input.combo_items_utf8;
-            while (*items)
-            {
-                comboItems.push_back(ToPtr(*items));
-                ++items;
-            }
-            wasmInput.combo_count = static_cast<uint32_t>(comboItems.size());
-            if (!comboItems.empty())
-            {
-                wasmInput.combo_items_ptr = ToPtr(comboItems.data());
-            }
+            return validation;
         }
+    }
 
-        inputPtr = ToPtr(&wasmInput);
+    std::vector<uint32_t> tableHeaders;
+    std::vector<NmbWasmColumn> tableColumns;
+    NmbWasmTable wasmTable{};
+    uint32_t tablePtr = 0;
+    if (const NmbTableOption* table = nmb_table(options))
+    {
+        tableHeaders.reserve(table->column_count);
+        tableColumns.reserve(table->column_count);
+        for (size_t c = 0; c < table->column_count; ++c)
+        {
+            tableHeaders.push_back(ToPtr(table->column_headers_utf8[c]));
+            tableColumns.push_back(NmbWasmColumn{ ToPtr(table->columns[c].data), ToPtr(table->columns[c].offsets) });
+        }
+        wasmTable.headers_ptr = ToPtr(tableHeaders.data());
+        wasmTable.columns_ptr = ToPtr(tableColumns.data());
+        wasmTable.column_count = static_cast<uint32_t>(table->column_count);
+        wasmTable.row_count = static_cast<uint32_t>(table->row_count);
+        tablePtr = ToPtr(&wasmTable);
     }
 
     NmbWasmSecondary wasmSecondary{};
@@ -299,9 +467,13 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     request.locale_ptr = ToPtr(options->locale_utf8);
     request.input_ptr = inputPtr;
     request.secondary_ptr = secondaryPtr;
+    request.form_fields_ptr = wasmFields.empty() ? 0u : ToPtr(wasmFields.data());
+    request.form_field_count = static_cast<uint32_t>(wasmFields.size());
+    request.table_ptr = tablePtr;
 
     NmbWasmResponse response{};
     int dispatch_rc = nmb_wasm_dispatch_message_box(ToPtr(&request), ToPtr(&response));
+    nmb_timing_finish(out_result, NMB_BACKEND_WEB);
     if (dispatch_rc != 0)
     {
         out_result->result_code = NMB_E_PLATFORM_FAILURE;
@@ -316,7 +488,7 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     if (response.input_ptr != 0)
     {
         const char* input_utf8 = reinterpret_cast<const char*>(static_cast<uintptr_t>(response.input_ptr));
-        NmbResultCode copy_rc = nmb_copy_string_to_allocator(options->allocator, input_utf8, &out_result->input_value_utf8);
+        NmbResultCode copy_rc = nmb_deliver_input_text(options, input_utf8, response.input_length, out_result);
         std::free(reinterpret_cast<void*>(static_cast<uintptr_t>(response.input_ptr)));
         if (copy_rc != NMB_OK)
         {
@@ -325,9 +497,76 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         }
     }
 
+    if (response.fields_ptr != 0)
+    {
+        NmbResultCode copy_rc = CopyFieldValues(options, response, out_result);
+        std::free(reinterpret_cast<void*>(static_cast<uintptr_t>(response.fields_ptr)));
+        if (copy_rc != NMB_OK)
+        {
+            out_result->result_code = copy_rc;
+            return copy_rc;
+        }
+    }
+
     return out_result->result_code;
 }
 
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void*,
+                                                               NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request)
+{
+    return nmb_request_submit(options, out_result, out_request, nmb_show_message_box_async);
+}
+
+NMB_API int NMB_CALL nmb_get_event_fd(void)
+{
+    return nmb_event_fd();
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t)
+{
+    nmb_event_fd_drain();
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options, NmbProgressHandle** out_handle)
+{
+    if (!options || !out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    *out_handle = nullptr;
+    nmb_runtime_log("Web: Progress dialogs are not supported.");
+    return NMB_E_NOT_SUPPORTED;
+}
+
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle*, double, const char*)
+{
+}
+
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle*)
+{
+    return NMB_FALSE;
+}
+
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle*)
+{
+}
+
 NMB_API void NMB_CALL nmb_shutdown(void)
 {
     nmb_runtime_reset_log();
@@ -12,9 +12,18 @@
 #include <vector>
 #include <cstddef>
 #include <cctype>
+#include <cstring>
 
+#include "../../shared/nmb_aggregate.h"
 #include "../../shared/nmb_alloc.h"
+#include "../../shared/nmb_async.h"
+#include "../../shared/nmb_clock.h"
+#include "../../shared/nmb_message_template.h"
+#include "../../shared/nmb_options.h"
+#include "../../shared/nmb_request.h"
 #include "../../shared/nmb_runtime.h"
+#include "../../shared/nmb_timing.h"
+#include "../../shared/nmb_toast.h"
 #if defined(NMB_TESTING)
 #include "native_message_box_test.h"
 #endif
@@ -53,8 +62,25 @@ namespace
         out_result->was_timeout = harness->simulate_timeout;
         out_result->result_code = harness->result_code;
 
+        const uint32_t timeout = options->timeout_button_id != NMB_BUTTON_ID_NONE ? options->timeout_milliseconds : 0;
+        if (nmb_clock_play_scripted_answer(timeout, harness->answer_after_milliseconds))
+        {
+            out_result->button = options->timeout_button_id;
+            out_result->was_timeout = NMB_TRUE;
+        }
+        nmb_timing_finish(out_result, NMB_BACKEND_HEADLESS);
+
         out_result->input_value_utf8 = nullptr;
-        if (harness->input_value_utf8)
+        if (harness->input_value_utf8 && nmb_input_chunk_callback(options->input))
+        {
+            NmbResultCode rc = nmb_deliver_input_text(options, harness->input_value_utf8,
+                                                      std::strlen(harness->input_value_utf8), out_result);
+            if (rc != NMB_OK)
+            {
+                out_result->result_code = rc;
+            }
+        }
+        else if (harness->input_value_utf8)
         {
             if (options->allocator)
             {
@@ -70,6 +96,15 @@ namespace
             }
         }
 
+        NmbResultCode fields_rc =
+            nmb_store_field_values(options, harness->field_values, harness->field_value_count, out_result);
+        if (fields_rc != NMB_OK)
+        {
+            out_result->result_code = fields_rc;
+        }
+
+        nmb_store_selection(options, harness->selection_bits, out_result);
+
         return true;
     }
 #endif
@@ -309,9 +344,11 @@ namespace
     struct TaskDialogState
     {
         const NmbMessageBoxOptions* options;
+        NmbMessageBoxResult* result;
         const NmbSecondaryContentOption* secondary;
         std::wstring help_link;
         DWORD timeout_ms;
+        uint64_t deadline; /* on the runtime clock */
         NmbButtonId timeout_button;
         bool timed_out;
     };
@@ -353,6 +390,45 @@ namespace
         return wide;
     }
 
+    // Reads text straight from the caller's UTF-16 views when present so UTF-16 hosts skip the
+    // UTF-8 round trip; falls back to converting the resolved UTF-8 field. nmb_prepare_options_utf16
+    // leaves the UTF-8 field of such a view NULL, so presence checks go through Has.
+    struct WideStrings
+    {
+        const NmbMessageBoxStrings16* strings;
+
+        bool Has(NmbStringView16 NmbMessageBoxStrings16::*field, const char* fallback) const
+        {
+            return (strings && (strings->*field).data) || fallback;
+        }
+
+        std::wstring Text(NmbStringView16 NmbMessageBoxStrings16::*field, const char* fallback) const
+        {
+            if (strings && (strings->*field).data)
+            {
+                return FromView(strings->*field);
+            }
+
+            return Utf8ToWide(fallback);
+        }
+
+        std::wstring ButtonLabel(size_t index, const char* fallback) const
+        {
+            if (strings && strings->button_labels && strings->button_labels[index].data)
+            {
+                return FromView(strings->button_labels[index]);
+            }
+
+            return Utf8ToWide(fallback);
+        }
+
+        static std::wstring FromView(const NmbStringView16& view)
+        {
+            static_assert(sizeof(wchar_t) == sizeof(uint16_t), "Windows wchar_t is expected to be UTF-16.");
+            return std::wstring(reinterpret_cast<const wchar_t*>(view.data), view.length);
+        }
+    };
+
     PCWSTR MapIconResource(NmbIcon icon)
     {
         switch (icon)
@@ -520,7 +596,7 @@ namespace
         }
     }
 
-    HRESULT CALLBACK TaskDialogCallbackProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM /*lParam*/, LONG_PTR refData)
+    HRESULT CALLBACK TaskDialogCallbackProc(HWND hwnd, UINT msg, WPARAM /*wParam*/, LPARAM /*lParam*/, LONG_PTR refData)
     {
         auto* state = reinterpret_cast<TaskDialogState*>(refData);
         if (!state)
@@ -530,6 +606,10 @@ namespace
 
         switch (msg)
         {
+        case TDN_CREATED:
+            // Sent once the window exists, before it is shown; the task dialog reports nothing later than that.
+            nmb_timing_mark(state->result, NMB_TIMING_BUILT);
+            return S_OK;
         case TDN_HYPERLINK_CLICKED:
             if (!state->help_link.empty())
             {
@@ -539,8 +619,8 @@ namespace
         case TDN_TIMER:
             if (state->timeout_ms > 0 && state->timeout_button != NMB_BUTTON_ID_NONE)
             {
-                DWORD elapsed = static_cast<DWORD>(wParam);
-                if (elapsed >= state->timeout_ms && !state->timed_out)
+                // TDN_TIMER only polls; elapsed time is read from the runtime clock so tests can drive it.
+                if (nmb_clock_now_milliseconds() >= state->deadline && !state->timed_out)
                 {
                     state->timed_out = true;
                     SendMessageW(hwnd, TDM_CLICK_BUTTON, static_cast<WPARAM>(state->timeout_button), 0);
@@ -552,7 +632,7 @@ namespace
         }
     }
 
-    bool RequiresTaskDialog(const NmbMessageBoxOptions* options)
+    bool RequiresTaskDialog(const NmbMessageBoxOptions* options, const WideStrings& wide)
     {
         if (!options)
         {
@@ -569,7 +649,8 @@ namespace
             return true;
         }
 
-        if (options->verification_text_utf8 || options->secondary || options->allow_cancel_via_escape == NMB_FALSE ||
+        if (wide.Has(&NmbMessageBoxStrings16::verification_text, options->verification_text_utf8) ||
+            options->secondary || options->allow_cancel_via_escape == NMB_FALSE ||
             options->show_suppress_checkbox == NMB_TRUE || options->timeout_milliseconds > 0 || options->icon == NMB_ICON_SHIELD)
         {
             return true;
@@ -583,7 +664,7 @@ namespace
         return false;
     }
 
-    NmbResultCode ShowTaskDialog(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    NmbResultCode ShowTaskDialog(const NmbMessageBoxOptions* options, const WideStrings& wide, NmbMessageBoxResult* out_result)
     {
         TaskDialogIndirectFn taskDialog = LoadTaskDialog();
         if (!taskDialog)
@@ -596,63 +677,70 @@ namespace
         icc.dwICC = ICC_STANDARD_CLASSES;
         InitCommonControlsEx(&icc);
 
-        std::wstring title = Utf8ToWide(options->title_utf8);
-        std::wstring message = Utf8ToWide(options->message_utf8);
+        std::wstring title = wide.Text(&NmbMessageBoxStrings16::title, options->title_utf8);
+        std::wstring message = wide.Text(&NmbMessageBoxStrings16::message, options->message_utf8);
         std::wstring informative;
         std::wstring footer;
         std::wstring verification;
 
         if (options->secondary)
         {
-            if (options->secondary->informative_text_utf8)
+            if (wide.Has(&NmbMessageBoxStrings16::informative_text, options->secondary->informative_text_utf8))
             {
-                informative = Utf8ToWide(options->secondary->informative_text_utf8);
+                informative = wide.Text(&NmbMessageBoxStrings16::informative_text, options->secondary->informative_text_utf8);
             }
 
-            if (options->secondary->footer_text_utf8)
+            if (wide.Has(&NmbMessageBoxStrings16::footer_text, options->secondary->footer_text_utf8))
             {
-                footer = Utf8ToWide(options->secondary->footer_text_utf8);
+                footer = wide.Text(&NmbMessageBoxStrings16::footer_text, options->secondary->footer_text_utf8);
             }
         }
 
-        if (options->verification_text_utf8)
+        if (wide.Has(&NmbMessageBoxStrings16::verification_text, options->verification_text_utf8))
         {
             if (options->show_suppress_checkbox == NMB_TRUE)
             {
-                verification = Utf8ToWide(options->verification_text_utf8);
+                verification = wide.Text(&NmbMessageBoxStrings16::verification_text, options->verification_text_utf8);
             }
             else
             {
                 nmb_runtime_log("Windows: Verification text provided but show_suppress_checkbox is false; suppressing checkbox.");
             }
         }
-        else if (options->input && options->input->mode == NMB_INPUT_CHECKBOX && options->input->prompt_utf8)
+        else if (options->input && options->input->mode == NMB_INPUT_CHECKBOX &&
+                 wide.Has(&NmbMessageBoxStrings16::input_prompt, options->input->prompt_utf8))
         {
-            verification = Utf8ToWide(options->input->prompt_utf8);
+            verification = wide.Text(&NmbMessageBoxStrings16::input_prompt, options->input->prompt_utf8);
         }
 
         TaskDialogState state = {};
         state.options = options;
+        state.result = out_result;
         state.secondary = options->secondary;
         state.timeout_ms = options->timeout_milliseconds;
+        state.deadline = nmb_clock_now_milliseconds() + options->timeout_milliseconds;
         state.timeout_button = options->timeout_button_id;
         state.timed_out = false;
 
+        const bool hasInformative = options->secondary &&
+                                    wide.Has(&NmbMessageBoxStrings16::informative_text, options->secondary->informative_text_utf8);
+        const bool hasExpanded = options->secondary &&
+                                 wide.Has(&NmbMessageBoxStrings16::expanded_text, options->secondary->expanded_text_utf8);
         std::wstring expanded;
-        if (options->secondary && options->secondary->expanded_text_utf8)
+        if (hasExpanded)
         {
-            expanded = Utf8ToWide(options->secondary->expanded_text_utf8);
+            expanded = wide.Text(&NmbMessageBoxStrings16::expanded_text, options->secondary->expanded_text_utf8);
         }
 
         std::wstring expanded_control_text = L"More details";
-        if (options->secondary && options->secondary->informative_text_utf8 && options->secondary->expanded_text_utf8)
+        if (hasInformative && hasExpanded)
         {
             expanded_control_text = L"Details";
         }
 
-        if (options->secondary && options->secondary->help_link_utf8)
+        if (options->secondary && wide.Has(&NmbMessageBoxStrings16::help_link, options->secondary->help_link_utf8))
         {
-            state.help_link = Utf8ToWide(options->secondary->help_link_utf8);
+            state.help_link = wide.Text(&NmbMessageBoxStrings16::help_link, options->secondary->help_link_utf8);
             if (!footer.empty())
             {
                 footer.append(L"\n");
@@ -671,7 +759,7 @@ namespace
         for (size_t i = 0; i < options->button_count; ++i)
         {
             const NmbButtonOption& opt = options->buttons[i];
-            std::wstring label = Utf8ToWide(opt.label_utf8);
+            std::wstring label = wide.ButtonLabel(i, opt.label_utf8);
             buttonTexts.push_back(label);
 
             TASKDIALOG_BUTTON btn = {};
@@ -735,6 +823,7 @@ namespace
         {
             return NMB_E_PLATFORM_FAILURE;
         }
+        nmb_timing_finish(out_result, NMB_BACKEND_WIN32);
 
         out_result->button = static_cast<NmbButtonId>(buttonPressed);
         out_result->checkbox_checked = verificationChecked ? NMB_TRUE : NMB_FALSE;
@@ -744,10 +833,10 @@ namespace
         return NMB_OK;
     }
 
-    NmbResultCode ShowMessageBoxSimple(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
+    NmbResultCode ShowMessageBoxSimple(const NmbMessageBoxOptions* options, const WideStrings& wide, NmbMessageBoxResult* out_result)
     {
-        std::wstring title = Utf8ToWide(options->title_utf8);
-        std::wstring message = Utf8ToWide(options->message_utf8);
+        std::wstring title = wide.Text(&NmbMessageBoxStrings16::title, options->title_utf8);
+        std::wstring message = wide.Text(&NmbMessageBoxStrings16::message, options->message_utf8);
 
         NmbButtonId defaultButton = NMB_BUTTON_ID_NONE;
         UINT flags = ComposeButtonFlags(options, &defaultButton) | MapMessageBoxIcon(options->icon);
@@ -788,6 +877,7 @@ namespace
 
         HWND parent = reinterpret_cast<HWND>(const_cast<void*>(options->parent_window));
         int response = MessageBoxW(parent, message.c_str(), title.empty() ? nullptr : title.c_str(), flags);
+        nmb_timing_finish(out_result, NMB_BACKEND_WIN32);
         if (response == 0)
         {
             DWORD error = GetLastError();
@@ -833,7 +923,8 @@ NMB_API NmbResultCode NMB_CALL nmb_initialize(const NmbInitializeOptions* option
 
 NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result)
 {
-    if (!options || !options->message_utf8 || !out_result)
+    const uint64_t received = nmb_clock_now_microseconds();
+    if (!options || !out_result)
     {
         return NMB_E_INVALID_ARGUMENT;
     }
@@ -850,14 +941,58 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return validation;
     }
 
+    NmbPreparedOptionsScope prepared;
+    validation = nmb_prepare_options_utf16(options, &prepared.value);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_expanded_source(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    validation = nmb_inline_table(&prepared.value, NMB_EXPANDED_SOURCE_INLINE_LIMIT);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+
+    options = prepared.value.options;
+    const WideStrings wide = {prepared.value.strings_utf16};
+    if (!wide.Has(&NmbMessageBoxStrings16::message, options->message_utf8))
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
     const bool buttonsSupportedByFallback = ButtonsSupportedByMessageBox(options);
 
-    out_result->struct_size = sizeof(*out_result);
-    out_result->button = NMB_BUTTON_ID_NONE;
-    out_result->checkbox_checked = NMB_FALSE;
-    out_result->input_value_utf8 = nullptr;
-    out_result->was_timeout = NMB_FALSE;
-    out_result->result_code = NMB_OK;
+    validation = nmb_reset_result(options, out_result);
+    if (validation != NMB_OK)
+    {
+        return validation;
+    }
+    nmb_timing_begin(out_result, received);
+
+    // A thread with windows pumps messages, possibly inside the very dialog it would join, so only threads
+    // without a message loop coalesce.
+    if (nmb_templated_message(options))
+    {
+        const nmb_bool may_wait = IsGUIThread(FALSE) ? NMB_FALSE : NMB_TRUE;
+        return nmb_message_template_show(options, out_result, nmb_show_message_box, may_wait);
+    }
+
+    if (nmb_aggregation(options))
+    {
+        return nmb_aggregate_show(options, out_result, nmb_show_message_box);
+    }
+
+    if (nmb_toast(options))
+    {
+        return nmb_toast_show_modal(options, out_result, nmb_show_message_box);
+    }
 
 #if defined(NMB_TESTING)
     if (ApplyTestHarness(options, out_result))
@@ -866,6 +1001,14 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
     }
 #endif
 
+    size_t fieldCount = 0;
+    if (nmb_form_fields(options, &fieldCount))
+    {
+        nmb_runtime_log("Windows: Form dialogs are not supported.");
+        out_result->result_code = NMB_E_NOT_SUPPORTED;
+        return NMB_E_NOT_SUPPORTED;
+    }
+
     if (options->input && options->input->mode != NMB_INPUT_CHECKBOX)
     {
         nmb_runtime_log("Windows: Input mode not supported in simple MessageBox fallback.");
@@ -873,9 +1016,14 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         return NMB_E_NOT_SUPPORTED;
     }
 
-    if (RequiresTaskDialog(options))
+    if (nmb_dialog_handle(options))
+    {
+        nmb_runtime_log("Windows: Live dialog updates are not supported; the handle is ignored.");
+    }
+
+    if (RequiresTaskDialog(options, wide))
     {
-        NmbResultCode rc = ShowTaskDialog(options, out_result);
+        NmbResultCode rc = ShowTaskDialog(options, wide, out_result);
         if (rc == NMB_OK)
         {
             return rc;
@@ -896,7 +1044,63 @@ NMB_API NmbResultCode NMB_CALL nmb_show_message_box(const NmbMessageBoxOptions*
         nmb_runtime_log("Windows: TaskDialogIndirect unavailable, falling back to MessageBox.");
     }
 
-    return ShowMessageBoxSimple(options, out_result);
+    return ShowMessageBoxSimple(options, wide, out_result);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_async(const NmbMessageBoxOptions* options,
+                                                          NmbMessageBoxResult* out_result,
+                                                          NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_show_message_box_in_context(const NmbMessageBoxOptions* options,
+                                                               NmbMessageBoxResult* out_result, void*,
+                                                               NmbMessageBoxCallback callback, void* user_data)
+{
+    return nmb_show_blocking_async(options, out_result, callback, user_data, nmb_show_message_box);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_submit_message_box(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result, NmbRequest** out_request)
+{
+    return nmb_request_submit(options, out_result, out_request, nmb_show_message_box_async);
+}
+
+NMB_API int NMB_CALL nmb_get_event_fd(void)
+{
+    return nmb_event_fd();
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_pump(uint32_t)
+{
+    nmb_event_fd_drain();
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_progress_begin(const NmbMessageBoxOptions* options, NmbProgressHandle** out_handle)
+{
+    if (!options || !out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    *out_handle = nullptr;
+    nmb_runtime_log("Windows: Progress dialogs are not supported.");
+    return NMB_E_NOT_SUPPORTED;
+}
+
+NMB_API void NMB_CALL nmb_progress_update(NmbProgressHandle*, double, const char*)
+{
+}
+
+NMB_API nmb_bool NMB_CALL nmb_progress_is_cancelled(const NmbProgressHandle*)
+{
+    return NMB_FALSE;
+}
+
+NMB_API void NMB_CALL nmb_progress_end(NmbProgressHandle*)
+{
 }
 
 NMB_API void NMB_CALL nmb_shutdown(void)
@@ -0,0 +1,232 @@
+#include "nmb_aggregate.h"
+#include "nmb_alloc.h"
+#include "nmb_clock.h"
+#include "nmb_options.h"
+#include "nmb_runtime.h"
+#include "nmb_thread.h"
+#include "nmb_timing.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* One request of a burst. Members live on their callers' stacks, which stay blocked until the burst is done. */
+typedef struct NmbBurstMember_t
+{
+    const char* message;
+    const char* detail;
+    struct NmbBurstMember_t* next;
+} NmbBurstMember;
+
+/* Lives on the stack of the request that opened it; that caller waits for every member to read the result. */
+typedef struct NmbBurst_t
+{
+    const char* category;
+    NmbBurstMember* first;
+    NmbBurstMember** tail;
+    size_t count;
+    nmb_bool has_detail;
+    nmb_bool done;
+    size_t readers; /* joined callers that have not copied the result yet */
+    NmbResultCode rc;
+    NmbButtonId button;
+    nmb_bool checkbox_checked;
+    nmb_bool was_timeout;
+    NmbDialogTiming timing;
+    struct NmbBurst_t* next;
+} NmbBurst;
+
+static NmbBurst* s_open_bursts = NULL;
+
+static NmbMutex s_lock = NMB_MUTEX_INIT;
+static NmbCondition s_changed = NMB_CONDITION_INIT;
+
+static NmbBurst* nmb_find_open_burst(const char* category)
+{
+    for (NmbBurst* burst = s_open_bursts; burst; burst = burst->next)
+    {
+        if (strcmp(burst->category, category) == 0)
+        {
+            return burst;
+        }
+    }
+    return NULL;
+}
+
+static void nmb_close_burst(NmbBurst* burst)
+{
+    for (NmbBurst** link = &s_open_bursts; *link; link = &(*link)->next)
+    {
+        if (*link == burst)
+        {
+            *link = burst->next;
+            return;
+        }
+    }
+}
+
+static void nmb_add_member(NmbBurst* burst, NmbBurstMember* member)
+{
+    *burst->tail = member;
+    burst->tail = &member->next;
+    ++burst->count;
+    if (member->detail)
+    {
+        burst->has_detail = NMB_TRUE;
+    }
+}
+
+/* Fills column with one cell per member, taken from message or detail, in arrival order. */
+static char* nmb_put_column(const NmbBurst* burst, nmb_bool detail, char* data, uint32_t* offsets,
+                            NmbItemBuffer* column)
+{
+    char* cursor = data;
+    size_t row = 0;
+    for (const NmbBurstMember* member = burst->first; member; member = member->next, ++row)
+    {
+        const char* text = detail ? member->detail : member->message;
+        const size_t length = text ? strlen(text) : 0;
+        offsets[row] = (uint32_t)(cursor - data);
+        memcpy(cursor, text ? text : "", length);
+        cursor += length;
+    }
+    offsets[row] = (uint32_t)(cursor - data);
+
+    column->struct_size = sizeof(*column);
+    column->data = data;
+    column->offsets = offsets;
+    column->item_count = burst->count;
+    return cursor;
+}
+
+/* Shows the burst as options with every member listed in a Message (and Detail) table. */
+static NmbResultCode nmb_show_burst(const NmbMessageBoxOptions* options, const NmbBurst* burst,
+                                    NmbMessageBoxResult* out_result, NmbShowFunction show)
+{
+    NmbMessageBoxOptions merged;
+    memset(&merged, 0, sizeof(merged));
+    memcpy(&merged, options, options->struct_size < sizeof(merged) ? options->struct_size : sizeof(merged));
+    merged.struct_size = sizeof(merged);
+    merged.aggregation = NULL;
+    if (burst->count == 1 && !burst->has_detail)
+    {
+        return nmb_timing_reenter(show, &merged, out_result);
+    }
+
+    size_t text_bytes = 0;
+    for (const NmbBurstMember* member = burst->first; member; member = member->next)
+    {
+        text_bytes += strlen(member->message) + (member->detail ? strlen(member->detail) : 0);
+    }
+    if (text_bytes > UINT32_MAX)
+    {
+        nmb_runtime_log("Runtime: an aggregated burst holds more text than a table column can address.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const size_t column_count = burst->has_detail ? 2 : 1;
+    const size_t offset_bytes = column_count * (burst->count + 1) * sizeof(uint32_t);
+    uint32_t* offsets = (uint32_t*)nmb_default_alloc(offset_bytes + text_bytes + 1);
+    if (!offsets)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    NmbItemBuffer columns[2];
+    char* data = (char*)(offsets + column_count * (burst->count + 1));
+    char* detail_data = nmb_put_column(burst, NMB_FALSE, data, offsets, &columns[0]);
+    if (burst->has_detail)
+    {
+        nmb_put_column(burst, NMB_TRUE, detail_data, offsets + burst->count + 1, &columns[1]);
+    }
+
+    static const char* const kHeaders[] = { "Message", "Detail" };
+    NmbTableOption table;
+    memset(&table, 0, sizeof(table));
+    table.struct_size = sizeof(table);
+    table.column_headers_utf8 = kHeaders;
+    table.columns = columns;
+    table.column_count = column_count;
+    table.row_count = burst->count;
+    merged.table = &table;
+
+    const char* summary = nmb_aggregation(options)->summary_utf8;
+    if (burst->count > 1 && summary)
+    {
+        merged.message_utf8 = summary;
+    }
+
+    NmbResultCode rc = nmb_timing_reenter(show, &merged, out_result);
+    nmb_default_free(offsets);
+    return rc;
+}
+
+NmbResultCode nmb_aggregate_show(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                 NmbShowFunction show)
+{
+    const NmbAggregationOption* aggregation = nmb_aggregation(options);
+    NmbBurstMember self;
+    self.message = options->message_utf8;
+    self.detail = aggregation->detail_utf8;
+    self.next = NULL;
+
+    nmb_mutex_lock(&s_lock);
+    NmbBurst* joined = nmb_find_open_burst(aggregation->category_utf8);
+    if (joined)
+    {
+        nmb_add_member(joined, &self);
+        ++joined->readers;
+        while (!joined->done)
+        {
+            nmb_condition_wait(&s_changed, &s_lock);
+        }
+
+        out_result->button = joined->button;
+        out_result->checkbox_checked = joined->checkbox_checked;
+        out_result->was_timeout = joined->was_timeout;
+        out_result->result_code = joined->rc;
+        nmb_timing_load(out_result, &joined->timing);
+        const NmbResultCode rc = joined->rc;
+        if (--joined->readers == 0)
+        {
+            nmb_condition_broadcast(&s_changed);
+        }
+        nmb_mutex_unlock(&s_lock);
+        return rc;
+    }
+
+    NmbBurst burst;
+    memset(&burst, 0, sizeof(burst));
+    burst.category = aggregation->category_utf8;
+    burst.tail = &burst.first;
+    nmb_add_member(&burst, &self);
+    burst.next = s_open_bursts;
+    s_open_bursts = &burst;
+    nmb_mutex_unlock(&s_lock);
+
+    if (aggregation->window_milliseconds > 0)
+    {
+        nmb_clock_wait_milliseconds(aggregation->window_milliseconds);
+    }
+
+    /* Once closed, later requests of the category open a new burst, so the member list below is final. */
+    nmb_mutex_lock(&s_lock);
+    nmb_close_burst(&burst);
+    nmb_mutex_unlock(&s_lock);
+
+    const NmbResultCode rc = nmb_show_burst(options, &burst, out_result, show);
+
+    nmb_mutex_lock(&s_lock);
+    burst.rc = rc;
+    burst.button = out_result->button;
+    burst.checkbox_checked = out_result->checkbox_checked;
+    burst.was_timeout = out_result->was_timeout;
+    nmb_timing_save(out_result, &burst.timing);
+    burst.done = NMB_TRUE;
+    nmb_condition_broadcast(&s_changed);
+    while (burst.readers > 0)
+    {
+        nmb_condition_wait(&s_changed, &s_lock);
+    }
+    nmb_mutex_unlock(&s_lock);
+    return rc;
+}
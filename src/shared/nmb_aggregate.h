@@ -0,0 +1,23 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A backend's own entry point, re-entered with the merged request of a burst. */
+typedef NmbResultCode(NMB_CALL* NmbShowFunction)(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result);
+
+/**
+ * Runs a request that carries an NmbAggregationOption. The first request of a category opens a burst, waits
+ * window_milliseconds for others to join, then shows one dialog through show listing every message of the
+ * burst; the others block without touching the UI. Every caller receives the dialog's button, checkbox state,
+ * timeout flag and result code. options must already be prepared, and out_result reset.
+ */
+NmbResultCode nmb_aggregate_show(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                 NmbShowFunction show);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+#include "nmb_arena.h"
+#include "nmb_alloc.h"
+
+#include <string.h>
+
+#define NMB_ARENA_MIN_BLOCK_SIZE 4096u
+
+struct NmbArenaBlock_t
+{
+    NmbArenaBlock* next;
+    size_t capacity;
+    size_t used;
+};
+
+static size_t nmb_arena_header_size(void)
+{
+    const size_t align = sizeof(void*) * 2;
+    return (sizeof(NmbArenaBlock) + align - 1) & ~(align - 1);
+}
+
+static const NmbAllocator* nmb_arena_allocator(const NmbArena* arena)
+{
+    return arena->has_allocator ? &arena->allocator : NULL;
+}
+
+static NmbArenaBlock* nmb_arena_push_block(NmbArena* arena, size_t minimum)
+{
+    size_t capacity = minimum < NMB_ARENA_MIN_BLOCK_SIZE ? NMB_ARENA_MIN_BLOCK_SIZE : minimum;
+    size_t header = nmb_arena_header_size();
+    if (capacity > (size_t)-1 - header)
+    {
+        return NULL;
+    }
+
+    NmbArenaBlock* block = (NmbArenaBlock*)nmb_allocate(nmb_arena_allocator(arena), header + capacity, sizeof(void*) * 2);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    block->next = arena->head;
+    block->capacity = capacity;
+    block->used = 0;
+    arena->head = block;
+    return block;
+}
+
+void nmb_arena_init(NmbArena* arena, const NmbAllocator* allocator)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    arena->head = NULL;
+    arena->has_allocator = (allocator && allocator->allocate && allocator->deallocate) ? NMB_TRUE : NMB_FALSE;
+    if (arena->has_allocator)
+    {
+        arena->allocator = *allocator;
+    }
+    else
+    {
+        memset(&arena->allocator, 0, sizeof(arena->allocator));
+    }
+}
+
+void* nmb_arena_alloc(NmbArena* arena, size_t size, size_t alignment)
+{
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    if (alignment == 0)
+    {
+        alignment = 1;
+    }
+
+    NmbArenaBlock* block = arena->head;
+    if (block)
+    {
+        size_t offset = (block->used + alignment - 1) & ~(alignment - 1);
+        if (offset <= block->capacity && size <= block->capacity - offset)
+        {
+            block->used = offset + size;
+            return (unsigned char*)block + nmb_arena_header_size() + offset;
+        }
+    }
+
+    if (size > (size_t)-1 - alignment)
+    {
+        return NULL;
+    }
+
+    block = nmb_arena_push_block(arena, size + alignment);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    block->used = size;
+    return (unsigned char*)block + nmb_arena_header_size();
+}
+
+NmbResultCode nmb_arena_reserve(NmbArena* arena, size_t size)
+{
+    if (!arena)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    if (arena->head && arena->head->capacity - arena->head->used >= size)
+    {
+        return NMB_OK;
+    }
+
+    return nmb_arena_push_block(arena, size) ? NMB_OK : NMB_E_OUT_OF_MEMORY;
+}
+
+char* nmb_arena_copy_string(NmbArena* arena, const char* data, size_t length)
+{
+    if (length == (size_t)-1)
+    {
+        return NULL;
+    }
+
+    char* buffer = (char*)nmb_arena_alloc(arena, length + 1, sizeof(char));
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    if (length > 0)
+    {
+        memcpy(buffer, data, length);
+    }
+    buffer[length] = '\0';
+    return buffer;
+}
+
+void nmb_arena_release(NmbArena* arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    NmbArenaBlock* block = arena->head;
+    while (block)
+    {
+        NmbArenaBlock* next = block->next;
+        nmb_deallocate(nmb_arena_allocator(arena), block);
+        block = next;
+    }
+
+    arena->head = NULL;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct NmbArenaBlock_t NmbArenaBlock;
+
+/**
+ * Bump allocator for per-call scratch memory. Everything allocated from an arena is released
+ * together by nmb_arena_release; individual allocations are never freed.
+ */
+typedef struct NmbArena_t
+{
+    NmbArenaBlock* head;
+    NmbAllocator allocator;
+    nmb_bool has_allocator;
+} NmbArena;
+
+void nmb_arena_init(NmbArena* arena, const NmbAllocator* allocator);
+void* nmb_arena_alloc(NmbArena* arena, size_t size, size_t alignment);
+/** Reserves at least size bytes in a single block so that subsequent allocations up to that total do not chain. */
+NmbResultCode nmb_arena_reserve(NmbArena* arena, size_t size);
+/** Copies length bytes and appends a NUL terminator. */
+char* nmb_arena_copy_string(NmbArena* arena, const char* data, size_t length);
+void nmb_arena_release(NmbArena* arena);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#include "nmb_async.h"
+#include "nmb_runtime.h"
+
+NmbResultCode nmb_show_blocking_async(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                      NmbMessageBoxCallback callback, void* user_data, NmbShowFunction show)
+{
+    if (!options || !out_result || !callback)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const NmbResultCode rc = show(options, out_result);
+    if (NMB_STRUCT_HAS_FIELD(out_result, NmbMessageBoxResult, result_code))
+    {
+        out_result->result_code = rc;
+    }
+    callback(user_data, out_result);
+    return NMB_OK;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_aggregate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * For backends or requests that cannot be shown without blocking: runs show to completion, stores its result
+ * code in out_result and hands the result to callback before returning NMB_OK.
+ */
+NmbResultCode nmb_show_blocking_async(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                      NmbMessageBoxCallback callback, void* user_data, NmbShowFunction show);
+
+#ifdef __cplusplus
+}
+#endif
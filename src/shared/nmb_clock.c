@@ -0,0 +1,160 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "nmb_clock.h"
+#include "nmb_thread.h"
+
+#if defined(NMB_TESTING)
+#include "native_message_box_test.h"
+#endif
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+static NmbMutex s_lock = NMB_MUTEX_INIT;
+static NmbCondition s_advanced = NMB_CONDITION_INIT;
+static nmb_bool s_virtual = NMB_FALSE;
+static uint64_t s_virtual_now = 0;
+static NmbClockWake s_wake = NULL;
+
+static uint64_t nmb_system_milliseconds(void)
+{
+#if defined(_WIN32)
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u;
+#endif
+}
+
+uint64_t nmb_clock_now_milliseconds(void)
+{
+    nmb_mutex_lock(&s_lock);
+    const nmb_bool is_virtual = s_virtual;
+    const uint64_t now = s_virtual_now;
+    nmb_mutex_unlock(&s_lock);
+    return is_virtual ? now : nmb_system_milliseconds();
+}
+
+static uint64_t nmb_system_microseconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+    const uint64_t per_second = (uint64_t)frequency.QuadPart;
+    return ticks / per_second * 1000000u + ticks % per_second * 1000000u / per_second;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+#endif
+}
+
+uint64_t nmb_clock_now_microseconds(void)
+{
+    nmb_mutex_lock(&s_lock);
+    const nmb_bool is_virtual = s_virtual;
+    const uint64_t now = s_virtual_now;
+    nmb_mutex_unlock(&s_lock);
+    return is_virtual ? now * 1000u : nmb_system_microseconds();
+}
+
+nmb_bool nmb_clock_is_virtual(void)
+{
+    nmb_mutex_lock(&s_lock);
+    const nmb_bool is_virtual = s_virtual;
+    nmb_mutex_unlock(&s_lock);
+    return is_virtual;
+}
+
+void nmb_clock_wait_milliseconds(uint32_t milliseconds)
+{
+    nmb_mutex_lock(&s_lock);
+    if (!s_virtual)
+    {
+        nmb_mutex_unlock(&s_lock);
+        nmb_sleep_milliseconds(milliseconds);
+        return;
+    }
+
+    const uint64_t deadline = s_virtual_now + milliseconds;
+    while (s_virtual && s_virtual_now < deadline)
+    {
+        nmb_condition_wait(&s_advanced, &s_lock);
+    }
+    nmb_mutex_unlock(&s_lock);
+}
+
+void nmb_clock_advance(uint64_t milliseconds)
+{
+    nmb_mutex_lock(&s_lock);
+    if (!s_virtual)
+    {
+        s_virtual_now = nmb_system_milliseconds();
+        s_virtual = NMB_TRUE;
+    }
+    s_virtual_now += milliseconds;
+    const NmbClockWake wake = s_wake;
+    nmb_condition_broadcast(&s_advanced);
+    nmb_mutex_unlock(&s_lock);
+
+    if (wake)
+    {
+        wake();
+    }
+}
+
+void nmb_clock_use_system(void)
+{
+    nmb_mutex_lock(&s_lock);
+    s_virtual = NMB_FALSE;
+    const NmbClockWake wake = s_wake;
+    nmb_condition_broadcast(&s_advanced);
+    nmb_mutex_unlock(&s_lock);
+
+    if (wake)
+    {
+        wake();
+    }
+}
+
+void nmb_clock_set_wake(NmbClockWake wake)
+{
+    nmb_mutex_lock(&s_lock);
+    s_wake = wake;
+    nmb_mutex_unlock(&s_lock);
+}
+
+nmb_bool nmb_clock_play_scripted_answer(uint32_t timeout_milliseconds, uint32_t answer_milliseconds)
+{
+    const nmb_bool timed_out = (timeout_milliseconds > 0 && timeout_milliseconds <= answer_milliseconds) ? NMB_TRUE
+                                                                                                        : NMB_FALSE;
+    const uint32_t elapsed = timed_out ? timeout_milliseconds : answer_milliseconds;
+    if (nmb_clock_is_virtual())
+    {
+        nmb_clock_advance(elapsed);
+    }
+    else if (elapsed > 0)
+    {
+        nmb_clock_wait_milliseconds(elapsed);
+    }
+    return timed_out;
+}
+
+#if defined(NMB_TESTING)
+NMB_API void NMB_CALL nmb_test_advance_clock(uint64_t milliseconds)
+{
+    nmb_clock_advance(milliseconds);
+}
+
+NMB_API void NMB_CALL nmb_test_use_system_clock(void)
+{
+    nmb_clock_use_system();
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The runtime clock behind every timeout, countdown and latency measurement, in milliseconds. It follows the
+ * monotonic system clock until a test engages the virtual clock, which then stands still between
+ * nmb_clock_advance calls. Thread-safe.
+ */
+uint64_t nmb_clock_now_milliseconds(void);
+
+/** The same clock in microseconds, for measurements finer than a timeout; the virtual clock still moves in ms. */
+uint64_t nmb_clock_now_microseconds(void);
+
+nmb_bool nmb_clock_is_virtual(void);
+
+/** Blocks until milliseconds have passed on the runtime clock; on the virtual clock, until it was advanced that far. */
+void nmb_clock_wait_milliseconds(uint32_t milliseconds);
+
+/** Engages the virtual clock at the current time if needed, moves it forward and wakes everything waiting on it. */
+void nmb_clock_advance(uint64_t milliseconds);
+
+/** Returns to the system clock and releases every wait. */
+void nmb_clock_use_system(void);
+
+/** Called after each nmb_clock_advance, from the advancing thread; lets a backend wake its main loop. */
+typedef void (*NmbClockWake)(void);
+
+void nmb_clock_set_wake(NmbClockWake wake);
+
+/**
+ * Plays out a scripted dialog that is answered answer_milliseconds after it opens, unless its timeout (0 = none)
+ * runs out first. The virtual clock is advanced instead of waited on, so an hour-long wait returns at once.
+ * Returns NMB_TRUE when the timeout won.
+ */
+nmb_bool nmb_clock_play_scripted_answer(uint32_t timeout_milliseconds, uint32_t answer_milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,354 @@
+#include "nmb_completion.h"
+#include "nmb_alloc.h"
+#include "nmb_items.h"
+#include "nmb_runtime.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define NMB_COMPLETION_MAGIC 0x4E4D4243u /* 'NMBC' */
+
+/* Below this many items a range is finished with insertion sort instead of another partition pass. */
+#define NMB_COMPLETION_SMALL_SORT 16
+
+/*
+ * One allocation holds the header, the rebased offsets, the sorted ranks and a private copy of the text,
+ * so the index does not borrow from the caller and can be shared read-only by any number of dialogs.
+ */
+struct NmbCompletionIndex_t
+{
+    uint32_t magic;
+    size_t count;            /* distinct entries */
+    const char* data;
+    const uint32_t* offsets; /* item_count + 1 entries, rebased so offsets[0] == 0 */
+    const uint32_t* sorted;  /* item positions in folded order, duplicates removed */
+};
+
+static unsigned char nmb_fold(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+static const char* nmb_entry_text(const NmbCompletionIndex* index, uint32_t item, size_t* length)
+{
+    *length = (size_t)(index->offsets[item + 1] - index->offsets[item]);
+    return index->data + index->offsets[item];
+}
+
+/* Folded byte of item at depth, or -1 past its end so shorter entries sort first. */
+static int nmb_entry_byte(const NmbCompletionIndex* index, uint32_t item, size_t depth)
+{
+    size_t length = 0;
+    const char* text = nmb_entry_text(index, item, &length);
+    return depth < length ? (int)nmb_fold((unsigned char)text[depth]) : -1;
+}
+
+/* Folded order from depth on, then shorter first; raw bytes break ties so only exact duplicates are equal. */
+static int nmb_entry_compare(const NmbCompletionIndex* index, uint32_t a, uint32_t b, size_t depth)
+{
+    size_t a_length = 0;
+    size_t b_length = 0;
+    const char* a_text = nmb_entry_text(index, a, &a_length);
+    const char* b_text = nmb_entry_text(index, b, &b_length);
+    const size_t common = a_length < b_length ? a_length : b_length;
+    for (size_t i = depth; i < common; ++i)
+    {
+        const unsigned char x = nmb_fold((unsigned char)a_text[i]);
+        const unsigned char y = nmb_fold((unsigned char)b_text[i]);
+        if (x != y)
+        {
+            return x < y ? -1 : 1;
+        }
+    }
+
+    if (a_length != b_length)
+    {
+        return a_length < b_length ? -1 : 1;
+    }
+    return memcmp(a_text, b_text, a_length);
+}
+
+static void nmb_insertion_sort(const NmbCompletionIndex* index, uint32_t* items, size_t count, size_t depth)
+{
+    for (size_t i = 1; i < count; ++i)
+    {
+        const uint32_t item = items[i];
+        size_t j = i;
+        while (j > 0 && nmb_entry_compare(index, item, items[j - 1], depth) < 0)
+        {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = item;
+    }
+}
+
+static void nmb_sift_down(const NmbCompletionIndex* index, uint32_t* items, size_t root, size_t count)
+{
+    for (size_t child = 2 * root + 1; child < count; child = 2 * root + 1)
+    {
+        if (child + 1 < count && nmb_entry_compare(index, items[child], items[child + 1], 0) < 0)
+        {
+            ++child;
+        }
+        if (nmb_entry_compare(index, items[root], items[child], 0) >= 0)
+        {
+            return;
+        }
+
+        const uint32_t swap = items[root];
+        items[root] = items[child];
+        items[child] = swap;
+        root = child;
+    }
+}
+
+/* Entries equal once folded differ at most in letter case; heapsort groups exact duplicates without recursion. */
+static void nmb_heap_sort(const NmbCompletionIndex* index, uint32_t* items, size_t count)
+{
+    for (size_t root = count / 2; root-- > 0;)
+    {
+        nmb_sift_down(index, items, root, count);
+    }
+    for (size_t end = count; end-- > 1;)
+    {
+        const uint32_t swap = items[0];
+        items[0] = items[end];
+        items[end] = swap;
+        nmb_sift_down(index, items, 0, end);
+    }
+}
+
+/*
+ * Multikey quicksort: partitions on one folded byte at a time, so a prefix shared by the whole corpus
+ * ("/home/", "node-") is examined once per level instead of once per comparison.
+ */
+static void nmb_completion_sort(const NmbCompletionIndex* index, uint32_t* items, size_t count, size_t depth)
+{
+    while (count > NMB_COMPLETION_SMALL_SORT)
+    {
+        const int a = nmb_entry_byte(index, items[0], depth);
+        const int b = nmb_entry_byte(index, items[count / 2], depth);
+        const int c = nmb_entry_byte(index, items[count - 1], depth);
+        const int pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+        /* items[0, less) < pivot, items[less, i) == pivot, items(greater, count) > pivot */
+        size_t less = 0;
+        size_t i = 0;
+        size_t greater = count;
+        while (i < greater)
+        {
+            const int byte = nmb_entry_byte(index, items[i], depth);
+            const uint32_t item = items[i];
+            if (byte < pivot)
+            {
+                items[i++] = items[less];
+                items[less++] = item;
+            }
+            else if (byte > pivot)
+            {
+                items[i] = items[--greater];
+                items[greater] = item;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        nmb_completion_sort(index, items, less, depth);
+        nmb_completion_sort(index, items + greater, count - greater, depth);
+        if (pivot < 0)
+        {
+            nmb_heap_sort(index, items + less, greater - less);
+            return;
+        }
+
+        items += less;
+        count = greater - less;
+        ++depth;
+    }
+
+    nmb_insertion_sort(index, items, count, depth);
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_completion_index_create(const NmbItemBuffer* candidates,
+                                                           NmbCompletionIndex** out_index)
+{
+    if (!out_index)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    *out_index = NULL;
+    if (!candidates)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    nmb_bool valid_utf8 = NMB_TRUE;
+    NmbResultCode rc = nmb_item_buffer_check(candidates, &valid_utf8);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+    if (!valid_utf8)
+    {
+        nmb_runtime_log("Runtime: completion candidates contain ill-formed UTF-8.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const size_t count = candidates->item_count;
+    const uint32_t base = count > 0 ? candidates->offsets[0] : 0u;
+    const size_t text_bytes = count > 0 ? (size_t)(candidates->offsets[count] - base) : 0u;
+    const size_t header = sizeof(NmbCompletionIndex);
+    const size_t tables = (2 * count + 1) * sizeof(uint32_t);
+    NmbCompletionIndex* index = (NmbCompletionIndex*)nmb_default_alloc(header + tables + text_bytes + 1);
+    if (!index)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    uint32_t* offsets = (uint32_t*)((char*)index + header);
+    uint32_t* sorted = offsets + count + 1;
+    char* data = (char*)(sorted + count);
+    if (text_bytes > 0)
+    {
+        memcpy(data, candidates->data + base, text_bytes);
+    }
+    data[text_bytes] = '\0';
+    for (size_t i = 0; i <= count; ++i)
+    {
+        offsets[i] = count > 0 ? candidates->offsets[i] - base : 0u;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        sorted[i] = (uint32_t)i;
+    }
+
+    index->magic = NMB_COMPLETION_MAGIC;
+    index->data = data;
+    index->offsets = offsets;
+    index->sorted = sorted;
+
+    nmb_completion_sort(index, sorted, count, 0);
+    size_t distinct = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (distinct == 0 || nmb_entry_compare(index, sorted[distinct - 1], sorted[i], 0) != 0)
+        {
+            sorted[distinct++] = sorted[i];
+        }
+    }
+    index->count = distinct;
+
+    *out_index = index;
+    return NMB_OK;
+}
+
+NMB_API void NMB_CALL nmb_completion_index_destroy(NmbCompletionIndex* index)
+{
+    if (!index)
+    {
+        return;
+    }
+
+    index->magic = 0;
+    nmb_default_free(index);
+}
+
+nmb_bool nmb_completion_index_is_valid(const NmbCompletionIndex* index)
+{
+    return (index && index->magic == NMB_COMPLETION_MAGIC) ? NMB_TRUE : NMB_FALSE;
+}
+
+NmbCompletionRange nmb_completion_index_all(const NmbCompletionIndex* index)
+{
+    NmbCompletionRange range;
+    range.first = 0;
+    range.last = index->count;
+    return range;
+}
+
+/* <0 when the entry sorts before every match of prefix, 0 when it starts with prefix, >0 after. */
+static int nmb_prefix_compare(const NmbCompletionIndex* index, size_t rank, const char* prefix, size_t prefix_length)
+{
+    size_t length = 0;
+    const char* text = nmb_entry_text(index, index->sorted[rank], &length);
+    const size_t common = length < prefix_length ? length : prefix_length;
+    for (size_t i = 0; i < common; ++i)
+    {
+        const unsigned char x = nmb_fold((unsigned char)text[i]);
+        const unsigned char y = nmb_fold((unsigned char)prefix[i]);
+        if (x != y)
+        {
+            return x < y ? -1 : 1;
+        }
+    }
+    return length < prefix_length ? -1 : 0;
+}
+
+NmbCompletionRange nmb_completion_index_narrow(const NmbCompletionIndex* index, NmbCompletionRange within,
+                                               const char* prefix, size_t prefix_length)
+{
+    size_t low = within.first;
+    size_t high = within.last;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (nmb_prefix_compare(index, middle, prefix, prefix_length) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    NmbCompletionRange range;
+    range.first = low;
+    high = within.last;
+    while (low < high)
+    {
+        const size_t middle = low + (high - low) / 2;
+        if (nmb_prefix_compare(index, middle, prefix, prefix_length) <= 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    range.last = low;
+    return range;
+}
+
+const char* nmb_completion_index_text(const NmbCompletionIndex* index, size_t rank, size_t* length)
+{
+    return nmb_entry_text(index, index->sorted[rank], length);
+}
+
+uint32_t nmb_completion_index_item(const NmbCompletionIndex* index, size_t rank)
+{
+    return index->sorted[rank];
+}
+
+NMB_API size_t NMB_CALL nmb_completion_index_query(const NmbCompletionIndex* index, const char* prefix_utf8,
+                                                   uint32_t* out_items, size_t max_results)
+{
+    if (!nmb_completion_index_is_valid(index) || (!out_items && max_results > 0))
+    {
+        return 0;
+    }
+
+    const char* prefix = prefix_utf8 ? prefix_utf8 : "";
+    const NmbCompletionRange range =
+        nmb_completion_index_narrow(index, nmb_completion_index_all(index), prefix, strlen(prefix));
+    size_t written = 0;
+    for (size_t rank = range.first; rank < range.last && written < max_results; ++rank)
+    {
+        out_items[written++] = index->sorted[rank];
+    }
+    return written;
+}
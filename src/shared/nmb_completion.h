@@ -0,0 +1,41 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Half-open span [first, last) of ranks in an index's sorted order. */
+typedef struct NmbCompletionRange_t
+{
+    size_t first;
+    size_t last;
+} NmbCompletionRange;
+
+/** NMB_TRUE when index was returned by nmb_completion_index_create and has not been destroyed. */
+nmb_bool nmb_completion_index_is_valid(const NmbCompletionIndex* index);
+
+/** Every rank of the index. */
+NmbCompletionRange nmb_completion_index_all(const NmbCompletionIndex* index);
+
+/**
+ * Ranks of the entries starting with prefix (ASCII case-insensitive), searched only inside within.
+ * Matches for a prefix are always a subset of the matches for any shorter prefix of it, so a caller
+ * that extends its prefix one keystroke at a time can pass the previous range and binary-search a
+ * shrinking span instead of the whole index.
+ */
+NmbCompletionRange nmb_completion_index_narrow(const NmbCompletionIndex* index, NmbCompletionRange within,
+                                               const char* prefix, size_t prefix_length);
+
+/** Text of the entry at rank; not NUL-terminated. */
+const char* nmb_completion_index_text(const NmbCompletionIndex* index, size_t rank, size_t* length);
+
+/** Position of the entry at rank in the candidate buffer the index was created from. */
+uint32_t nmb_completion_index_item(const NmbCompletionIndex* index, size_t rank);
+
+#ifdef __cplusplus
+}
+#endif
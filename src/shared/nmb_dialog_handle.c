@@ -0,0 +1,233 @@
+#include "nmb_dialog_handle.h"
+#include "nmb_alloc.h"
+#include "nmb_runtime.h"
+#include "nmb_thread.h"
+#include "nmb_utf8.h"
+
+#include <string.h>
+
+#define NMB_DIALOG_HANDLE_MAGIC 0x4E4D4244u /* 'NMBD' */
+
+static const size_t kDialogUpdateMinSize = offsetof(NmbDialogUpdate, button_enabled) + sizeof(nmb_bool);
+
+/*
+ * Waiting changes are merged in place: a newer message or informative text replaces the older copy and a
+ * button keeps only its latest state, so the UI thread applies at most one value per widget however many
+ * updates arrived since it last looked.
+ */
+struct NmbDialogHandle_t
+{
+    uint32_t magic;
+    NmbMutex lock;
+    NmbDialogChanges pending;
+    size_t button_capacity;
+    NmbDialogWakeFunction wake;
+    void* wake_context;
+    nmb_bool woken; /* wake ran and the UI thread has not taken the changes yet */
+};
+
+static char* nmb_copy_text(const char* text)
+{
+    const size_t length = strlen(text) + 1;
+    char* copy = (char*)nmb_default_alloc(length);
+    if (copy)
+    {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+/* Records state for button, growing the array when it is new; fails only when growing runs out of memory. */
+static nmb_bool nmb_merge_button(NmbDialogHandle* handle, NmbButtonId button, nmb_bool enabled)
+{
+    NmbDialogChanges* pending = &handle->pending;
+    for (size_t i = 0; i < pending->button_count; ++i)
+    {
+        if (pending->buttons[i].id == button)
+        {
+            pending->buttons[i].enabled = enabled;
+            return NMB_TRUE;
+        }
+    }
+
+    if (pending->button_count == handle->button_capacity)
+    {
+        const size_t capacity = handle->button_capacity ? handle->button_capacity * 2 : 4;
+        NmbButtonState* buttons = (NmbButtonState*)nmb_default_alloc(capacity * sizeof(NmbButtonState));
+        if (!buttons)
+        {
+            return NMB_FALSE;
+        }
+        if (pending->button_count > 0)
+        {
+            memcpy(buttons, pending->buttons, pending->button_count * sizeof(NmbButtonState));
+        }
+        nmb_default_free(pending->buttons);
+        pending->buttons = buttons;
+        handle->button_capacity = capacity;
+    }
+
+    pending->buttons[pending->button_count].id = button;
+    pending->buttons[pending->button_count].enabled = enabled;
+    ++pending->button_count;
+    return NMB_TRUE;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_dialog_handle_create(NmbDialogHandle** out_handle)
+{
+    if (!out_handle)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    NmbDialogHandle* handle = (NmbDialogHandle*)nmb_default_alloc(sizeof(NmbDialogHandle));
+    if (!handle)
+    {
+        *out_handle = NULL;
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    memset(handle, 0, sizeof(*handle));
+    nmb_mutex_init(&handle->lock);
+    handle->magic = NMB_DIALOG_HANDLE_MAGIC;
+    *out_handle = handle;
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_update_dialog(NmbDialogHandle* handle, const NmbDialogUpdate* fields)
+{
+    if (!nmb_dialog_handle_is_valid(handle) || !fields)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    if (fields->struct_size < kDialogUpdateMinSize)
+    {
+        nmb_runtime_log("Runtime: NmbDialogUpdate.struct_size is smaller than expected.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const uint32_t flags = fields->flags;
+    const char* message = (flags & NMB_DIALOG_UPDATE_MESSAGE) ? fields->message_utf8 : NULL;
+    const char* informative = (flags & NMB_DIALOG_UPDATE_INFORMATIVE_TEXT) ? fields->informative_text_utf8 : NULL;
+    if ((flags & NMB_DIALOG_UPDATE_MESSAGE) && !message)
+    {
+        nmb_runtime_log("Runtime: NMB_DIALOG_UPDATE_MESSAGE requires message_utf8.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    if ((message && !nmb_utf8_is_valid(message, strlen(message))) ||
+        (informative && !nmb_utf8_is_valid(informative, strlen(informative))))
+    {
+        nmb_runtime_log("Runtime: dialog update text is not well-formed UTF-8.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    /* Copies are made before taking the lock so the UI thread never waits on an allocation. */
+    char* message_copy = message ? nmb_copy_text(message) : NULL;
+    char* informative_copy = informative ? nmb_copy_text(informative) : NULL;
+    if ((message && !message_copy) || (informative && !informative_copy))
+    {
+        nmb_default_free(message_copy);
+        nmb_default_free(informative_copy);
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    NmbResultCode rc = NMB_OK;
+    nmb_mutex_lock(&handle->lock);
+    if ((flags & NMB_DIALOG_UPDATE_BUTTON_ENABLED) &&
+        !nmb_merge_button(handle, fields->button_id, fields->button_enabled ? NMB_TRUE : NMB_FALSE))
+    {
+        rc = NMB_E_OUT_OF_MEMORY;
+    }
+    else
+    {
+        if (flags & NMB_DIALOG_UPDATE_MESSAGE)
+        {
+            char* replaced = handle->pending.message;
+            handle->pending.message = message_copy;
+            message_copy = replaced;
+        }
+        if (flags & NMB_DIALOG_UPDATE_INFORMATIVE_TEXT)
+        {
+            char* replaced = handle->pending.informative_text;
+            handle->pending.informative_text = informative_copy;
+            informative_copy = replaced;
+        }
+
+        handle->pending.flags |= flags & (NMB_DIALOG_UPDATE_MESSAGE | NMB_DIALOG_UPDATE_INFORMATIVE_TEXT |
+                                          NMB_DIALOG_UPDATE_BUTTON_ENABLED);
+        if (handle->wake && !handle->woken && handle->pending.flags != 0)
+        {
+            handle->woken = NMB_TRUE;
+            handle->wake(handle->wake_context);
+        }
+    }
+    nmb_mutex_unlock(&handle->lock);
+
+    nmb_default_free(message_copy);
+    nmb_default_free(informative_copy);
+    return rc;
+}
+
+NMB_API void NMB_CALL nmb_dialog_handle_destroy(NmbDialogHandle* handle)
+{
+    if (!nmb_dialog_handle_is_valid(handle))
+    {
+        return;
+    }
+
+    handle->magic = 0;
+    nmb_dialog_changes_release(&handle->pending);
+    nmb_mutex_destroy(&handle->lock);
+    nmb_default_free(handle);
+}
+
+nmb_bool nmb_dialog_handle_is_valid(const NmbDialogHandle* handle)
+{
+    return (handle && handle->magic == NMB_DIALOG_HANDLE_MAGIC) ? NMB_TRUE : NMB_FALSE;
+}
+
+nmb_bool nmb_dialog_handle_attach(NmbDialogHandle* handle, NmbDialogWakeFunction wake, void* context)
+{
+    nmb_mutex_lock(&handle->lock);
+    const nmb_bool attached = handle->wake ? NMB_FALSE : NMB_TRUE;
+    if (attached)
+    {
+        handle->wake = wake;
+        handle->wake_context = context;
+        handle->woken = NMB_FALSE;
+        if (handle->pending.flags != 0)
+        {
+            handle->woken = NMB_TRUE;
+            wake(context);
+        }
+    }
+    nmb_mutex_unlock(&handle->lock);
+    return attached;
+}
+
+void nmb_dialog_handle_detach(NmbDialogHandle* handle)
+{
+    nmb_mutex_lock(&handle->lock);
+    handle->wake = NULL;
+    handle->wake_context = NULL;
+    handle->woken = NMB_FALSE;
+    nmb_mutex_unlock(&handle->lock);
+}
+
+void nmb_dialog_handle_take(NmbDialogHandle* handle, NmbDialogChanges* changes)
+{
+    nmb_mutex_lock(&handle->lock);
+    *changes = handle->pending;
+    memset(&handle->pending, 0, sizeof(handle->pending));
+    handle->button_capacity = 0;
+    handle->woken = NMB_FALSE;
+    nmb_mutex_unlock(&handle->lock);
+}
+
+void nmb_dialog_changes_release(NmbDialogChanges* changes)
+{
+    nmb_default_free(changes->message);
+    nmb_default_free(changes->informative_text);
+    nmb_default_free(changes->buttons);
+    memset(changes, 0, sizeof(*changes));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Called by nmb_update_dialog, with the handle locked, when changes arrive and none are waiting yet. */
+typedef void (*NmbDialogWakeFunction)(void* context);
+
+typedef struct NmbButtonState_t
+{
+    NmbButtonId id;
+    nmb_bool enabled;
+} NmbButtonState;
+
+/** Changes moved out of a handle by nmb_dialog_handle_take; only the members named by flags are meaningful. */
+typedef struct NmbDialogChanges_t
+{
+    uint32_t flags;
+    char* message;
+    char* informative_text;  /* NULL clears the informative text */
+    NmbButtonState* buttons; /* latest state per button, in first-update order */
+    size_t button_count;
+} NmbDialogChanges;
+
+/** NMB_TRUE when handle was returned by nmb_dialog_handle_create and has not been destroyed. */
+nmb_bool nmb_dialog_handle_is_valid(const NmbDialogHandle* handle);
+
+/**
+ * Connects the showing dialog to handle. wake runs on the updating thread and must only schedule work on the
+ * UI thread, which then calls nmb_dialog_handle_take. Changes already waiting wake it at once. Fails when
+ * another dialog is attached.
+ */
+nmb_bool nmb_dialog_handle_attach(NmbDialogHandle* handle, NmbDialogWakeFunction wake, void* context);
+
+/** Disconnects the dialog; once this returns, wake is not called again. */
+void nmb_dialog_handle_detach(NmbDialogHandle* handle);
+
+/** Moves every waiting change into changes and rearms wake. Release changes with nmb_dialog_changes_release. */
+void nmb_dialog_handle_take(NmbDialogHandle* handle, NmbDialogChanges* changes);
+
+void nmb_dialog_changes_release(NmbDialogChanges* changes);
+
+#ifdef __cplusplus
+}
+#endif
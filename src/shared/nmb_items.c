@@ -0,0 +1,228 @@
+#include "nmb_items.h"
+#include "nmb_alloc.h"
+#include "nmb_runtime.h"
+#include "nmb_utf8.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static const size_t kItemBufferMinSize = offsetof(NmbItemBuffer, item_count) + sizeof(size_t);
+
+static NmbResultCode nmb_items_invalid(const char* message)
+{
+    nmb_runtime_log(message);
+    return NMB_E_INVALID_ARGUMENT;
+}
+
+NmbResultCode nmb_item_buffer_check(const NmbItemBuffer* items, nmb_bool* valid_utf8)
+{
+    *valid_utf8 = NMB_TRUE;
+    if (items->struct_size < kItemBufferMinSize)
+    {
+        return nmb_items_invalid("Runtime: NmbItemBuffer.struct_size is smaller than expected.");
+    }
+
+    if (items->item_count == 0)
+    {
+        return NMB_OK;
+    }
+
+    if (!items->data || !items->offsets || items->item_count >= UINT32_MAX)
+    {
+        return nmb_items_invalid("Runtime: NmbItemBuffer requires data and item_count + 1 offsets.");
+    }
+
+    for (size_t i = 0; i < items->item_count; ++i)
+    {
+        if (items->offsets[i + 1] < items->offsets[i])
+        {
+            return nmb_items_invalid("Runtime: NmbItemBuffer.offsets must not decrease.");
+        }
+    }
+
+    const char* first = items->data + items->offsets[0];
+    const size_t total = (size_t)(items->offsets[items->item_count] - items->offsets[0]);
+    if (!nmb_utf8_is_valid(first, total))
+    {
+        *valid_utf8 = NMB_FALSE;
+        return NMB_OK;
+    }
+
+    /* The whole run is well-formed; an item is too unless its boundary lands inside a sequence. */
+    for (size_t i = 1; i < items->item_count; ++i)
+    {
+        const uint32_t offset = items->offsets[i];
+        if (offset < items->offsets[items->item_count] && ((unsigned char)items->data[offset] & 0xC0u) == 0x80u)
+        {
+            *valid_utf8 = NMB_FALSE;
+            break;
+        }
+    }
+    return NMB_OK;
+}
+
+NmbResultCode nmb_item_buffer_repair(const NmbItemBuffer* items, NmbArena* arena, NmbItemBuffer* out)
+{
+    const size_t total = (size_t)(items->offsets[items->item_count] - items->offsets[0]);
+    if (total > (UINT32_MAX - 1u) / 3u)
+    {
+        return nmb_items_invalid("Runtime: NmbItemBuffer is too large to repair.");
+    }
+
+    uint32_t* offsets = (uint32_t*)nmb_arena_alloc(arena, (items->item_count + 1) * sizeof(uint32_t), sizeof(uint32_t));
+    char* data = (char*)nmb_arena_alloc(arena, NMB_UTF8_REPAIR_MAX(total) + 1, 1);
+    if (!offsets || !data)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    uint32_t written = 0;
+    for (size_t i = 0; i < items->item_count; ++i)
+    {
+        offsets[i] = written;
+        written += (uint32_t)nmb_utf8_repair(nmb_item_data(items, i), nmb_item_length(items, i), data + written);
+    }
+    offsets[items->item_count] = written;
+
+    out->struct_size = sizeof(*out);
+    out->data = data;
+    out->offsets = offsets;
+    out->item_count = items->item_count;
+    return NMB_OK;
+}
+
+static uint64_t nmb_item_hash(const char* text, size_t length)
+{
+    /* FNV-1a; item strings are short, so a simple byte-wise hash beats anything needing setup. */
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static size_t nmb_item_index_probe(const NmbItemIndex* index, const char* text, size_t length, nmb_bool* found)
+{
+    size_t slot = (size_t)nmb_item_hash(text, length) & index->mask;
+    for (;;)
+    {
+        const uint32_t entry = index->slots[slot];
+        if (entry == 0)
+        {
+            *found = NMB_FALSE;
+            return slot;
+        }
+
+        const size_t item = entry - 1u;
+        if (nmb_item_length(index->items, item) == length &&
+            memcmp(nmb_item_data(index->items, item), text, length) == 0)
+        {
+            *found = NMB_TRUE;
+            return slot;
+        }
+        slot = (slot + 1) & index->mask;
+    }
+}
+
+NmbResultCode nmb_item_index_build(NmbItemIndex* index, const NmbItemBuffer* items)
+{
+    memset(index, 0, sizeof(*index));
+    index->items = items;
+
+    /* Keep the load factor at or below one half so linear probes stay short. */
+    size_t capacity = 16;
+    while (capacity < items->item_count * 2)
+    {
+        capacity <<= 1;
+    }
+
+    index->slots = (uint32_t*)nmb_default_alloc(capacity * sizeof(uint32_t));
+    if (!index->slots)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+    memset(index->slots, 0, capacity * sizeof(uint32_t));
+    index->mask = capacity - 1;
+
+    for (size_t i = 0; i < items->item_count; ++i)
+    {
+        nmb_bool found = NMB_FALSE;
+        const size_t slot = nmb_item_index_probe(index, nmb_item_data(items, i), nmb_item_length(items, i), &found);
+        if (!found)
+        {
+            index->slots[slot] = (uint32_t)(i + 1);
+        }
+    }
+    return NMB_OK;
+}
+
+size_t nmb_item_index_find(const NmbItemIndex* index, const char* text, size_t length)
+{
+    if (!index->slots || !text)
+    {
+        return NMB_ITEM_NOT_FOUND;
+    }
+
+    nmb_bool found = NMB_FALSE;
+    const size_t slot = nmb_item_index_probe(index, text, length, &found);
+    return found ? (size_t)index->slots[slot] - 1u : NMB_ITEM_NOT_FOUND;
+}
+
+void nmb_item_index_release(NmbItemIndex* index)
+{
+    nmb_default_free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+static unsigned char nmb_ascii_lower(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+static nmb_bool nmb_contains_folded(const char* text, size_t length, const unsigned char* needle, size_t needle_length)
+{
+    if (needle_length > length)
+    {
+        return NMB_FALSE;
+    }
+
+    for (size_t start = 0; start + needle_length <= length; ++start)
+    {
+        size_t i = 0;
+        while (i < needle_length && nmb_ascii_lower((unsigned char)text[start + i]) == needle[i])
+        {
+            ++i;
+        }
+        if (i == needle_length)
+        {
+            return NMB_TRUE;
+        }
+    }
+    return NMB_FALSE;
+}
+
+size_t nmb_items_filter(const NmbItemBuffer* items, const char* needle, size_t needle_length, uint32_t* out)
+{
+    unsigned char folded[256];
+    if (needle_length > sizeof(folded))
+    {
+        needle_length = sizeof(folded);
+    }
+    for (size_t i = 0; i < needle_length; ++i)
+    {
+        folded[i] = nmb_ascii_lower((unsigned char)needle[i]);
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < items->item_count; ++i)
+    {
+        if (needle_length == 0 ||
+            nmb_contains_folded(nmb_item_data(items, i), nmb_item_length(items, i), folded, needle_length))
+        {
+            out[count++] = (uint32_t)i;
+        }
+    }
+    return count;
+}
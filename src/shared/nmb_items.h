@@ -0,0 +1,60 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_arena.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Returned by nmb_item_index_find when no item has the requested text. */
+#define NMB_ITEM_NOT_FOUND ((size_t)-1)
+
+/** Byte length of item index in items. */
+static inline size_t nmb_item_length(const NmbItemBuffer* items, size_t index)
+{
+    return (size_t)(items->offsets[index + 1] - items->offsets[index]);
+}
+
+/** First byte of item index in items. */
+static inline const char* nmb_item_data(const NmbItemBuffer* items, size_t index)
+{
+    return items->data + items->offsets[index];
+}
+
+/**
+ * Checks struct_size, the offsets table and the text. Structural problems fail with
+ * NMB_E_INVALID_ARGUMENT; ill-formed UTF-8 (including an item boundary inside a sequence) only
+ * clears *valid_utf8, so the caller can decide between rejecting and repairing.
+ */
+NmbResultCode nmb_item_buffer_check(const NmbItemBuffer* items, nmb_bool* valid_utf8);
+
+/** Copies items into arena with every item repaired as nmb_utf8_repair does; out borrows from arena. */
+NmbResultCode nmb_item_buffer_repair(const NmbItemBuffer* items, NmbArena* arena, NmbItemBuffer* out);
+
+/**
+ * Open-addressing hash index from item text to the first item carrying it, built in one pass so
+ * lookups such as resolving default_value_utf8 stay O(1) for lists of any size.
+ */
+typedef struct NmbItemIndex_t
+{
+    const NmbItemBuffer* items;
+    uint32_t* slots; /* item index + 1; 0 marks an empty slot */
+    size_t mask;
+} NmbItemIndex;
+
+NmbResultCode nmb_item_index_build(NmbItemIndex* index, const NmbItemBuffer* items);
+size_t nmb_item_index_find(const NmbItemIndex* index, const char* text, size_t length);
+void nmb_item_index_release(NmbItemIndex* index);
+
+/**
+ * Writes the indices of items containing needle (ASCII case-insensitive) to out, which must hold
+ * item_count entries, and returns how many matched. An empty needle matches every item.
+ */
+size_t nmb_items_filter(const NmbItemBuffer* items, const char* needle, size_t needle_length, uint32_t* out);
+
+#ifdef __cplusplus
+}
+#endif
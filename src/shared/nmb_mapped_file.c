@@ -0,0 +1,327 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "nmb_mapped_file.h"
+#include "nmb_runtime.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const size_t kContentSourceMinSize = offsetof(NmbContentSource, length) + sizeof(uint64_t);
+
+static NmbResultCode nmb_mapped_file_fail(const char* message, NmbResultCode rc)
+{
+    nmb_runtime_log(message);
+    return rc;
+}
+
+/* Clamps the requested range to the file size; fails when it starts past the end or cannot be addressed. */
+static NmbResultCode nmb_mapped_file_range(const NmbContentSource* source, uint64_t file_size, size_t* length)
+{
+    if (source->offset > file_size)
+    {
+        return nmb_mapped_file_fail("Runtime: NmbContentSource.offset is past the end of the file.",
+                                    NMB_E_INVALID_ARGUMENT);
+    }
+
+    uint64_t available = file_size - source->offset;
+    uint64_t requested = (source->length == 0 || source->length > available) ? available : source->length;
+    if (requested > (uint64_t)SIZE_MAX)
+    {
+        return nmb_mapped_file_fail("Runtime: NmbContentSource range does not fit in the address space.",
+                                    NMB_E_OUT_OF_MEMORY);
+    }
+
+    *length = (size_t)requested;
+    return NMB_OK;
+}
+
+#if defined(_WIN32)
+
+static NmbResultCode nmb_mapped_file_map(HANDLE handle, const NmbContentSource* source, NmbMappedFile* file)
+{
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        return nmb_mapped_file_fail("Runtime: could not query the size of the content source.",
+                                    NMB_E_PLATFORM_FAILURE);
+    }
+
+    size_t length = 0;
+    NmbResultCode rc = nmb_mapped_file_range(source, (uint64_t)size.QuadPart, &length);
+    if (rc != NMB_OK || length == 0)
+    {
+        return rc;
+    }
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const uint64_t aligned = source->offset - (source->offset % info.dwAllocationGranularity);
+    const size_t delta = (size_t)(source->offset - aligned);
+
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        return nmb_mapped_file_fail("Runtime: could not create a mapping for the content source.",
+                                    NMB_E_PLATFORM_FAILURE);
+    }
+
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(aligned >> 32), (DWORD)(aligned & 0xFFFFFFFFu),
+                               delta + length);
+    CloseHandle(mapping);
+    if (!base)
+    {
+        return nmb_mapped_file_fail("Runtime: could not map the content source.", NMB_E_PLATFORM_FAILURE);
+    }
+
+    file->base = base;
+    file->base_length = delta + length;
+    file->data = (const char*)base + delta;
+    file->length = length;
+    return NMB_OK;
+}
+
+static NmbResultCode nmb_mapped_file_open_path(const NmbContentSource* source, NmbMappedFile* file)
+{
+    int wide_length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, source->path_utf8, -1, NULL, 0);
+    if (wide_length <= 0)
+    {
+        return nmb_mapped_file_fail("Runtime: NmbContentSource.path_utf8 is not valid UTF-8.",
+                                    NMB_E_INVALID_ARGUMENT);
+    }
+
+    WCHAR* path = (WCHAR*)HeapAlloc(GetProcessHeap(), 0, (SIZE_T)wide_length * sizeof(WCHAR));
+    if (!path)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    MultiByteToWideChar(CP_UTF8, 0, source->path_utf8, -1, path, wide_length);
+    HANDLE handle = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    HeapFree(GetProcessHeap(), 0, path);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return nmb_mapped_file_fail("Runtime: could not open NmbContentSource.path_utf8.", NMB_E_INVALID_ARGUMENT);
+    }
+
+    NmbResultCode rc = nmb_mapped_file_map(handle, source, file);
+    CloseHandle(handle);
+    return rc;
+}
+
+static void nmb_mapped_file_unmap(NmbMappedFile* file)
+{
+    UnmapViewOfFile(file->base);
+}
+
+#else
+
+static NmbResultCode nmb_mapped_file_map(int fd, const NmbContentSource* source, NmbMappedFile* file)
+{
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        return nmb_mapped_file_fail("Runtime: could not query the size of the content source.",
+                                    NMB_E_PLATFORM_FAILURE);
+    }
+
+    size_t length = 0;
+    NmbResultCode rc = nmb_mapped_file_range(source, (uint64_t)info.st_size, &length);
+    if (rc != NMB_OK || length == 0)
+    {
+        return rc;
+    }
+
+    const uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    const uint64_t aligned = source->offset - (source->offset % page);
+    const size_t delta = (size_t)(source->offset - aligned);
+
+    void* base = mmap(NULL, delta + length, PROT_READ, MAP_PRIVATE, fd, (off_t)aligned);
+    if (base == MAP_FAILED)
+    {
+        return nmb_mapped_file_fail("Runtime: could not map the content source.", NMB_E_PLATFORM_FAILURE);
+    }
+
+    file->base = base;
+    file->base_length = delta + length;
+    file->data = (const char*)base + delta;
+    file->length = length;
+    return NMB_OK;
+}
+
+static NmbResultCode nmb_mapped_file_open_path(const NmbContentSource* source, NmbMappedFile* file)
+{
+    int fd = open(source->path_utf8, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return nmb_mapped_file_fail("Runtime: could not open NmbContentSource.path_utf8.", NMB_E_INVALID_ARGUMENT);
+    }
+
+    /* The mapping keeps the pages reachable; the descriptor is not needed past this point. */
+    NmbResultCode rc = nmb_mapped_file_map(fd, source, file);
+    close(fd);
+    return rc;
+}
+
+static void nmb_mapped_file_unmap(NmbMappedFile* file)
+{
+    munmap(file->base, file->base_length);
+}
+
+#endif
+
+NmbResultCode nmb_mapped_file_open(const NmbContentSource* source, NmbMappedFile* file)
+{
+    if (!source || !file)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    memset(file, 0, sizeof(*file));
+    file->data = "";
+
+    if (source->struct_size < kContentSourceMinSize)
+    {
+        return nmb_mapped_file_fail("Runtime: NmbContentSource.struct_size is smaller than expected.",
+                                    NMB_E_INVALID_ARGUMENT);
+    }
+
+    switch (source->kind)
+    {
+    case NMB_CONTENT_SOURCE_PATH:
+        if (!source->path_utf8)
+        {
+            return nmb_mapped_file_fail("Runtime: NmbContentSource.path_utf8 is required for a path source.",
+                                        NMB_E_INVALID_ARGUMENT);
+        }
+        return nmb_mapped_file_open_path(source, file);
+    case NMB_CONTENT_SOURCE_FD:
+#if defined(_WIN32)
+        return nmb_mapped_file_map((HANDLE)source->fd, source, file);
+#else
+        if (source->fd < 0 || source->fd > INT32_MAX)
+        {
+            return nmb_mapped_file_fail("Runtime: NmbContentSource.fd is not a valid descriptor.",
+                                        NMB_E_INVALID_ARGUMENT);
+        }
+        return nmb_mapped_file_map((int)source->fd, source, file);
+#endif
+    default:
+        return nmb_mapped_file_fail("Runtime: NmbContentSource.kind is not recognized.", NMB_E_INVALID_ARGUMENT);
+    }
+}
+
+nmb_bool nmb_content_source_follows(const NmbContentSource* source)
+{
+    return (source && NMB_STRUCT_HAS_FIELD(source, NmbContentSource, follow) && source->follow) ? NMB_TRUE
+                                                                                                : NMB_FALSE;
+}
+
+void nmb_mapped_file_close(NmbMappedFile* file)
+{
+    if (!file)
+    {
+        return;
+    }
+
+    if (file->base)
+    {
+        nmb_mapped_file_unmap(file);
+    }
+
+    memset(file, 0, sizeof(*file));
+    file->data = "";
+}
+
+size_t nmb_text_chunk_end(const char* data, size_t length, size_t limit)
+{
+    if (length <= limit)
+    {
+        return length;
+    }
+
+    if (limit == 0)
+    {
+        limit = 1;
+    }
+
+    const size_t floor = limit - limit / 4;
+    for (size_t end = limit; end > floor; --end)
+    {
+        if (data[end - 1] == '\n')
+        {
+            return end;
+        }
+    }
+
+    /* Step back over at most three continuation bytes so the next chunk starts on a lead byte. */
+    size_t end = limit;
+    for (int i = 0; i < 3 && end > 1 && ((unsigned char)data[end] & 0xC0u) == 0x80u; ++i)
+    {
+        --end;
+    }
+    return end;
+}
+
+nmb_bool nmb_text_exceeds(const char* text, size_t max_bytes, size_t max_lines)
+{
+    if (!text)
+    {
+        return NMB_FALSE;
+    }
+
+    const char* terminator = (const char*)memchr(text, '\0', max_bytes + 1);
+    if (!terminator)
+    {
+        return NMB_TRUE;
+    }
+
+    size_t lines = 1;
+    for (const char* cursor = text; (cursor = (const char*)memchr(cursor, '\n', (size_t)(terminator - cursor)));
+         ++cursor)
+    {
+        if (++lines > max_lines)
+        {
+            return NMB_TRUE;
+        }
+    }
+    return NMB_FALSE;
+}
+
+size_t nmb_text_find(const char* haystack, size_t length, const char* needle, size_t needle_length, size_t from)
+{
+    if (!haystack || !needle || needle_length == 0 || from > length || needle_length > length - from)
+    {
+        return NMB_TEXT_NOT_FOUND;
+    }
+
+    /* memchr is vectorized by every libc we ship on, so scanning for the first byte dominates. */
+    const char* cursor = haystack + from;
+    const char* last = haystack + (length - needle_length);
+    while (cursor <= last)
+    {
+        const char* hit = (const char*)memchr(cursor, (unsigned char)needle[0], (size_t)(last - cursor) + 1);
+        if (!hit)
+        {
+            break;
+        }
+
+        if (memcmp(hit + 1, needle + 1, needle_length - 1) == 0)
+        {
+            return (size_t)(hit - haystack);
+        }
+        cursor = hit + 1;
+    }
+    return NMB_TEXT_NOT_FOUND;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Returned by nmb_text_find when the needle does not occur. */
+#define NMB_TEXT_NOT_FOUND ((size_t)-1)
+
+/**
+ * Read-only view of the byte range selected by an NmbContentSource. Opening only maps the range, so
+ * the cost is independent of the file size; pages are faulted in as a backend reads them.
+ */
+typedef struct NmbMappedFile_t
+{
+    const char* data; /**< First byte of the requested range; never NULL after a successful open. */
+    size_t length;    /**< Bytes in the requested range. */
+    void* base;       /**< Start of the page-aligned mapping, or NULL for an empty range. */
+    size_t base_length;
+} NmbMappedFile;
+
+NmbResultCode nmb_mapped_file_open(const NmbContentSource* source, NmbMappedFile* file);
+
+/** NMB_TRUE when source asks to follow its file as it grows. */
+nmb_bool nmb_content_source_follows(const NmbContentSource* source);
+void nmb_mapped_file_close(NmbMappedFile* file);
+
+/**
+ * Returns the end of the next chunk of at most limit bytes starting at data: the last line break in the
+ * final quarter of the window when there is one, otherwise the last position that does not split a
+ * UTF-8 sequence. Always makes progress when length > 0.
+ */
+size_t nmb_text_chunk_end(const char* data, size_t length, size_t limit);
+
+/**
+ * NMB_TRUE when a NUL-terminated text is longer than max_bytes or spans more than max_lines lines.
+ * Reads at most max_bytes + 1 bytes, so the answer costs the same for any size of text.
+ */
+nmb_bool nmb_text_exceeds(const char* text, size_t max_bytes, size_t max_lines);
+
+/** Byte offset of the first occurrence of needle at or after from, or NMB_TEXT_NOT_FOUND. */
+size_t nmb_text_find(const char* haystack, size_t length, const char* needle, size_t needle_length, size_t from);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,396 @@
+#include "nmb_message_template.h"
+#include "nmb_alloc.h"
+#include "nmb_options.h"
+#include "nmb_runtime.h"
+#include "nmb_thread.h"
+#include "nmb_timing.h"
+#include "nmb_utf8.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define NMB_MESSAGE_TEMPLATE_MAGIC 0x4E4D424Du /* 'NMBM' */
+
+/* Marks a segment that copies pattern text rather than an argument. */
+#define NMB_SEGMENT_LITERAL UINT32_MAX
+
+/* A run of literal text, or a placeholder whose name is kept for nmb_message_template_argument_index. */
+typedef struct NmbTemplateSegment_t
+{
+    uint32_t offset; /* into text */
+    uint32_t length;
+    uint32_t argument;
+} NmbTemplateSegment;
+
+/* The dialog a coalescing request opened; lives on that request's stack until every joined caller has read it. */
+typedef struct NmbTemplateShowing_t
+{
+    nmb_bool done;
+    size_t readers;
+    NmbResultCode rc;
+    NmbButtonId button;
+    nmb_bool checkbox_checked;
+    nmb_bool was_timeout;
+    NmbDialogTiming timing;
+} NmbTemplateShowing;
+
+/* One allocation holds the header, the segments and the unescaped pattern text. */
+struct NmbMessageTemplate_t
+{
+    uint32_t magic;
+    uint64_t id;
+    size_t segment_count;
+    size_t argument_count;
+    const NmbTemplateSegment* segments;
+    const char* text;
+    /* guarded by s_lock */
+    NmbButtonId suppressed_button;
+    NmbTemplateShowing* showing;
+    NmbMessageTemplateStats stats;
+};
+
+static NmbMutex s_lock = NMB_MUTEX_INIT;
+static NmbCondition s_changed = NMB_CONDITION_INIT;
+
+static uint64_t nmb_fnv1a(const char* data, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static NmbResultCode nmb_invalid_pattern(const char* message)
+{
+    nmb_runtime_log(message);
+    return NMB_E_INVALID_ARGUMENT;
+}
+
+/* Argument number of the placeholder called name among the first count segments, or SIZE_MAX. */
+static size_t nmb_find_argument(const NmbTemplateSegment* segments, size_t count, const char* text, const char* name,
+                                size_t length)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const NmbTemplateSegment* segment = &segments[i];
+        if (segment->argument != NMB_SEGMENT_LITERAL && segment->length == length &&
+            memcmp(text + segment->offset, name, length) == 0)
+        {
+            return segment->argument;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/* Splits pattern into segments, unescaping "{{" and "}}" into text. */
+static NmbResultCode nmb_parse_pattern(const char* pattern, size_t length, NmbMessageTemplate* message_template,
+                                       NmbTemplateSegment* segments, char* text)
+{
+    size_t count = 0;
+    size_t arguments = 0;
+    size_t written = 0;
+    nmb_bool in_literal = NMB_FALSE;
+    for (size_t i = 0; i < length;)
+    {
+        const char c = pattern[i];
+        const nmb_bool escaped =
+            ((c == '{' || c == '}') && i + 1 < length && pattern[i + 1] == c) ? NMB_TRUE : NMB_FALSE;
+        if (c == '}' && !escaped)
+        {
+            return nmb_invalid_pattern("Runtime: message template has a '}' without a matching '{'.");
+        }
+        if (c != '{' || escaped)
+        {
+            if (!in_literal)
+            {
+                segments[count].offset = (uint32_t)written;
+                segments[count].length = 0;
+                segments[count].argument = NMB_SEGMENT_LITERAL;
+                ++count;
+                in_literal = NMB_TRUE;
+            }
+            text[written++] = c;
+            ++segments[count - 1].length;
+            i += escaped ? 2 : 1;
+            continue;
+        }
+
+        const char* name = pattern + i + 1;
+        const char* close = (const char*)memchr(name, '}', length - i - 1);
+        const char* nested = (const char*)memchr(name, '{', close ? (size_t)(close - name) : length - i - 1);
+        if (!close || nested || close == name)
+        {
+            return nmb_invalid_pattern("Runtime: message template has an unterminated or empty placeholder.");
+        }
+
+        const size_t name_length = (size_t)(close - name);
+        size_t argument = nmb_find_argument(segments, count, text, name, name_length);
+        if (argument == SIZE_MAX)
+        {
+            argument = arguments++;
+        }
+        memcpy(text + written, name, name_length);
+        segments[count].offset = (uint32_t)written;
+        segments[count].length = (uint32_t)name_length;
+        segments[count].argument = (uint32_t)argument;
+        ++count;
+        written += name_length;
+        in_literal = NMB_FALSE;
+        i += name_length + 2;
+    }
+
+    text[written] = '\0';
+    message_template->segment_count = count;
+    message_template->argument_count = arguments;
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_message_template_create(const char* pattern_utf8,
+                                                           NmbMessageTemplate** out_template)
+{
+    if (!out_template)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    *out_template = NULL;
+    if (!pattern_utf8)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const size_t length = strlen(pattern_utf8);
+    if (length > UINT32_MAX || !nmb_utf8_is_valid(pattern_utf8, length))
+    {
+        return nmb_invalid_pattern("Runtime: message template pattern is too long or ill-formed UTF-8.");
+    }
+
+    /* Every placeholder opens with '{' and may split a literal in two, which bounds the segment count. */
+    size_t opens = 0;
+    for (const char* brace = strchr(pattern_utf8, '{'); brace; brace = strchr(brace + 1, '{'))
+    {
+        ++opens;
+    }
+    const size_t segment_capacity = 2 * opens + 1;
+    const size_t header = sizeof(NmbMessageTemplate);
+    const size_t table = segment_capacity * sizeof(NmbTemplateSegment);
+    NmbMessageTemplate* message_template = (NmbMessageTemplate*)nmb_default_alloc(header + table + length + 1);
+    if (!message_template)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    memset(message_template, 0, header);
+    NmbTemplateSegment* segments = (NmbTemplateSegment*)((char*)message_template + header);
+    char* text = (char*)(segments + segment_capacity);
+    NmbResultCode rc = nmb_parse_pattern(pattern_utf8, length, message_template, segments, text);
+    if (rc != NMB_OK)
+    {
+        nmb_default_free(message_template);
+        return rc;
+    }
+
+    message_template->magic = NMB_MESSAGE_TEMPLATE_MAGIC;
+    message_template->id = nmb_fnv1a(pattern_utf8, length);
+    message_template->segments = segments;
+    message_template->text = text;
+    message_template->suppressed_button = NMB_BUTTON_ID_NONE;
+    message_template->stats.struct_size = sizeof(message_template->stats);
+    *out_template = message_template;
+    return NMB_OK;
+}
+
+nmb_bool nmb_message_template_is_valid(const NmbMessageTemplate* message_template)
+{
+    return (message_template && message_template->magic == NMB_MESSAGE_TEMPLATE_MAGIC) ? NMB_TRUE : NMB_FALSE;
+}
+
+NMB_API uint64_t NMB_CALL nmb_message_template_id(const NmbMessageTemplate* message_template)
+{
+    return nmb_message_template_is_valid(message_template) ? message_template->id : 0;
+}
+
+NMB_API size_t NMB_CALL nmb_message_template_argument_count(const NmbMessageTemplate* message_template)
+{
+    return nmb_message_template_is_valid(message_template) ? message_template->argument_count : 0;
+}
+
+NMB_API size_t NMB_CALL nmb_message_template_argument_index(const NmbMessageTemplate* message_template,
+                                                            const char* name_utf8)
+{
+    if (!nmb_message_template_is_valid(message_template) || !name_utf8)
+    {
+        return SIZE_MAX;
+    }
+    return nmb_find_argument(message_template->segments, message_template->segment_count, message_template->text,
+                             name_utf8, strlen(name_utf8));
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_message_template_suppress(NmbMessageTemplate* message_template,
+                                                             NmbButtonId button)
+{
+    if (!nmb_message_template_is_valid(message_template))
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    nmb_mutex_lock(&s_lock);
+    message_template->suppressed_button = button;
+    nmb_mutex_unlock(&s_lock);
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_message_template_get_stats(const NmbMessageTemplate* message_template,
+                                                              NmbMessageTemplateStats* out_stats)
+{
+    if (!nmb_message_template_is_valid(message_template) || !out_stats ||
+        out_stats->struct_size < offsetof(NmbMessageTemplateStats, requests) + sizeof(uint64_t))
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const uint32_t struct_size = out_stats->struct_size;
+    nmb_mutex_lock(&s_lock);
+    memcpy(out_stats, &message_template->stats,
+           struct_size < sizeof(NmbMessageTemplateStats) ? struct_size : sizeof(NmbMessageTemplateStats));
+    nmb_mutex_unlock(&s_lock);
+    out_stats->struct_size = struct_size;
+    return NMB_OK;
+}
+
+NMB_API void NMB_CALL nmb_message_template_destroy(NmbMessageTemplate* message_template)
+{
+    if (!message_template)
+    {
+        return;
+    }
+
+    message_template->magic = 0;
+    nmb_default_free(message_template);
+}
+
+NmbResultCode nmb_message_template_expand(const NmbMessageTemplate* message_template, const NmbStringView* arguments,
+                                          NmbArena* arena, const char** out_text)
+{
+    const NmbTemplateSegment* segments = message_template->segments;
+    size_t total = 0;
+    for (size_t i = 0; i < message_template->segment_count; ++i)
+    {
+        total += segments[i].argument == NMB_SEGMENT_LITERAL ? segments[i].length
+                                                             : arguments[segments[i].argument].length;
+    }
+
+    char* buffer = (char*)nmb_arena_alloc(arena, total + 1, 1);
+    if (!buffer)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    char* cursor = buffer;
+    for (size_t i = 0; i < message_template->segment_count; ++i)
+    {
+        const NmbTemplateSegment* segment = &segments[i];
+        const NmbStringView* argument =
+            segment->argument == NMB_SEGMENT_LITERAL ? NULL : &arguments[segment->argument];
+        const size_t length = argument ? argument->length : segment->length;
+        if (length > 0)
+        {
+            memcpy(cursor, argument ? argument->data : message_template->text + segment->offset, length);
+        }
+        cursor += length;
+    }
+    *cursor = '\0';
+    *out_text = buffer;
+    return NMB_OK;
+}
+
+static void nmb_answer(NmbMessageBoxResult* out_result, NmbResultCode rc, NmbButtonId button,
+                       nmb_bool checkbox_checked, nmb_bool was_timeout)
+{
+    out_result->button = button;
+    out_result->checkbox_checked = checkbox_checked;
+    out_result->was_timeout = was_timeout;
+    out_result->result_code = rc;
+}
+
+NmbResultCode nmb_message_template_show(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                        NmbShowFunction show, nmb_bool may_wait)
+{
+    const NmbTemplatedMessage* templated = nmb_templated_message(options);
+    NmbMessageTemplate* message_template = templated->message_template;
+
+    nmb_mutex_lock(&s_lock);
+    ++message_template->stats.requests;
+    if (message_template->suppressed_button != NMB_BUTTON_ID_NONE)
+    {
+        ++message_template->stats.suppressed;
+        nmb_answer(out_result, NMB_OK, message_template->suppressed_button, NMB_TRUE, NMB_FALSE);
+        nmb_timing_finish(out_result, NMB_BACKEND_RUNTIME);
+        nmb_mutex_unlock(&s_lock);
+        return NMB_OK;
+    }
+
+    NmbTemplateShowing* joined = (templated->coalesce && may_wait) ? message_template->showing : NULL;
+    if (joined)
+    {
+        ++message_template->stats.coalesced;
+        ++joined->readers;
+        while (!joined->done)
+        {
+            nmb_condition_wait(&s_changed, &s_lock);
+        }
+
+        nmb_answer(out_result, joined->rc, joined->button, joined->checkbox_checked, joined->was_timeout);
+        nmb_timing_load(out_result, &joined->timing);
+        const NmbResultCode rc = joined->rc;
+        if (--joined->readers == 0)
+        {
+            nmb_condition_broadcast(&s_changed);
+        }
+        nmb_mutex_unlock(&s_lock);
+        return rc;
+    }
+
+    NmbTemplateShowing showing;
+    memset(&showing, 0, sizeof(showing));
+    const nmb_bool leads = (templated->coalesce && !message_template->showing) ? NMB_TRUE : NMB_FALSE;
+    if (leads)
+    {
+        message_template->showing = &showing;
+    }
+    ++message_template->stats.shown;
+    nmb_mutex_unlock(&s_lock);
+
+    NmbMessageBoxOptions expanded;
+    memset(&expanded, 0, sizeof(expanded));
+    memcpy(&expanded, options, options->struct_size < sizeof(expanded) ? options->struct_size : sizeof(expanded));
+    expanded.struct_size = sizeof(expanded);
+    expanded.templated_message = NULL;
+    const NmbResultCode rc = nmb_timing_reenter(show, &expanded, out_result);
+
+    nmb_mutex_lock(&s_lock);
+    if (rc == NMB_OK && options->show_suppress_checkbox && out_result->checkbox_checked)
+    {
+        message_template->suppressed_button = out_result->button;
+    }
+    if (leads)
+    {
+        message_template->showing = NULL;
+        showing.rc = rc;
+        showing.button = out_result->button;
+        showing.checkbox_checked = out_result->checkbox_checked;
+        showing.was_timeout = out_result->was_timeout;
+        nmb_timing_save(out_result, &showing.timing);
+        showing.done = NMB_TRUE;
+        nmb_condition_broadcast(&s_changed);
+        while (showing.readers > 0)
+        {
+            nmb_condition_wait(&s_changed, &s_lock);
+        }
+    }
+    nmb_mutex_unlock(&s_lock);
+    return rc;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_aggregate.h"
+#include "nmb_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** NMB_TRUE when message_template was returned by nmb_message_template_create and has not been destroyed. */
+nmb_bool nmb_message_template_is_valid(const NmbMessageTemplate* message_template);
+
+/**
+ * Substitutes arguments (at least nmb_message_template_argument_count of them, already checked) into one
+ * NUL-terminated buffer allocated from arena. Sizes the buffer first, so every byte is written exactly once.
+ */
+NmbResultCode nmb_message_template_expand(const NmbMessageTemplate* message_template, const NmbStringView* arguments,
+                                          NmbArena* arena, const char** out_text);
+
+/**
+ * Runs a request that carries an NmbTemplatedMessage: counts it, answers it from the template's suppression, or
+ * joins the template's open dialog when coalesce is set and may_wait allows blocking, and otherwise shows it
+ * through show with the message already expanded. options must already be prepared, and out_result reset.
+ */
+NmbResultCode nmb_message_template_show(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                        NmbShowFunction show, nmb_bool may_wait);
+
+#ifdef __cplusplus
+}
+#endif
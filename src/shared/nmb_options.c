@@ -0,0 +1,1454 @@
+#include "nmb_options.h"
+#include "nmb_alloc.h"
+#include "nmb_completion.h"
+#include "nmb_dialog_handle.h"
+#include "nmb_items.h"
+#include "nmb_mapped_file.h"
+#include "nmb_message_template.h"
+#include "nmb_runtime.h"
+#include "nmb_utf16.h"
+#include "nmb_utf8.h"
+
+#include <stdio.h>
+#include <string.h>
+
+enum
+{
+    NMB_TEXT_TITLE,
+    NMB_TEXT_MESSAGE,
+    NMB_TEXT_VERIFICATION,
+    NMB_TEXT_LOCALE,
+    NMB_TEXT_PROMPT,
+    NMB_TEXT_PLACEHOLDER,
+    NMB_TEXT_DEFAULT_VALUE,
+    NMB_TEXT_INFORMATIVE,
+    NMB_TEXT_EXPANDED,
+    NMB_TEXT_FOOTER,
+    NMB_TEXT_HELP_LINK,
+    NMB_TEXT_FIXED_COUNT
+};
+
+/* One caller-provided string in either encoding; data == NULL means "not provided". */
+typedef struct NmbTextSource_t
+{
+    const void* data;
+    size_t length;
+} NmbTextSource;
+
+/* Encoding-neutral view over NmbMessageBoxStrings or NmbMessageBoxStrings16. */
+typedef struct NmbTextTable_t
+{
+    NmbTextSource fixed[NMB_TEXT_FIXED_COUNT];
+    const void* button_labels;
+    const void* button_descriptions;
+    const void* combo_items;
+    size_t combo_item_count;
+    nmb_bool utf16;
+} NmbTextTable;
+
+typedef enum NmbSlotKind_t
+{
+    NMB_SLOT_UTF8_VIEW,  /* copy, validating (and repairing when allowed) */
+    NMB_SLOT_UTF16_VIEW, /* transcode; output is well-formed by construction */
+    NMB_SLOT_REPAIR      /* caller's NUL-terminated string failed validation; store a repaired copy */
+} NmbSlotKind;
+
+typedef struct NmbStringSlot_t
+{
+    const char** target;
+    NmbTextSource source;
+    NmbSlotKind kind;
+    const char* name;
+} NmbStringSlot;
+
+typedef struct NmbSlotList_t
+{
+    NmbStringSlot* items;
+    size_t count;
+} NmbSlotList;
+
+/* Result of validating the caller's NUL-terminated strings that are not overridden by a view. */
+typedef struct NmbTextScan_t
+{
+    uint32_t invalid_fixed; /* bit per NMB_TEXT_* index */
+    nmb_bool invalid_buttons;
+    nmb_bool invalid_combo;
+} NmbTextScan;
+
+static const char* const kTextNames[NMB_TEXT_FIXED_COUNT] = {
+    "title_utf8",         "message_utf8",           "verification_text_utf8", "locale_utf8",
+    "prompt_utf8",        "placeholder_utf8",       "default_value_utf8",     "informative_text_utf8",
+    "expanded_text_utf8", "footer_text_utf8",       "help_link_utf8"
+};
+
+static const size_t kFormFieldMinSize = offsetof(NmbInputOption, combo_items_utf8) + sizeof(const char* const*);
+static const size_t kTableMinSize = offsetof(NmbTableOption, row_count) + sizeof(size_t);
+static const size_t kAggregationMinSize = offsetof(NmbAggregationOption, summary_utf8) + sizeof(const char*);
+static const size_t kToastMinSize = offsetof(NmbToastOption, user_data) + sizeof(void*);
+static const size_t kTemplatedMessageMinSize = offsetof(NmbTemplatedMessage, coalesce) + sizeof(nmb_bool);
+static const size_t kStringsMinSize = offsetof(NmbMessageBoxStrings, help_link) + sizeof(NmbStringView);
+static const size_t kStrings16MinSize = offsetof(NmbMessageBoxStrings16, help_link) + sizeof(NmbStringView16);
+
+static size_t nmb_min_size(size_t a, size_t b)
+{
+    return a < b ? a : b;
+}
+
+static NmbResultCode nmb_invalid_strings(const char* message)
+{
+    nmb_runtime_log(message);
+    return NMB_E_INVALID_ARGUMENT;
+}
+
+#define NMB_TEXT_FROM_VIEW(source, view) ((source).data = (view).data, (source).length = (view).length)
+
+/* Copies a strings table of either encoding into an NmbTextTable; both tables share field names. */
+#define NMB_LOAD_TEXT_TABLE(table, strings)                                                         \
+    do                                                                                              \
+    {                                                                                               \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_TITLE], (strings)->title);                       \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_MESSAGE], (strings)->message);                   \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_VERIFICATION], (strings)->verification_text);    \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_LOCALE], (strings)->locale);                     \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_PROMPT], (strings)->input_prompt);               \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_PLACEHOLDER], (strings)->input_placeholder);     \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_DEFAULT_VALUE], (strings)->input_default_value); \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_INFORMATIVE], (strings)->informative_text);      \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_EXPANDED], (strings)->expanded_text);            \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_FOOTER], (strings)->footer_text);                \
+        NMB_TEXT_FROM_VIEW((table)->fixed[NMB_TEXT_HELP_LINK], (strings)->help_link);               \
+        (table)->button_labels = (strings)->button_labels;                                          \
+        (table)->button_descriptions = (strings)->button_descriptions;                              \
+        (table)->combo_items = (strings)->combo_items;                                              \
+        (table)->combo_item_count = (strings)->combo_item_count;                                    \
+    } while (0)
+
+static NmbResultCode nmb_load_text_table(const NmbMessageBoxOptions* options, NmbTextTable* table)
+{
+    memset(table, 0, sizeof(*table));
+    const nmb_bool wants_utf8 = (options->flags & NMB_MESSAGE_BOX_FLAG_STRING_VIEWS) ? NMB_TRUE : NMB_FALSE;
+    const nmb_bool wants_utf16 = (options->flags & NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS) ? NMB_TRUE : NMB_FALSE;
+
+    if (wants_utf8 && wants_utf16)
+    {
+        return nmb_invalid_strings(
+            "Runtime: NMB_MESSAGE_BOX_FLAG_STRING_VIEWS and NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS are mutually exclusive.");
+    }
+
+    if (wants_utf16)
+    {
+        const NmbMessageBoxStrings16* strings = NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, strings_utf16)
+                                                    ? options->strings_utf16
+                                                    : NULL;
+        if (!strings)
+        {
+            return nmb_invalid_strings(
+                "Runtime: NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS set without NmbMessageBoxOptions.strings_utf16.");
+        }
+
+        if (strings->struct_size < kStrings16MinSize)
+        {
+            return nmb_invalid_strings("Runtime: NmbMessageBoxStrings16.struct_size is smaller than expected.");
+        }
+
+        NMB_LOAD_TEXT_TABLE(table, strings);
+        table->utf16 = NMB_TRUE;
+        return NMB_OK;
+    }
+
+    const NmbMessageBoxStrings* strings = options->strings;
+    if (!strings)
+    {
+        return nmb_invalid_strings("Runtime: NMB_MESSAGE_BOX_FLAG_STRING_VIEWS set without NmbMessageBoxOptions.strings.");
+    }
+
+    if (strings->struct_size < kStringsMinSize)
+    {
+        return nmb_invalid_strings("Runtime: NmbMessageBoxStrings.struct_size is smaller than expected.");
+    }
+
+    NMB_LOAD_TEXT_TABLE(table, strings);
+    return NMB_OK;
+}
+
+static NmbTextSource nmb_text_at(const NmbTextTable* table, const void* array, size_t index)
+{
+    NmbTextSource source;
+    if (table->utf16)
+    {
+        const NmbStringView16* view = (const NmbStringView16*)array + index;
+        source.data = view->data;
+        source.length = view->length;
+    }
+    else
+    {
+        const NmbStringView* view = (const NmbStringView*)array + index;
+        source.data = view->data;
+        source.length = view->length;
+    }
+    return source;
+}
+
+/* Bytes needed to hold source as NUL-terminated UTF-8. */
+static size_t nmb_text_capacity(const NmbTextTable* table, NmbTextSource source)
+{
+    if (!source.data)
+    {
+        return 0;
+    }
+
+    return (table->utf16 ? NMB_UTF16_TO_UTF8_MAX(source.length) : source.length) + 1;
+}
+
+static NmbResultCode nmb_invalid_utf8(const char* name)
+{
+    char message[128];
+    snprintf(message, sizeof(message), "Runtime: %s is not valid UTF-8.", name);
+    return nmb_invalid_strings(message);
+}
+
+static nmb_bool nmb_text_is_valid(const char* text)
+{
+    return nmb_utf8_is_valid(text, strlen(text));
+}
+
+static void nmb_collect_borrowed(const NmbMessageBoxOptions* options, const char* borrowed[NMB_TEXT_FIXED_COUNT])
+{
+    memset(borrowed, 0, sizeof(const char*) * NMB_TEXT_FIXED_COUNT);
+    borrowed[NMB_TEXT_TITLE] = options->title_utf8;
+    borrowed[NMB_TEXT_MESSAGE] = options->message_utf8;
+    borrowed[NMB_TEXT_VERIFICATION] = options->verification_text_utf8;
+    borrowed[NMB_TEXT_LOCALE] = options->locale_utf8;
+    if (options->input)
+    {
+        borrowed[NMB_TEXT_PROMPT] = options->input->prompt_utf8;
+        borrowed[NMB_TEXT_PLACEHOLDER] = options->input->placeholder_utf8;
+        borrowed[NMB_TEXT_DEFAULT_VALUE] = options->input->default_value_utf8;
+    }
+    if (options->secondary)
+    {
+        borrowed[NMB_TEXT_INFORMATIVE] = options->secondary->informative_text_utf8;
+        borrowed[NMB_TEXT_EXPANDED] = options->secondary->expanded_text_utf8;
+        borrowed[NMB_TEXT_FOOTER] = options->secondary->footer_text_utf8;
+        borrowed[NMB_TEXT_HELP_LINK] = options->secondary->help_link_utf8;
+    }
+}
+
+/*
+ * Validates every NUL-terminated string the caller passed that no view overrides. Runs on every call,
+ * so it allocates nothing; ill-formed text either fails the call or is flagged for repair.
+ */
+static NmbResultCode nmb_scan_borrowed(const NmbMessageBoxOptions* options, const NmbTextTable* table,
+                                       const char* const borrowed[NMB_TEXT_FIXED_COUNT], nmb_bool repair,
+                                       NmbTextScan* scan)
+{
+    memset(scan, 0, sizeof(*scan));
+    for (size_t i = 0; i < NMB_TEXT_FIXED_COUNT; ++i)
+    {
+        if (table->fixed[i].data || !borrowed[i] || nmb_text_is_valid(borrowed[i]))
+        {
+            continue;
+        }
+
+        if (!repair)
+        {
+            return nmb_invalid_utf8(kTextNames[i]);
+        }
+        scan->invalid_fixed |= 1u << i;
+    }
+
+    for (size_t i = 0; options->buttons && i < options->button_count; ++i)
+    {
+        const NmbButtonOption* button = &options->buttons[i];
+        const NmbTextSource none = {0};
+        const NmbTextSource label = table->button_labels ? nmb_text_at(table, table->button_labels, i) : none;
+        const NmbTextSource description =
+            table->button_descriptions ? nmb_text_at(table, table->button_descriptions, i) : none;
+        const nmb_bool label_ok = (label.data || !button->label_utf8 || nmb_text_is_valid(button->label_utf8));
+        const nmb_bool description_ok =
+            (description.data || !button->description_utf8 || nmb_text_is_valid(button->description_utf8));
+        if (label_ok && description_ok)
+        {
+            continue;
+        }
+
+        if (!repair)
+        {
+            return nmb_invalid_utf8(label_ok ? "button description_utf8" : "button label_utf8");
+        }
+        scan->invalid_buttons = NMB_TRUE;
+    }
+
+    if (options->input && options->input->combo_items_utf8 && !table->combo_items)
+    {
+        for (const char* const* item = options->input->combo_items_utf8; *item; ++item)
+        {
+            if (nmb_text_is_valid(*item))
+            {
+                continue;
+            }
+
+            if (!repair)
+            {
+                return nmb_invalid_utf8("combo_items_utf8 entry");
+            }
+            scan->invalid_combo = NMB_TRUE;
+        }
+    }
+
+    return NMB_OK;
+}
+
+/*
+ * Registers target for materialization: a view always wins; otherwise the caller's own string is only
+ * copied when it needs repair, and valid strings keep pointing at caller memory.
+ */
+static void nmb_push_text(NmbSlotList* slots, const char** target, const NmbTextTable* table, NmbTextSource view,
+                          const char* borrowed, nmb_bool borrowed_invalid, const char* name)
+{
+    NmbStringSlot* slot = &slots->items[slots->count];
+    if (view.data)
+    {
+        slot->source = view;
+        slot->kind = table->utf16 ? NMB_SLOT_UTF16_VIEW : NMB_SLOT_UTF8_VIEW;
+    }
+    else if (borrowed && borrowed_invalid)
+    {
+        slot->source.data = borrowed;
+        slot->source.length = strlen(borrowed);
+        slot->kind = NMB_SLOT_REPAIR;
+    }
+    else
+    {
+        return;
+    }
+
+    slot->target = target;
+    slot->name = name;
+    ++slots->count;
+}
+
+static NmbResultCode nmb_materialize_slot(NmbArena* arena, const NmbStringSlot* slot, nmb_bool repair)
+{
+    const char* text = (const char*)slot->source.data;
+    const size_t length = slot->source.length;
+    char* copy = NULL;
+
+    if (slot->kind == NMB_SLOT_UTF16_VIEW)
+    {
+        copy = (char*)nmb_arena_alloc(arena, NMB_UTF16_TO_UTF8_MAX(length) + 1, 1);
+        if (copy)
+        {
+            copy[nmb_utf16_to_utf8((const uint16_t*)slot->source.data, length, copy)] = '\0';
+        }
+    }
+    else if (slot->kind == NMB_SLOT_UTF8_VIEW && nmb_utf8_is_valid(text, length))
+    {
+        copy = nmb_arena_copy_string(arena, text, length);
+    }
+    else
+    {
+        if (!repair)
+        {
+            return nmb_invalid_utf8(slot->name);
+        }
+
+        copy = (char*)nmb_arena_alloc(arena, NMB_UTF8_REPAIR_MAX(length) + 1, 1);
+        if (copy)
+        {
+            copy[nmb_utf8_repair(text, length, copy)] = '\0';
+        }
+    }
+
+    if (!copy)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    *slot->target = copy;
+    return NMB_OK;
+}
+
+static nmb_bool nmb_has_secondary_text(const NmbTextTable* table)
+{
+    return (table->fixed[NMB_TEXT_INFORMATIVE].data || table->fixed[NMB_TEXT_EXPANDED].data ||
+            table->fixed[NMB_TEXT_FOOTER].data || table->fixed[NMB_TEXT_HELP_LINK].data)
+               ? NMB_TRUE
+               : NMB_FALSE;
+}
+
+static size_t nmb_count_items(const char* const* items)
+{
+    size_t count = 0;
+    while (items && items[count])
+    {
+        ++count;
+    }
+    return count;
+}
+
+static const NmbItemBuffer* nmb_combo_item_buffer(const NmbInputOption* input)
+{
+    if (!input || (input->mode != NMB_INPUT_COMBO && input->mode != NMB_INPUT_MULTISELECT) ||
+        !NMB_STRUCT_HAS_FIELD(input, NmbInputOption, combo_item_buffer))
+    {
+        return NULL;
+    }
+    return input->combo_item_buffer;
+}
+
+/* Multiselect answers land in caller buffers, so their sizes are checked before any UI is built. */
+static NmbResultCode nmb_check_selection(const NmbInputOption* input, size_t item_count)
+{
+    if (!NMB_STRUCT_HAS_FIELD(input, NmbInputOption, selection_index_capacity))
+    {
+        return nmb_invalid_strings("Runtime: NmbInputOption is too small for NMB_INPUT_MULTISELECT.");
+    }
+
+    if (item_count > UINT32_MAX)
+    {
+        return nmb_invalid_strings("Runtime: NMB_INPUT_MULTISELECT supports at most UINT32_MAX items.");
+    }
+
+    if (!input->selection_bits && !input->selection_indices)
+    {
+        return nmb_invalid_strings("Runtime: NMB_INPUT_MULTISELECT needs selection_bits or selection_indices.");
+    }
+
+    if (input->selection_bits && input->selection_bits_size < (item_count + 7) / 8)
+    {
+        return nmb_invalid_strings("Runtime: NmbInputOption.selection_bits is smaller than the item list.");
+    }
+
+    if (!input->selection_indices && input->selection_index_capacity > 0)
+    {
+        return nmb_invalid_strings("Runtime: NmbInputOption.selection_index_capacity set without selection_indices.");
+    }
+
+    return NMB_OK;
+}
+
+static nmb_bool nmb_optional_text_is_valid(const char* text)
+{
+    return (!text || nmb_text_is_valid(text)) ? NMB_TRUE : NMB_FALSE;
+}
+
+/* Form fields are checked in place and never copied, so they must already be well-formed UTF-8. */
+static NmbResultCode nmb_check_form_fields(const NmbMessageBoxOptions* options)
+{
+    if (!NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, form_field_count) || options->form_field_count == 0)
+    {
+        return NMB_OK;
+    }
+
+    if (!options->form_fields)
+    {
+        return nmb_invalid_strings("Runtime: NmbMessageBoxOptions.form_field_count set without form_fields.");
+    }
+
+    if (options->input)
+    {
+        return nmb_invalid_strings("Runtime: NmbMessageBoxOptions.input and form_fields are mutually exclusive.");
+    }
+
+    for (size_t i = 0; i < options->form_field_count; ++i)
+    {
+        const NmbInputOption* field = &options->form_fields[i];
+        if (field->struct_size < kFormFieldMinSize)
+        {
+            return nmb_invalid_strings("Runtime: form field struct_size is smaller than expected.");
+        }
+
+        if (field->mode < NMB_INPUT_CHECKBOX || field->mode > NMB_INPUT_MULTILINE)
+        {
+            return nmb_invalid_strings("Runtime: form field mode is not a supported input mode.");
+        }
+
+        if (!nmb_optional_text_is_valid(field->prompt_utf8) || !nmb_optional_text_is_valid(field->placeholder_utf8) ||
+            !nmb_optional_text_is_valid(field->default_value_utf8))
+        {
+            return nmb_invalid_utf8("form field text");
+        }
+
+        for (const char* const* item = field->combo_items_utf8; item && *item; ++item)
+        {
+            if (!nmb_text_is_valid(*item))
+            {
+                return nmb_invalid_utf8("form field combo_items_utf8 entry");
+            }
+        }
+    }
+
+    return NMB_OK;
+}
+
+/* Table cells are borrowed for the lifetime of the dialog and never copied, so they are only validated. */
+static NmbResultCode nmb_check_table(const NmbMessageBoxOptions* options)
+{
+    const NmbTableOption* table = nmb_table(options);
+    if (!table)
+    {
+        return NMB_OK;
+    }
+
+    if (table->struct_size < kTableMinSize)
+    {
+        return nmb_invalid_strings("Runtime: NmbTableOption.struct_size is smaller than expected.");
+    }
+
+    if (table->column_count == 0 || !table->columns || !table->column_headers_utf8)
+    {
+        return nmb_invalid_strings("Runtime: NmbTableOption needs column_headers_utf8 and at least one column.");
+    }
+
+    if (table->row_count > UINT32_MAX)
+    {
+        return nmb_invalid_strings("Runtime: NmbTableOption supports at most UINT32_MAX rows.");
+    }
+
+    for (size_t c = 0; c < table->column_count; ++c)
+    {
+        if (!nmb_optional_text_is_valid(table->column_headers_utf8[c]))
+        {
+            return nmb_invalid_utf8("table column header");
+        }
+
+        nmb_bool valid = NMB_TRUE;
+        NmbResultCode rc = nmb_item_buffer_check(&table->columns[c], &valid);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+        if (!valid)
+        {
+            return nmb_invalid_utf8("table cell");
+        }
+        if (table->columns[c].item_count != table->row_count)
+        {
+            return nmb_invalid_strings("Runtime: every NmbTableOption column must hold row_count cells.");
+        }
+    }
+
+    return NMB_OK;
+}
+
+/* Every caller of a burst receives one shared button, so requests that answer with text of their own are refused. */
+static NmbResultCode nmb_check_aggregation(const NmbMessageBoxOptions* options)
+{
+    const NmbAggregationOption* aggregation = nmb_aggregation(options);
+    if (!aggregation)
+    {
+        return NMB_OK;
+    }
+
+    if (aggregation->struct_size < kAggregationMinSize)
+    {
+        return nmb_invalid_strings("Runtime: NmbAggregationOption.struct_size is smaller than expected.");
+    }
+
+    if (!aggregation->category_utf8)
+    {
+        return nmb_invalid_strings("Runtime: NmbAggregationOption.category_utf8 is required.");
+    }
+
+    size_t field_count = 0;
+    if (options->input || nmb_form_fields(options, &field_count) || nmb_table(options))
+    {
+        return nmb_invalid_strings("Runtime: aggregated requests cannot carry input, form fields or a table.");
+    }
+
+    if (!nmb_text_is_valid(aggregation->category_utf8) || !nmb_optional_text_is_valid(aggregation->detail_utf8) ||
+        !nmb_optional_text_is_valid(aggregation->summary_utf8))
+    {
+        return nmb_invalid_utf8("aggregation text");
+    }
+
+    return NMB_OK;
+}
+
+/* A toast returns before anyone answers it, so it cannot collect input or wait for a burst. */
+static NmbResultCode nmb_check_toast(const NmbMessageBoxOptions* options)
+{
+    const NmbToastOption* toast = nmb_toast(options);
+    if (!toast)
+    {
+        return NMB_OK;
+    }
+
+    if (toast->struct_size < kToastMinSize)
+    {
+        return nmb_invalid_strings("Runtime: NmbToastOption.struct_size is smaller than expected.");
+    }
+
+    size_t field_count = 0;
+    if (options->input || nmb_form_fields(options, &field_count) || nmb_table(options) || nmb_aggregation(options))
+    {
+        return nmb_invalid_strings("Runtime: toasts cannot carry input, form fields, a table or aggregation.");
+    }
+
+    return NMB_OK;
+}
+
+static NmbResultCode nmb_check_templated_message(const NmbMessageBoxOptions* options)
+{
+    const NmbTemplatedMessage* templated = nmb_templated_message(options);
+    if (!templated)
+    {
+        return NMB_OK;
+    }
+
+    if (templated->struct_size < kTemplatedMessageMinSize)
+    {
+        return nmb_invalid_strings("Runtime: NmbTemplatedMessage.struct_size is smaller than expected.");
+    }
+
+    if (!nmb_message_template_is_valid(templated->message_template))
+    {
+        return nmb_invalid_strings("Runtime: NmbTemplatedMessage.message_template is not a live message template.");
+    }
+
+    const size_t argument_count = nmb_message_template_argument_count(templated->message_template);
+    if (templated->argument_count < argument_count || (argument_count > 0 && !templated->arguments))
+    {
+        return nmb_invalid_strings("Runtime: NmbTemplatedMessage supplies fewer arguments than its placeholders.");
+    }
+
+    for (size_t i = 0; i < argument_count; ++i)
+    {
+        const NmbStringView* argument = &templated->arguments[i];
+        if ((!argument->data && argument->length > 0) ||
+            (argument->data && !nmb_utf8_is_valid(argument->data, argument->length)))
+        {
+            return nmb_invalid_utf8("templated message argument");
+        }
+    }
+
+    return NMB_OK;
+}
+
+static NmbResultCode nmb_expand_templated_message(NmbPreparedOptions* prepared);
+
+static NmbResultCode nmb_prepare(const NmbMessageBoxOptions* options, NmbPreparedOptions* prepared,
+                                 nmb_bool renders_utf16)
+{
+    if (!options || !prepared)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    memset(prepared, 0, sizeof(*prepared));
+    prepared->options = options;
+    nmb_arena_init(&prepared->arena, options->allocator);
+
+    const uint32_t flags = NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, flags) ? options->flags : 0;
+    const nmb_bool repair = (flags & NMB_MESSAGE_BOX_FLAG_STRICT_UTF8) ? NMB_FALSE : NMB_TRUE;
+    const nmb_bool has_views =
+        (NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, strings) &&
+         (flags & (NMB_MESSAGE_BOX_FLAG_STRING_VIEWS | NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS)) != 0)
+            ? NMB_TRUE
+            : NMB_FALSE;
+
+    NmbTextTable table;
+    memset(&table, 0, sizeof(table));
+    NmbResultCode rc = has_views ? nmb_load_text_table(options, &table) : NMB_OK;
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    const char* borrowed[NMB_TEXT_FIXED_COUNT];
+    nmb_collect_borrowed(options, borrowed);
+
+    NmbTextScan scan;
+    rc = nmb_scan_borrowed(options, &table, borrowed, repair, &scan);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    rc = nmb_check_form_fields(options);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    rc = nmb_check_table(options);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    rc = nmb_check_aggregation(options);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    rc = nmb_check_toast(options);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    rc = nmb_check_templated_message(options);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    const NmbItemBuffer* item_buffer = nmb_combo_item_buffer(options->input);
+    nmb_bool items_valid = NMB_TRUE;
+    if (item_buffer)
+    {
+        rc = nmb_item_buffer_check(item_buffer, &items_valid);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+        if (!items_valid && !repair)
+        {
+            return nmb_invalid_utf8("combo_item_buffer");
+        }
+    }
+
+    if (options->input && NMB_STRUCT_HAS_FIELD(options->input, NmbInputOption, completion_index) &&
+        options->input->completion_index && !nmb_completion_index_is_valid(options->input->completion_index))
+    {
+        nmb_runtime_log("Runtime: NmbInputOption.completion_index is not a live completion index.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const NmbSecondaryContentOption* secondary = options->secondary;
+    const NmbContentSource* source =
+        (secondary && NMB_STRUCT_HAS_FIELD(secondary, NmbSecondaryContentOption, expanded_text_source))
+            ? secondary->expanded_text_source
+            : NULL;
+    if (nmb_content_source_follows(source) && source->kind != NMB_CONTENT_SOURCE_PATH)
+    {
+        return nmb_invalid_strings("Runtime: following an NmbContentSource requires NMB_CONTENT_SOURCE_PATH.");
+    }
+
+    const NmbDialogHandle* dialog_handle = nmb_dialog_handle(options);
+    if (dialog_handle && !nmb_dialog_handle_is_valid(dialog_handle))
+    {
+        nmb_runtime_log("Runtime: NmbMessageBoxOptions.dialog_handle is not a live dialog handle.");
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    if (options->input && options->input->mode == NMB_INPUT_MULTISELECT)
+    {
+        const size_t item_count = item_buffer         ? item_buffer->item_count
+                                  : table.combo_items ? table.combo_item_count
+                                                      : nmb_count_items(options->input->combo_items_utf8);
+        rc = nmb_check_selection(options->input, item_count);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+    }
+
+    if (!has_views && scan.invalid_fixed == 0 && !scan.invalid_buttons && !scan.invalid_combo && items_valid)
+    {
+        return nmb_expand_templated_message(prepared);
+    }
+
+    if (table.utf16)
+    {
+        prepared->strings_utf16 = options->strings_utf16;
+    }
+
+    /* Templates, bursts and toasts re-enter the backend with the resolved UTF-8 options, so they keep it. */
+    const nmb_bool defer_utf16 = (renders_utf16 && table.utf16 && !nmb_templated_message(options) &&
+                                  !nmb_aggregation(options) && !nmb_toast(options))
+                                     ? NMB_TRUE
+                                     : NMB_FALSE;
+
+    const nmb_bool has_buttons = (options->buttons && options->button_count > 0) ? NMB_TRUE : NMB_FALSE;
+    const nmb_bool copy_buttons =
+        (has_buttons && (table.button_labels || table.button_descriptions || scan.invalid_buttons)) ? NMB_TRUE
+                                                                                                    : NMB_FALSE;
+    const nmb_bool has_combo_views = (options->input && table.combo_items) ? NMB_TRUE : NMB_FALSE;
+    const nmb_bool copy_combo = (has_combo_views || scan.invalid_combo) ? NMB_TRUE : NMB_FALSE;
+    const size_t combo_count = has_combo_views ? table.combo_item_count
+                               : scan.invalid_combo ? nmb_count_items(options->input->combo_items_utf8)
+                                                    : 0;
+    const size_t button_count = copy_buttons ? options->button_count : 0;
+    const size_t slot_capacity = NMB_TEXT_FIXED_COUNT + button_count * 2 + combo_count;
+
+    /*
+     * Size the arena once so that every view and array lands in a single block; only repaired copies,
+     * whose size is not known up front, may spill into a second one.
+     */
+    size_t total = slot_capacity * sizeof(NmbStringSlot) + button_count * sizeof(NmbButtonOption) +
+                   (copy_combo ? (combo_count + 1) * sizeof(const char*) : 0) + 4 * sizeof(void*);
+    for (size_t i = 0; !defer_utf16 && i < NMB_TEXT_FIXED_COUNT; ++i)
+    {
+        total += nmb_text_capacity(&table, table.fixed[i]);
+    }
+    for (size_t i = 0; i < button_count; ++i)
+    {
+        if (table.button_labels)
+        {
+            total += nmb_text_capacity(&table, nmb_text_at(&table, table.button_labels, i));
+        }
+        if (table.button_descriptions)
+        {
+            total += nmb_text_capacity(&table, nmb_text_at(&table, table.button_descriptions, i));
+        }
+    }
+    for (size_t i = 0; has_combo_views && i < combo_count; ++i)
+    {
+        total += nmb_text_capacity(&table, nmb_text_at(&table, table.combo_items, i)) + 1;
+    }
+
+    rc = nmb_arena_reserve(&prepared->arena, total);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    memcpy(&prepared->resolved, options, nmb_min_size(options->struct_size, sizeof(prepared->resolved)));
+    prepared->resolved.struct_size = sizeof(prepared->resolved);
+    prepared->resolved.flags &= ~(uint32_t)(NMB_MESSAGE_BOX_FLAG_STRING_VIEWS | NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS);
+    prepared->resolved.strings = NULL;
+    prepared->resolved.strings_utf16 = NULL;
+
+    if (options->input)
+    {
+        memcpy(&prepared->input, options->input, nmb_min_size(options->input->struct_size, sizeof(prepared->input)));
+        prepared->input.struct_size = sizeof(prepared->input);
+        prepared->resolved.input = &prepared->input;
+    }
+
+    if (!items_valid)
+    {
+        rc = nmb_item_buffer_repair(item_buffer, &prepared->arena, &prepared->items);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+        prepared->input.combo_item_buffer = &prepared->items;
+    }
+
+    if (options->secondary)
+    {
+        memcpy(&prepared->secondary, options->secondary,
+               nmb_min_size(options->secondary->struct_size, sizeof(prepared->secondary)));
+        prepared->secondary.struct_size = sizeof(prepared->secondary);
+        prepared->resolved.secondary = &prepared->secondary;
+    }
+    else if (nmb_has_secondary_text(&table))
+    {
+        prepared->secondary.struct_size = sizeof(prepared->secondary);
+        prepared->resolved.secondary = &prepared->secondary;
+    }
+
+    NmbSlotList slots;
+    slots.count = 0;
+    slots.items =
+        (NmbStringSlot*)nmb_arena_alloc(&prepared->arena, slot_capacity * sizeof(NmbStringSlot), sizeof(void*));
+    if (!slots.items)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    const char** targets[NMB_TEXT_FIXED_COUNT] = {
+        &prepared->resolved.title_utf8,          &prepared->resolved.message_utf8,
+        &prepared->resolved.verification_text_utf8, &prepared->resolved.locale_utf8,
+        &prepared->input.prompt_utf8,            &prepared->input.placeholder_utf8,
+        &prepared->input.default_value_utf8,     &prepared->secondary.informative_text_utf8,
+        &prepared->secondary.expanded_text_utf8, &prepared->secondary.footer_text_utf8,
+        &prepared->secondary.help_link_utf8
+    };
+    for (size_t i = 0; i < NMB_TEXT_FIXED_COUNT; ++i)
+    {
+        const nmb_bool is_input = (i >= NMB_TEXT_PROMPT && i <= NMB_TEXT_DEFAULT_VALUE) ? NMB_TRUE : NMB_FALSE;
+        const nmb_bool is_secondary = (i >= NMB_TEXT_INFORMATIVE) ? NMB_TRUE : NMB_FALSE;
+        if ((is_input && !options->input) || (is_secondary && !prepared->resolved.secondary))
+        {
+            continue;
+        }
+
+        if (defer_utf16 && table.fixed[i].data)
+        {
+            *targets[i] = NULL;
+            continue;
+        }
+
+        nmb_push_text(&slots, targets[i], &table, table.fixed[i], borrowed[i],
+                      (scan.invalid_fixed & (1u << i)) ? NMB_TRUE : NMB_FALSE, kTextNames[i]);
+    }
+
+    if (copy_buttons)
+    {
+        NmbButtonOption* buttons = (NmbButtonOption*)nmb_arena_alloc(
+            &prepared->arena, button_count * sizeof(NmbButtonOption), sizeof(void*));
+        if (!buttons)
+        {
+            return NMB_E_OUT_OF_MEMORY;
+        }
+
+        memcpy(buttons, options->buttons, button_count * sizeof(NmbButtonOption));
+        for (size_t i = 0; i < button_count; ++i)
+        {
+            const NmbTextSource none = {0};
+            const char* label = buttons[i].label_utf8;
+            const char* description = buttons[i].description_utf8;
+            nmb_push_text(&slots, &buttons[i].label_utf8, &table,
+                          table.button_labels ? nmb_text_at(&table, table.button_labels, i) : none, label,
+                          (scan.invalid_buttons && label && !nmb_text_is_valid(label)) ? NMB_TRUE : NMB_FALSE,
+                          "button label_utf8");
+            nmb_push_text(&slots, &buttons[i].description_utf8, &table,
+                          table.button_descriptions ? nmb_text_at(&table, table.button_descriptions, i) : none,
+                          description,
+                          (scan.invalid_buttons && description && !nmb_text_is_valid(description)) ? NMB_TRUE
+                                                                                                    : NMB_FALSE,
+                          "button description_utf8");
+        }
+        prepared->resolved.buttons = buttons;
+    }
+
+    if (copy_combo)
+    {
+        const char** items =
+            (const char**)nmb_arena_alloc(&prepared->arena, (combo_count + 1) * sizeof(const char*), sizeof(void*));
+        if (!items)
+        {
+            return NMB_E_OUT_OF_MEMORY;
+        }
+
+        for (size_t i = 0; i < combo_count; ++i)
+        {
+            if (!has_combo_views)
+            {
+                const char* item = options->input->combo_items_utf8[i];
+                items[i] = item;
+                const NmbTextSource none = {0};
+                nmb_push_text(&slots, &items[i], &table, none, item,
+                              nmb_text_is_valid(item) ? NMB_FALSE : NMB_TRUE, "combo_items_utf8 entry");
+                continue;
+            }
+
+            NmbTextSource item = nmb_text_at(&table, table.combo_items, i);
+            if (!item.data)
+            {
+                item.data = "";
+                item.length = 0;
+            }
+            nmb_push_text(&slots, &items[i], &table, item, NULL, NMB_FALSE, "combo item view");
+        }
+        items[combo_count] = NULL;
+        prepared->input.combo_items_utf8 = items;
+    }
+
+    for (size_t i = 0; i < slots.count; ++i)
+    {
+        rc = nmb_materialize_slot(&prepared->arena, &slots.items[i], repair);
+        if (rc != NMB_OK)
+        {
+            return rc;
+        }
+    }
+
+    prepared->options = &prepared->resolved;
+    return nmb_expand_templated_message(prepared);
+}
+
+NmbResultCode nmb_prepare_options(const NmbMessageBoxOptions* options, NmbPreparedOptions* prepared)
+{
+    return nmb_prepare(options, prepared, NMB_FALSE);
+}
+
+NmbResultCode nmb_prepare_options_utf16(const NmbMessageBoxOptions* options, NmbPreparedOptions* prepared)
+{
+    return nmb_prepare(options, prepared, NMB_TRUE);
+}
+
+/* Moves a passthrough result onto the resolved copies so that a backend-specific step can rewrite fields. */
+static void nmb_prepared_detach(NmbPreparedOptions* prepared)
+{
+    const NmbMessageBoxOptions* options = prepared->options;
+    if (options == &prepared->resolved)
+    {
+        return;
+    }
+
+    memcpy(&prepared->resolved, options, nmb_min_size(options->struct_size, sizeof(prepared->resolved)));
+    prepared->resolved.struct_size = sizeof(prepared->resolved);
+    if (options->input)
+    {
+        memcpy(&prepared->input, options->input, nmb_min_size(options->input->struct_size, sizeof(prepared->input)));
+        prepared->input.struct_size = sizeof(prepared->input);
+        prepared->resolved.input = &prepared->input;
+    }
+    if (options->secondary)
+    {
+        memcpy(&prepared->secondary, options->secondary,
+               nmb_min_size(options->secondary->struct_size, sizeof(prepared->secondary)));
+        prepared->secondary.struct_size = sizeof(prepared->secondary);
+        prepared->resolved.secondary = &prepared->secondary;
+    }
+    prepared->options = &prepared->resolved;
+}
+
+/* Writes the template's text into message_utf8; the template stays attached for nmb_message_template_show. */
+static NmbResultCode nmb_expand_templated_message(NmbPreparedOptions* prepared)
+{
+    const NmbTemplatedMessage* templated = nmb_templated_message(prepared->options);
+    if (!templated)
+    {
+        return NMB_OK;
+    }
+
+    if (prepared->options->message_utf8)
+    {
+        return nmb_invalid_strings("Runtime: a templated message replaces message_utf8, which must be NULL.");
+    }
+
+    nmb_prepared_detach(prepared);
+    return nmb_message_template_expand(templated->message_template, templated->arguments, &prepared->arena,
+                                       &prepared->resolved.message_utf8);
+}
+
+NmbResultCode nmb_inline_expanded_source(NmbPreparedOptions* prepared, size_t limit)
+{
+    if (!prepared || !prepared->options)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const NmbSecondaryContentOption* secondary = prepared->options->secondary;
+    if (!secondary || !NMB_STRUCT_HAS_FIELD(secondary, NmbSecondaryContentOption, expanded_text_source) ||
+        !secondary->expanded_text_source)
+    {
+        return NMB_OK;
+    }
+
+    if (nmb_content_source_follows(secondary->expanded_text_source))
+    {
+        nmb_runtime_log("Runtime: this backend cannot follow a growing file; the expanded text is a snapshot.");
+    }
+
+    NmbMappedFile file;
+    NmbResultCode rc = nmb_mapped_file_open(secondary->expanded_text_source, &file);
+    if (rc != NMB_OK)
+    {
+        return rc;
+    }
+
+    nmb_prepared_detach(prepared);
+
+    static const char kTruncated[] = "\n\xE2\x80\xA6";
+    const size_t take = nmb_text_chunk_end(file.data, file.length, limit);
+    const nmb_bool truncated = take < file.length ? NMB_TRUE : NMB_FALSE;
+    const nmb_bool valid = nmb_utf8_is_valid(file.data, take);
+    char* text = (char*)nmb_arena_alloc(&prepared->arena,
+                                        (valid ? take : NMB_UTF8_REPAIR_MAX(take)) + sizeof(kTruncated), 1);
+    if (!text)
+    {
+        nmb_mapped_file_close(&file);
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    size_t written = take;
+    if (valid)
+    {
+        memcpy(text, file.data, take);
+    }
+    else
+    {
+        written = nmb_utf8_repair(file.data, take, text);
+    }
+    nmb_mapped_file_close(&file);
+
+    if (truncated)
+    {
+        memcpy(text + written, kTruncated, sizeof(kTruncated) - 1);
+        written += sizeof(kTruncated) - 1;
+    }
+    text[written] = '\0';
+
+    prepared->secondary.expanded_text_utf8 = text;
+    prepared->secondary.expanded_text_source = NULL;
+    return NMB_OK;
+}
+
+static const char* nmb_table_header(const NmbTableOption* table, size_t column)
+{
+    const char* header = table->column_headers_utf8[column];
+    return header ? header : "";
+}
+
+/* Bytes of one tab-separated line including its line break; row == row_count stands for the header line. */
+static size_t nmb_table_line_length(const NmbTableOption* table, size_t row)
+{
+    const nmb_bool header = row == table->row_count;
+    size_t length = table->column_count;
+    for (size_t c = 0; c < table->column_count; ++c)
+    {
+        length += header ? strlen(nmb_table_header(table, c)) : nmb_item_length(&table->columns[c], row);
+    }
+    return length;
+}
+
+static char* nmb_table_put_line(const NmbTableOption* table, size_t row, char* out)
+{
+    const nmb_bool header = row == table->row_count;
+    for (size_t c = 0; c < table->column_count; ++c)
+    {
+        const char* cell = header ? nmb_table_header(table, c) : nmb_item_data(&table->columns[c], row);
+        const size_t length = header ? strlen(cell) : nmb_item_length(&table->columns[c], row);
+        for (size_t i = 0; i < length; ++i)
+        {
+            const char ch = cell[i];
+            *out++ = (ch == '\t' || ch == '\n' || ch == '\r') ? ' ' : ch;
+        }
+        *out++ = c + 1 < table->column_count ? '\t' : '\n';
+    }
+    return out;
+}
+
+NmbResultCode nmb_inline_table(NmbPreparedOptions* prepared, size_t limit)
+{
+    if (!prepared || !prepared->options)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const NmbTableOption* table = nmb_table(prepared->options);
+    if (!table)
+    {
+        return NMB_OK;
+    }
+
+    nmb_prepared_detach(prepared);
+
+    /* The header always fits; rows are taken whole until the next one would pass limit. */
+    static const char kTruncated[] = "\xE2\x80\xA6";
+    size_t used = nmb_table_line_length(table, table->row_count);
+    size_t rows = 0;
+    for (; rows < table->row_count; ++rows)
+    {
+        const size_t line = nmb_table_line_length(table, rows);
+        if (used + line > limit)
+        {
+            break;
+        }
+        used += line;
+    }
+
+    const char* existing = prepared->resolved.secondary ? prepared->secondary.expanded_text_utf8 : NULL;
+    const size_t existing_length = existing ? strlen(existing) : 0;
+    char* text = (char*)nmb_arena_alloc(&prepared->arena, existing_length + 2 + used + sizeof(kTruncated), 1);
+    if (!text)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    char* out = text;
+    if (existing_length > 0)
+    {
+        memcpy(out, existing, existing_length);
+        out += existing_length;
+        *out++ = '\n';
+        *out++ = '\n';
+    }
+    out = nmb_table_put_line(table, table->row_count, out);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        out = nmb_table_put_line(table, row, out);
+    }
+    if (rows < table->row_count)
+    {
+        memcpy(out, kTruncated, sizeof(kTruncated) - 1);
+        out += sizeof(kTruncated) - 1;
+    }
+    else
+    {
+        --out;
+    }
+    *out = '\0';
+
+    prepared->secondary.struct_size = sizeof(prepared->secondary);
+    prepared->secondary.expanded_text_utf8 = text;
+    prepared->resolved.secondary = &prepared->secondary;
+    prepared->resolved.table = NULL;
+    return NMB_OK;
+}
+
+NmbResultCode nmb_expand_combo_buffer(NmbPreparedOptions* prepared)
+{
+    if (!prepared || !prepared->options)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    const NmbItemBuffer* items = nmb_combo_item_buffer(prepared->options->input);
+    if (!items)
+    {
+        return NMB_OK;
+    }
+
+    nmb_prepared_detach(prepared);
+
+    const size_t count = items->item_count;
+    const size_t total = count == 0 ? 0 : (size_t)(items->offsets[count] - items->offsets[0]);
+    const char** pointers = (const char**)nmb_arena_alloc(&prepared->arena, (count + 1) * sizeof(const char*),
+                                                          sizeof(void*));
+    char* text = (char*)nmb_arena_alloc(&prepared->arena, total + count + 1, 1);
+    if (!pointers || !text)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t length = nmb_item_length(items, i);
+        memcpy(text, nmb_item_data(items, i), length);
+        text[length] = '\0';
+        pointers[i] = text;
+        text += length + 1;
+    }
+    pointers[count] = NULL;
+
+    prepared->input.combo_items_utf8 = pointers;
+    prepared->input.combo_item_buffer = NULL;
+    return NMB_OK;
+}
+
+void nmb_release_prepared_options(NmbPreparedOptions* prepared)
+{
+    if (!prepared)
+    {
+        return;
+    }
+
+    nmb_arena_release(&prepared->arena);
+    prepared->options = NULL;
+    prepared->strings_utf16 = NULL;
+}
+
+NmbInputChunkCallback nmb_input_chunk_callback(const NmbInputOption* input)
+{
+    if (!input || input->mode != NMB_INPUT_MULTILINE ||
+        !NMB_STRUCT_HAS_FIELD(input, NmbInputOption, input_chunk_user_data))
+    {
+        return NULL;
+    }
+    return input->input_chunk_callback;
+}
+
+NmbResultCode nmb_deliver_input_text(const NmbMessageBoxOptions* options, const char* text, size_t length,
+                                     NmbMessageBoxResult* out_result)
+{
+    out_result->input_value_utf8 = NULL;
+    if (!text)
+    {
+        return NMB_OK;
+    }
+
+    NmbInputChunkCallback callback = nmb_input_chunk_callback(options->input);
+    if (callback)
+    {
+        for (size_t offset = 0; offset < length;)
+        {
+            const size_t chunk = nmb_text_chunk_end(text + offset, length - offset, NMB_INPUT_CHUNK_BYTES);
+            NmbResultCode rc = callback(options->input->input_chunk_user_data, text + offset, chunk);
+            if (rc != NMB_OK)
+            {
+                return rc;
+            }
+            offset += chunk;
+        }
+        return NMB_OK;
+    }
+
+    char* copy = (char*)nmb_allocate(options->allocator, length + 1, 1);
+    if (!copy)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    out_result->input_value_utf8 = copy;
+    return NMB_OK;
+}
+
+const NmbTableOption* nmb_table(const NmbMessageBoxOptions* options)
+{
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, table))
+    {
+        return NULL;
+    }
+    return options->table;
+}
+
+const NmbAggregationOption* nmb_aggregation(const NmbMessageBoxOptions* options)
+{
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, aggregation))
+    {
+        return NULL;
+    }
+    return options->aggregation;
+}
+
+const NmbToastOption* nmb_toast(const NmbMessageBoxOptions* options)
+{
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, toast))
+    {
+        return NULL;
+    }
+    return options->toast;
+}
+
+const NmbTemplatedMessage* nmb_templated_message(const NmbMessageBoxOptions* options)
+{
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, templated_message))
+    {
+        return NULL;
+    }
+    return options->templated_message;
+}
+
+NmbDialogHandle* nmb_dialog_handle(const NmbMessageBoxOptions* options)
+{
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, dialog_handle))
+    {
+        return NULL;
+    }
+    return options->dialog_handle;
+}
+
+const NmbInputOption* nmb_form_fields(const NmbMessageBoxOptions* options, size_t* count)
+{
+    *count = 0;
+    if (!options || !NMB_STRUCT_HAS_FIELD(options, NmbMessageBoxOptions, form_field_count) || !options->form_fields)
+    {
+        return NULL;
+    }
+
+    *count = options->form_field_count;
+    return *count > 0 ? options->form_fields : NULL;
+}
+
+NmbResultCode nmb_reset_result(const NmbMessageBoxOptions* options, NmbMessageBoxResult* result)
+{
+    result->button = NMB_BUTTON_ID_NONE;
+    result->checkbox_checked = NMB_FALSE;
+    result->input_value_utf8 = NULL;
+    result->was_timeout = NMB_FALSE;
+    result->result_code = NMB_OK;
+
+    size_t field_count = 0;
+    if (NMB_STRUCT_HAS_FIELD(result, NmbMessageBoxResult, field_value_count))
+    {
+        result->field_values = NULL;
+        result->field_value_count = 0;
+    }
+    else if (nmb_form_fields(options, &field_count))
+    {
+        return nmb_invalid_strings("Runtime: NmbMessageBoxResult is too small to return form field values.");
+    }
+
+    if (NMB_STRUCT_HAS_FIELD(result, NmbMessageBoxResult, selection_count))
+    {
+        result->selection_count = 0;
+    }
+
+    return NMB_OK;
+}
+
+NmbResultCode nmb_store_field_values(const NmbMessageBoxOptions* options, const NmbFieldValue* answers, size_t count,
+                                     NmbMessageBoxResult* out_result)
+{
+    size_t field_count = 0;
+    if (!nmb_form_fields(options, &field_count))
+    {
+        return NMB_OK;
+    }
+
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < field_count; ++i)
+    {
+        text_bytes += ((i < count && answers[i].value_utf8) ? answers[i].length : 0) + 1;
+    }
+
+    NmbFieldValue* values = (NmbFieldValue*)nmb_allocate(options->allocator,
+                                                         field_count * sizeof(NmbFieldValue) + text_bytes,
+                                                         sizeof(void*));
+    if (!values)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+
+    char* text = (char*)(values + field_count);
+    for (size_t i = 0; i < field_count; ++i)
+    {
+        const size_t length = (i < count && answers[i].value_utf8) ? answers[i].length : 0;
+        if (length > 0)
+        {
+            memcpy(text, answers[i].value_utf8, length);
+        }
+        text[length] = '\0';
+        values[i].value_utf8 = text;
+        values[i].length = length;
+        values[i].checked = (i < count && answers[i].checked) ? NMB_TRUE : NMB_FALSE;
+        text += length + 1;
+    }
+
+    out_result->field_values = values;
+    out_result->field_value_count = field_count;
+    return NMB_OK;
+}
+
+size_t nmb_input_item_count(const NmbInputOption* input)
+{
+    const NmbItemBuffer* items = nmb_combo_item_buffer(input);
+    if (items)
+    {
+        return items->item_count;
+    }
+    return input ? nmb_count_items(input->combo_items_utf8) : 0;
+}
+
+void nmb_store_selection(const NmbMessageBoxOptions* options, const uint8_t* bits, NmbMessageBoxResult* out_result)
+{
+    const NmbInputOption* input = options->input;
+    if (!input || input->mode != NMB_INPUT_MULTISELECT || !bits)
+    {
+        return;
+    }
+
+    const size_t item_count = nmb_input_item_count(input);
+    const size_t byte_count = (item_count + 7) / 8;
+    size_t selected = 0;
+    for (size_t byte = 0; byte < byte_count; ++byte)
+    {
+        /* Bits past the last item are never reported, whatever the backend left in them. */
+        const size_t tail = item_count - byte * 8;
+        unsigned value = bits[byte] & (tail >= 8 ? 0xFFu : (1u << tail) - 1u);
+        if (input->selection_bits)
+        {
+            input->selection_bits[byte] = (uint8_t)value;
+        }
+
+        /* Whole bytes of unchecked items are skipped, so sparse picks from long lists cost one test per 8 items. */
+        for (uint32_t bit = 0; value != 0; ++bit, value >>= 1)
+        {
+            if ((value & 1u) == 0)
+            {
+                continue;
+            }
+            if (selected < input->selection_index_capacity)
+            {
+                input->selection_indices[selected] = (uint32_t)(byte * 8 + bit);
+            }
+            ++selected;
+        }
+    }
+
+    if (NMB_STRUCT_HAS_FIELD(out_result, NmbMessageBoxResult, selection_count))
+    {
+        out_result->selection_count = selected;
+    }
+}
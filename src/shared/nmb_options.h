@@ -0,0 +1,137 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Options as seen by a backend after the shared runtime has normalized the caller's struct.
+ * When the caller used only NUL-terminated strings, options points straight at the caller's
+ * struct and nothing is copied; otherwise it points at resolved, whose strings live in arena.
+ */
+typedef struct NmbPreparedOptions_t
+{
+    const NmbMessageBoxOptions* options;
+    NmbMessageBoxOptions resolved;
+    NmbInputOption input;
+    NmbSecondaryContentOption secondary;
+    /** Repaired copy of input->combo_item_buffer when the caller's items were ill-formed UTF-8. */
+    NmbItemBuffer items;
+    /** Caller's UTF-16 table when NMB_MESSAGE_BOX_FLAG_UTF16_STRINGS was set, for backends that render UTF-16. */
+    const NmbMessageBoxStrings16* strings_utf16;
+    NmbArena arena;
+} NmbPreparedOptions;
+
+/** Largest prefix of an expanded_text_source that nmb_inline_expanded_source copies into memory. */
+#define NMB_EXPANDED_SOURCE_INLINE_LIMIT ((size_t)1024u * 1024u)
+
+NmbResultCode nmb_prepare_options(const NmbMessageBoxOptions* options, NmbPreparedOptions* prepared);
+
+/**
+ * For backends that render strings_utf16 themselves: like nmb_prepare_options, but a title, message, input or
+ * secondary text given as a UTF-16 view is not transcoded and its UTF-8 field is left NULL; read it from
+ * prepared->strings_utf16 instead. Button labels and combo items are still transcoded, as are all views of a
+ * templated, aggregated or toast request.
+ */
+NmbResultCode nmb_prepare_options_utf16(const NmbMessageBoxOptions* options, NmbPreparedOptions* prepared);
+
+/**
+ * For backends that cannot stream file content into their UI: replaces secondary->expanded_text_source
+ * with an in-memory expanded_text_utf8 holding at most limit bytes of the file (cut at a line or
+ * character boundary and marked when truncated). No-op when no source was supplied.
+ */
+NmbResultCode nmb_inline_expanded_source(NmbPreparedOptions* prepared, size_t limit);
+
+/**
+ * For backends whose combo controls take one string per item: replaces input->combo_item_buffer with an
+ * equivalent NULL-terminated combo_items_utf8 array, built with one allocation for all item text.
+ * No-op when no buffer was supplied.
+ */
+NmbResultCode nmb_expand_combo_buffer(NmbPreparedOptions* prepared);
+
+/** Largest piece handed to an NmbInputChunkCallback at once. */
+#define NMB_INPUT_CHUNK_BYTES ((size_t)64u * 1024u)
+
+/** The chunk callback of a multiline prompt, or NULL when the answer goes to input_value_utf8. */
+NmbInputChunkCallback nmb_input_chunk_callback(const NmbInputOption* input);
+
+/**
+ * Delivers a finished answer: in pieces of at most NMB_INPUT_CHUNK_BYTES to the chunk callback when one
+ * is set, otherwise as a single allocator copy in out_result->input_value_utf8.
+ */
+NmbResultCode nmb_deliver_input_text(const NmbMessageBoxOptions* options, const char* text, size_t length,
+                                     NmbMessageBoxResult* out_result);
+
+/**
+ * For backends without a table control: renders options->table as tab-separated lines of at most limit bytes
+ * (cut at a row boundary and marked when truncated), appends them to secondary->expanded_text_utf8 and clears
+ * table. Tabs and line breaks inside cells become spaces. No-op when no table was supplied.
+ */
+NmbResultCode nmb_inline_table(NmbPreparedOptions* prepared, size_t limit);
+
+/** The table of options, or NULL when none was supplied. */
+const NmbTableOption* nmb_table(const NmbMessageBoxOptions* options);
+
+/** The aggregation option of options, or NULL when the request is shown on its own. */
+const NmbAggregationOption* nmb_aggregation(const NmbMessageBoxOptions* options);
+
+/** The toast option of options, or NULL when the request is shown as a dialog. */
+const NmbToastOption* nmb_toast(const NmbMessageBoxOptions* options);
+
+/** The templated message of options, or NULL when message_utf8 is used as given. */
+const NmbTemplatedMessage* nmb_templated_message(const NmbMessageBoxOptions* options);
+
+/** The live-update handle of options, or NULL when the dialog cannot be changed while it shows. */
+NmbDialogHandle* nmb_dialog_handle(const NmbMessageBoxOptions* options);
+
+/** The form fields of options, or NULL with *count set to 0 when the call is not a form. */
+const NmbInputOption* nmb_form_fields(const NmbMessageBoxOptions* options, size_t* count);
+
+/**
+ * Clears every output field that result->struct_size covers. The caller's struct_size is kept, so fields
+ * appended after the caller was compiled are never written. Fails when options describe a form and result
+ * is too small to carry field_values.
+ */
+NmbResultCode nmb_reset_result(const NmbMessageBoxOptions* options, NmbMessageBoxResult* result);
+
+/**
+ * Stores one answer per form field in out_result->field_values: the array and the NUL-terminated text in a
+ * single allocator block. answers holds count entries in field order; fields past count answer empty.
+ * No-op when the call is not a form.
+ */
+NmbResultCode nmb_store_field_values(const NmbMessageBoxOptions* options, const NmbFieldValue* answers, size_t count,
+                                     NmbMessageBoxResult* out_result);
+
+/** Number of items a combo or multiselect input offers, whether passed as combo_item_buffer or combo_items_utf8. */
+size_t nmb_input_item_count(const NmbInputOption* input);
+
+/**
+ * Delivers a finished multiselect answer without allocating. bits holds one bit per item, laid out as
+ * NmbInputOption.selection_bits; it is copied to the caller's bitset, the checked items are listed in
+ * selection_indices, and out_result->selection_count is set. No-op unless the input is NMB_INPUT_MULTISELECT.
+ */
+void nmb_store_selection(const NmbMessageBoxOptions* options, const uint8_t* bits, NmbMessageBoxResult* out_result);
+
+void nmb_release_prepared_options(NmbPreparedOptions* prepared);
+
+#ifdef __cplusplus
+}
+
+/** Releases the prepared options when the backend entry point returns. */
+struct NmbPreparedOptionsScope
+{
+    NmbPreparedOptions value = {};
+
+    NmbPreparedOptionsScope() = default;
+    NmbPreparedOptionsScope(const NmbPreparedOptionsScope&) = delete;
+    NmbPreparedOptionsScope& operator=(const NmbPreparedOptionsScope&) = delete;
+
+    ~NmbPreparedOptionsScope()
+    {
+        nmb_release_prepared_options(&value);
+    }
+};
+#endif
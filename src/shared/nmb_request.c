@@ -0,0 +1,162 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "nmb_request.h"
+#include "nmb_alloc.h"
+#include "nmb_runtime.h"
+#include "nmb_thread.h"
+
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define NMB_REQUEST_MAGIC 0x4E4D4252u /* 'NMBR' */
+
+struct NmbRequest_t
+{
+    uint32_t magic;
+    nmb_bool done; /* guarded by s_lock */
+    NmbMessageBoxResult* result;
+};
+
+static NmbMutex s_lock = NMB_MUTEX_INIT;
+static int s_event_fd = -1;
+#if !defined(__linux__) && !defined(_WIN32)
+static int s_signal_fd = -1; /* write end of the pipe */
+#endif
+
+int nmb_event_fd(void)
+{
+    nmb_mutex_lock(&s_lock);
+    if (s_event_fd < 0)
+    {
+#if defined(__linux__)
+        s_event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#elif !defined(_WIN32)
+        int fds[2];
+        if (pipe(fds) == 0)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+                fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+            }
+            s_event_fd = fds[0];
+            s_signal_fd = fds[1];
+        }
+#endif
+        if (s_event_fd < 0)
+        {
+            nmb_runtime_log("Runtime: no event fd is available on this platform.");
+        }
+    }
+    const int fd = s_event_fd;
+    nmb_mutex_unlock(&s_lock);
+    return fd;
+}
+
+void nmb_event_fd_signal(void)
+{
+#if defined(__linux__)
+    const int fd = nmb_event_fd();
+    const uint64_t one = 1;
+    if (fd >= 0 && write(fd, &one, sizeof(one)) < 0)
+    {
+        /* The counter is already far from zero; the fd stays readable either way. */
+    }
+#elif !defined(_WIN32)
+    if (nmb_event_fd() >= 0)
+    {
+        const char one = 1;
+        if (write(s_signal_fd, &one, 1) < 0)
+        {
+            /* A full pipe is readable already. */
+        }
+    }
+#endif
+}
+
+void nmb_event_fd_drain(void)
+{
+#if !defined(_WIN32)
+    const int fd = nmb_event_fd();
+    char buffer[64];
+    while (fd >= 0 && read(fd, buffer, sizeof(buffer)) > 0)
+    {
+    }
+#endif
+}
+
+static void NMB_CALL nmb_request_complete(void* user_data, NmbMessageBoxResult* result)
+{
+    NmbRequest* request = (NmbRequest*)user_data;
+    (void)result;
+    nmb_mutex_lock(&s_lock);
+    request->done = NMB_TRUE;
+    nmb_mutex_unlock(&s_lock);
+    nmb_event_fd_signal();
+}
+
+NmbResultCode nmb_request_submit(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                 NmbRequest** out_request, NmbShowAsyncFunction show_async)
+{
+    if (!out_request)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    *out_request = NULL;
+
+    NmbRequest* request = (NmbRequest*)nmb_default_alloc(sizeof(NmbRequest));
+    if (!request)
+    {
+        return NMB_E_OUT_OF_MEMORY;
+    }
+    request->magic = NMB_REQUEST_MAGIC;
+    request->done = NMB_FALSE;
+    request->result = out_result;
+
+    const NmbResultCode rc = show_async(options, out_result, nmb_request_complete, request);
+    if (rc != NMB_OK)
+    {
+        request->magic = 0;
+        nmb_default_free(request);
+        return rc;
+    }
+
+    *out_request = request;
+    return NMB_OK;
+}
+
+NMB_API NmbResultCode NMB_CALL nmb_poll_result(NmbRequest* request, nmb_bool* out_done)
+{
+    if (!out_done)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+    *out_done = NMB_FALSE;
+    if (!request || request->magic != NMB_REQUEST_MAGIC)
+    {
+        return NMB_E_INVALID_ARGUMENT;
+    }
+
+    nmb_mutex_lock(&s_lock);
+    const nmb_bool done = request->done;
+    nmb_mutex_unlock(&s_lock);
+    if (!done)
+    {
+        return NMB_OK;
+    }
+
+    *out_done = NMB_TRUE;
+    const NmbResultCode rc = request->result->result_code;
+    request->magic = 0;
+    nmb_default_free(request);
+    return rc;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A backend's nmb_show_message_box_async, used to start a pollable request. */
+typedef NmbResultCode(NMB_CALL* NmbShowAsyncFunction)(const NmbMessageBoxOptions* options,
+                                                      NmbMessageBoxResult* out_result,
+                                                      NmbMessageBoxCallback callback, void* user_data);
+
+/**
+ * Starts a request through show_async and hands back a handle for nmb_poll_result. Completion signals the
+ * event fd, so hosts polling it learn about the result without a callback.
+ */
+NmbResultCode nmb_request_submit(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                 NmbRequest** out_request, NmbShowAsyncFunction show_async);
+
+/**
+ * The runtime's event fd: an eventfd on Linux and Android, the read end of a pipe on other POSIX systems, and
+ * -1 where neither exists. Created on first use and kept for the life of the process.
+ */
+int nmb_event_fd(void);
+
+/** Makes the event fd readable; safe from any thread. */
+void nmb_event_fd_signal(void);
+
+/** Clears pending signals so the event fd blocks again until the next one. */
+void nmb_event_fd_drain(void);
+
+#ifdef __cplusplus
+}
+#endif
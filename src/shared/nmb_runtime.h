@@ -2,6 +2,12 @@
 
 #include "native_message_box.h"
 
+#include <stddef.h>
+
+/** True when a caller-supplied struct is large enough to contain the given field. */
+#define NMB_STRUCT_HAS_FIELD(ptr, type, field) \
+    ((ptr)->struct_size >= offsetof(type, field) + sizeof(((const type*)0)->field))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
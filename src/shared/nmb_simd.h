@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+ * Compile-time SIMD selection shared by the text kernels. SSE2 and NEON are part of the x86-64 and
+ * AArch64 baselines and are used unconditionally; AVX2 is compiled as a separate target on GCC/Clang
+ * and picked at run time, or used directly when the whole build already targets it (MSVC /arch:AVX2).
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define NMB_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define NMB_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(NMB_SIMD_SSE2) && defined(__AVX2__)
+#define NMB_SIMD_AVX2 1
+#define NMB_SIMD_AVX2_TARGET
+#include <immintrin.h>
+#elif defined(NMB_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define NMB_SIMD_AVX2 1
+#define NMB_SIMD_AVX2_DISPATCH 1
+#define NMB_SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+#if defined(NMB_SIMD_AVX2_DISPATCH)
+static inline int nmb_simd_has_avx2(void)
+{
+    static int cached = -1;
+    if (cached < 0)
+    {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached;
+}
+#elif defined(NMB_SIMD_AVX2)
+static inline int nmb_simd_has_avx2(void)
+{
+    return 1;
+}
+#endif
@@ -0,0 +1,87 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "nmb_thread.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <time.h>
+#endif
+
+#if defined(_WIN32)
+void nmb_mutex_init(NmbMutex* mutex)
+{
+    InitializeSRWLock(mutex);
+}
+
+void nmb_mutex_destroy(NmbMutex* mutex)
+{
+    (void)mutex;
+}
+
+void nmb_mutex_lock(NmbMutex* mutex)
+{
+    AcquireSRWLockExclusive(mutex);
+}
+
+void nmb_mutex_unlock(NmbMutex* mutex)
+{
+    ReleaseSRWLockExclusive(mutex);
+}
+
+void nmb_condition_wait(NmbCondition* condition, NmbMutex* mutex)
+{
+    SleepConditionVariableSRW(condition, mutex, INFINITE, 0);
+}
+
+void nmb_condition_broadcast(NmbCondition* condition)
+{
+    WakeAllConditionVariable(condition);
+}
+
+void nmb_sleep_milliseconds(uint32_t milliseconds)
+{
+    Sleep(milliseconds);
+}
+#else
+void nmb_mutex_init(NmbMutex* mutex)
+{
+    pthread_mutex_init(mutex, NULL);
+}
+
+void nmb_mutex_destroy(NmbMutex* mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+void nmb_mutex_lock(NmbMutex* mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+void nmb_mutex_unlock(NmbMutex* mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+void nmb_condition_wait(NmbCondition* condition, NmbMutex* mutex)
+{
+    pthread_cond_wait(condition, mutex);
+}
+
+void nmb_condition_broadcast(NmbCondition* condition)
+{
+    pthread_cond_broadcast(condition);
+}
+
+void nmb_sleep_milliseconds(uint32_t milliseconds)
+{
+    struct timespec remaining;
+    remaining.tv_sec = (time_t)(milliseconds / 1000u);
+    remaining.tv_nsec = (long)(milliseconds % 1000u) * 1000000L;
+    while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR)
+    {
+    }
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Minimal locking for shared runtime state: SRW locks on Windows, pthreads elsewhere. */
+#if defined(_WIN32)
+typedef SRWLOCK NmbMutex;
+typedef CONDITION_VARIABLE NmbCondition;
+#define NMB_MUTEX_INIT SRWLOCK_INIT
+#define NMB_CONDITION_INIT CONDITION_VARIABLE_INIT
+#else
+typedef pthread_mutex_t NmbMutex;
+typedef pthread_cond_t NmbCondition;
+#define NMB_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define NMB_CONDITION_INIT PTHREAD_COND_INITIALIZER
+#endif
+
+void nmb_mutex_init(NmbMutex* mutex);
+void nmb_mutex_destroy(NmbMutex* mutex);
+void nmb_mutex_lock(NmbMutex* mutex);
+void nmb_mutex_unlock(NmbMutex* mutex);
+
+/** Releases mutex while waiting and holds it again on return; callers re-check their predicate. */
+void nmb_condition_wait(NmbCondition* condition, NmbMutex* mutex);
+void nmb_condition_broadcast(NmbCondition* condition);
+
+/** Blocks the calling thread for at least milliseconds. */
+void nmb_sleep_milliseconds(uint32_t milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,193 @@
+#include "nmb_timer_wheel.h"
+
+#include <string.h>
+
+#define NMB_TIMER_WHEEL_MASK ((uint64_t)NMB_TIMER_WHEEL_SLOTS - 1u)
+
+/* Ticks a timer may be ahead of the wheel; later deadlines wait in the last slot and are placed again. */
+#define NMB_TIMER_WHEEL_SPAN ((uint64_t)1u << (NMB_TIMER_WHEEL_LEVELS * NMB_TIMER_WHEEL_SLOT_BITS))
+
+static void nmb_timer_link(NmbTimer** head, NmbTimer* timer)
+{
+    timer->next = *head;
+    if (timer->next)
+    {
+        timer->next->link = &timer->next;
+    }
+    timer->link = head;
+    *head = timer;
+}
+
+static void nmb_timer_unlink(NmbTimer* timer)
+{
+    *timer->link = timer->next;
+    if (timer->next)
+    {
+        timer->next->link = timer->link;
+    }
+    timer->next = NULL;
+    timer->link = NULL;
+}
+
+/* Picks the level whose slots are just fine enough for the distance to the deadline. */
+static void nmb_timer_wheel_place(NmbTimerWheel* wheel, NmbTimer* timer)
+{
+    uint64_t deadline = timer->deadline;
+    if (deadline - wheel->tick >= NMB_TIMER_WHEEL_SPAN)
+    {
+        deadline = wheel->tick + NMB_TIMER_WHEEL_SPAN - 1u;
+    }
+
+    const uint64_t delta = deadline - wheel->tick;
+    unsigned level = 0;
+    while (level + 1 < NMB_TIMER_WHEEL_LEVELS && (delta >> ((level + 1) * NMB_TIMER_WHEEL_SLOT_BITS)) != 0)
+    {
+        ++level;
+    }
+    const size_t slot = (size_t)((deadline >> (level * NMB_TIMER_WHEEL_SLOT_BITS)) & NMB_TIMER_WHEEL_MASK);
+    nmb_timer_link(&wheel->slots[level][slot], timer);
+}
+
+/* Moves the timers of one upper-level slot down, now that its span has come up. */
+static void nmb_timer_wheel_cascade(NmbTimerWheel* wheel, unsigned level, size_t slot)
+{
+    NmbTimer* timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    while (timer)
+    {
+        NmbTimer* next = timer->next;
+        timer->next = NULL;
+        nmb_timer_wheel_place(wheel, timer);
+        timer = next;
+    }
+}
+
+void nmb_timer_wheel_init(NmbTimerWheel* wheel, uint32_t tick_milliseconds, uint64_t now_milliseconds)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->tick_milliseconds = tick_milliseconds > 0 ? tick_milliseconds : 1u;
+    wheel->tick = now_milliseconds / wheel->tick_milliseconds + 1u;
+}
+
+void nmb_timer_init(NmbTimer* timer, NmbTimerCallback callback, void* user_data)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = callback;
+    timer->user_data = user_data;
+}
+
+nmb_bool nmb_timer_is_pending(const NmbTimer* timer)
+{
+    return timer->link ? NMB_TRUE : NMB_FALSE;
+}
+
+void nmb_timer_wheel_schedule(NmbTimerWheel* wheel, NmbTimer* timer, uint64_t deadline_milliseconds)
+{
+    nmb_timer_wheel_cancel(wheel, timer);
+
+    const uint64_t tick_milliseconds = wheel->tick_milliseconds;
+    const uint64_t deadline = (deadline_milliseconds + tick_milliseconds - 1u) / tick_milliseconds;
+    timer->deadline = deadline < wheel->tick ? wheel->tick : deadline;
+    nmb_timer_wheel_place(wheel, timer);
+    ++wheel->count;
+}
+
+void nmb_timer_wheel_cancel(NmbTimerWheel* wheel, NmbTimer* timer)
+{
+    if (timer->link)
+    {
+        nmb_timer_unlink(timer);
+        --wheel->count;
+    }
+}
+
+size_t nmb_timer_wheel_advance(NmbTimerWheel* wheel, uint64_t now_milliseconds)
+{
+    const uint64_t last = now_milliseconds / wheel->tick_milliseconds;
+    size_t fired = 0;
+    while (wheel->tick <= last)
+    {
+        if (wheel->count == 0)
+        {
+            /* Nothing to cascade or fire: skip the idle stretch in one step. */
+            wheel->tick = last + 1u;
+            break;
+        }
+
+        for (unsigned level = 1; level < NMB_TIMER_WHEEL_LEVELS; ++level)
+        {
+            const unsigned shift = (level - 1) * NMB_TIMER_WHEEL_SLOT_BITS;
+            if (((wheel->tick >> shift) & NMB_TIMER_WHEEL_MASK) != 0)
+            {
+                break;
+            }
+            const uint64_t span = wheel->tick >> (level * NMB_TIMER_WHEEL_SLOT_BITS);
+            nmb_timer_wheel_cascade(wheel, level, (size_t)(span & NMB_TIMER_WHEEL_MASK));
+        }
+
+        /* Detach the due slot first, so callbacks that schedule for this tick land on the next one. */
+        NmbTimer** slot = &wheel->slots[0][wheel->tick & NMB_TIMER_WHEEL_MASK];
+        NmbTimer* due = *slot;
+        *slot = NULL;
+        if (due)
+        {
+            due->link = &due;
+        }
+        ++wheel->tick;
+
+        while (due)
+        {
+            NmbTimer* timer = due;
+            nmb_timer_unlink(timer);
+            --wheel->count;
+            ++fired;
+            if (timer->callback)
+            {
+                timer->callback(timer->user_data);
+            }
+        }
+    }
+    return fired;
+}
+
+nmb_bool nmb_timer_wheel_next_deadline(const NmbTimerWheel* wheel, uint64_t* out_milliseconds)
+{
+    if (wheel->count == 0)
+    {
+        return NMB_FALSE;
+    }
+
+    /*
+     * Level 0 holds the next 64 ticks one per slot. Above it, the slot of the current span was emptied when the
+     * span began, so the first occupied slot after it holds the level's earliest timers.
+     */
+    uint64_t best = UINT64_MAX;
+    for (uint64_t i = 0; i < NMB_TIMER_WHEEL_SLOTS && best == UINT64_MAX; ++i)
+    {
+        if (wheel->slots[0][(wheel->tick + i) & NMB_TIMER_WHEEL_MASK])
+        {
+            best = wheel->tick + i;
+        }
+    }
+
+    for (unsigned level = 1; level < NMB_TIMER_WHEEL_LEVELS; ++level)
+    {
+        const uint64_t span = wheel->tick >> (level * NMB_TIMER_WHEEL_SLOT_BITS);
+        for (uint64_t i = 1; i <= NMB_TIMER_WHEEL_SLOTS; ++i)
+        {
+            const NmbTimer* timer = wheel->slots[level][(span + i) & NMB_TIMER_WHEEL_MASK];
+            if (!timer)
+            {
+                continue;
+            }
+            for (; timer; timer = timer->next)
+            {
+                best = timer->deadline < best ? timer->deadline : best;
+            }
+            break;
+        }
+    }
+
+    *out_milliseconds = best * wheel->tick_milliseconds;
+    return NMB_TRUE;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NMB_TIMER_WHEEL_LEVELS 4
+#define NMB_TIMER_WHEEL_SLOT_BITS 6
+#define NMB_TIMER_WHEEL_SLOTS (1u << NMB_TIMER_WHEEL_SLOT_BITS)
+
+typedef void (*NmbTimerCallback)(void* user_data);
+
+/** One deadline. Owned by the caller and linked into a wheel while pending; zero-initialize or nmb_timer_init it. */
+typedef struct NmbTimer_t
+{
+    uint64_t deadline; /* in ticks */
+    NmbTimerCallback callback;
+    void* user_data;
+    struct NmbTimer_t* next;
+    struct NmbTimer_t** link; /* the pointer that points at this timer; NULL when not pending */
+} NmbTimer;
+
+/**
+ * Hierarchical timer wheel: four levels of 64 slots, each level 64 times coarser than the one below. Adding,
+ * cancelling and firing a timer cost O(1); a timer far ahead is moved down a level only when its slot comes up.
+ * Time is passed in by the caller in milliseconds, so the wheel runs the same against a real or a virtual clock.
+ * Deadlines round up to whole ticks, which lets every timer due within one tick share one wakeup.
+ * Not thread-safe: one thread owns a wheel.
+ */
+typedef struct NmbTimerWheel_t
+{
+    uint32_t tick_milliseconds;
+    uint64_t tick; /* next tick to run; every earlier tick has fired */
+    size_t count;  /* pending timers */
+    NmbTimer* slots[NMB_TIMER_WHEEL_LEVELS][NMB_TIMER_WHEEL_SLOTS];
+} NmbTimerWheel;
+
+void nmb_timer_wheel_init(NmbTimerWheel* wheel, uint32_t tick_milliseconds, uint64_t now_milliseconds);
+
+void nmb_timer_init(NmbTimer* timer, NmbTimerCallback callback, void* user_data);
+
+nmb_bool nmb_timer_is_pending(const NmbTimer* timer);
+
+/**
+ * Arms timer to fire on the first tick at or after deadline_milliseconds, moving it if it is already pending.
+ * A deadline in the past fires on the next tick.
+ */
+void nmb_timer_wheel_schedule(NmbTimerWheel* wheel, NmbTimer* timer, uint64_t deadline_milliseconds);
+
+/** Disarms timer; does nothing when it is not pending. */
+void nmb_timer_wheel_cancel(NmbTimerWheel* wheel, NmbTimer* timer);
+
+/**
+ * Runs every tick up to now_milliseconds and fires the timers due on them, tick by tick. Callbacks may
+ * schedule and cancel any timer, including their own. Returns the number of timers fired.
+ */
+size_t nmb_timer_wheel_advance(NmbTimerWheel* wheel, uint64_t now_milliseconds);
+
+/** When a timer is pending, stores the tick boundary of the earliest one in out_milliseconds. */
+nmb_bool nmb_timer_wheel_next_deadline(const NmbTimerWheel* wheel, uint64_t* out_milliseconds);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+#include "nmb_timing.h"
+#include "nmb_clock.h"
+#include "nmb_runtime.h"
+
+#include <string.h>
+
+/* The timing fields were added together, so backend (the last of them) gates them all. */
+static nmb_bool nmb_has_timing(const NmbMessageBoxResult* result)
+{
+    return NMB_STRUCT_HAS_FIELD(result, NmbMessageBoxResult, backend) ? NMB_TRUE : NMB_FALSE;
+}
+
+void nmb_timing_begin(NmbMessageBoxResult* result, uint64_t received_microseconds)
+{
+    if (!nmb_has_timing(result))
+    {
+        return;
+    }
+
+    result->received_microseconds = received_microseconds;
+    result->validated_microseconds = nmb_clock_now_microseconds();
+    result->built_microseconds = 0;
+    result->mapped_microseconds = 0;
+    result->responded_microseconds = 0;
+    result->backend = NMB_BACKEND_UNKNOWN;
+}
+
+void nmb_timing_mark(NmbMessageBoxResult* result, NmbTimingStage stage)
+{
+    if (!nmb_has_timing(result))
+    {
+        return;
+    }
+
+    uint64_t* field = stage == NMB_TIMING_BUILT    ? &result->built_microseconds
+                      : stage == NMB_TIMING_MAPPED ? &result->mapped_microseconds
+                                                   : &result->responded_microseconds;
+    if (*field == 0)
+    {
+        *field = nmb_clock_now_microseconds();
+    }
+}
+
+void nmb_timing_finish(NmbMessageBoxResult* result, NmbBackend backend)
+{
+    nmb_timing_mark(result, NMB_TIMING_RESPONDED);
+    if (nmb_has_timing(result))
+    {
+        result->backend = backend;
+    }
+}
+
+NmbResultCode nmb_timing_reenter(NmbShowFunction show, const NmbMessageBoxOptions* options,
+                                 NmbMessageBoxResult* result)
+{
+    if (!nmb_has_timing(result))
+    {
+        return show(options, result);
+    }
+
+    const uint64_t received = result->received_microseconds;
+    const uint64_t validated = result->validated_microseconds;
+    const NmbResultCode rc = show(options, result);
+    result->received_microseconds = received;
+    result->validated_microseconds = validated;
+    return rc;
+}
+
+void nmb_timing_save(const NmbMessageBoxResult* result, NmbDialogTiming* out_timing)
+{
+    memset(out_timing, 0, sizeof(*out_timing));
+    if (nmb_has_timing(result))
+    {
+        out_timing->built_microseconds = result->built_microseconds;
+        out_timing->mapped_microseconds = result->mapped_microseconds;
+        out_timing->responded_microseconds = result->responded_microseconds;
+        out_timing->backend = result->backend;
+    }
+}
+
+void nmb_timing_load(NmbMessageBoxResult* result, const NmbDialogTiming* timing)
+{
+    if (nmb_has_timing(result))
+    {
+        result->built_microseconds = timing->built_microseconds;
+        result->mapped_microseconds = timing->mapped_microseconds;
+        result->responded_microseconds = timing->responded_microseconds;
+        result->backend = timing->backend;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_aggregate.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Stages a backend reports in NmbMessageBoxResult after nmb_timing_begin. */
+typedef enum NmbTimingStage_t
+{
+    NMB_TIMING_BUILT = 0,
+    NMB_TIMING_MAPPED = 1,
+    NMB_TIMING_RESPONDED = 2
+} NmbTimingStage;
+
+/** What a dialog reported, kept for callers that share it without showing their own. */
+typedef struct NmbDialogTiming_t
+{
+    uint64_t built_microseconds;
+    uint64_t mapped_microseconds;
+    uint64_t responded_microseconds;
+    NmbBackend backend;
+} NmbDialogTiming;
+
+/**
+ * Called once the result is reset: stores received_microseconds (read from nmb_clock_now_microseconds when the
+ * call entered the runtime), stamps validation and clears the later stages. Results too small for the timing
+ * fields are left alone by every call here.
+ */
+void nmb_timing_begin(NmbMessageBoxResult* result, uint64_t received_microseconds);
+
+/** Stamps stage unless it was already stamped, so repeated map events and responses keep the first. */
+void nmb_timing_mark(NmbMessageBoxResult* result, NmbTimingStage stage);
+
+/** Records which backend answered and stamps the response if the backend did not do so itself. */
+void nmb_timing_finish(NmbMessageBoxResult* result, NmbBackend backend);
+
+/** Re-enters show for a request that was already received and validated, keeping its first two stamps. */
+NmbResultCode nmb_timing_reenter(NmbShowFunction show, const NmbMessageBoxOptions* options,
+                                 NmbMessageBoxResult* result);
+
+void nmb_timing_save(const NmbMessageBoxResult* result, NmbDialogTiming* out_timing);
+
+/** Copies a shared dialog's stages and backend into result, leaving its own received and validated stamps. */
+void nmb_timing_load(NmbMessageBoxResult* result, const NmbDialogTiming* timing);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+#include "nmb_toast.h"
+#include "nmb_options.h"
+#include "nmb_runtime.h"
+#include "nmb_timing.h"
+
+#include <string.h>
+
+NmbResultCode nmb_toast_show_modal(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                   NmbShowFunction show)
+{
+    const NmbToastOption* toast = nmb_toast(options);
+    nmb_runtime_log("Runtime: toasts are not supported by this backend; showing a modal dialog instead.");
+
+    NmbMessageBoxOptions modal;
+    memset(&modal, 0, sizeof(modal));
+    memcpy(&modal, options, options->struct_size < sizeof(modal) ? options->struct_size : sizeof(modal));
+    modal.struct_size = sizeof(modal);
+    modal.toast = NULL;
+
+    const NmbResultCode rc = nmb_timing_reenter(show, &modal, out_result);
+    if (toast->callback)
+    {
+        toast->callback(toast->user_data, rc == NMB_OK ? out_result->button : NMB_BUTTON_ID_NONE);
+    }
+    return rc;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "native_message_box.h"
+#include "nmb_aggregate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * For backends without toasts: shows a request that carries an NmbToastOption as an ordinary modal dialog
+ * through show, then reports its button to the toast callback, so callers get one callback on every
+ * platform. options must already be prepared, and out_result reset.
+ */
+NmbResultCode nmb_toast_show_modal(const NmbMessageBoxOptions* options, NmbMessageBoxResult* out_result,
+                                   NmbShowFunction show);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,134 @@
+#include "nmb_utf16.h"
+#include "nmb_simd.h"
+
+/* Encodes the code point starting at src[*index] and advances *index past it. */
+static unsigned char* nmb_utf16_encode_one(const uint16_t* src, size_t length, size_t* index, unsigned char* out)
+{
+    uint32_t c = src[(*index)++];
+    if (c < 0x80u)
+    {
+        *out++ = (unsigned char)c;
+        return out;
+    }
+
+    if (c < 0x800u)
+    {
+        *out++ = (unsigned char)(0xC0u | (c >> 6));
+        *out++ = (unsigned char)(0x80u | (c & 0x3Fu));
+        return out;
+    }
+
+    if (c >= 0xD800u && c <= 0xDFFFu)
+    {
+        if (c <= 0xDBFFu && *index < length && src[*index] >= 0xDC00u && src[*index] <= 0xDFFFu)
+        {
+            uint32_t cp = 0x10000u + ((c - 0xD800u) << 10) + (uint32_t)(src[(*index)++] - 0xDC00u);
+            *out++ = (unsigned char)(0xF0u | (cp >> 18));
+            *out++ = (unsigned char)(0x80u | ((cp >> 12) & 0x3Fu));
+            *out++ = (unsigned char)(0x80u | ((cp >> 6) & 0x3Fu));
+            *out++ = (unsigned char)(0x80u | (cp & 0x3Fu));
+            return out;
+        }
+
+        c = 0xFFFDu;
+    }
+
+    *out++ = (unsigned char)(0xE0u | (c >> 12));
+    *out++ = (unsigned char)(0x80u | ((c >> 6) & 0x3Fu));
+    *out++ = (unsigned char)(0x80u | (c & 0x3Fu));
+    return out;
+}
+
+/* Converts everything up to block_end one code point at a time; a trailing surrogate pair may overrun it by one unit. */
+static unsigned char* nmb_utf16_encode_block(const uint16_t* src, size_t length, size_t* index, size_t block_end,
+                                             unsigned char* out)
+{
+    while (*index < block_end)
+    {
+        out = nmb_utf16_encode_one(src, length, index, out);
+    }
+    return out;
+}
+
+size_t nmb_utf16_to_utf8_scalar(const uint16_t* src, size_t length, char* dst)
+{
+    unsigned char* out = (unsigned char*)dst;
+    size_t i = 0;
+    out = nmb_utf16_encode_block(src, length, &i, length, out);
+    return (size_t)(out - (unsigned char*)dst);
+}
+
+#if defined(NMB_SIMD_AVX2)
+NMB_SIMD_AVX2_TARGET
+static void nmb_utf16_to_utf8_avx2(const uint16_t* src, size_t length, size_t* index, unsigned char** out)
+{
+    const __m256i non_ascii = _mm256_set1_epi16((short)0xFF80);
+    size_t i = *index;
+    unsigned char* o = *out;
+    while (i + 16 <= length)
+    {
+        __m256i units = _mm256_loadu_si256((const __m256i*)(src + i));
+        if (!_mm256_testz_si256(units, non_ascii))
+        {
+            o = nmb_utf16_encode_block(src, length, &i, i + 16, o);
+            continue;
+        }
+
+        /* packus narrows within each 128-bit lane; gather the two low quadwords into one 16-byte run. */
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(units, units), 0x08);
+        _mm_storeu_si128((__m128i*)o, _mm256_castsi256_si128(packed));
+        o += 16;
+        i += 16;
+    }
+    *index = i;
+    *out = o;
+}
+#endif
+
+size_t nmb_utf16_to_utf8(const uint16_t* src, size_t length, char* dst)
+{
+    unsigned char* out = (unsigned char*)dst;
+    size_t i = 0;
+
+#if defined(NMB_SIMD_AVX2)
+    if (nmb_simd_has_avx2())
+    {
+        nmb_utf16_to_utf8_avx2(src, length, &i, &out);
+    }
+#endif
+
+#if defined(NMB_SIMD_SSE2)
+    const __m128i non_ascii = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 8 <= length)
+    {
+        __m128i units = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, non_ascii), zero)) != 0xFFFF)
+        {
+            out = nmb_utf16_encode_block(src, length, &i, i + 8, out);
+            continue;
+        }
+
+        _mm_storel_epi64((__m128i*)out, _mm_packus_epi16(units, units));
+        out += 8;
+        i += 8;
+    }
+#elif defined(NMB_SIMD_NEON)
+    while (i + 8 <= length)
+    {
+        uint16x8_t units = vld1q_u16(src + i);
+        if (vmaxvq_u16(units) >= 0x80u)
+        {
+            out = nmb_utf16_encode_block(src, length, &i, i + 8, out);
+            continue;
+        }
+
+        vst1_u8(out, vmovn_u16(units));
+        out += 8;
+        i += 8;
+    }
+#endif
+
+    out = nmb_utf16_encode_block(src, length, &i, length, out);
+    return (size_t)(out - (unsigned char*)dst);
+}
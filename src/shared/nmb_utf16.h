@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Worst-case UTF-8 size of length UTF-16 code units (excluding the terminator). */
+#define NMB_UTF16_TO_UTF8_MAX(length) ((length) * 3u)
+
+/**
+ * Transcodes length UTF-16 code units into dst, which must hold NMB_UTF16_TO_UTF8_MAX(length) bytes.
+ * Unpaired surrogates become U+FFFD, so the output is always valid UTF-8. Returns the bytes written;
+ * no terminator is appended. ASCII runs are converted 8 or 16 code units at a time.
+ */
+size_t nmb_utf16_to_utf8(const uint16_t* src, size_t length, char* dst);
+
+/** Portable reference implementation of nmb_utf16_to_utf8, exposed for tests and benchmarks. */
+size_t nmb_utf16_to_utf8_scalar(const uint16_t* src, size_t length, char* dst);
+
+#ifdef __cplusplus
+}
+#endif
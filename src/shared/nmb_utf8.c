@@ -0,0 +1,355 @@
+#include "nmb_utf8.h"
+#include "nmb_simd.h"
+
+#include <string.h>
+
+/*
+ * Returns the length (1-4) of the well-formed sequence at s, or 0 when it is ill-formed. In the
+ * latter case *subpart receives the length of the maximal ill-formed subpart (at least 1), which is
+ * what a repairing decoder replaces with a single U+FFFD.
+ */
+static size_t nmb_utf8_sequence(const unsigned char* s, size_t remaining, size_t* subpart)
+{
+    const unsigned char lead = s[0];
+    if (lead < 0x80u)
+    {
+        return 1;
+    }
+
+    size_t needed;
+    unsigned char low = 0x80u;
+    unsigned char high = 0xBFu;
+    if (lead >= 0xC2u && lead <= 0xDFu)
+    {
+        needed = 1;
+    }
+    else if (lead >= 0xE0u && lead <= 0xEFu)
+    {
+        needed = 2;
+        if (lead == 0xE0u)
+        {
+            low = 0xA0u;
+        }
+        else if (lead == 0xEDu)
+        {
+            high = 0x9Fu;
+        }
+    }
+    else if (lead >= 0xF0u && lead <= 0xF4u)
+    {
+        needed = 3;
+        if (lead == 0xF0u)
+        {
+            low = 0x90u;
+        }
+        else if (lead == 0xF4u)
+        {
+            high = 0x8Fu;
+        }
+    }
+    else
+    {
+        *subpart = 1;
+        return 0;
+    }
+
+    size_t matched = 0;
+    while (matched < needed && 1 + matched < remaining)
+    {
+        const unsigned char c = s[1 + matched];
+        if (c < low || c > high)
+        {
+            break;
+        }
+
+        low = 0x80u;
+        high = 0xBFu;
+        ++matched;
+    }
+
+    if (matched == needed)
+    {
+        return needed + 1;
+    }
+
+    *subpart = matched + 1;
+    return 0;
+}
+
+/* Validates whole sequences starting at *index until at least end; returns NMB_FALSE on the first error. */
+static nmb_bool nmb_utf8_validate_run(const unsigned char* s, size_t length, size_t* index, size_t end)
+{
+    size_t i = *index;
+    while (i < end)
+    {
+        size_t subpart;
+        size_t n = nmb_utf8_sequence(s + i, length - i, &subpart);
+        if (n == 0)
+        {
+            return NMB_FALSE;
+        }
+        i += n;
+    }
+    *index = i;
+    return NMB_TRUE;
+}
+
+nmb_bool nmb_utf8_is_valid_scalar(const char* data, size_t length)
+{
+    size_t i = 0;
+    return nmb_utf8_validate_run((const unsigned char*)data, length, &i, length);
+}
+
+size_t nmb_utf8_repair(const char* data, size_t length, char* dst)
+{
+    const unsigned char* s = (const unsigned char*)data;
+    unsigned char* out = (unsigned char*)dst;
+    size_t i = 0;
+    while (i < length)
+    {
+        size_t subpart;
+        size_t n = nmb_utf8_sequence(s + i, length - i, &subpart);
+        if (n != 0)
+        {
+            memcpy(out, s + i, n);
+            out += n;
+            i += n;
+            continue;
+        }
+
+        *out++ = 0xEFu;
+        *out++ = 0xBFu;
+        *out++ = 0xBDu;
+        i += subpart;
+    }
+    return (size_t)(out - (unsigned char*)dst);
+}
+
+/*
+ * Vectorized validation after Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ * Byte". Each byte pair is classified through three 16-entry nibble tables; any error bit that
+ * survives the AND marks an ill-formed pair, and the 3rd/4th continuation bytes are checked
+ * separately against the lead two and three positions back.
+ */
+#define NMB_UTF8_TOO_SHORT (1u << 0)
+#define NMB_UTF8_TOO_LONG (1u << 1)
+#define NMB_UTF8_OVERLONG_3 (1u << 2)
+#define NMB_UTF8_TOO_LARGE (1u << 3)
+#define NMB_UTF8_SURROGATE (1u << 4)
+#define NMB_UTF8_OVERLONG_2 (1u << 5)
+#define NMB_UTF8_TOO_LARGE_1000 (1u << 6)
+#define NMB_UTF8_OVERLONG_4 (1u << 6)
+#define NMB_UTF8_TWO_CONTS (1u << 7)
+#define NMB_UTF8_CARRY (NMB_UTF8_TOO_SHORT | NMB_UTF8_TOO_LONG | NMB_UTF8_TWO_CONTS)
+
+#if defined(NMB_SIMD_AVX2) || defined(NMB_SIMD_NEON)
+static const uint8_t kByte1High[16] = {
+    NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG,
+    NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG, NMB_UTF8_TOO_LONG,
+    NMB_UTF8_TWO_CONTS, NMB_UTF8_TWO_CONTS, NMB_UTF8_TWO_CONTS, NMB_UTF8_TWO_CONTS,
+    NMB_UTF8_TOO_SHORT | NMB_UTF8_OVERLONG_2,
+    NMB_UTF8_TOO_SHORT,
+    NMB_UTF8_TOO_SHORT | NMB_UTF8_OVERLONG_3 | NMB_UTF8_SURROGATE,
+    NMB_UTF8_TOO_SHORT | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000 | NMB_UTF8_OVERLONG_4,
+};
+
+static const uint8_t kByte1Low[16] = {
+    NMB_UTF8_CARRY | NMB_UTF8_OVERLONG_3 | NMB_UTF8_OVERLONG_2 | NMB_UTF8_OVERLONG_4,
+    NMB_UTF8_CARRY | NMB_UTF8_OVERLONG_2,
+    NMB_UTF8_CARRY,
+    NMB_UTF8_CARRY,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000 | NMB_UTF8_SURROGATE,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+    NMB_UTF8_CARRY | NMB_UTF8_TOO_LARGE | NMB_UTF8_TOO_LARGE_1000,
+};
+
+static const uint8_t kByte2High[16] = {
+    NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT,
+    NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT,
+    NMB_UTF8_TOO_LONG | NMB_UTF8_OVERLONG_2 | NMB_UTF8_TWO_CONTS | NMB_UTF8_OVERLONG_3 | NMB_UTF8_TOO_LARGE_1000 |
+        NMB_UTF8_OVERLONG_4,
+    NMB_UTF8_TOO_LONG | NMB_UTF8_OVERLONG_2 | NMB_UTF8_TWO_CONTS | NMB_UTF8_OVERLONG_3 | NMB_UTF8_TOO_LARGE,
+    NMB_UTF8_TOO_LONG | NMB_UTF8_OVERLONG_2 | NMB_UTF8_TWO_CONTS | NMB_UTF8_SURROGATE | NMB_UTF8_TOO_LARGE,
+    NMB_UTF8_TOO_LONG | NMB_UTF8_OVERLONG_2 | NMB_UTF8_TWO_CONTS | NMB_UTF8_SURROGATE | NMB_UTF8_TOO_LARGE,
+    NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT, NMB_UTF8_TOO_SHORT,
+};
+
+/* A block is incomplete when one of its last three bytes starts a sequence that runs past the block. */
+static const uint8_t kIncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+#endif
+
+#if defined(NMB_SIMD_AVX2)
+typedef struct NmbUtf8Avx2State_t
+{
+    __m256i prev_input;
+    __m256i prev_incomplete;
+    __m256i error;
+} NmbUtf8Avx2State;
+
+NMB_SIMD_AVX2_TARGET
+static void nmb_utf8_avx2_block(NmbUtf8Avx2State* state, __m256i input, __m256i byte1_high, __m256i byte1_low,
+                                __m256i byte2_high, __m256i incomplete_max)
+{
+    if (_mm256_movemask_epi8(input) == 0)
+    {
+        state->error = _mm256_or_si256(state->error, state->prev_incomplete);
+        state->prev_incomplete = _mm256_setzero_si256();
+        state->prev_input = input;
+        return;
+    }
+
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i carry = _mm256_permute2x128_si256(state->prev_input, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, carry, 15);
+    const __m256i prev2 = _mm256_alignr_epi8(input, carry, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(input, carry, 13);
+
+    __m256i special = _mm256_shuffle_epi8(byte1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    special = _mm256_and_si256(special, _mm256_shuffle_epi8(byte1_low, _mm256_and_si256(prev1, nibble)));
+    special = _mm256_and_si256(special,
+                               _mm256_shuffle_epi8(byte2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+    const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+
+    state->error = _mm256_or_si256(state->error, _mm256_xor_si256(must23, special));
+    state->prev_incomplete = _mm256_subs_epu8(input, incomplete_max);
+    state->prev_input = input;
+}
+
+NMB_SIMD_AVX2_TARGET
+static nmb_bool nmb_utf8_is_valid_avx2(const unsigned char* s, size_t length)
+{
+    const __m256i byte1_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kByte1High));
+    const __m256i byte1_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kByte1Low));
+    const __m256i byte2_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kByte2High));
+    const __m256i incomplete_max = _mm256_loadu_si256((const __m256i*)kIncompleteMax);
+
+    NmbUtf8Avx2State state;
+    state.prev_input = _mm256_setzero_si256();
+    state.prev_incomplete = _mm256_setzero_si256();
+    state.error = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        nmb_utf8_avx2_block(&state, _mm256_loadu_si256((const __m256i*)(s + i)), byte1_high, byte1_low, byte2_high,
+                            incomplete_max);
+    }
+
+    if (i < length)
+    {
+        /* Zero padding is ASCII, so an unterminated sequence in the tail shows up as TOO_SHORT. */
+        unsigned char tail[32] = {0};
+        memcpy(tail, s + i, length - i);
+        nmb_utf8_avx2_block(&state, _mm256_loadu_si256((const __m256i*)tail), byte1_high, byte1_low, byte2_high,
+                            incomplete_max);
+    }
+
+    const __m256i error = _mm256_or_si256(state.error, state.prev_incomplete);
+    return _mm256_testz_si256(error, error) ? NMB_TRUE : NMB_FALSE;
+}
+#endif
+
+#if defined(NMB_SIMD_NEON)
+static nmb_bool nmb_utf8_is_valid_neon(const unsigned char* s, size_t length)
+{
+    const uint8x16_t byte1_high = vld1q_u8(kByte1High);
+    const uint8x16_t byte1_low = vld1q_u8(kByte1Low);
+    const uint8x16_t byte2_high = vld1q_u8(kByte2High);
+    const uint8x16_t incomplete_max = vld1q_u8(kIncompleteMax + 16);
+    const uint8x16_t nibble = vdupq_n_u8(0x0F);
+
+    uint8x16_t prev_input = vdupq_n_u8(0);
+    uint8x16_t prev_incomplete = vdupq_n_u8(0);
+    uint8x16_t error = vdupq_n_u8(0);
+    unsigned char tail[16];
+
+    for (size_t i = 0; i < length; i += 16)
+    {
+        const unsigned char* block = s + i;
+        if (length - i < 16)
+        {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, s + i, length - i);
+            block = tail;
+        }
+
+        const uint8x16_t input = vld1q_u8(block);
+        if (vmaxvq_u8(input) < 0x80u)
+        {
+            error = vorrq_u8(error, prev_incomplete);
+            prev_incomplete = vdupq_n_u8(0);
+            prev_input = input;
+            continue;
+        }
+
+        const uint8x16_t prev1 = vextq_u8(prev_input, input, 15);
+        const uint8x16_t prev2 = vextq_u8(prev_input, input, 14);
+        const uint8x16_t prev3 = vextq_u8(prev_input, input, 13);
+
+        uint8x16_t special = vqtbl1q_u8(byte1_high, vshrq_n_u8(prev1, 4));
+        special = vandq_u8(special, vqtbl1q_u8(byte1_low, vandq_u8(prev1, nibble)));
+        special = vandq_u8(special, vqtbl1q_u8(byte2_high, vshrq_n_u8(input, 4)));
+
+        const uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+        const uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+        const uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+
+        error = vorrq_u8(error, veorq_u8(must23, special));
+        prev_incomplete = vqsubq_u8(input, incomplete_max);
+        prev_input = input;
+    }
+
+    error = vorrq_u8(error, prev_incomplete);
+    return vmaxvq_u8(error) == 0 ? NMB_TRUE : NMB_FALSE;
+}
+#endif
+
+nmb_bool nmb_utf8_is_valid(const char* data, size_t length)
+{
+    const unsigned char* s = (const unsigned char*)data;
+
+#if defined(NMB_SIMD_AVX2)
+    if (nmb_simd_has_avx2())
+    {
+        return nmb_utf8_is_valid_avx2(s, length);
+    }
+#endif
+
+#if defined(NMB_SIMD_NEON)
+    return nmb_utf8_is_valid_neon(s, length);
+#else
+    size_t i = 0;
+#if defined(NMB_SIMD_SSE2)
+    /* Without a byte shuffle, skip ASCII 16 bytes at a time and validate the rest sequence by sequence. */
+    while (i + 16 <= length)
+    {
+        if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i))) == 0)
+        {
+            i += 16;
+            continue;
+        }
+
+        if (!nmb_utf8_validate_run(s, length, &i, i + 16))
+        {
+            return NMB_FALSE;
+        }
+    }
+#endif
+    return nmb_utf8_validate_run(s, length, &i, length);
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "native_message_box.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Worst-case size of nmb_utf8_repair output for length input bytes (every byte becomes U+FFFD). */
+#define NMB_UTF8_REPAIR_MAX(length) ((length) * 3u)
+
+/**
+ * Returns NMB_TRUE when length bytes form well-formed UTF-8 (no overlongs, surrogates or code points
+ * above U+10FFFF). Uses a 32-byte AVX2 or 16-byte NEON classifier where available and an ASCII
+ * skip-ahead otherwise, so mostly-ASCII diagnostics validate at close to memory bandwidth.
+ */
+nmb_bool nmb_utf8_is_valid(const char* data, size_t length);
+
+/** Portable reference implementation of nmb_utf8_is_valid, exposed for tests and benchmarks. */
+nmb_bool nmb_utf8_is_valid_scalar(const char* data, size_t length);
+
+/**
+ * Copies length bytes into dst, replacing each maximal ill-formed subsequence with U+FFFD as the
+ * WHATWG decoder does. dst must hold NMB_UTF8_REPAIR_MAX(length) bytes. Returns the bytes written;
+ * no terminator is appended.
+ */
+size_t nmb_utf8_repair(const char* data, size_t length, char* dst);
+
+#ifdef __cplusplus
+}
+#endif